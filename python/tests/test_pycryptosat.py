@@ -330,6 +330,46 @@ class TestSolveTimeLimit(unittest.TestCase):
         # systems, but not on overloaded CI servers
         self.assertLess(took_time, 4)
 
+class TestLearntExchange(unittest.TestCase):
+
+    def get_clauses(self):
+        return TestSolveTimeLimit.get_clauses(self)
+
+    def test_wrong_args(self):
+        solver = Solver()
+        self.assertRaises(TypeError, solver.set_learnt_clause_export, 1)
+        self.assertRaises(TypeError, solver.set_learnt_clause_import, "a")
+
+    def test_export_import(self):
+        clauses = self.get_clauses()
+        exported = []
+        def export(cls):
+            exported.extend(cls)
+
+        a = Solver(confl_limit=3000)
+        a.add_clauses(clauses)
+        a.set_learnt_clause_export(export, max_size=6, max_glue=3, batch_size=10)
+        a.solve()
+        self.assertGreater(len(exported), 0)
+        for cl in exported:
+            self.assertLessEqual(len(cl), 6)
+            for lit in cl:
+                self.assertLessEqual(abs(lit), 400)
+        a.set_learnt_clause_export(None)
+
+        polled = []
+        def imp():
+            polled.append(1)
+            if len(polled) == 1:
+                return exported
+            return None
+
+        b = Solver(confl_limit=3000)
+        b.add_clauses(clauses)
+        b.set_learnt_clause_import(imp)
+        b.solve()
+        self.assertGreater(len(polled), 1)
+
 # ------------------------------------------------------------------------
 
 
@@ -346,6 +386,7 @@ def run():
     suite.addTest(unittest.makeSuite(TestSolve))
     suite.addTest(unittest.makeSuite(TestDump))
     suite.addTest(unittest.makeSuite(TestSolveTimeLimit))
+    suite.addTest(unittest.makeSuite(TestLearntExchange))
 
     runner = unittest.TextTestRunner(verbosity=2)
     result = runner.run(suite)
@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""
+Compares rephasing schedules on the satisfiable instances of a set of CNFs.
+Example:
+  ./rephase.py --solver ../../build/cryptominisat5 ../../tests/cnf-files
+"""
+
+from __future__ import print_function
+import argparse
+import glob
+import os
+import re
+import subprocess
+import time
+
+CONFIGS = [
+    ("no-rephase", ["--rephase", "0"]),
+    ("default", ["--rephase", "1"]),
+    ("no-walk", ["--rephase", "1", "--rephasesched", "best,orig,best,inv,best,rnd"]),
+    ("best-only", ["--rephase", "1", "--rephasesched", "best"]),
+]
+
+
+def run_one(solver, fname, extra, seed, timeout):
+    cmd = [solver, "--verb", "1", "--random", str(seed)] + extra + [fname]
+    start = time.time()
+    try:
+        out = subprocess.check_output(cmd, timeout=timeout,
+                                      universal_newlines=True)
+    except subprocess.CalledProcessError as e:
+        # exit code is 10 for SAT, 20 for UNSAT
+        out = e.output
+    except subprocess.TimeoutExpired:
+        return None, timeout, None
+    elapsed = time.time() - start
+
+    status = None
+    confls = None
+    for line in out.splitlines():
+        if line.startswith("s "):
+            status = line.split()[1]
+        m = re.match(r"c conflicts\s*:\s*(\d+)", line)
+        if m:
+            confls = int(m.group(1))
+    return status, elapsed, confls
+
+
+def collect_files(paths):
+    files = []
+    for p in paths:
+        if os.path.isdir(p):
+            files.extend(sorted(glob.glob(os.path.join(p, "*.cnf"))))
+        else:
+            files.append(p)
+    return files
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--solver", default="cryptominisat5",
+                        help="Solver executable")
+    parser.add_argument("--seeds", type=int, default=3,
+                        help="Number of random seeds per config")
+    parser.add_argument("--timeout", type=int, default=300,
+                        help="Timeout per run in seconds")
+    parser.add_argument("paths", nargs="*", default=["tests/cnf-files"],
+                        help="CNF files or directories of CNF files")
+    args = parser.parse_args()
+
+    files = collect_files(args.paths)
+    sat_files = []
+    for f in files:
+        status, _, _ = run_one(args.solver, f, [], 0, args.timeout)
+        if status == "SATISFIABLE":
+            sat_files.append(f)
+    print("Satisfiable instances: %d out of %d" % (len(sat_files), len(files)))
+
+    for name, extra in CONFIGS:
+        tot_time = 0.0
+        tot_confl = 0
+        solved = 0
+        for f in sat_files:
+            for seed in range(args.seeds):
+                status, elapsed, confls = run_one(args.solver, f, extra, seed,
+                                                  args.timeout)
+                tot_time += elapsed
+                if status == "SATISFIABLE":
+                    solved += 1
+                if confls is not None:
+                    tot_confl += confls
+
+        print("{:<12} solved: {:5d}/{:<5d} time: {:9.2f} s  conflicts: {:12d}".format(
+            name, solved, len(sat_files)*args.seeds, tot_time, tot_confl))
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "searcher.h"
 #include "time_mem.h"
 #include "sqlstats.h"
+#include "simplefile.h"
 #ifdef USE_GAUSS
 #include "gaussian.h"
 #endif
@@ -214,6 +215,16 @@ ClOffset ClauseAllocator::move_cl(
     return new_offset;
 }
 
+ClOffset ClauseAllocator::moved_to(const Clause* old) const
+{
+    assert(old->reloced);
+    ClOffset new_offset = (*old)[0].toInt();
+    #ifdef LARGE_OFFSETS
+    new_offset += ((uint64_t)(*old)[1].toInt())<<32;
+    #endif
+    return new_offset;
+}
+
 void ClauseAllocator::move_one_watchlist(
     watch_subarray& ws, ClOffset* newDataStart, ClOffset*& new_ptr)
 {
@@ -223,11 +234,7 @@ void ClauseAllocator::move_one_watchlist(
             assert(!old->freed());
             Lit blocked = w.getBlockedLit();
             if (old->reloced) {
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                w = Watched(new_offset, blocked);
+                w = Watched(moved_to(old), blocked);
             } else {
                 ClOffset new_offset = move_cl(newDataStart, new_ptr, old);
                 w = Watched(new_offset, blocked);
@@ -294,17 +301,15 @@ void ClauseAllocator::consolidate(
             ) {
                 Clause* old = ptr(vdata.reason.get_offset());
                 assert(!old->freed());
-                ClOffset new_offset = (*old)[0].toInt();
-                #ifdef LARGE_OFFSETS
-                new_offset += ((uint64_t)(*old)[1].toInt())<<32;
-                #endif
-                vdata.reason = PropBy(new_offset);
+                vdata.reason = PropBy(moved_to(old));
             } else {
                 vdata.reason = PropBy();
             }
         }
     }
 
+    solver->drat->clauses_moved();
+
     //Update sizes
     const uint64_t old_size = size;
     size = new_ptr-newDataStart;
@@ -351,10 +356,7 @@ void ClauseAllocator::update_offsets(
             assert(old->_xor_is_detached);
             offs = move_cl(newDataStart, new_ptr, old);
         } else {
-            offs = (*old)[0].toInt();
-            #ifdef LARGE_OFFSETS
-            offs += ((uint64_t)(*old)[1].toInt())<<32;
-            #endif
+            offs = moved_to(old);
         }
     }
 }
@@ -366,3 +368,58 @@ size_t ClauseAllocator::mem_used() const
 
     return mem;
 }
+
+void ClauseAllocator::save_state(SimpleOutFile& f) const
+{
+    f.put_uint64_t(size);
+    f.put_uint64_t(currentlyUsedSize);
+    f.put_raw(dataStart, size*sizeof(BASE_DATA_TYPE));
+}
+
+void ClauseAllocator::load_state(SimpleInFile& f)
+{
+    assert(size == 0);
+    const uint64_t new_size = f.get_uint64_t();
+    const uint64_t new_used = f.get_uint64_t();
+    if (new_size > MAXSIZE || new_used > new_size) {
+        throw std::runtime_error("ERROR: clause arena in file is corrupt");
+    }
+    if (new_size == 0) {
+        return;
+    }
+
+    alloc_exactly(new_size);
+    f.get_raw(dataStart, new_size, sizeof(BASE_DATA_TYPE));
+    size = new_size;
+    currentlyUsedSize = new_used;
+}
+
+void ClauseAllocator::copy_from(const ClauseAllocator& other)
+{
+    assert(size == 0);
+    if (other.size == 0) {
+        return;
+    }
+
+    alloc_exactly(other.size);
+    memcpy(dataStart, other.dataStart, other.size*sizeof(BASE_DATA_TYPE));
+    size = other.size;
+    currentlyUsedSize = other.currentlyUsedSize;
+}
+
+void ClauseAllocator::alloc_exactly(const uint64_t new_capacity)
+{
+    BASE_DATA_TYPE* new_dataStart = (BASE_DATA_TYPE*)realloc(
+        dataStart
+        , new_capacity*sizeof(BASE_DATA_TYPE)
+    );
+    if (new_dataStart == NULL) {
+        std::cerr
+        << "ERROR: while allocating clause space"
+        << endl;
+
+        throw std::bad_alloc();
+    }
+    dataStart = new_dataStart;
+    capacity = new_capacity;
+}
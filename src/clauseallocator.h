@@ -39,6 +39,8 @@ namespace CMSat {
 class Clause;
 class Solver;
 class PropEngine;
+class SimpleOutFile;
+class SimpleInFile;
 
 using std::map;
 using std::vector;
@@ -87,6 +89,9 @@ class ClauseAllocator {
         void clauseFree(Clause* c);
         void clauseFree(ClOffset offset);
 
+        ///Where consolidate() moved the clause to, only valid while it runs
+        ClOffset moved_to(const Clause* old) const;
+
         void consolidate(
             Solver* solver
             , const bool force = false
@@ -95,7 +100,13 @@ class ClauseAllocator {
 
         size_t mem_used() const;
 
+        ///The arena is written as-is, offsets stay valid after loading
+        void save_state(SimpleOutFile& f) const;
+        void load_state(SimpleInFile& f);
+        void copy_from(const ClauseAllocator& other); ///<Same, without a file
+
     private:
+        void alloc_exactly(const uint64_t new_capacity);
         void update_offsets(
             vector<ClOffset>& offsets,
             ClOffset* newDataStart,
@@ -183,6 +183,8 @@ bool ClauseCleaner::clean_clause(Clause& cl)
 
     assert(cl.size() > 2);
     (*solver->drat) << deldelay << cl << fin;
+    const bool hints = solver->drat->hints_needed();
+    frat_hints.clear();
 
     #ifdef SLOW_DEBUG
     uint32_t num_false_begin = 0;
@@ -205,9 +207,16 @@ bool ClauseCleaner::clean_clause(Clause& cl)
             (*solver->drat) << findelay;
             return true;
         }
+        if (hints) {
+            frat_hints.push_back(solver->drat->unit_ID(~*i));
+        }
     }
     if (i != j) {
         cl.shrink(i-j);
+        if (hints) {
+            frat_hints.push_back(solver->drat->ID_of(cl));
+            solver->drat->set_hints(frat_hints);
+        }
         (*solver->drat) << add << cl
         #ifdef STATS_NEEDED
         << solver->sumConflicts
@@ -81,6 +81,7 @@ class ClauseCleaner
 
         bool satisfied(const Watched& watched, Lit lit);
         vector<ClOffset> delayed_free;
+        vector<uint32_t> frat_hints;
 
         Solver* solver;
 };
@@ -0,0 +1,384 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+//The hub of distributed solving. Every cryptominisat5 started with
+//--net ADDRESS connects here, and every clause one of them sends is
+//forwarded to all the others that don't know about it yet. Once one of them
+//has finished, all the others are told to stop, and so is every solver that
+//connects later. The hub exits when the last solver has disconnected after
+//that.
+
+#include "netsync.h"
+
+#include <iostream>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <poll.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <signal.h>
+#include <sys/socket.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CMSat;
+using namespace CMSat::net;
+
+//A solver that doesn't read what it is sent only loses clauses, it doesn't
+//make the hub run out of memory
+static const size_t max_pending_write = 64U*1024U*1024U;
+
+struct Peer
+{
+    explicit Peer(int fd, uint32_t _id) :
+        conn(fd)
+        , id(_id)
+    {}
+
+    Conn conn;
+    uint32_t id;
+    bool hello = false;
+    bool dead = false;
+    bool done_sent = false;
+
+    //Everything this peer has sent or has been sent
+    std::unordered_set<uint64_t> known;
+    vector<uint32_t> pending;
+};
+
+struct HubStats
+{
+    uint64_t peers = 0;
+    uint64_t recv_cls = 0;
+    uint64_t fwd_cls = 0;
+    uint64_t dedup_cls = 0;
+    uint64_t bytes_recv = 0;
+    uint64_t bytes_sent = 0;
+};
+
+static void print_usage(const char* prog)
+{
+    cout
+    << "Usage: " << prog << " [--verb N] [--solvers N] ADDRESS" << endl
+    << "  ADDRESS is HOST:PORT (e.g. *:5555) or unix:PATH" << endl
+    << "  --solvers N: don't exit before N solvers have connected" << endl
+    << "  Then start the solvers with: cryptominisat5 --net ADDRESS FILE" << endl;
+}
+
+class Hub
+{
+public:
+    Hub(int _listen_fd, int _verb, uint64_t _min_solvers) :
+        listen_fd(_listen_fd)
+        , verb(_verb)
+        , min_solvers(_min_solvers)
+    {}
+
+    void run();
+    const HubStats& get_stats() const
+    {
+        return stats;
+    }
+
+private:
+    void accept_new();
+    void handle_msg(Peer& p, MsgType type, const vector<uint8_t>& payload);
+    void forward(Peer& from, const vector<uint32_t>& flat);
+    void send_done(Peer& p);
+    void flush_pending();
+    void remove_dead();
+
+    int listen_fd;
+    int verb;
+    uint64_t min_solvers;
+    vector<std::unique_ptr<Peer>> peers;
+    uint32_t next_id = 0;
+    bool num_vars_set = false;
+    uint64_t num_vars = 0;
+    bool done = false;
+    HubStats stats;
+
+    vector<uint32_t> flat;
+    vector<uint8_t> payload;
+};
+
+void Hub::accept_new()
+{
+    while(true) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd == -1) {
+            return;
+        }
+        const int flags = fcntl(fd, F_GETFL, 0);
+        if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+            close_fd(fd);
+            continue;
+        }
+        std::unique_ptr<Peer> p(new Peer(fd, next_id++));
+        if (verb) {
+            cout << "c [hub] solver " << p->id << " connected" << endl;
+        }
+        stats.peers++;
+        peers.push_back(std::move(p));
+    }
+}
+
+void Hub::send_done(Peer& p)
+{
+    if (p.done_sent) {
+        return;
+    }
+    p.done_sent = true;
+    payload.clear();
+    p.conn.queue(MsgType::done, payload);
+}
+
+void Hub::forward(Peer& from, const vector<uint32_t>& cls)
+{
+    size_t at = 0;
+    while(at < cls.size()) {
+        const uint32_t sz = cls[at];
+        const uint32_t* lits = cls.data() + at + 1;
+        const uint64_t h = clause_hash(lits, sz);
+        stats.recv_cls++;
+        from.known.insert(h);
+        for(auto& p: peers) {
+            if (p.get() == &from || !p->hello || p->dead) {
+                continue;
+            }
+            if (p->known.insert(h).second) {
+                p->pending.push_back(sz);
+                p->pending.insert(p->pending.end(), lits, lits + sz);
+                stats.fwd_cls++;
+            } else {
+                stats.dedup_cls++;
+            }
+        }
+        at += 1 + sz;
+    }
+}
+
+void Hub::handle_msg(Peer& p, MsgType type, const vector<uint8_t>& data)
+{
+    switch(type) {
+        case MsgType::hello: {
+            const uint8_t* at = data.data();
+            uint64_t nv;
+            if (!get_varint(at, data.data() + data.size(), nv)) {
+                p.dead = true;
+                return;
+            }
+            if (!num_vars_set) {
+                num_vars_set = true;
+                num_vars = nv;
+            } else if (nv != num_vars) {
+                cerr << "c [hub] solver " << p.id << " has " << nv
+                << " variables instead of " << num_vars
+                << ", it must be solving a different problem. Dropping it." << endl;
+                p.dead = true;
+                return;
+            }
+            p.hello = true;
+            if (done) {
+                send_done(p);
+            }
+            break;
+        }
+
+        case MsgType::clauses:
+            if (!p.hello) {
+                return;
+            }
+            flat.clear();
+            if (!decode_clauses(data.data(), data.size(), flat)) {
+                cerr << "c [hub] malformed batch from solver " << p.id << endl;
+                p.dead = true;
+                return;
+            }
+            forward(p, flat);
+            break;
+
+        case MsgType::done:
+            if (verb) {
+                cout << "c [hub] solver " << p.id << " has finished" << endl;
+            }
+            done = true;
+            p.done_sent = true;
+            for(auto& other: peers) {
+                if (other->hello) {
+                    send_done(*other);
+                }
+            }
+            break;
+
+        default:
+            p.dead = true;
+            break;
+    }
+}
+
+void Hub::flush_pending()
+{
+    for(auto& p: peers) {
+        if (!p->pending.empty() && !p->dead && !p->done_sent
+            && p->conn.pending_write() < max_pending_write
+        ) {
+            payload.clear();
+            encode_clauses(p->pending, payload);
+            p->conn.queue(MsgType::clauses, payload);
+        }
+        p->pending.clear();
+        if (p->conn.want_write() && !p->conn.write_some()) {
+            p->dead = true;
+        }
+    }
+}
+
+void Hub::remove_dead()
+{
+    size_t j = 0;
+    for(size_t i = 0; i < peers.size(); i++) {
+        if (peers[i]->dead) {
+            if (verb) {
+                cout << "c [hub] solver " << peers[i]->id << " disconnected" << endl;
+            }
+            stats.bytes_recv += peers[i]->conn.bytes_recv;
+            stats.bytes_sent += peers[i]->conn.bytes_sent;
+            continue;
+        }
+        peers[j++] = std::move(peers[i]);
+    }
+    peers.resize(j);
+}
+
+void Hub::run()
+{
+    vector<pollfd> fds;
+    vector<uint8_t> data;
+    while(!(done && peers.empty() && stats.peers >= min_solvers)) {
+        fds.clear();
+        pollfd lp;
+        lp.fd = listen_fd;
+        lp.events = POLLIN;
+        lp.revents = 0;
+        fds.push_back(lp);
+        for(auto& p: peers) {
+            pollfd pp;
+            pp.fd = p->conn.fd;
+            pp.events = POLLIN | (p->conn.want_write() ? POLLOUT : 0);
+            pp.revents = 0;
+            fds.push_back(pp);
+        }
+        if (poll(fds.data(), fds.size(), -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(string("ERROR: poll failed: ") + strerror(errno));
+        }
+
+        //Messages are read from every peer first, so that what arrives at the
+        //same time goes out in one batch
+        const size_t num_peers = peers.size();
+        for(size_t i = 0; i < num_peers; i++) {
+            Peer& p = *peers[i];
+            const short ev = fds[i+1].revents;
+            if (ev == 0 || p.dead) {
+                continue;
+            }
+            if ((ev & POLLOUT) && !p.conn.write_some()) {
+                p.dead = true;
+            }
+            if (ev & (POLLIN | POLLHUP | POLLERR)) {
+                const bool alive = p.conn.read_some();
+                MsgType type;
+                bool malformed;
+                while(!p.dead && p.conn.next_msg(type, data, malformed)) {
+                    handle_msg(p, type, data);
+                }
+                if (!alive || malformed) {
+                    p.dead = true;
+                }
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            accept_new();
+        }
+        flush_pending();
+        remove_dead();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int verb = 1;
+    uint64_t min_solvers = 0;
+    string addr;
+    for(int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verb") == 0 && i+1 < argc) {
+            verb = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--solvers") == 0 && i+1 < argc) {
+            min_solvers = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (addr.empty()) {
+            addr = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return -1;
+        }
+    }
+    if (addr.empty()) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    try {
+        const int fd = listen_on(addr);
+        if (verb) {
+            cout << "c [hub] listening on " << addr << endl;
+        }
+        Hub hub(fd, verb, min_solvers);
+        hub.run();
+        close_fd(fd);
+
+        const HubStats& s = hub.get_stats();
+        if (verb) {
+            cout
+            << "c [hub] solvers served: " << s.peers << endl
+            << "c [hub] clauses received: " << s.recv_cls << endl
+            << "c [hub] clauses forwarded: " << s.fwd_cls << endl
+            << "c [hub] clauses deduplicated: " << s.dedup_cls << endl
+            << "c [hub] bytes received: " << s.bytes_recv << endl
+            << "c [hub] bytes sent: " << s.bytes_sent << endl;
+        }
+    } catch (std::runtime_error& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
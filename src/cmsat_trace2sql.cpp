@@ -0,0 +1,363 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+//Converts the binary trace written with --sqltrace 1 into the SQLite
+//database that --sql 1 would have written, with the table structure of
+//cmsat_tablestructure.sql
+
+#include "tracewriter.h"
+#include "sql_tablestructure.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <stdexcept>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CMSat;
+
+class TraceReader
+{
+public:
+    explicit TraceReader(const string& fname) :
+        in(fname.c_str(), std::ios::binary)
+    {
+        if (!in) {
+            throw std::runtime_error("ERROR: cannot open trace file '" + fname + "'");
+        }
+    }
+
+    bool eof()
+    {
+        return in.peek() == EOF;
+    }
+
+    void get_bytes(void* data, size_t len)
+    {
+        in.read((char*)data, len);
+        if ((size_t)in.gcount() != len) {
+            throw std::runtime_error("ERROR: the trace file is truncated");
+        }
+    }
+
+    uint8_t get_u8()
+    {
+        uint8_t v;
+        get_bytes(&v, 1);
+        return v;
+    }
+
+    uint32_t get_u32()
+    {
+        uint8_t b[4];
+        get_bytes(b, 4);
+        return (uint32_t)b[0] | ((uint32_t)b[1] << 8)
+            | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    }
+
+    string get_str()
+    {
+        const uint32_t len = get_u32();
+        if (len > max_len) {
+            throw std::runtime_error("ERROR: the trace file is corrupt");
+        }
+        string s(len, '\0');
+        get_bytes(&s[0], len);
+        return s;
+    }
+
+    static const uint32_t max_len = 1U << 30;
+
+private:
+    std::ifstream in;
+};
+
+struct TableIns
+{
+    string name;
+    uint32_t num_cols = 0;
+    sqlite3_stmt* stmt = NULL;
+};
+
+class Converter
+{
+public:
+    Converter(sqlite3* _db, const string& fname) :
+        db(_db)
+        , rd(fname)
+    {}
+
+    ~Converter()
+    {
+        for(auto& t: tables) {
+            sqlite3_finalize(t.stmt);
+        }
+    }
+
+    void run();
+    uint64_t num_rows = 0;
+
+private:
+    void check(int rc, const string& what);
+    void read_table();
+    void read_block();
+    void run_block(const TableIns& t, uint32_t rows, const uint8_t* data);
+
+    sqlite3* db;
+    TraceReader rd;
+    vector<TableIns> tables;
+    vector<string> texts;
+    vector<uint8_t> stored;
+    vector<uint8_t> raw;
+    bool compressed = false;
+};
+
+void Converter::check(int rc, const string& what)
+{
+    if (rc != SQLITE_OK && rc != SQLITE_DONE) {
+        throw std::runtime_error(
+            "ERROR: SQLite failed at " + what + ": " + sqlite3_errmsg(db));
+    }
+}
+
+void Converter::read_table()
+{
+    const uint32_t id = rd.get_u32();
+    if (id != tables.size()) {
+        throw std::runtime_error("ERROR: the trace file is corrupt");
+    }
+    TableIns t;
+    t.name = rd.get_str();
+    t.num_cols = rd.get_u32();
+    if (t.num_cols == 0 || t.num_cols > 0xffff) {
+        throw std::runtime_error("ERROR: the trace file is corrupt");
+    }
+
+    std::stringstream ss;
+    ss << "insert into `" << t.name << "` (";
+    for(uint32_t i = 0; i < t.num_cols; i++) {
+        ss << (i > 0 ? ", " : "") << "`" << rd.get_str() << "`";
+    }
+    ss << ") values (";
+    for(uint32_t i = 0; i < t.num_cols; i++) {
+        ss << (i > 0 ? ",?" : "?");
+    }
+    ss << ");";
+    check(sqlite3_prepare_v2(db, ss.str().c_str(), -1, &t.stmt, NULL)
+        , "preparing the insert into '" + t.name + "'");
+    tables.push_back(t);
+}
+
+void Converter::read_block()
+{
+    const uint32_t id = rd.get_u32();
+    const uint32_t rows = rd.get_u32();
+    const uint32_t raw_len = rd.get_u32();
+    const uint32_t stored_len = rd.get_u32();
+    if (id >= tables.size()
+        || raw_len != (uint64_t)rows*tables[id].num_cols*9
+        || stored_len > TraceReader::max_len
+    ) {
+        throw std::runtime_error("ERROR: the trace file is corrupt");
+    }
+    stored.resize(stored_len);
+    rd.get_bytes(stored.data(), stored_len);
+
+    const uint8_t* data = stored.data();
+    if (compressed) {
+        #ifdef USE_ZLIB
+        raw.resize(raw_len);
+        uLongf len = raw_len;
+        if (uncompress(raw.data(), &len, stored.data(), stored_len) != Z_OK
+            || len != raw_len
+        ) {
+            throw std::runtime_error("ERROR: the trace file is corrupt");
+        }
+        data = raw.data();
+        #endif
+    } else if (stored_len != raw_len) {
+        throw std::runtime_error("ERROR: the trace file is corrupt");
+    }
+    run_block(tables[id], rows, data);
+}
+
+void Converter::run_block(const TableIns& t, uint32_t rows, const uint8_t* data)
+{
+    //Column c starts at c*rows*9: the types of its rows, then their values
+    for(uint32_t r = 0; r < rows; r++) {
+        for(uint32_t c = 0; c < t.num_cols; c++) {
+            const uint8_t* col = data + (size_t)c*rows*9;
+            const TraceVal type = (TraceVal)col[r];
+            const uint8_t* vb = col + rows + (size_t)r*8;
+            uint64_t v = 0;
+            for(uint32_t i = 0; i < 8; i++) {
+                v |= (uint64_t)vb[i] << (8*i);
+            }
+
+            int rc;
+            switch(type) {
+                case TraceVal::null:
+                    rc = sqlite3_bind_null(t.stmt, c+1);
+                    break;
+                case TraceVal::int64:
+                    rc = sqlite3_bind_int64(t.stmt, c+1, (int64_t)v);
+                    break;
+                case TraceVal::dbl: {
+                    double d;
+                    memcpy(&d, &v, sizeof(d));
+                    rc = sqlite3_bind_double(t.stmt, c+1, d);
+                    break;
+                }
+                case TraceVal::text:
+                    if (v >= texts.size()) {
+                        throw std::runtime_error("ERROR: the trace file is corrupt");
+                    }
+                    rc = sqlite3_bind_text(
+                        t.stmt, c+1, texts[v].c_str(), -1, SQLITE_STATIC);
+                    break;
+                default:
+                    throw std::runtime_error("ERROR: the trace file is corrupt");
+            }
+            check(rc, "binding a value of '" + t.name + "'");
+        }
+        check(sqlite3_step(t.stmt), "inserting into '" + t.name + "'");
+        check(sqlite3_reset(t.stmt), "resetting the insert into '" + t.name + "'");
+        num_rows++;
+    }
+}
+
+void Converter::run()
+{
+    char magic[sizeof(trace_magic)];
+    rd.get_bytes(magic, sizeof(magic));
+    if (memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("ERROR: not a CryptoMiniSat SQL trace");
+    }
+    const uint32_t version = rd.get_u32();
+    if (version != trace_version) {
+        throw std::runtime_error("ERROR: the trace has format version "
+            + std::to_string(version) + ", this converter reads version "
+            + std::to_string(trace_version));
+    }
+    compressed = rd.get_u32() & trace_flag_zlib;
+    #ifndef USE_ZLIB
+    if (compressed) {
+        throw std::runtime_error(
+            "ERROR: the trace is compressed, but zlib was not compiled in");
+    }
+    #endif
+
+    while(!rd.eof()) {
+        switch((TraceRec)rd.get_u8()) {
+            case TraceRec::table:
+                read_table();
+                break;
+
+            case TraceRec::text: {
+                const uint32_t id = rd.get_u32();
+                if (id != texts.size()) {
+                    throw std::runtime_error("ERROR: the trace file is corrupt");
+                }
+                texts.push_back(rd.get_str());
+                break;
+            }
+
+            case TraceRec::sql: {
+                const string sql = rd.get_str();
+                check(sqlite3_exec(db, sql.c_str(), NULL, NULL, NULL), "'" + sql + "'");
+                break;
+            }
+
+            case TraceRec::block:
+                read_block();
+                break;
+
+            default:
+                throw std::runtime_error("ERROR: the trace file is corrupt");
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        cout
+        << "Usage: " << argv[0] << " TRACE DB" << endl
+        << "  Converts TRACE, written by cryptominisat5 --sqltrace 1, to the SQLite"
+        << endl
+        << "  database DB, which must not exist yet" << endl;
+        return -1;
+    }
+    const string trace_fname = argv[1];
+    const string db_fname = argv[2];
+
+    if (std::ifstream(db_fname.c_str()).good()) {
+        cerr << "ERROR: the database already exists: " << db_fname << endl;
+        return -1;
+    }
+
+    sqlite3* db = NULL;
+    if (sqlite3_open(db_fname.c_str(), &db)) {
+        cerr << "ERROR: cannot open sqlite database: " << sqlite3_errmsg(db) << endl;
+        sqlite3_close(db);
+        return -1;
+    }
+
+    try {
+        if (sqlite3_exec(db, "PRAGMA synchronous = OFF", NULL, NULL, NULL)
+            || sqlite3_exec(db, "PRAGMA journal_mode = MEMORY", NULL, NULL, NULL)
+            || sqlite3_exec(db, cmsat_tablestructure_sql, NULL, NULL, NULL)
+            || sqlite3_exec(db, "BEGIN TRANSACTION", NULL, NULL, NULL)
+        ) {
+            throw std::runtime_error(
+                string("ERROR: cannot set up the database: ") + sqlite3_errmsg(db));
+        }
+
+        uint64_t num_rows;
+        {
+            Converter conv(db, trace_fname);
+            conv.run();
+            num_rows = conv.num_rows;
+        }
+        if (sqlite3_exec(db, "END TRANSACTION", NULL, NULL, NULL)) {
+            throw std::runtime_error(
+                string("ERROR: cannot commit to the database: ") + sqlite3_errmsg(db));
+        }
+        cout << "c converted " << num_rows << " rows to " << db_fname << endl;
+    } catch (std::runtime_error& e) {
+        cerr << e.what() << endl;
+        sqlite3_close(db);
+        std::remove(db_fname.c_str());
+        return -1;
+    }
+
+    sqlite3_close(db);
+    return 0;
+}
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "watchalgos.h"
 #include "varupdatehelper.h"
 #include "time_mem.h"
+#include "dratchecker.h"
 
 using namespace CMSat;
 
@@ -418,6 +419,172 @@ void CNF::load_state(SimpleInFile& f)
     watches.resize(nVars()*2);
 }
 
+static void save_xors(SimpleOutFile& f, const vector<Xor>& xors)
+{
+    f.put_uint64_t(xors.size());
+    for(const Xor& x: xors) {
+        f.put_uint32_t(x.rhs);
+        f.put_uint32_t(x.detached);
+        f.put_vector(x.clash_vars);
+        f.put_vector(x.vars);
+    }
+}
+
+static void load_xors(SimpleInFile& f, vector<Xor>& xors)
+{
+    xors.clear();
+    xors.resize(f.get_uint64_t());
+    for(Xor& x: xors) {
+        x.rhs = f.get_uint32_t();
+        x.detached = f.get_uint32_t();
+        f.get_vector(x.clash_vars);
+        f.get_vector(x.vars);
+    }
+}
+
+//Unlike save_state(), everything needed to continue the search is written,
+//and the clauses are not written one-by-one: the clause arena is dumped
+//as-is together with the offset tables. Watches are not written, they are
+//rebuilt from the clauses when loading.
+void CNF::save_checkpoint(SimpleOutFile& f) const
+{
+    f.put_vector(interToOuterMain);
+    f.put_vector(outerToInterMain);
+    f.put_vector(outer_to_with_bva_map);
+    f.put_vector(assigns);
+    f.put_vector(varData);
+    f.put_uint32_t(minNumVars);
+    f.put_uint32_t(num_bva_vars);
+    f.put_uint32_t(ok);
+
+    f.put_uint64_t(sumConflicts);
+    f.put_uint64_t(sumDecisions);
+    f.put_uint64_t(sumAntecedents);
+    f.put_uint64_t(sumPropagations);
+    f.put_uint64_t(sumConflictClauseLits);
+    f.put_uint64_t(sumAntecedentsLits);
+    f.put_uint64_t(sumDecisionBasedCl);
+    f.put_uint64_t(sumClLBD);
+    f.put_uint64_t(sumClSize);
+    f.put_struct(binTri);
+    f.put_struct(litStats);
+    f.put_struct(clauseID);
+    f.put_struct(restartID);
+    f.put_struct(polarity_mode);
+    f.put_uint32_t(longest_trail_ever);
+    f.put_uint32_t(cur_max_temp_red_lev2_cls);
+
+    cl_alloc.save_state(f);
+    f.put_vector(longIrredCls);
+    for(const auto& lredcls: longRedCls) {
+        f.put_vector(lredcls);
+    }
+    assert(detached_xor_repr_cls.empty());
+    save_xors(f, xorclauses);
+    save_xors(f, xorclauses_unused);
+    f.put_vector(removed_xorclauses_clash_vars);
+}
+
+//The per-variable datastructures must already have been created with
+//new_vars(), they are overwritten here
+void CNF::load_checkpoint(SimpleInFile& f)
+{
+    f.get_vector(interToOuterMain);
+    f.get_vector(outerToInterMain);
+    f.get_vector(outer_to_with_bva_map);
+    f.get_vector(assigns);
+    f.get_vector(varData);
+    minNumVars = f.get_uint32_t();
+    num_bva_vars = f.get_uint32_t();
+    ok = f.get_uint32_t();
+
+    sumConflicts = f.get_uint64_t();
+    sumDecisions = f.get_uint64_t();
+    sumAntecedents = f.get_uint64_t();
+    sumPropagations = f.get_uint64_t();
+    sumConflictClauseLits = f.get_uint64_t();
+    sumAntecedentsLits = f.get_uint64_t();
+    sumDecisionBasedCl = f.get_uint64_t();
+    sumClLBD = f.get_uint64_t();
+    sumClSize = f.get_uint64_t();
+    f.get_struct(binTri);
+    f.get_struct(litStats);
+    f.get_struct(clauseID);
+    f.get_struct(restartID);
+    f.get_struct(polarity_mode);
+    longest_trail_ever = f.get_uint32_t();
+    cur_max_temp_red_lev2_cls = f.get_uint32_t();
+
+    cl_alloc.load_state(f);
+    f.get_vector(longIrredCls);
+    for(auto& lredcls: longRedCls) {
+        f.get_vector(lredcls);
+    }
+    load_xors(f, xorclauses);
+    load_xors(f, xorclauses_unused);
+    f.get_vector(removed_xorclauses_clash_vars);
+
+    //Gauss-Jordan matrices are not saved, they are rebuilt from the XORs
+    xor_clauses_updated = true;
+
+    if (interToOuterMain.size() != nVarsOuter()
+        || outerToInterMain.size() != nVarsOuter()
+        || varData.size() != nVarsOuter()
+        || minNumVars > nVarsOuter()
+    ) {
+        throw std::runtime_error("ERROR: checkpoint is corrupt");
+    }
+}
+
+//Same as a checkpoint saved by "other" and loaded here, but the watches are
+//copied as well, and so are the XOR-encoding clauses "other" has detached.
+//"other" may be above level 0, the caller must backtrack this copy.
+void CNF::copy_checkpoint_from(const CNF& other)
+{
+    interToOuterMain = other.interToOuterMain;
+    outerToInterMain = other.outerToInterMain;
+    outer_to_with_bva_map = other.outer_to_with_bva_map;
+    assigns = other.assigns;
+    varData = other.varData;
+    minNumVars = other.minNumVars;
+    num_bva_vars = other.num_bva_vars;
+    ok = other.ok;
+
+    sumConflicts = other.sumConflicts;
+    sumDecisions = other.sumDecisions;
+    sumAntecedents = other.sumAntecedents;
+    sumPropagations = other.sumPropagations;
+    sumConflictClauseLits = other.sumConflictClauseLits;
+    sumAntecedentsLits = other.sumAntecedentsLits;
+    sumDecisionBasedCl = other.sumDecisionBasedCl;
+    sumClLBD = other.sumClLBD;
+    sumClSize = other.sumClSize;
+    binTri = other.binTri;
+    litStats = other.litStats;
+    clauseID = other.clauseID;
+    restartID = other.restartID;
+    polarity_mode = other.polarity_mode;
+    longest_trail_ever = other.longest_trail_ever;
+    cur_max_temp_red_lev2_cls = other.cur_max_temp_red_lev2_cls;
+
+    //The arena is copied as one block, offsets stay valid
+    cl_alloc.copy_from(other.cl_alloc);
+    longIrredCls = other.longIrredCls;
+    longRedCls = other.longRedCls;
+    assert(watches.size() >= other.watches.size());
+    for(size_t i = 0; i < other.watches.size(); i++) {
+        other.watches.watches[i].copyTo(watches.watches[i]);
+    }
+    xorclauses = other.xorclauses;
+    xorclauses_unused = other.xorclauses_unused;
+    removed_xorclauses_clash_vars = other.removed_xorclauses_clash_vars;
+    detached_xor_repr_cls = other.detached_xor_repr_cls;
+    detached_xor_clauses = other.detached_xor_clauses;
+
+    //Gauss-Jordan matrices are not copied, they are rebuilt from the XORs
+    xor_clauses_updated = true;
+}
+
 
 void CNF::test_all_clause_attached() const
 {
@@ -756,12 +923,24 @@ void CNF::add_drat(std::ostream* os, bool add_ID) {
     if (drat)
         delete drat;
 
-    if (add_ID) {
+    if (conf.frat_proof) {
+        drat = new FratFile(interToOuterMain, cl_alloc);
+    } else if (add_ID) {
         drat = new DratFile<true>(interToOuterMain);
     } else {
         drat = new DratFile<false>(interToOuterMain);
     }
     drat->setFile(os);
+    if (conf.drat_async_bufs > 0) {
+        drat->set_async(conf.drat_async_bufs);
+    }
+}
+
+void CNF::add_drat_checker() {
+    if (drat)
+        delete drat;
+
+    drat = new DratChecker(interToOuterMain, conf.drat_async_bufs);
 }
 
 vector<uint32_t> CNF::get_outside_var_incidence()
@@ -159,6 +159,7 @@ public:
     //drat
     Drat* drat;
     void add_drat(std::ostream* os, bool add_ID);
+    void add_drat_checker();
 
     //Clauses
     vector<ClOffset> longIrredCls;
@@ -347,6 +348,9 @@ protected:
 
     void save_state(SimpleOutFile& f) const;
     void load_state(SimpleInFile& f);
+    void save_checkpoint(SimpleOutFile& f) const;
+    void load_checkpoint(SimpleInFile& f);
+    void copy_checkpoint_from(const CNF& other);
     vector<uint32_t> outerToInterMain;
     vector<uint32_t> interToOuterMain;
 
@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include <set>
 #include <map>
+#include <array>
 #include <iomanip>
 #include <iostream>
 #include "compfinder.h"
@@ -48,7 +49,6 @@ using std::endl;
 
 CompFinder::CompFinder(Solver* _solver) :
     timedout(false)
-    , seen(_solver->seen)
     , solver(_solver)
 {
 }
@@ -106,8 +106,8 @@ void CompFinder::find_components()
     table.clear();
     table.resize(solver->nVars(), std::numeric_limits<uint32_t>::max());
     reverseTable.clear();
-    comp_no = 0;
-    used_comp_no = 0;
+    uf = UnionFind();
+    uf.resize(solver->nVars());
 
     solver->clauseCleaner->remove_and_clean_all();
 
@@ -119,9 +119,16 @@ void CompFinder::find_components()
     timedout = false;
     add_clauses_to_component(solver->longIrredCls);
     addToCompImplicits();
-    if (timedout) {
-        reverseTable.clear();
+    if (!timedout) {
+        //Vars not in any clause stay outside of all comps
+        for (uint32_t var = 0; var < solver->nVars(); var++) {
+            if (table[var] != std::numeric_limits<uint32_t>::max()) {
+                table[var] = uf.find(var);
+                reverseTable[table[var]].push_back(var);
+            }
+        }
     }
+    uf = UnionFind();
     print_and_add_to_sql_result(myTime);
 
     assert(solver->okay());
@@ -166,16 +173,14 @@ void CompFinder::add_clauses_to_component(const vector<ClOffset>& cs)
             timedout = true;
             break;
         }
-        bogoprops_remain -= 10;
         Clause* cl = solver->cl_alloc.ptr(offset);
+        bogoprops_remain -= (int64_t)cl->size() + 2;
         add_clause_to_component(*cl);
     }
 }
 
 void CompFinder::addToCompImplicits()
 {
-    vector<Lit> lits;
-
     for (size_t var = 0; var < solver->nVars(); var++) {
         if (bogoprops_remain <= 0) {
             timedout = true;
@@ -183,18 +188,15 @@ void CompFinder::addToCompImplicits()
         }
 
         bogoprops_remain -= 2;
-        Lit lit(var, false);
-        lits.clear();
-        lits.push_back(lit);
         for(int sign = 0; sign < 2; sign++) {
-            lit = Lit(var, sign);
+            const Lit lit = Lit(var, sign);
             watch_subarray ws = solver->watches[lit];
 
             //If empty, skip
             if (ws.empty())
                 continue;
 
-            bogoprops_remain -= (int64_t)ws.size() + 10;
+            bogoprops_remain -= (int64_t)ws.size();
             for(const Watched *it2 = ws.begin(), *end2 = ws.end()
                 ; it2 != end2
                 ; it2++
@@ -205,78 +207,11 @@ void CompFinder::addToCompImplicits()
                     //Only do each binary once
                     && lit < it2->lit2()
                 ) {
-                    if (!seen[it2->lit2().var()]) {
-                        lits.push_back(it2->lit2());
-                        seen[it2->lit2().var()] = 1;
-                    }
+                    const std::array<Lit, 2> bin = {{lit, it2->lit2()}};
+                    add_clause_to_component(bin);
                 }
             }
         }
-
-        if (lits.size() > 1) {
-            //Clear seen
-            for(vector<Lit>::const_iterator
-                it = lits.begin(), end = lits.end()
-                ; it != end
-                ; ++it
-            ) {
-                seen[it->var()] = 0;
-            }
-
-            add_clause_to_component(lits);
-        }
-
-    }
-}
-
-template<class T>
-bool CompFinder::belong_to_same_component(const T& cl)
-{
-    if (table[cl[0].var()] != std::numeric_limits<uint32_t>::max()) {
-        bogoprops_remain -= (int64_t)cl.size()/2 + 1;
-        const uint32_t comp = table[cl[0].var()];
-
-        for (const Lit l: cl) {
-            if (table[l.var()] != comp) {
-                return false;
-            }
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-template<class T>
-void CompFinder::fill_newset_and_tomerge(const T& cl)
-{
-    bogoprops_remain -= (int64_t)cl.size()*2;
-
-    for (const Lit lit: cl) {
-        if (table[lit.var()] != std::numeric_limits<uint32_t>::max()
-        ) {
-            if (!seen[table[lit.var()]]) {
-                tomerge.push_back(table[lit.var()]);
-                seen[table[lit.var()]] = 1;
-            }
-        } else {
-            newSet.push_back(lit.var());
-        }
-    }
-}
-
-void CompFinder::merge_newset_into_single_component()
-{
-    const uint32_t into = tomerge[0];
-    seen[into] = 0;
-    map<uint32_t, vector<uint32_t> >::iterator intoReverse
-        = reverseTable.find(into);
-
-    //Put the new lits into this set
-    for (const uint32_t v: newSet) {
-        intoReverse->second.push_back(v);
-        table[v] = into;
     }
 }
 
@@ -284,59 +219,10 @@ template<class T>
 void CompFinder::add_clause_to_component(const T& cl)
 {
     assert(cl.size() > 1);
-    tomerge.clear();
-    newSet.clear();
-
-    if (belong_to_same_component(cl)) {
-        return;
-    }
-
-    fill_newset_and_tomerge(cl);
-
-    //no sets to merge, only merge the clause into one tree
-    if (tomerge.size() == 1) {
-        merge_newset_into_single_component();
-        return;
-    }
-
-    //Expensive merging coming up
-    bogoprops_remain -= 20;
-
-    //Delete tables to merge and put their elements into newSet
-    for (const uint32_t merge: tomerge) {
-        //Clear seen
-        seen[merge] = 0;
-
-        //Find in reverseTable
-        bogoprops_remain -= (int64_t)reverseTable.size()*2;
-        map<uint32_t, vector<uint32_t> >::iterator it2 = reverseTable.find(merge);
-        assert(it2 != reverseTable.end());
-
-        //Add them all
-        bogoprops_remain -= (int64_t)it2->second.size();
-        newSet.insert(
-            newSet.end()
-            , it2->second.begin()
-            , it2->second.end()
-        );
-
-        //Delete this comp
-        bogoprops_remain -= (int64_t)reverseTable.size();
-        reverseTable.erase(it2);
-        used_comp_no--;
-    }
-
-    //No literals lie outside of already seen components
-    if (newSet.empty())
-        return;
-
-    //Mark all lits not belonging to seen components as belonging to comp_no
-    bogoprops_remain -= (int64_t)newSet.size();
-    for (const uint32_t v: newSet) {
-        table[v] = comp_no;
+    const uint32_t first = cl[0].var();
+    for (const Lit lit: cl) {
+        //Mark as part of a comp, the comp number is set at the end
+        table[lit.var()] = 0;
+        uf.unite(first, lit.var());
     }
-
-    reverseTable[comp_no] = newSet;
-    comp_no++;
-    used_comp_no++;
 }
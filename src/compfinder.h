@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "constants.h"
 #include "solvertypes.h"
 #include "cloffset.h"
+#include "unionfind.h"
 
 namespace CMSat {
 
@@ -56,46 +57,25 @@ class CompFinder {
         void add_clauses_to_component(const vector<ClOffset>& cs);
         template<class T>
         void add_clause_to_component(const T& cl);
-        template<class T>
-        bool belong_to_same_component(const T& cl);
-        template<class T>
-        void fill_newset_and_tomerge(const T& cl);
-        void merge_newset_into_single_component();
 
         void print_found_components() const;
         bool reverse_table_is_correct() const;
         void print_and_add_to_sql_result(const double myTime) const;
 
-        struct MySorter
-        {
-            bool operator () (
-                const pair<uint32_t, uint32_t>& left
-                , const pair<uint32_t, uint32_t>& right
-            ) {
-                return left.second < right.second;
-            }
-        };
-
-        //comp -> vars
+        //comp -> vars. The comp number is a var in it.
         map<uint32_t, vector<uint32_t> > reverseTable;
 
         //var -> comp
         vector<uint32_t> table;
 
-        //The comp counter
-        uint32_t comp_no;
-        uint32_t used_comp_no;
-
-        //Temporary
-        vector<uint32_t> newSet;
-        vector<uint32_t> tomerge;
+        //Vars in the same comp are in the same set
+        UnionFind uf;
 
         //Keep track of time
         long long bogoprops_remain;
         long long orig_bogoprops;
         bool timedout;
 
-        vector<uint16_t>& seen;
         Solver* solver;
 };
 
@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "comphandler.h"
 #include "compfinder.h"
+#include "comptracker.h"
 #include "varreplacer.h"
 #include "solver.h"
 #include "varupdatehelper.h"
@@ -31,6 +32,8 @@ THE SOFTWARE.
 #include <iostream>
 #include <cassert>
 #include <iomanip>
+#include <atomic>
+#include <thread>
 #include "cryptominisat5/cryptominisat.h"
 #include "sqlstats.h"
 
@@ -76,27 +79,14 @@ size_t CompHandler::mem_used() const
 {
     size_t mem = 0;
     mem += savedState.capacity()*sizeof(lbool);
-    mem += useless.capacity()*sizeof(uint32_t);
-    mem += smallsolver_to_bigsolver.capacity()*sizeof(uint32_t);
+    mem += var_to_comp.capacity()*sizeof(uint32_t);
     mem += bigsolver_to_smallsolver.capacity()*sizeof(uint32_t);
+    mem += cache.size()*sizeof(CachedComp);
+    mem += cache_lits*sizeof(Lit);
 
     return mem;
 }
 
-void CompHandler::createRenumbering(const vector<uint32_t>& vars)
-{
-    smallsolver_to_bigsolver.resize(vars.size());
-    bigsolver_to_smallsolver.resize(solver->nVars());
-
-    for(size_t i = 0, size = vars.size()
-        ; i < size
-        ; ++i
-    ) {
-        bigsolver_to_smallsolver[vars[i]] = i;
-        smallsolver_to_bigsolver[i] = vars[i];
-    }
-}
-
 bool CompHandler::assumpsInsideComponent(const vector<uint32_t>& vars)
 {
     for(uint32_t var: vars) {
@@ -135,7 +125,8 @@ bool CompHandler::handle()
 {
     assert(solver->conf.sampling_vars == NULL && "Cannot handle components when sampling vars is set");
     assert(solver->okay());
-    double myTime = cpuTime();
+    //Wall-clock time, the sub-solvers may run on other threads
+    double myTime = realTimeSec();
 
     delete compFinder;
     compFinder = new CompFinder(solver);
@@ -145,6 +136,7 @@ bool CompHandler::handle()
         compFinder = NULL;
         return solver->okay();
     }
+    solver->compTracker->set_from(*compFinder);
 
     const uint32_t num_comps = compFinder->getNumComps();
 
@@ -172,19 +164,50 @@ bool CompHandler::handle()
     assert(num_comps == compFinder->getReverseTable().size());
     vector<pair<uint32_t, uint32_t> > sizes = get_component_sizes();
 
-    size_t num_comps_solved = 0;
-    size_t vars_solved = 0;
+    //Take out all but the largest component
+    comps.clear();
+    var_to_comp.clear();
+    var_to_comp.resize(solver->nVars(), std::numeric_limits<uint32_t>::max());
+    bigsolver_to_smallsolver.resize(solver->nVars());
     for (uint32_t it = 0; it < sizes.size()-1; ++it) {
         const uint32_t comp = sizes[it].first;
         vector<uint32_t>& vars = reverseTable[comp];
-        const bool ok = try_to_solve_component(it, comp, vars, num_comps);
-        if (!ok) {
-            break;
+        if (!can_move_component(vars)) {
+            continue;
         }
-        num_comps_solved++;
-        vars_solved += vars.size();
+        move_component_vars(vars);
+    }
+    moveClausesImplicit();
+    moveClausesLong(solver->longIrredCls);
+    for(auto& lredcls: solver->longRedCls) {
+        removeRedClausesLong(lredcls);
+    }
+
+    size_t num_from_cache = 0;
+    for(Comp& comp: comps) {
+        canonicalize(comp);
+        num_from_cache += find_in_cache(comp);
     }
 
+    const uint32_t num_threads = std::max(1U, solver->conf.comp_threads);
+    vector<Job> jobs = create_jobs(num_threads);
+    if (solver->conf.verbosity >= 2 || (solver->conf.verbosity && num_threads > 1)) {
+        cout
+        << "c [comp] Solving " << comps.size() - num_from_cache
+        << " component(s) with " << jobs.size() << " sub-solver(s)"
+        << " on " << std::min<size_t>(num_threads, jobs.size()) << " thread(s)"
+        << ", " << num_from_cache << " cached"
+        << endl;
+    }
+    solve_jobs(jobs, num_threads);
+
+    size_t vars_solved = 0;
+    for(const Comp& comp: comps) {
+        vars_solved += comp.vars.size();
+    }
+    const size_t num_comps_solved = comps.size();
+    const bool solved = apply_results();
+    comps.clear();
     if (!solver->okay()) {
         delete compFinder;
         compFinder = NULL;
@@ -192,12 +215,13 @@ bool CompHandler::handle()
         return solver->okay();
     }
 
-    const double time_used = cpuTime() - myTime;
-    if (solver->conf.verbosity  >= 1) {
+    const double time_used = realTimeSec() - myTime;
+    if (solver->conf.verbosity  >= 1 && solved) {
         cout
         << "c [comp] Coming back to original instance, solved "
         << num_comps_solved << " component(s), "
-        << vars_solved << " vars"
+        << vars_solved << " vars, "
+        << num_from_cache << " from cache"
         << solver->conf.print_times(time_used)
         << endl;
     }
@@ -217,100 +241,300 @@ bool CompHandler::handle()
     return solver->okay();
 }
 
-bool CompHandler::try_to_solve_component(
-    const uint32_t comp_at
-    , const uint32_t comp
-    , const vector<uint32_t>& vars_orig
-    , const size_t num_comps
-) {
-    for(const uint32_t var: vars_orig) {
+bool CompHandler::can_move_component(const vector<uint32_t>& vars)
+{
+    for(const uint32_t var: vars) {
         assert(solver->value(var) == l_Undef);
     }
 
-    if (vars_orig.size() > 100ULL*1000ULL*
+    if (vars.size() > 100ULL*1000ULL*
             solver->conf.var_and_mem_out_mult
        ) {
         //There too many variables -- don't create a sub-solver
         //I'm afraid that we will memory-out
 
-        return true;
+        return false;
     }
 
     //Components with assumptions should not be removed
-    if (assumpsInsideComponent(vars_orig))
-        return true;
+    if (assumpsInsideComponent(vars))
+        return false;
 
-    return solve_component(comp_at, comp, vars_orig, num_comps);
+    return true;
 }
 
-bool CompHandler::solve_component(
-    const uint32_t comp_at
-    , const uint32_t comp
-    , const vector<uint32_t>& vars_orig
-    , const size_t num_comps
-) {
+/**
+@brief Makes the variables of the component non-decision in the solver
+
+Its clauses are moved out later, all components at once
+*/
+void CompHandler::move_component_vars(const vector<uint32_t>& vars)
+{
     assert(! (solver->drat->enabled() || solver->conf.simulate_drat) );
-    vector<uint32_t> vars(vars_orig);
     components_solved++;
+    comps.push_back(Comp());
+    Comp& comp = comps.back();
+    comp.vars = vars;
+    std::sort(comp.vars.begin(), comp.vars.end(),
+        [&](const uint32_t a, const uint32_t b) {
+            return solver->map_inter_to_outer(a) < solver->map_inter_to_outer(b);
+    });
+
+    for(uint32_t i = 0; i < comp.vars.size(); i++) {
+        const uint32_t var = comp.vars[i];
+        assert(solver->value(var) == l_Undef);
+        assert(solver->varData[var].removed == Removed::none);
+        solver->varData[var].removed = Removed::decomposed;
+        num_vars_removed++;
 
-    //Sort and renumber
-    std::sort(vars.begin(), vars.end());
-    createRenumbering(vars);
+        var_to_comp[var] = comps.size()-1;
+        bigsolver_to_smallsolver[var] = i;
+    }
+}
 
-    if (solver->conf.verbosity && num_comps < 20) {
-        cout
-        << "c [comp] Solving component " << comp_at
-        << " num vars: " << vars.size()
-        << " ======================================="
-        << endl;
+/**
+@brief Sorts the literals of each clause and the clauses, and hashes them
+
+Two components with the same clauses in local numbering get the same hash.
+The local numbering follows the outer numbering, so it does not change when
+the solver renumbers its variables.
+*/
+void CompHandler::canonicalize(Comp& comp)
+{
+    vector<pair<uint32_t, uint32_t> > cls; //start, size
+    uint32_t at = 0;
+    for(const uint32_t sz: comp.sizes) {
+        std::sort(comp.lits.begin() + at, comp.lits.begin() + at + sz);
+        cls.push_back(make_pair(at, sz));
+        at += sz;
+    }
+    const vector<Lit>& lits = comp.lits;
+    std::sort(cls.begin(), cls.end(),
+        [&](const pair<uint32_t, uint32_t>& a, const pair<uint32_t, uint32_t>& b) {
+            if (a.second != b.second) {
+                return a.second < b.second;
+            }
+            return std::lexicographical_compare(
+                lits.begin() + a.first, lits.begin() + a.first + a.second
+                , lits.begin() + b.first, lits.begin() + b.first + b.second);
+    });
+
+    vector<Lit> sorted_lits;
+    sorted_lits.reserve(lits.size());
+    uint64_t hash = 14695981039346656037ULL; //FNV-1a
+    const auto add = [&](const uint32_t x) {
+        hash = (hash ^ x) * 1099511628211ULL;
+    };
+    add(comp.vars.size());
+    for(uint32_t i = 0; i < cls.size(); i++) {
+        comp.sizes[i] = cls[i].second;
+        add(cls[i].second);
+        for(uint32_t i2 = cls[i].first; i2 < cls[i].first + cls[i].second; i2++) {
+            sorted_lits.push_back(lits[i2]);
+            add(lits[i2].toInt());
+        }
+    }
+    comp.lits.swap(sorted_lits);
+    comp.hash = hash;
+}
+
+bool CompHandler::find_in_cache(Comp& comp) const
+{
+    if (!solver->conf.comp_cache) {
+        return false;
     }
 
-    //Set up new solver
-    SolverConf conf = configureNewSolver(vars.size());
+    const auto range = cache.equal_range(comp.hash);
+    for(auto it = range.first; it != range.second; ++it) {
+        const CachedComp& c = it->second;
+        if (c.model.size() == comp.vars.size()
+            && c.sizes == comp.sizes
+            && c.lits == comp.lits
+        ) {
+            comp.status = l_True;
+            comp.model = c.model;
+            comp.zero_assigned = c.zero_assigned;
+            comp.from_cache = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CompHandler::add_to_cache(const Comp& comp)
+{
+    if (!solver->conf.comp_cache || comp.from_cache) {
+        return;
+    }
+
+    //Don't let it grow without bounds
+    if (cache_lits > 20ULL*1000ULL*1000ULL*solver->conf.var_and_mem_out_mult) {
+        cache.clear();
+        cache_lits = 0;
+    }
+
+    CachedComp c;
+    c.lits = comp.lits;
+    c.sizes = comp.sizes;
+    c.model = comp.model;
+    c.zero_assigned = comp.zero_assigned;
+    cache_lits += c.lits.size();
+    cache.insert(std::make_pair(comp.hash, std::move(c)));
+}
+
+/**
+@brief Groups the components that are not cached into sub-solvers
+
+Components below conf.comp_batch_vars variables are batched together, up to
+that many variables in a sub-solver
+*/
+vector<CompHandler::Job> CompHandler::create_jobs(const uint32_t num_threads)
+{
+    vector<Job> jobs;
+    int64_t batch = -1;
+    for(uint32_t i = 0; i < comps.size(); i++) {
+        const Comp& comp = comps[i];
+        if (comp.from_cache) {
+            continue;
+        }
+
+        const uint32_t nvars = comp.vars.size();
+        if (batch == -1
+            || nvars >= solver->conf.comp_batch_vars
+            || jobs[batch].num_vars + nvars > solver->conf.comp_batch_vars
+        ) {
+            jobs.push_back(Job());
+            if (nvars < solver->conf.comp_batch_vars) {
+                batch = jobs.size()-1;
+            }
+        }
+        Job& job = (nvars < solver->conf.comp_batch_vars) ? jobs[batch] : jobs.back();
+        job.comps.push_back(i);
+        job.num_vars += nvars;
+    }
+
+    for(Job& job: jobs) {
+        job.conf = configureNewSolver(job.num_vars);
+
+        //Their output would be interleaved
+        if (num_threads > 1) {
+            job.conf.verbosity = 0;
+        }
+    }
+
+    return jobs;
+}
+
+void CompHandler::solve_job(Job& job)
+{
     SATSolver newSolver(
-        (void*)&conf
+        (void*)&job.conf
         , solver->get_must_interrupt_inter_asap_ptr()
     );
-    moveVariablesBetweenSolvers(&newSolver, vars, comp);
+    newSolver.new_vars(job.num_vars);
 
-    //Move clauses over
-    moveClausesImplicit(&newSolver, comp, vars);
-    moveClausesLong(solver->longIrredCls, &newSolver, comp);
-    for(auto& lredcls: solver->longRedCls) {
-        moveClausesLong(lredcls, &newSolver, comp);
+    vector<uint32_t> offsets;
+    vector<Lit> tmp;
+    uint32_t offset = 0;
+    for(const uint32_t at: job.comps) {
+        const Comp& comp = comps[at];
+        offsets.push_back(offset);
+        size_t i = 0;
+        for(const uint32_t sz: comp.sizes) {
+            tmp.clear();
+            for(size_t i2 = i; i2 < i + sz; i2++) {
+                const Lit lit = comp.lits[i2];
+                tmp.push_back(Lit(lit.var() + offset, lit.sign()));
+            }
+            newSolver.add_clause(tmp);
+            i += sz;
+        }
+        offset += comp.vars.size();
     }
 
     const lbool status = newSolver.solve();
-    //Out of time
-    if (status == l_Undef) {
-        if (solver->conf.verbosity) {
-            cout
-            << "c [comp] subcomponent returned l_Undef -- timeout or interrupt."
-            << endl;
+    for(uint32_t i = 0; i < job.comps.size(); i++) {
+        Comp& comp = comps[job.comps[i]];
+        comp.status = status;
+        if (status == l_True) {
+            const vector<lbool>& model = newSolver.get_model();
+            comp.model.assign(
+                model.begin() + offsets[i]
+                , model.begin() + offsets[i] + comp.vars.size());
         }
-        readdRemovedClauses();
-        return false;
+    }
+    if (status != l_True) {
+        return;
     }
 
-    if (status == l_False) {
-        solver->ok = false;
-        if (solver->conf.verbosity) {
-            cout
-            << "c [comp] The component is UNSAT -> problem is UNSAT"
-            << endl;
+    for(const Lit lit: newSolver.get_zero_assigned_lits()) {
+        const uint32_t i = std::upper_bound(offsets.begin(), offsets.end(), lit.var())
+            - offsets.begin() - 1;
+        comps[job.comps[i]].zero_assigned.push_back(
+            Lit(lit.var() - offsets[i], lit.sign()));
+    }
+}
+
+void CompHandler::solve_jobs(vector<Job>& jobs, const uint32_t num_threads)
+{
+    std::atomic<size_t> next(0);
+    std::atomic<bool> found_unsat(false);
+    const auto work = [&]() {
+        size_t at;
+        while(!found_unsat && (at = next++) < jobs.size()) {
+            solve_job(jobs[at]);
+
+            //The problem is UNSAT, the rest need not be solved
+            if (comps[jobs[at].comps[0]].status == l_False) {
+                found_unsat = true;
+            }
         }
-        return false;
+    };
+
+    vector<std::thread> threads;
+    for(uint32_t i = 1; i < std::min<size_t>(num_threads, jobs.size()); i++) {
+        threads.push_back(std::thread(work));
     }
+    work();
+    for(std::thread& t: threads) {
+        t.join();
+    }
+}
 
-    check_solution_is_unassigned_in_main_solver(&newSolver, vars);
-    save_solution_to_savedstate(&newSolver, vars, comp);
-    move_decision_level_zero_vars_here(&newSolver);
+bool CompHandler::apply_results()
+{
+    for(const Comp& comp: comps) {
+        if (comp.status == l_False) {
+            solver->ok = false;
+            if (solver->conf.verbosity) {
+                cout
+                << "c [comp] The component is UNSAT -> problem is UNSAT"
+                << endl;
+            }
+            return false;
+        }
+    }
 
-    if (solver->conf.verbosity && num_comps < 20) {
-        cout
-        << "c [comp] component " << comp_at
-        << " ======================================="
-        << endl;
+    for(const Comp& comp: comps) {
+        //Out of time
+        if (comp.status == l_Undef) {
+            if (solver->conf.verbosity) {
+                cout
+                << "c [comp] subcomponent returned l_Undef -- timeout or interrupt."
+                << endl;
+            }
+            readdRemovedClauses();
+            return false;
+        }
+    }
+
+    for(const Comp& comp: comps) {
+        check_solution_is_unassigned_in_main_solver(comp);
+        save_solution_to_savedstate(comp);
+        move_decision_level_zero_vars_here(comp);
+        add_to_cache(comp);
+        components_cached += comp.from_cache;
     }
     return true;
 }
@@ -337,43 +561,37 @@ void CompHandler::check_local_vardata_sanity()
 }
 
 void CompHandler::check_solution_is_unassigned_in_main_solver(
-    const SATSolver* newSolver
-    , const vector<uint32_t>& vars
+    const Comp& comp
 ) {
-    for (size_t i = 0; i < vars.size(); ++i) {
-        uint32_t var = vars[i];
-        if (newSolver->get_model()[upd_bigsolver_to_smallsolver(var)] != l_Undef) {
-            assert(solver->value(var) == l_Undef);
+    for (size_t i = 0; i < comp.vars.size(); ++i) {
+        if (comp.model[i] != l_Undef) {
+            assert(solver->value(comp.vars[i]) == l_Undef);
         }
     }
 }
 
 void CompHandler::save_solution_to_savedstate(
-    const SATSolver* newSolver
-    , const vector<uint32_t>& vars
-    , const uint32_t comp
+    const Comp& comp
 ) {
     assert(savedState.size() == solver->nVarsOuter());
-    for (size_t i = 0; i < vars.size(); ++i) {
-        uint32_t var = vars[i];
+    for (size_t i = 0; i < comp.vars.size(); ++i) {
+        uint32_t var = comp.vars[i];
         uint32_t outerVar = solver->map_inter_to_outer(var);
-        if (newSolver->get_model()[upd_bigsolver_to_smallsolver(var)] != l_Undef) {
+        if (comp.model[i] != l_Undef) {
             assert(savedState[outerVar] == l_Undef);
-            assert(compFinder->getVarComp(var) == comp);
+            assert(var_to_comp[var] == (uint32_t)(&comp - comps.data()));
 
-            savedState[outerVar] = newSolver->get_model()[upd_bigsolver_to_smallsolver(var)];
+            savedState[outerVar] = comp.model[i];
         }
     }
 }
 
 void CompHandler::move_decision_level_zero_vars_here(
-    const SATSolver* newSolver
+    const Comp& comp
 ) {
-    const vector<Lit> zero_assigned = newSolver->get_zero_assigned_lits();
-    for (Lit lit: zero_assigned) {
-        assert(lit.var() < newSolver->nVars());
-        assert(lit.var() < smallsolver_to_bigsolver.size());
-        lit = Lit(smallsolver_to_bigsolver[lit.var()], lit.sign());
+    for (Lit lit: comp.zero_assigned) {
+        assert(lit.var() < comp.vars.size());
+        lit = Lit(comp.vars[lit.var()], lit.sign());
         assert(solver->value(lit) == l_Undef);
 
         assert(solver->varData[lit.var()].removed == Removed::decomposed);
@@ -414,113 +632,90 @@ SolverConf CompHandler::configureNewSolver(
     //Don't recurse
     conf.doCompHandler = false;
 
-    return conf;
-}
-
-/**
-@brief Moves the variables to the new solver
-
-This implies making the right variables decision in the new solver,
-and making it non-decision in the old solver.
-*/
-void CompHandler::moveVariablesBetweenSolvers(
-    SATSolver* newSolver
-    , const vector<uint32_t>& vars
-    , const uint32_t comp
-) {
-    for(const uint32_t var: vars) {
-        newSolver->new_var();
-        assert(compFinder->getVarComp(var) == comp);
-        assert(solver->value(var) == l_Undef);
+    //These belong to the main solver
+    conf.checkpoint_file.clear();
+    conf.metrics_listen.clear();
+    conf.metrics_file.clear();
+    conf.net_sync.clear();
 
-        assert(solver->varData[var].removed == Removed::none);
-        solver->varData[var].removed = Removed::decomposed;
-        num_vars_removed++;
-    }
+    return conf;
 }
 
 void CompHandler::moveClausesLong(
     vector<ClOffset>& cs
-    , SATSolver* newSolver
-    , const uint32_t comp
 ) {
-    vector<Lit> tmp;
-
     vector<ClOffset>::iterator i, j, end;
     for (i = j = cs.begin(), end = cs.end()
         ; i != end
         ; ++i
     ) {
         Clause& cl = *solver->cl_alloc.ptr(*i);
+        assert(!cl.red());
+        const uint32_t comp = var_to_comp[cl[0].var()];
 
-        //Irred, different comp
-        if (!cl.red()) {
-            if (compFinder->getVarComp(cl[0].var()) != comp) {
-                //different comp, move along
-                *j++ = *i;
-                continue;
-            }
+        //Not in a moved comp
+        if (comp == std::numeric_limits<uint32_t>::max()) {
+            //different comp, move along
+            *j++ = *i;
+            continue;
         }
 
-        if (cl.red()) {
-            //Check which comp(s) it belongs to
-            bool thisComp = false;
-            bool otherComp = false;
-            for (Lit* l = cl.begin(), *end2 = cl.end(); l != end2; ++l) {
-                if (compFinder->getVarComp(l->var()) == comp)
-                    thisComp = true;
+        //Let's move it to the component!
+        #ifdef VERBOSE_DEBUG
+        cout << "clause in comp " << comp << ":" << cl << endl;
+        #endif
+        saveClause(cl);
+        Comp& c = comps[comp];
+        for (const Lit lit: cl) {
+            assert(var_to_comp[lit.var()] == comp);
+            c.lits.push_back(upd_bigsolver_to_smallsolver(lit));
+        }
+        c.sizes.push_back(cl.size());
 
-                if (compFinder->getVarComp(l->var()) != comp)
-                    otherComp = true;
-            }
+        //Remove from here
+        solver->detachClause(cl);
+        solver->free_cl(&cl);
+    }
+    cs.resize(cs.size() - (i-j));
+}
 
-            //In both comps, remove it
-            if (thisComp && otherComp) {
-                solver->detachClause(cl);
-                solver->free_cl(&cl);
-                continue;
-            }
+//Redundant clauses are not moved, so they never make it into a Comp and its
+//cache key. Remove them if they touch a moved comp, even if they also touch
+//others
+void CompHandler::removeRedClausesLong(
+    vector<ClOffset>& cs
+) {
+    vector<ClOffset>::iterator i, j, end;
+    for (i = j = cs.begin(), end = cs.end()
+        ; i != end
+        ; ++i
+    ) {
+        Clause& cl = *solver->cl_alloc.ptr(*i);
+        assert(cl.red());
 
-            //In one comp, but not this one
-            if (!thisComp) {
-                //different comp, move along
-                *j++ = *i;
-                continue;
+        bool moved = false;
+        for (const Lit l: cl) {
+            if (var_to_comp[l.var()] != std::numeric_limits<uint32_t>::max()) {
+                moved = true;
+                break;
             }
-            assert(thisComp && !otherComp);
         }
 
-        //Let's move it to the other solver!
-        #ifdef VERBOSE_DEBUG
-        cout << "clause in this comp:" << cl << endl;
-        #endif
-
-        //Create temporary space 'tmp' and copy to backup
-        tmp.resize(cl.size());
-        for (size_t i2 = 0; i2 < cl.size(); ++i2) {
-            tmp[i2] = upd_bigsolver_to_smallsolver(cl[i2]);
-        }
-
-        //Add 'tmp' to the new solver
-        if (cl.red()) {
-            #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
-            cl.stats.introduced_at_conflict = 0;
-            #endif
-            //newSolver->addRedClause(tmp, cl.stats);
-        } else {
-            saveClause(cl);
-            newSolver->add_clause(tmp);
+        if (!moved) {
+            *j++ = *i;
+            continue;
         }
 
-        //Remove from here
         solver->detachClause(cl);
         solver->free_cl(&cl);
     }
     cs.resize(cs.size() - (i-j));
 }
 
-void CompHandler::remove_bin_except_for_lit1(const Lit lit, const Lit lit2)
-{
+void CompHandler::remove_bin_except_for_lit1(
+    const Lit lit
+    , const Lit lit2
+) {
     removeWBin(solver->watches, lit2, lit, true);
 
     //Update stats
@@ -528,31 +723,21 @@ void CompHandler::remove_bin_except_for_lit1(const Lit lit, const Lit lit2)
 }
 
 void CompHandler::move_binary_clause(
-    SATSolver* newSolver
-    , const uint32_t comp
-    ,  Watched *i
+    Watched *i
     , const Lit lit
 ) {
     const Lit lit2 = i->lit2();
+    const uint32_t comp = var_to_comp[lit.var()];
 
     //Unless redundant, cannot be in 2 comps at once
-    assert((compFinder->getVarComp(lit.var()) == comp
-                && compFinder->getVarComp(lit2.var()) == comp
-           ) || i->red()
-    );
+    assert(var_to_comp[lit2.var()] == comp || i->red());
 
     //If it's redundant and the lits are in different comps, remove it.
-    if (compFinder->getVarComp(lit.var()) != comp
-        || compFinder->getVarComp(lit2.var()) != comp
-    ) {
+    if (var_to_comp[lit2.var()] != comp) {
         //Can only be redundant, otherwise it would be in the same
         //component
         assert(i->red());
 
-        //The way we go through this, it's definitely going to be
-        //lit2 that's in the other component
-        assert(compFinder->getVarComp(lit2.var()) != comp);
-
         remove_bin_except_for_lit1(lit, lit2);
         return;
     }
@@ -560,20 +745,17 @@ void CompHandler::move_binary_clause(
     //don't add the same clause twice
     if (lit < lit2) {
 
-        //Add clause
-        tmp_lits = {upd_bigsolver_to_smallsolver(lit), upd_bigsolver_to_smallsolver(lit2)};
-        assert(compFinder->getVarComp(lit.var()) == comp);
-        assert(compFinder->getVarComp(lit2.var()) == comp);
-
         //Add new clause
         if (i->red()) {
-            //newSolver->addRedClause(tmp_lits);
             numRemovedHalfRed++;
         } else {
             //Save backup
             saveClause(vector<Lit>{lit, lit2});
 
-            newSolver->add_clause(tmp_lits);
+            Comp& c = comps[comp];
+            c.lits.push_back(upd_bigsolver_to_smallsolver(lit));
+            c.lits.push_back(upd_bigsolver_to_smallsolver(lit2));
+            c.sizes.push_back(2);
             numRemovedHalfIrred++;
         }
     } else {
@@ -587,15 +769,13 @@ void CompHandler::move_binary_clause(
     }
 }
 
-void CompHandler::moveClausesImplicit(
-    SATSolver* newSolver
-    , const uint32_t comp
-    , const vector<uint32_t>& vars
-) {
+void CompHandler::moveClausesImplicit()
+{
     numRemovedHalfIrred = 0;
     numRemovedHalfRed = 0;
 
-    for(const uint32_t var: vars) {
+    for(const Comp& comp: comps) {
+    for(const uint32_t var: comp.vars) {
     for(unsigned sign = 0; sign < 2; ++sign) {
         const Lit lit = Lit(var, sign);
         watch_subarray ws = solver->watches[lit];
@@ -611,19 +791,15 @@ void CompHandler::moveClausesImplicit(
             ; i != end2
             ; ++i
         ) {
-            //At least one variable inside comp
-            if (i->isBin()
-                && (compFinder->getVarComp(lit.var()) == comp
-                    || compFinder->getVarComp(i->lit2().var()) == comp
-                )
-            ) {
-                move_binary_clause(newSolver, comp, i, lit);
+            //The variable is inside a moved comp
+            if (i->isBin()) {
+                move_binary_clause(i, lit);
                 continue;
             }
             *j++ = *i;
         }
         ws.shrink_(i-j);
-    }}
+    }}}
 
     assert(numRemovedHalfIrred % 2 == 0);
     solver->binTri.irredBins -= numRemovedHalfIrred/2;
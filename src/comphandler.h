@@ -24,9 +24,11 @@ THE SOFTWARE.
 #define PARTHANDLER_H
 
 #include "solvertypes.h"
+#include "solverconf.h"
 #include "cloffset.h"
 #include <map>
 #include <vector>
+#include <unordered_map>
 
 namespace CMSat {
 
@@ -46,6 +48,10 @@ Uses CompFinder to find disconnected components and treats them using
 subsolvers. The solutions (if SAT) are aggregated, and at then end, the
 solution is extended with the sub-solutions, and the removed clauses are
 added back to the problem.
+
+Sub-solvers run on conf.comp_threads threads, small components are batched
+into one sub-solver, and the solutions are cached by the components' clauses,
+so that unchanged components are not solved again by later calls.
 */
 class CompHandler
 {
@@ -69,6 +75,7 @@ class CompHandler
         uint32_t dump_removed_clauses(std::ostream* outfile) const;
         size_t get_num_vars_removed() const;
         size_t get_num_components_solved() const;
+        size_t get_num_components_cached() const;
         size_t mem_used() const;
 
     private:
@@ -80,61 +87,61 @@ class CompHandler
                 return left.second < right.second;
             }
         };
+
+        ///A component moved out of the solver. Its clauses are irredundant,
+        ///numbered by the index of the var in 'vars', and in canonical order
+        struct Comp {
+            vector<uint32_t> vars; ///<Inter vars, by increasing outer number
+            vector<Lit> lits;
+            vector<uint32_t> sizes;
+            uint64_t hash = 0;
+
+            lbool status = l_Undef;
+            vector<lbool> model;
+            vector<Lit> zero_assigned;
+            bool from_cache = false;
+        };
+
+        ///Components solved together by one sub-solver
+        struct Job {
+            vector<uint32_t> comps; ///<Indices into 'comps'
+            uint32_t num_vars = 0;
+            SolverConf conf;
+        };
+
+        struct CachedComp {
+            vector<Lit> lits;
+            vector<uint32_t> sizes;
+            vector<lbool> model;
+            vector<Lit> zero_assigned;
+        };
+
         bool assumpsInsideComponent(const vector<uint32_t>& vars);
-        void move_decision_level_zero_vars_here(
-            const SATSolver* newSolver
-        );
-        void save_solution_to_savedstate(
-            const SATSolver* newSolver
-            , const vector<uint32_t>& vars
-            , const uint32_t comp
-        );
-        void check_solution_is_unassigned_in_main_solver(
-            const SATSolver* newSolver
-            , const vector<uint32_t>& vars
-        );
-        void check_local_vardata_sanity();
-        bool try_to_solve_component(
-            const uint32_t comp_at
-            , const uint32_t comp
-            , const vector<uint32_t>& vars
-            , const size_t num_comps
-        );
-        bool solve_component(
-            const uint32_t comp_at
-            , const uint32_t comp
-            , const vector<uint32_t>& vars_orig
-            , const size_t num_comps
-        );
         vector<pair<uint32_t, uint32_t> > get_component_sizes() const;
+        bool can_move_component(const vector<uint32_t>& vars);
+        void move_component_vars(const vector<uint32_t>& vars);
+        void canonicalize(Comp& comp);
+        bool find_in_cache(Comp& comp) const;
+        void add_to_cache(const Comp& comp);
+        vector<Job> create_jobs(const uint32_t num_threads);
+        void solve_job(Job& job);
+        void solve_jobs(vector<Job>& jobs, const uint32_t num_threads);
+        bool apply_results();
+
+        void move_decision_level_zero_vars_here(const Comp& comp);
+        void save_solution_to_savedstate(const Comp& comp);
+        void check_solution_is_unassigned_in_main_solver(const Comp& comp);
+        void check_local_vardata_sanity();
 
         SolverConf configureNewSolver(
             const size_t numVars
         ) const;
 
-        void moveVariablesBetweenSolvers(
-            SATSolver* newSolver
-            , const vector<uint32_t>& vars
-            , const uint32_t comp
-        );
-
         //For moving clauses
-        void moveClausesImplicit(
-            SATSolver* newSolver
-            , const uint32_t comp
-            , const vector<uint32_t>& vars
-        );
-        void moveClausesLong(
-            vector<ClOffset>& cs
-            , SATSolver* newSolver
-            , const uint32_t comp
-        );
-        void move_binary_clause(
-            SATSolver* newSolver
-            , const uint32_t comp
-            ,  Watched *i
-            , const Lit lit
-        );
+        void moveClausesImplicit();
+        void moveClausesLong(vector<ClOffset>& cs);
+        void removeRedClausesLong(vector<ClOffset>& cs);
+        void move_binary_clause(Watched *i, const Lit lit);
         void remove_bin_except_for_lit1(const Lit lit, const Lit lit2);
 
         Solver* solver;
@@ -143,10 +150,13 @@ class CompHandler
         ///The solutions that have been found by the comps
         vector<lbool> savedState;
 
+        ///The components being moved out by handle()
+        vector<Comp> comps;
+
+        ///Inter var -> index in 'comps', or max if not moved
+        vector<uint32_t> var_to_comp;
+
         //Re-numbering
-        void createRenumbering(const vector<uint32_t>& vars);
-        vector<uint32_t> useless; //temporary
-        vector<uint32_t> smallsolver_to_bigsolver;
         vector<uint32_t> bigsolver_to_smallsolver;
 
         Lit upd_bigsolver_to_smallsolver(const Lit lit) const
@@ -159,20 +169,20 @@ class CompHandler
             return bigsolver_to_smallsolver[var];
         }
 
+        //Solutions of earlier components, by the hash of their clauses
+        std::unordered_multimap<uint64_t, CachedComp> cache;
+        size_t cache_lits = 0;
+
         //Saving clauses
         template<class T>
         void saveClause(const T& lits);
         RemovedClauses removedClauses;
         size_t num_vars_removed = 0;
         size_t components_solved = 0;
-
-        //Clauses that have been moved to other comps
-        //vector<ClOffset> clausesRemoved;
-        //vector<pair<Lit, Lit> > binClausesRemoved;
+        size_t components_cached = 0;
 
         uint32_t numRemovedHalfIrred = 0;
         uint32_t numRemovedHalfRed = 0;
-        vector<Lit> tmp_lits;
 };
 
 /**
@@ -198,6 +208,11 @@ inline size_t CompHandler::get_num_components_solved() const
     return components_solved;
 }
 
+inline size_t CompHandler::get_num_components_cached() const
+{
+    return components_cached;
+}
+
 } //end of namespace
 
 #endif //PARTHANDLER_H
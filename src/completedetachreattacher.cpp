@@ -171,6 +171,8 @@ bool CompleteDetachReatacher::clean_clause(Clause* cl)
         << endl;
     }
     assert(ps.size() > 2);
+    const bool hints = solver->drat->hints_needed();
+    frat_hints.clear();
 
     Lit *i = ps.begin();
     Lit *j = i;
@@ -181,12 +183,18 @@ bool CompleteDetachReatacher::clean_clause(Clause* cl)
         }
         if (solver->value(*i) == l_Undef) {
             *j++ = *i;
+        } else if (hints) {
+            frat_hints.push_back(solver->drat->unit_ID(~*i));
         }
     }
     ps.shrink(i-j);
 
     //Drat
     if (i != j) {
+        if (hints) {
+            frat_hints.push_back(solver->drat->ID_of(ps));
+            solver->drat->set_hints(frat_hints);
+        }
         (*solver->drat) << add << *cl
         #ifdef STATS_NEEDED
         << solver->sumConflicts
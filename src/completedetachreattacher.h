@@ -76,6 +76,7 @@ class CompleteDetachReatacher
                 uint64_t irredBins;
         };
         ClausesStay clearWatchNotBinNotTri(watch_subarray ws);
+        vector<uint32_t> frat_hints;
 
         Solver* solver;
 };
@@ -0,0 +1,255 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "comptracker.h"
+#include "solver.h"
+#include "occsimplifier.h"
+#include "varreplacer.h"
+#include "comphandler.h"
+#include "compfinder.h"
+#include "time_mem.h"
+
+#include <iostream>
+#include <iomanip>
+#include <array>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+CompTracker::CompTracker(Solver* _solver) :
+    solver(_solver)
+{
+}
+
+void CompTracker::new_var()
+{
+    uf.resize(uf.size()+1);
+}
+
+void CompTracker::new_vars(const size_t n)
+{
+    uf.resize(uf.size()+n);
+}
+
+size_t CompTracker::mem_used() const
+{
+    return uf.mem_used() + tmp.capacity()*sizeof(Lit);
+}
+
+bool CompTracker::is_fixed(const Lit outer_lit) const
+{
+    const uint32_t inter = solver->map_outer_to_inter(outer_lit.var());
+    return solver->value(inter) != l_Undef
+        && solver->varData[inter].level == 0;
+}
+
+bool CompTracker::is_satisfied(const Lit outer_lit) const
+{
+    return is_fixed(outer_lit)
+        && solver->value(solver->map_outer_to_inter(outer_lit)) == l_True;
+}
+
+template<class T>
+void CompTracker::add_clause_int(const T& lits, const bool outer, const bool is_xor)
+{
+    tmp.clear();
+    for(Lit lit: lits) {
+        if (!outer) {
+            lit = solver->map_inter_to_outer(lit);
+        }
+        if (!is_xor && is_satisfied(lit)) {
+            return;
+        }
+        if (!is_fixed(lit)) {
+            tmp.push_back(lit);
+        }
+    }
+
+    for(const Lit lit: tmp) {
+        uf.unite(tmp[0].var(), lit.var());
+    }
+}
+
+//Until the first rebuild, there is nothing to merge into
+void CompTracker::add_clause(const vector<Lit>& outer_lits, const bool is_xor)
+{
+    if (rebuilt) {
+        add_clause_int(outer_lits, true, is_xor);
+    }
+}
+
+void CompTracker::attached_clause(const Clause& cl)
+{
+    if (rebuilt) {
+        add_clause_int(cl, false, false);
+    }
+}
+
+void CompTracker::attached_bin(const Lit lit1, const Lit lit2)
+{
+    if (rebuilt) {
+        add_clause_int(std::array<Lit, 2>{{lit1, lit2}}, false, false);
+    }
+}
+
+uint64_t CompTracker::irred_size() const
+{
+    return solver->litStats.irredLits + 2*solver->binTri.irredBins;
+}
+
+//The sets are never wrong, only too large once the solver has removed what
+//connected them. Rebuild when 1/16th of the vars have been set or a quarter
+//of the irredundant clauses have gone since the last rebuild
+bool CompTracker::too_coarse()
+{
+    if (!rebuilt) {
+        return true;
+    }
+    max_irred_size = std::max(max_irred_size, irred_size());
+    return (solver->getTrailSize() - num_units)*16 > solver->nVarsOuter()
+        || irred_size()*4 < max_irred_size*3;
+}
+
+void CompTracker::set_rebuilt()
+{
+    rebuilt = true;
+    num_units = solver->getTrailSize();
+    max_irred_size = irred_size();
+    num_rebuilds++;
+}
+
+void CompTracker::rebuild()
+{
+    const double myTime = cpuTime();
+    assert(uf.size() == solver->nVarsOuter());
+    uf.reset();
+
+    for(const ClOffset offs: solver->longIrredCls) {
+        add_clause_int(*solver->cl_alloc.ptr(offs), false, false);
+    }
+    for(uint32_t i = 0; i < solver->nVars()*2; i++) {
+        const Lit lit = Lit::toLit(i);
+        for(const Watched& w: solver->watches[lit]) {
+            if (w.isBin() && !w.red() && lit < w.lit2()) {
+                add_clause_int(std::array<Lit, 2>{{lit, w.lit2()}}, false, false);
+            }
+        }
+    }
+    add_not_attached();
+    set_rebuilt();
+
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [comp-track] rebuilt"
+        << solver->conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
+//CompFinder has gone through the attached irredundant clauses, with the units
+//already removed
+void CompTracker::set_from(const CompFinder& finder)
+{
+    assert(!finder.getTimedOut());
+    assert(uf.size() == solver->nVarsOuter());
+    uf.reset();
+    for(const auto& comp: finder.getReverseTable()) {
+        const uint32_t first = solver->map_inter_to_outer(comp.second[0]);
+        for(const uint32_t var: comp.second) {
+            uf.unite(first, solver->map_inter_to_outer(var));
+        }
+    }
+    add_not_attached();
+    set_rebuilt();
+}
+
+//Whatever connects vars but is not among the attached clauses
+void CompTracker::add_not_attached()
+{
+    //Their clauses may have been detached
+    for(const auto* xors: {&solver->xorclauses, &solver->xorclauses_unused}) {
+        for(const Xor& x: *xors) {
+            vector<Lit> lits;
+            for(const uint32_t v: x) {
+                lits.push_back(Lit(v, false));
+            }
+            add_clause_int(lits, false, true);
+        }
+    }
+
+    //Clauses removed by elimination
+    if (solver->occsimplifier) {
+        vector<Lit> cl;
+        solver->occsimplifier->for_each_blocked_clause_group(
+            [&](const Lit* lits, const uint64_t size) {
+                cl.clear();
+                for(uint64_t i = 1; i < size; i++) {
+                    if (lits[i] == lit_Undef) {
+                        add_clause_int(cl, true, false);
+                        cl.clear();
+                    } else {
+                        cl.push_back(lits[i]);
+                    }
+                }
+        });
+    }
+
+    //Clauses moved to the component handler
+    if (solver->compHandler) {
+        const CompHandler::RemovedClauses& removed =
+            solver->compHandler->getRemovedClauses();
+        vector<Lit> cl;
+        size_t at = 0;
+        for(const uint32_t sz: removed.sizes) {
+            cl.assign(removed.lits.begin() + at, removed.lits.begin() + at + sz);
+            add_clause_int(cl, true, false);
+            at += sz;
+        }
+    }
+
+    //Replaced vars are in the comp of their replacement
+    for(uint32_t outer = 0; outer < solver->nVarsOuter(); outer++) {
+        const uint32_t repl = solver->varReplacer->get_var_replaced_with_outer(outer);
+        if (repl != outer) {
+            uf.unite(outer, repl);
+        }
+    }
+}
+
+vector<uint32_t> CompTracker::get_outer_comps()
+{
+    if (too_coarse()) {
+        rebuild();
+    }
+
+    vector<uint32_t> comps(solver->nVarsOuter());
+    for(uint32_t outer = 0; outer < solver->nVarsOuter(); outer++) {
+        if (is_fixed(Lit(outer, false))) {
+            comps[outer] = var_Undef;
+        } else {
+            comps[outer] = uf.find(outer);
+        }
+    }
+
+    return comps;
+}
@@ -0,0 +1,102 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef COMPTRACKER_H
+#define COMPTRACKER_H
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+#include "unionfind.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+class CompFinder;
+class Clause;
+
+/**
+@brief Keeps the connected components of the problem up to date, over outer vars
+
+Every irredundant clause is merged in when it is attached, and clauses and
+XORs from the outside when they are added, at one union per literal. What the
+solver derives never connects two components, so the sets are always correct
+in that vars in different sets share no clause.
+
+Units, subsumption and strengthening can split a component, which a
+union-find cannot follow. The sets then stay merged, until CompHandler finds
+the exact components anyway, or until enough of the problem has gone
+for a rebuild from all clauses (including eliminated, decomposed and replaced
+ones) in one linear pass to be worth it.
+*/
+class CompTracker
+{
+    public:
+        explicit CompTracker(Solver* solver);
+        void new_var();
+        void new_vars(const size_t n);
+        void add_clause(const vector<Lit>& outer_lits, const bool is_xor = false);
+        void attached_clause(const Clause& cl);
+        void attached_bin(const Lit lit1, const Lit lit2);
+
+        ///Takes over the exact components it has found, instead of a rebuild
+        void set_from(const CompFinder& finder);
+
+        ///For each outer var, a var of its component, or var_Undef if the
+        ///var is set at level 0
+        vector<uint32_t> get_outer_comps();
+        size_t get_num_rebuilds() const;
+        size_t mem_used() const;
+
+    private:
+        bool too_coarse();
+        void rebuild();
+        void add_not_attached();
+        void set_rebuilt();
+        uint64_t irred_size() const;
+        bool is_fixed(const Lit outer_lit) const;
+        bool is_satisfied(const Lit outer_lit) const;
+        template<class T>
+        void add_clause_int(const T& lits, const bool outer, const bool is_xor);
+
+        Solver* solver;
+        UnionFind uf;
+        vector<Lit> tmp;
+
+        //Since the last rebuild
+        bool rebuilt = false;
+        size_t num_units = 0;
+        uint64_t max_irred_size = 0;
+        size_t num_rebuilds = 0;
+};
+
+inline size_t CompTracker::get_num_rebuilds() const
+{
+    return num_rebuilds;
+}
+
+} //end namespace
+
+#endif //COMPTRACKER_H
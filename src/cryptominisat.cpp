@@ -25,6 +25,8 @@ THE SOFTWARE.
 #include "solver.h"
 #include "drat.h"
 #include "shareddata.h"
+#include "datasync.h"
+#include "metrics.h"
 #include <fstream>
 
 #include <thread>
@@ -56,6 +58,8 @@ namespace CMSat {
         }
         ~CMSatPrivateData()
         {
+            //Reads the metrics of the solvers, so it must go first
+            delete metrics;
             for(Solver* this_s: solvers) {
                 delete this_s;
             }
@@ -77,6 +81,7 @@ namespace CMSat {
         bool okay = true;
         std::ofstream* log = NULL;
         int sql = 0;
+        MetricsExporter* metrics = NULL;
         double timeout = std::numeric_limits<double>::max();
         bool interrupted = false;
 
@@ -89,6 +94,12 @@ namespace CMSat {
         uint32_t num_solve_simplify_calls = 0;
         bool promised_single_call = false;
 
+        //DRAT, also set up for solvers added later
+        std::ostream* drat_os = NULL;
+        bool drat_add_ID = false;
+        bool drat_check = false;
+        bool drat_set = false;
+
         //stats
         uint64_t previous_sum_conflicts = 0;
         uint64_t previous_sum_propagations = 0;
@@ -142,6 +153,13 @@ DLL_PUBLIC SATSolver::SATSolver(
 
     data->solvers.push_back(new Solver((SolverConf*) config, data->must_interrupt));
     data->cpu_times.push_back(0.0);
+
+    //Sharing with other processes goes through the same data as sharing
+    //between threads, so it's needed even with a single thread
+    if (data->solvers[0]->datasync->net_enabled()) {
+        data->shared_data = new SharedData(1);
+        data->solvers[0]->set_shared_data(data->shared_data);
+    }
 }
 
 DLL_PUBLIC SATSolver::~SATSolver()
@@ -366,6 +384,52 @@ void update_config(SolverConf& conf, unsigned thread_num)
     }
 }
 
+static void setup_drat(Solver* s, const CMSatPrivateData* data)
+{
+    if (!s->conf.net_sync.empty() || s->datasync->ext_import_enabled()) {
+        const char err[] = "ERROR: Clauses received from other processes cannot be put into a proof";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    if (s->external_propagator_connected()) {
+        const char err[] = "ERROR: Clauses of an external propagator cannot be put into a proof";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    s->conf.gaussconf.doMatrixFind = false;
+    s->conf.doBreakid = false;
+    if (data->drat_check) {
+        s->add_drat_checker();
+    } else {
+        s->add_drat(data->drat_os, data->drat_add_ID);
+    }
+    s->conf.do_hyperbin_and_transred = true;
+    s->conf.doFindXors = false;
+    s->conf.doCompHandler = false;
+}
+
+//All threads write into the same DRAT file. Clauses are exported only
+//after they have been written, so the proof stays in order. BVA is off,
+//because the threads would introduce the same new variables differently.
+static void share_drat_file(CMSatPrivateData* data)
+{
+    assert(data->shared_data != NULL);
+    if (data->solvers[0]->conf.frat_proof) {
+        const char err[] = "ERROR: FRAT proofs can only be written in single-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    if (data->drat_check) {
+        const char err[] = "ERROR: The proof can only be checked while solving in single-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    for(Solver* s: data->solvers) {
+        s->conf.do_bva = false;
+        s->drat->set_shared(&data->shared_data->drat_mutex);
+    }
+}
+
 DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
 {
     if (num <= 0) {
@@ -377,16 +441,13 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         return;
     }
 
-    if (data->solvers[0]->drat->enabled() ||
-        data->solvers[0]->conf.simulate_drat
-    ) {
-        const char err[] = "ERROR: DRAT cannot be used in multi-threaded mode";
+    if (data->cls > 0 || nVars() > 0) {
+        const char err[] = "ERROR: You must first call set_num_threads() and only then add clauses and variables";
         std::cerr << err << endl;
         throw std::runtime_error(err);
     }
-
-    if (data->cls > 0 || nVars() > 0) {
-        const char err[] = "ERROR: You must first call set_num_threads() and only then add clauses and variables";
+    if (data->solvers[0]->external_propagator_connected()) {
+        const char err[] = "ERROR: An external propagator only works in single-threaded mode";
         std::cerr << err << endl;
         throw std::runtime_error(err);
     }
@@ -400,6 +461,7 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
     }
 
     //set shared data
+    delete data->shared_data;
     data->shared_data = new SharedData(data->solvers.size());
     for(unsigned i = 0; i < num; i++) {
         SolverConf conf = data->solvers[i]->getConf();
@@ -410,6 +472,13 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         data->solvers[i]->setConf(conf);
         data->solvers[i]->set_shared_data((SharedData*)data->shared_data);
     }
+
+    if (data->drat_set) {
+        for(unsigned i = 1; i < num; i++) {
+            setup_drat(data->solvers[i], data);
+        }
+        share_drat_file(data);
+    }
 }
 
 struct OneThreadAddCls
@@ -760,6 +829,32 @@ struct OneThreadCalc
     bool only_sampling_solution;
 };
 
+//Started at the first solve/simplify call, once all threads exist
+static void start_metrics(CMSatPrivateData* data)
+{
+    const SolverConf& conf = data->solvers[0]->conf;
+    if (data->metrics != NULL
+        || (conf.metrics_listen.empty() && conf.metrics_file.empty())
+    ) {
+        return;
+    }
+
+    vector<const SolverMetrics*> sources;
+    for(Solver* s: data->solvers) {
+        sources.push_back(s->enable_metrics());
+    }
+    try {
+        data->metrics = new MetricsExporter(
+            sources, conf.metrics_listen, conf.metrics_file, conf.metrics_every);
+    } catch (std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        exit(-1);
+    }
+    if (conf.verbosity && !conf.metrics_listen.empty()) {
+        cout << "c Serving metrics at " << conf.metrics_listen << endl;
+    }
+}
+
 lbool calc(
     const vector< Lit >* assumptions,
     bool solve, CMSatPrivateData *data,
@@ -785,8 +880,11 @@ lbool calc(
         }
         (*data->log) << " )" << endl;
     }
+    start_metrics(data);
 
-    if (data->solvers.size() > 1 && data->sql > 0) {
+    if (data->solvers.size() > 1 && data->sql > 0
+        && !data->solvers[0]->conf.sql_trace
+    ) {
         std::cerr
         << "Multithreaded solving and SQL cannot be specified at the same time"
         << endl;
@@ -805,6 +903,9 @@ lbool calc(
         }
         data->okay = data->solvers[0]->okay();
         data->cpu_times[0] = cpuTime();
+        if (solve && ret != l_Undef) {
+            data->solvers[0]->datasync->signal_net_finished();
+        }
         return ret;
     }
 
@@ -829,6 +930,9 @@ lbool calc(
     data->cls_lits.clear();
     data->vars_to_add = 0;
     data->okay = data->solvers[*data_for_thread.which_solved]->okay();
+    if (solve && real_ret != l_Undef) {
+        data->solvers[0]->datasync->signal_net_finished();
+    }
     return real_ret;
 }
 
@@ -850,7 +954,13 @@ DLL_PUBLIC lbool SATSolver::solve(const vector< Lit >* assumptions, bool only_sa
     data->previous_sum_propagations = get_sum_propagations();
     data->previous_sum_decisions = get_sum_decisions();
 
-    return calc(assumptions, true, data, only_sampling_solution);
+    const lbool ret = calc(assumptions, true, data, only_sampling_solution);
+    if (ret == l_Undef && (assumptions == NULL || assumptions->empty())) {
+        for(Solver* s: data->solvers) {
+            s->write_checkpoint();
+        }
+    }
+    return ret;
 }
 
 DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions)
@@ -874,6 +984,38 @@ DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions)
     return calc(assumptions, false, data);
 }
 
+DLL_PUBLIC uint64_t SATSolver::enumerate(
+    const std::function<bool(const std::vector<lbool>& model)>& callback
+    , const std::vector<uint32_t>* projection
+    , uint64_t limit
+) {
+    if (data->promised_single_call
+        && data->num_solve_simplify_calls > 0
+    ) {
+        cout
+        << "ERROR: You promised to only call solve/simplify() once"
+        << "       by calling set_single_run(), but you violated it. Exiting."
+        << endl;
+        exit(-1);
+    }
+    if (data->solvers[0]->external_propagator_connected()) {
+        const char err[] = "ERROR: Enumeration cannot be used with an external propagator, reject the models in cb_check_found_model() instead";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    data->num_solve_simplify_calls++;
+
+    data->previous_sum_conflicts = get_sum_conflicts();
+    data->previous_sum_propagations = get_sum_propagations();
+    data->previous_sum_decisions = get_sum_decisions();
+
+    actually_add_clauses_to_threads(data);
+    const uint64_t num = data->solvers[data->which_solved]->enumerate(
+        callback, projection, limit);
+    data->okay = data->solvers[data->which_solved]->okay();
+    return num;
+}
+
 DLL_PUBLIC const vector< lbool >& SATSolver::get_model() const
 {
     return data->solvers[data->which_solved]->get_model();
@@ -992,22 +1134,42 @@ DLL_PUBLIC void SATSolver::print_stats() const
 
 DLL_PUBLIC void SATSolver::set_drat(std::ostream* os, bool add_ID)
 {
-    if (data->solvers.size() > 1) {
-        std::cerr << "ERROR: DRAT cannot be used in multi-threaded mode" << endl;
+    if (nVars() > 0) {
+        std::cerr << "ERROR: DRAT cannot be set after variables have been added" << endl;
         exit(-1);
     }
+
+    data->drat_os = os;
+    data->drat_add_ID = add_ID;
+    data->drat_set = true;
+    for(Solver* s: data->solvers) {
+        setup_drat(s, data);
+    }
+    if (data->solvers.size() > 1) {
+        share_drat_file(data);
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_drat_check()
+{
     if (nVars() > 0) {
         std::cerr << "ERROR: DRAT cannot be set after variables have been added" << endl;
         exit(-1);
     }
 
-    data->solvers[0]->conf.gaussconf.doMatrixFind = false;
-    data->solvers[0]->conf.doBreakid = false;
-    data->solvers[0]->add_drat(os, add_ID);
-    data->solvers[0]->conf.do_hyperbin_and_transred = true;
-    data->solvers[0]->conf.doFindXors = false;
-    data->solvers[0]->conf.doCompHandler = false;
+    data->drat_check = true;
+    data->drat_set = true;
+    for(Solver* s: data->solvers) {
+        setup_drat(s, data);
+    }
+    if (data->solvers.size() > 1) {
+        share_drat_file(data);
+    }
+}
 
+DLL_PUBLIC lbool SATSolver::get_drat_check_result() const
+{
+    return data->solvers[data->which_solved]->drat_check_result;
 }
 
 DLL_PUBLIC void SATSolver::interrupt_asap()
@@ -1015,6 +1177,183 @@ DLL_PUBLIC void SATSolver::interrupt_asap()
     data->must_interrupt->store(true, std::memory_order_relaxed);
 }
 
+DLL_PUBLIC void SATSolver::set_terminate_callback(std::function<bool()> callback)
+{
+    data->solvers[0]->set_terminate_callback(callback);
+}
+
+DLL_PUBLIC void SATSolver::set_progress_callback(
+    std::function<void(const SolveProgress& progress)> callback
+    , double every_secs
+) {
+    data->solvers[0]->set_progress_callback(callback, every_secs);
+}
+
+DLL_PUBLIC void SATSolver::connect_external_propagator(ExternalPropagator* propagator)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: An external propagator only works in single-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    if (data->drat_set) {
+        const char err[] = "ERROR: Clauses of an external propagator cannot be put into a proof";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    actually_add_clauses_to_threads(data);
+    data->solvers[0]->connect_external_propagator(propagator);
+}
+
+DLL_PUBLIC void SATSolver::disconnect_external_propagator()
+{
+    data->solvers[0]->disconnect_external_propagator();
+}
+
+static void check_propagator_connected(const CMSatPrivateData* data)
+{
+    if (!data->solvers[0]->external_propagator_connected()) {
+        const char err[] = "ERROR: Observed variables need an external propagator to be connected";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+}
+
+DLL_PUBLIC void SATSolver::add_observed_var(uint32_t var)
+{
+    check_propagator_connected(data);
+    actually_add_clauses_to_threads(data);
+    data->solvers[0]->add_observed_var(var);
+}
+
+DLL_PUBLIC void SATSolver::remove_observed_var(uint32_t var)
+{
+    check_propagator_connected(data);
+    data->solvers[0]->remove_observed_var(var);
+}
+
+DLL_PUBLIC void SATSolver::reset_observed_vars()
+{
+    check_propagator_connected(data);
+    data->solvers[0]->reset_observed_vars();
+}
+
+DLL_PUBLIC void SATSolver::set_checkpoint(const std::string& fname, double every_secs)
+{
+    for(Solver* s: data->solvers) {
+        s->conf.checkpoint_file = fname;
+        s->conf.checkpoint_every = every_secs;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_metrics(
+    const std::string& listen_addr
+    , const std::string& json_fname
+    , double every_secs
+) {
+    if (data->metrics != NULL) {
+        std::cerr << "ERROR: metrics must be set up before the first solve() or simplify()" << endl;
+        exit(-1);
+    }
+    for(Solver* s: data->solvers) {
+        s->conf.metrics_listen = listen_addr;
+        s->conf.metrics_file = json_fname;
+        s->conf.metrics_every = every_secs;
+    }
+}
+
+DLL_PUBLIC void SATSolver::load_checkpoint(const std::string& fname)
+{
+    if (nVars() > 0) {
+        std::cerr << "ERROR: a checkpoint cannot be loaded after variables have been added" << endl;
+        exit(-1);
+    }
+
+    for(Solver* s: data->solvers) {
+        s->load_checkpoint(s->checkpoint_fname(fname));
+    }
+    data->okay = data->solvers[0]->okay();
+}
+
+DLL_PUBLIC void SATSolver::save_simplified(const std::string& fname)
+{
+    if (data->solvers[0]->external_propagator_connected()) {
+        const char err[] = "ERROR: The variables of an external propagator cannot be saved, disconnect it first";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    //The other threads would simplify the same problem the same way
+    actually_add_clauses_to_threads(data);
+    data->solvers[0]->save_snapshot(fname);
+    data->okay = data->solvers[0]->okay();
+}
+
+DLL_PUBLIC void SATSolver::load_simplified(const std::string& fname)
+{
+    if (nVars() > 0) {
+        std::cerr << "ERROR: a simplified problem cannot be loaded after variables have been added" << endl;
+        exit(-1);
+    }
+
+    for(Solver* s: data->solvers) {
+        s->load_checkpoint(fname, true);
+    }
+    data->okay = data->solvers[0]->okay();
+}
+
+//Files and addresses belong to the original, the copy must not write or
+//listen there as well
+static SolverConf conf_for_clone(const Solver* s)
+{
+    SolverConf conf = s->getConf();
+    conf.checkpoint_file.clear();
+    conf.metrics_listen.clear();
+    conf.metrics_file.clear();
+    conf.net_sync.clear();
+    return conf;
+}
+
+DLL_PUBLIC SATSolver* SATSolver::clone()
+{
+    if (data->solvers[0]->external_propagator_connected()) {
+        const char err[] = "ERROR: A solver with an external propagator cannot be cloned, disconnect it first";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    actually_add_clauses_to_threads(data);
+
+    //Same configuration for every thread, see set_num_threads()
+    SolverConf conf = conf_for_clone(data->solvers[0]);
+    SATSolver* c = new SATSolver(&conf);
+    CMSatPrivateData* cdata = c->data;
+    if (data->solvers.size() > 1) {
+        for(size_t i = 1; i < data->solvers.size(); i++) {
+            conf = conf_for_clone(data->solvers[i]);
+            cdata->solvers.push_back(new Solver(&conf, cdata->must_interrupt));
+            cdata->cpu_times.push_back(0.0);
+        }
+        delete cdata->shared_data;
+        cdata->shared_data = new SharedData(cdata->solvers.size());
+        for(Solver* s: cdata->solvers) {
+            s->set_shared_data((SharedData*)cdata->shared_data);
+        }
+    }
+
+    try {
+        for(size_t i = 0; i < data->solvers.size(); i++) {
+            cdata->solvers[i]->copy_state_from(data->solvers[i]);
+        }
+    } catch (...) {
+        delete c;
+        throw;
+    }
+    cdata->okay = data->okay;
+    cdata->which_solved = data->which_solved;
+    cdata->timeout = data->timeout;
+    return c;
+}
+
 void DLL_PUBLIC SATSolver::add_in_partial_solving_stats()
 {
     data->solvers[data->which_solved]->add_in_partial_solving_stats();
@@ -1023,6 +1362,7 @@ void DLL_PUBLIC SATSolver::add_in_partial_solving_stats()
 
 DLL_PUBLIC std::vector<Lit> SATSolver::get_zero_assigned_lits() const
 {
+    data->solvers[data->which_solved]->drop_kept_assumps();
     return data->solvers[data->which_solved]->get_zero_assigned_lits();
 }
 
@@ -1080,14 +1420,18 @@ SATSolver::get_recovered_xors(bool xor_together_xors) const
 
 DLL_PUBLIC void SATSolver::set_sqlite(std::string filename)
 {
-    if (data->solvers.size() > 1) {
+    //A binary trace is a file per thread, a database would be shared
+    if (data->solvers.size() > 1 && !data->solvers[0]->conf.sql_trace) {
         std::cerr
         << "Multithreaded solving and SQL cannot be specified at the same time"
         << endl;
         exit(-1);
     }
     data->sql = 1;
-    data->solvers[0]->set_sqlite(filename);
+    for(size_t i = 0; i < data->solvers.size(); i++) {
+        data->solvers[i]->set_sqlite(
+            i == 0 ? filename : filename + "." + std::to_string(i));
+    }
 }
 
 DLL_PUBLIC uint64_t SATSolver::get_sum_conflicts()
@@ -1164,24 +1508,48 @@ DLL_PUBLIC uint64_t SATSolver::get_last_decisions()
 
 DLL_PUBLIC void SATSolver::dump_irred_clauses(std::ostream *out) const
 {
+    data->solvers[data->which_solved]->drop_kept_assumps();
     data->solvers[data->which_solved]->dump_irred_clauses(out);
 }
 
 void DLL_PUBLIC SATSolver::dump_red_clauses(std::ostream *out) const
 {
+    data->solvers[data->which_solved]->drop_kept_assumps();
     data->solvers[data->which_solved]->dump_red_clauses(out);
 }
 
 DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses(std::string fname) const
 {
+    data->solvers[data->which_solved]->drop_kept_assumps();
     data->solvers[data->which_solved]->open_file_and_dump_irred_clauses(fname);
 }
 
 void DLL_PUBLIC SATSolver::open_file_and_dump_red_clauses(std::string fname) const
 {
+    data->solvers[data->which_solved]->drop_kept_assumps();
     data->solvers[data->which_solved]->open_file_and_dump_red_clauses(fname);
 }
 
+void DLL_PUBLIC SATSolver::set_learnt_clause_export(
+    std::function<void(const std::vector<Lit>& clauses)> callback
+    , uint32_t max_size
+    , uint32_t max_glue
+    , uint32_t batch_size
+) {
+    data->solvers[0]->datasync->set_ext_export(callback, max_size, max_glue, batch_size);
+}
+
+void DLL_PUBLIC SATSolver::set_learnt_clause_import(
+    std::function<void(std::vector<Lit>& clauses)> callback)
+{
+    if (callback && data->drat_set) {
+        const char err[] = "ERROR: Clauses received from other processes cannot be put into a proof";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    data->solvers[0]->datasync->set_ext_import(callback);
+}
+
 void DLL_PUBLIC SATSolver::start_getting_small_clauses(uint32_t max_len, uint32_t max_glue)
 {
     assert(data->solvers.size() >= 1);
@@ -1277,6 +1645,12 @@ DLL_PUBLIC vector<uint32_t> SATSolver::get_var_incidence_also_red()
     return data->solvers[data->which_solved]->get_outside_var_incidence_also_red();
 }
 
+DLL_PUBLIC vector<uint32_t> SATSolver::get_var_components()
+{
+    actually_add_clauses_to_threads(data);
+    return data->solvers[data->which_solved]->get_outside_var_components();
+}
+
 DLL_PUBLIC void SATSolver::set_intree_probe(int val)
 {
     for (size_t i = 0; i < data->solvers.size(); ++i) {
@@ -1375,3 +1749,11 @@ DLL_PUBLIC void SATSolver::set_yes_comphandler()
         s.enable_comphandler();
     }
 }
+
+DLL_PUBLIC void SATSolver::set_comphandler_threads(unsigned num)
+{
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.comp_threads = num;
+    }
+}
@@ -33,6 +33,7 @@ static_assert(sizeof(Lit) == sizeof(c_Lit), "Lit layout not c-compatible");
 static_assert(alignof(Lit) == alignof(c_Lit), "Lit layout not c-compatible");
 static_assert(sizeof(lbool) == sizeof(c_lbool), "lbool layout not c-compatible");
 static_assert(alignof(lbool) == alignof(c_lbool), "lbool layout not c-compatible");
+static_assert(CMSAT_LIT_UNDEF == (var_Undef << 1), "lit_Undef layout changed");
 
 const Lit* fromc(const c_Lit* x)
 {
@@ -173,4 +174,26 @@ extern "C"
     DLL_PUBLIC void cmsat_set_max_time(SATSolver* self, double max_time) NOEXCEPT_START {
         self->set_max_time(max_time);
     } NOEXCEPT_END
+
+    DLL_PUBLIC void cmsat_set_learnt_clause_export(SATSolver* self, cmsat_learnt_export_fn fn, void* user_data, unsigned max_size, unsigned max_glue, unsigned batch_size) NOEXCEPT_START {
+        if (fn == NULL) {
+            self->set_learnt_clause_export(nullptr);
+            return;
+        }
+        self->set_learnt_clause_export([=](const std::vector<Lit>& cls) {
+            fn(user_data, toc(cls.data()), cls.size());
+        }, max_size, max_glue, batch_size);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void cmsat_set_learnt_clause_import(SATSolver* self, cmsat_learnt_import_fn fn, void* user_data) NOEXCEPT_START {
+        if (fn == NULL) {
+            self->set_learnt_clause_import(nullptr);
+            return;
+        }
+        self->set_learnt_clause_import([=](std::vector<Lit>& cls) {
+            const slice_Lit got = fn(user_data);
+            const Lit* lits = fromc(got.vals);
+            cls.insert(cls.end(), lits, lits + got.num_vals);
+        });
+    } NOEXCEPT_END
 }
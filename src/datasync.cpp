@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "varreplacer.h"
 #include "solver.h"
 #include "shareddata.h"
+#include "netsync.h"
 #include <iomanip>
 
 using namespace CMSat;
@@ -47,6 +48,25 @@ DataSync::DataSync(Solver* _solver, SharedData* _sharedData, bool _is_mpi) :
         assert(!(mpiSize > 1 && sharedData == NULL));
     }
 #endif
+
+    if (!solver->conf.net_sync.empty() && solver->conf.thread_num == 0) {
+        try {
+            netClient = new net::Client(solver->conf.net_sync);
+        } catch (std::runtime_error& e) {
+            std::cerr << e.what() << endl;
+            throw;
+        }
+        net_max_size = solver->conf.net_share_max_size;
+        net_max_glue = solver->conf.net_share_max_glue;
+        if (solver->conf.verbosity) {
+            cout << "c [net] connected to hub at " << solver->conf.net_sync << endl;
+        }
+    }
+}
+
+DataSync::~DataSync()
+{
+    delete netClient;
 }
 
 void DataSync::set_shared_data(SharedData* _sharedData)
@@ -90,17 +110,38 @@ void DataSync::updateVars(
 ) {
 }
 
+//The import callback is polled at every restart, the other threads and
+//processes are synced with every sync_every_confl conflicts
+bool DataSync::sync_due() const
+{
+    return ext_import_enabled()
+        || (sharedData != NULL
+            && lastSyncConf + solver->conf.sync_every_confl < solver->sumConflicts);
+}
+
 bool DataSync::syncData()
 {
-    if (!enabled()
+    flush_ext_export();
+    if (!sync_due()) {
+        return true;
+    }
+    assert(solver->decisionLevel() == 0);
+
+    if (ext_import_enabled() && !sync_from_ext()) {
+        return false;
+    }
+    if (sharedData == NULL
         || lastSyncConf + solver->conf.sync_every_confl >= solver->sumConflicts
     ) {
         return true;
     }
     numCalls++;
 
-    assert(sharedData != NULL);
-    assert(solver->decisionLevel() == 0);
+    //Everything we export must be in the shared DRAT file before the other
+    //threads can use it
+    if (sharedData->num_threads > 1 && solver->drat->enabled()) {
+        solver->drat->flush();
+    }
 
     if (must_rebuild_bva_map) {
         outer_to_without_bva_map = solver->build_outer_to_without_bva_map();
@@ -108,6 +149,16 @@ bool DataSync::syncData()
     }
 
     bool ok;
+    if (netClient != NULL && net_alive) {
+        sharedData->unit_mutex.lock();
+        sharedData->bin_mutex.lock();
+        extend_bins_if_needed();
+        ok = syncFromNet();
+        sharedData->bin_mutex.unlock();
+        sharedData->unit_mutex.unlock();
+        if (!ok) return false;
+    }
+
     sharedData->unit_mutex.lock();
     ok = shareUnitData();
     sharedData->unit_mutex.unlock();
@@ -120,6 +171,26 @@ bool DataSync::syncData()
     sharedData->bin_mutex.unlock();
     if (!ok) return false;
 
+    if (netClient != NULL && net_alive) {
+        //Long clauses only go into this thread, the others get them from
+        //their own peers in the other processes
+        size_t at = 0;
+        while(at < net_recv.size()) {
+            const uint32_t sz = net_recv[at];
+            if (sz > 2 && !add_clause_from_net(net_recv.data() + at + 1, sz)) {
+                return false;
+            }
+            at += 1 + sz;
+        }
+        net_recv.clear();
+
+        sharedData->unit_mutex.lock();
+        sharedData->bin_mutex.lock();
+        syncToNet();
+        sharedData->bin_mutex.unlock();
+        sharedData->unit_mutex.unlock();
+    }
+
     #ifdef USE_MPI
     if (is_mpi && mpiSize > 1 && solver->conf.thread_num == 0) {
         sharedData->unit_mutex.lock();
@@ -391,6 +462,338 @@ void DataSync::signalNewBinClause(Lit lit1, Lit lit2)
 }
 
 
+///////////////////////////////////////
+// Other processes, through the hub
+///////////////////////////////////////
+
+void DataSync::newLongClauseToNet(const Lit* lits, const uint32_t size)
+{
+    if (!net_alive) {
+        return;
+    }
+
+    if (must_rebuild_bva_map) {
+        outer_to_without_bva_map = solver->build_outer_to_without_bva_map();
+        must_rebuild_bva_map = false;
+    }
+
+    net_cl.clear();
+    for(uint32_t i = 0; i < size; i++) {
+        if (solver->varData[lits[i].var()].is_bva) {
+            return;
+        }
+        Lit lit = solver->map_inter_to_outer(lits[i]);
+        lit = map_outside_without_bva(lit);
+        net_cl.push_back(lit.toInt());
+    }
+    netClient->add_clause(net_cl);
+}
+
+//Called with both the unit and the bin mutex held. Units and binaries are
+//put into the shared data, so all threads get them. Long clauses are kept in
+//net_recv, and are added to this thread only once the mutexes are released
+bool DataSync::syncFromNet()
+{
+    bool got_done;
+    net_recv.clear();
+    if (!netClient->receive(net_recv, got_done)) {
+        net_alive = false;
+        if (solver->conf.verbosity) {
+            cout << "c [net] lost the connection to the hub, continuing alone" << endl;
+        }
+    }
+    if (got_done) {
+        if (solver->conf.verbosity) {
+            cout << "c [net] another solver has finished, stopping" << endl;
+        }
+        solver->set_must_interrupt_asap();
+    }
+
+    SharedData& shared = *sharedData;
+    if (shared.value.size() < solver->nVarsOutside()) {
+        shared.value.resize(solver->nVarsOutside(), l_Undef);
+    }
+    net_unit_sent.resize(solver->nVarsOutside(), 0);
+
+    size_t at = 0;
+    while(at < net_recv.size()) {
+        const uint32_t sz = net_recv[at];
+        const uint32_t* lits = net_recv.data() + at + 1;
+        at += 1 + sz;
+
+        bool in_range = true;
+        for(uint32_t i = 0; i < sz; i++) {
+            in_range &= Lit::toLit(lits[i]).var() < solver->nVarsOutside();
+        }
+        if (!in_range) {
+            continue;
+        }
+
+        if (sz == 1) {
+            const Lit lit = Lit::toLit(lits[0]);
+            const lbool val = lit.sign() ? l_False : l_True;
+            net_unit_sent[lit.var()] = 1;
+            if (shared.value[lit.var()] == l_Undef) {
+                shared.value[lit.var()] = val;
+                net_recv_units++;
+            } else if (shared.value[lit.var()] != val) {
+                solver->ok = false;
+                return false;
+            }
+        } else if (sz == 2) {
+            const Lit lit1 = Lit::toLit(lits[0]);
+            const Lit lit2 = Lit::toLit(lits[1]);
+            if (lit1.var() != lit2.var()) {
+                addOneBinToOthers(lit1, lit2);
+                net_recv_bins++;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool DataSync::add_clause_from_net(const uint32_t* lits, const uint32_t size)
+{
+    net_tmp.clear();
+    for(uint32_t i = 0; i < size; i++) {
+        Lit lit = Lit::toLit(lits[i]);
+        //The hub doesn't check what it forwards, another process may have
+        //more variables than this one
+        if (lit.var() >= solver->nVarsOutside()) {
+            return true;
+        }
+        lit = solver->map_to_with_bva(lit);
+        if (lit.var() >= solver->nVarsOuter()) {
+            return true;
+        }
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none
+            || solver->value(lit) == l_True
+        ) {
+            return true;
+        }
+        net_tmp.push_back(lit);
+    }
+    net_recv_longs++;
+
+    return add_red_clause(net_tmp, net_max_glue);
+}
+
+//Adds a clause received from elsewhere as a learnt one. Its glue is not
+//known, so it is taken to be at most max_glue
+bool DataSync::add_red_clause(vector<Lit>& lits, const uint32_t max_glue)
+{
+    //Don't add DRAT: it would add to the thread data, too
+    Clause* cl = solver->add_clause_int(lits, true, ClauseStats(), true, NULL, false);
+    if (cl != NULL) {
+        cl->stats.glue = std::min<uint32_t>(max_glue, cl->size());
+        #ifndef FINAL_PREDICTOR
+        cl->stats.which_red_array = 0;
+        #else
+        cl->stats.which_red_array = 3;
+        #endif
+        solver->longRedCls[cl->stats.which_red_array].push_back(
+            solver->cl_alloc.get_offset(cl));
+    }
+    return solver->okay();
+}
+
+void DataSync::syncToNet()
+{
+    const SharedData& shared = *sharedData;
+    net_unit_sent.resize(solver->nVarsOutside(), 0);
+    for(uint32_t var = 0; var < shared.value.size(); var++) {
+        if (shared.value[var] == l_Undef || net_unit_sent[var]) {
+            continue;
+        }
+        net_unit_sent[var] = 1;
+        net_cl.clear();
+        net_cl.push_back(Lit(var, shared.value[var] == l_False).toInt());
+        netClient->add_clause(net_cl);
+    }
+
+    net_bin_finish.resize(shared.bins.size(), 0);
+    for(uint32_t wsLit = 0; wsLit < shared.bins.size(); wsLit++) {
+        if (shared.bins[wsLit].data == NULL) {
+            continue;
+        }
+        const vector<Lit>& bins = *shared.bins[wsLit].data;
+        for(uint32_t i = net_bin_finish[wsLit]; i < bins.size(); i++) {
+            net_cl.clear();
+            net_cl.push_back(wsLit);
+            net_cl.push_back(bins[i].toInt());
+            netClient->add_clause(net_cl);
+        }
+        net_bin_finish[wsLit] = bins.size();
+    }
+
+    netClient->send_batch(solver->nVarsOutside());
+}
+
+void DataSync::signal_net_finished()
+{
+    if (netClient != NULL && net_alive) {
+        netClient->send_done();
+    }
+}
+
+void DataSync::get_net_cls(uint64_t& sent, uint64_t& recv) const
+{
+    if (netClient == NULL) {
+        sent = 0;
+        recv = 0;
+        return;
+    }
+    const net::Client::Stats s = netClient->get_stats();
+    sent = s.sent_cls;
+    recv = s.recv_cls;
+}
+
+void DataSync::print_net_stats() const
+{
+    const net::Client::Stats s = netClient->get_stats();
+    print_stats_line("c net cls sent", s.sent_cls);
+    print_stats_line("c net cls sent dedup", s.dedup_cls);
+    print_stats_line("c net batches sent", s.batches
+        , s.dropped_batches
+        , "dropped"
+    );
+    print_stats_line("c net batches held back", s.held_batches);
+    print_stats_line("c net cls recv", s.recv_cls);
+    print_stats_line("c net units recv", net_recv_units);
+    print_stats_line("c net bins recv", net_recv_bins);
+    print_stats_line("c net long cls recv", net_recv_longs);
+    print_stats_line("c net KB sent", s.bytes_sent/1024
+        , ratio_for_stat(s.bytes_sent, s.sent_cls)
+        , "B/cl"
+    );
+    print_stats_line("c net KB recv", s.bytes_recv/1024);
+}
+
+///////////////////////////////////////
+// Other solvers, through callbacks
+///////////////////////////////////////
+
+void DataSync::set_ext_export(
+    std::function<void(const vector<Lit>&)> callback
+    , const uint32_t max_size
+    , const uint32_t max_glue
+    , const uint32_t batch_size
+) {
+    ext_out.clear();
+    ext_out_cls = 0;
+    ext_export = callback;
+    ext_max_size = ext_export ? max_size : 0;
+    ext_max_glue = max_glue;
+    ext_batch_size = std::max<uint32_t>(batch_size, 1);
+}
+
+void DataSync::set_ext_import(std::function<void(vector<Lit>&)> callback)
+{
+    ext_import = callback;
+}
+
+void DataSync::learnt_to_ext(const Lit* lits, const uint32_t size)
+{
+    if (must_rebuild_bva_map) {
+        outer_to_without_bva_map = solver->build_outer_to_without_bva_map();
+        must_rebuild_bva_map = false;
+    }
+
+    const size_t start = ext_out.size();
+    for(uint32_t i = 0; i < size; i++) {
+        if (solver->varData[lits[i].var()].is_bva) {
+            ext_out.resize(start);
+            return;
+        }
+        Lit lit = solver->map_inter_to_outer(lits[i]);
+        lit = map_outside_without_bva(lit);
+        ext_out.push_back(lit);
+    }
+    ext_out.push_back(lit_Undef);
+    ext_out_cls++;
+
+    if (ext_out_cls >= ext_batch_size) {
+        flush_ext_export();
+    }
+}
+
+void DataSync::flush_ext_export()
+{
+    if (ext_out_cls == 0) {
+        return;
+    }
+    ext_export(ext_out);
+    ext_sent_cls += ext_out_cls;
+    ext_out.clear();
+    ext_out_cls = 0;
+}
+
+//At level 0. Clauses over unknown or eliminated variables are dropped
+bool DataSync::sync_from_ext()
+{
+    assert(solver->okay());
+    ext_in.clear();
+    ext_import(ext_in);
+
+    size_t start = 0;
+    for(size_t i = 0; i <= ext_in.size(); i++) {
+        if (i < ext_in.size() && ext_in[i] != lit_Undef) {
+            continue;
+        }
+        if (i > start
+            && !add_clause_from_ext(ext_in.data() + start, i - start)
+        ) {
+            return false;
+        }
+        start = i + 1;
+    }
+
+    if (solver->conf.verbosity >= 3) {
+        cout << "c [ext] recv cls total " << ext_recv_cls
+        << " dropped " << ext_recv_dropped << endl;
+    }
+
+    return true;
+}
+
+bool DataSync::add_clause_from_ext(const Lit* lits, const uint32_t size)
+{
+    ext_tmp.clear();
+    for(uint32_t i = 0; i < size; i++) {
+        Lit lit = lits[i];
+        if (lit.var() >= solver->nVarsOutside()) {
+            ext_recv_dropped++;
+            return true;
+        }
+        lit = solver->map_to_with_bva(lit);
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none) {
+            ext_recv_dropped++;
+            return true;
+        }
+        if (solver->value(lit) == l_True) {
+            return true;
+        }
+        ext_tmp.push_back(lit);
+    }
+    ext_recv_cls++;
+
+    return add_red_clause(ext_tmp, size);
+}
+
+void DataSync::print_ext_stats() const
+{
+    print_stats_line("c ext cls sent", ext_sent_cls);
+    print_stats_line("c ext cls recv", ext_recv_cls
+        , ext_recv_dropped
+        , "dropped"
+    );
+}
+
 ///////////////////////////////////////
 // MPI
 ///////////////////////////////////////
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "solvertypes.h"
 #include "watched.h"
 #include "watcharray.h"
+#include <functional>
 #ifdef USE_MPI
 #include "mpi.h"
 #endif //USE_MPI
@@ -32,11 +33,17 @@ namespace CMSat {
 
 class SharedData;
 class Solver;
+namespace net { class Client; }
+
 class DataSync
 {
     public:
         DataSync(Solver* solver, SharedData* sharedData, bool is_mpi);
+        ~DataSync();
+        DataSync(const DataSync&) = delete;
+        DataSync& operator=(const DataSync&) = delete;
         bool enabled();
+        bool sync_due() const; ///<next syncData() will actually sync, needs level 0
         void set_shared_data(SharedData* sharedData);
         void new_var(const bool bva);
         void new_vars(const size_t n);
@@ -50,6 +57,27 @@ class DataSync
 
         template <class T> void signalNewBinClause(T& ps);
         void signalNewBinClause(Lit lit1, Lit lit2);
+        template <class T> void signalNewLongClause(const T& cl, const uint32_t glue);
+        bool net_enabled() const;
+
+        ///Tells the other processes that this one has finished
+        void signal_net_finished();
+        void print_net_stats() const;
+
+        ///Learnt clause exchange with other solvers through callbacks.
+        ///Clauses are in the outside numbering, each ended by lit_Undef
+        void set_ext_export(
+            std::function<void(const vector<Lit>&)> callback
+            , const uint32_t max_size
+            , const uint32_t max_glue
+            , const uint32_t batch_size
+        );
+        void set_ext_import(std::function<void(vector<Lit>&)> callback);
+        bool ext_import_enabled() const;
+        bool ext_enabled() const;
+        template <class T> void signal_learnt_to_ext(const T& cl, const uint32_t glue);
+        void flush_ext_export();
+        void print_ext_stats() const;
 
         struct Stats
         {
@@ -60,6 +88,9 @@ class DataSync
         };
         const Stats& get_stats() const;
 
+        ///Clauses sent to and received from the hub, 0 without --net
+        void get_net_cls(uint64_t& sent, uint64_t& recv) const;
+
     private:
         void extend_bins_if_needed();
         Lit map_outside_without_bva(Lit lit) const;
@@ -70,10 +101,46 @@ class DataSync
         void clear_set_binary_values();
         void addOneBinToOthers(const Lit lit1, const Lit lit2);
         bool shareBinData();
+        void newLongClauseToNet(const Lit* lits, const uint32_t size);
+        bool add_red_clause(vector<Lit>& lits, const uint32_t glue);
 
         //stuff to sync
         vector<std::pair<Lit, Lit> > newBinClauses;
 
+        //Other processes, through the hub. Only thread 0 talks to the hub
+        net::Client* netClient = NULL;
+        bool syncFromNet();
+        void syncToNet();
+        bool add_clause_from_net(const uint32_t* lits, const uint32_t size);
+        vector<uint32_t> net_cl;
+        vector<uint32_t> net_recv;
+        vector<Lit> net_tmp;
+        vector<char> net_unit_sent;
+        vector<uint32_t> net_bin_finish;
+        bool net_alive = true;
+        uint32_t net_max_size = 0;
+        uint32_t net_max_glue = 0;
+        uint64_t net_recv_units = 0;
+        uint64_t net_recv_bins = 0;
+        uint64_t net_recv_longs = 0;
+
+        //Other solvers, through the user's callbacks
+        void learnt_to_ext(const Lit* lits, const uint32_t size);
+        bool sync_from_ext();
+        bool add_clause_from_ext(const Lit* lits, const uint32_t size);
+        std::function<void(const vector<Lit>&)> ext_export;
+        std::function<void(vector<Lit>&)> ext_import;
+        vector<Lit> ext_out;
+        vector<Lit> ext_in;
+        vector<Lit> ext_tmp;
+        uint32_t ext_out_cls = 0;
+        uint32_t ext_max_size = 0; //0 when not exporting
+        uint32_t ext_max_glue = 0;
+        uint32_t ext_batch_size = 0;
+        uint64_t ext_sent_cls = 0;
+        uint64_t ext_recv_cls = 0;
+        uint64_t ext_recv_dropped = 0;
+
         //stats
         uint64_t lastSyncConf = 0;
         vector<uint32_t> syncFinish;
@@ -132,6 +199,44 @@ inline void DataSync::signalNewBinClause(T& ps)
     signalNewBinClause(ps[0], ps[1]);
 }
 
+template <class T>
+inline void DataSync::signalNewLongClause(const T& cl, const uint32_t glue)
+{
+    if (netClient == NULL
+        || cl.size() > net_max_size
+        || glue > net_max_glue
+    ) {
+        return;
+    }
+    newLongClauseToNet(cl.data(), cl.size());
+}
+
+template <class T>
+inline void DataSync::signal_learnt_to_ext(const T& cl, const uint32_t glue)
+{
+    if (cl.size() > ext_max_size
+        || glue > ext_max_glue
+    ) {
+        return;
+    }
+    learnt_to_ext(cl.data(), cl.size());
+}
+
+inline bool DataSync::ext_import_enabled() const
+{
+    return (bool)ext_import;
+}
+
+inline bool DataSync::ext_enabled() const
+{
+    return ext_import || ext_export;
+}
+
+inline bool DataSync::net_enabled() const
+{
+    return netClient != NULL;
+}
+
 inline Lit DataSync::map_outside_without_bva(const Lit lit) const
 {
     return Lit(outer_to_without_bva_map[lit.var()], lit.sign());
@@ -265,6 +265,9 @@ ClOffset DistillerLong::try_distill_clause_and_return_new(
     solver->detachClause(offset, false);
     Clause& cl = *solver->cl_alloc.ptr(offset);
     (*solver->drat) << deldelay << cl << fin;
+    if (solver->drat->hints_needed()) {
+        orig_lits.assign(cl.begin(), cl.end());
+    }
 
     uint32_t orig_size = cl.size();
     uint32_t i = 0;
@@ -349,6 +352,22 @@ ClOffset DistillerLong::try_distill_clause_and_return_new(
             lits_set = true;
         }
     }
+
+    //The negation of the new clause propagates to the conflict
+    if (solver->drat->hints_needed()) {
+        if (!lits_set) {
+            lits.assign(cl.begin(), cl.end());
+        }
+        const Lit confl_lit = True_confl ? cl[cl.size()-1] : lit_Undef;
+        //Without a conflict, the literals removed are false and the
+        //original clause conflicts
+        const bool ok = (confl.isNULL() && !True_confl)
+            ? solver->build_hints(lits, orig_lits, solver->drat->ID_of(cl), solver->frat_hints)
+            : solver->build_hints(lits, confl, confl_lit, solver->frat_hints);
+        if (!ok) {
+            solver->frat_hints.clear();
+        }
+    }
     solver->cancelUntil<false, true>(0);
     runStats.numLitsRem += orig_size - cl.size();
     runStats.numClShorten++;
@@ -433,5 +452,6 @@ double DistillerLong::mem_used() const
 {
     double mem_used = sizeof(DistillerLong);
     mem_used += lits.size()*sizeof(Lit);
+    mem_used += orig_lits.size()*sizeof(Lit);
     return mem_used;
 }
@@ -85,6 +85,7 @@ class DistillerLong {
 
         //For distill
         vector<Lit> lits;
+        vector<Lit> orig_lits; ///<Of the clause being distilled, for FRAT hints
         uint64_t oldBogoProps;
         int64_t maxNumProps;
         int64_t orig_maxNumProps;
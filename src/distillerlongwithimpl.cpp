@@ -100,6 +100,7 @@ void DistillerLongWithImpl::strengthen_clause_with_watch(
         if (seen[(~wit->lit2()).toInt()]) {
             thisremLitBin++;
             seen[(~wit->lit2()).toInt()] = 0;
+            str_bin_IDs.push_back(solver->drat->bin_ID(lit, wit->lit2()));
         }
     }
 }
@@ -203,6 +204,7 @@ bool DistillerLongWithImpl::sub_str_cl_with_watch(
     tmpStats.triedCls++;
     isSubsumed = false;
     thisremLitBin = 0;
+    str_bin_IDs.clear();
 
     //Fill 'seen'
     lits2.clear();
@@ -251,6 +253,13 @@ bool DistillerLongWithImpl::remove_or_shrink_clause(Clause& cl, ClOffset& offset
     watch_based_data.remLitBin += thisremLitBin;
     tmpStats.shrinked++;
     timeAvailable -= (long)lits.size()*2 + 50;
+
+    //A literal is removed by a binary clause whose other literal is removed
+    //later or stays, so the binaries become unit in reverse order
+    if (solver->drat->hints_needed()) {
+        solver->frat_hints.assign(str_bin_IDs.rbegin(), str_bin_IDs.rend());
+        solver->frat_hints.push_back(solver->drat->ID_of(cl));
+    }
     Clause* c2 = solver->add_clause_int(lits, cl.red(), cl.stats);
     if (c2 != NULL) {
         solver->detachClause(offset);
@@ -124,6 +124,7 @@ class DistillerLongWithImpl {
         WatchBasedData watch_based_data;
         bool isSubsumed;
         size_t thisremLitBin;
+        vector<uint32_t> str_bin_IDs; ///<FRAT IDs of the binaries that removed literals
         void str_and_sub_using_watch(
             Clause& cl
             , const Lit lit
@@ -24,8 +24,19 @@ THE SOFTWARE.
 #define __DRAT_H__
 
 #include "clause.h"
+#include "clauseallocator.h"
 #include <vector>
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
 
 using std::vector;
 //#define DEBUG_DRAT
@@ -34,6 +45,18 @@ namespace CMSat {
 
 enum DratFlag{fin, deldelay, del, findelay, add};
 
+//ID of the clause that is being added or deleted, only used by proofs that
+//number their clauses (FRAT). The proof keeps the IDs of the clauses in the
+//solver itself, an explicit ID is for the ones it does not keep, see FratFile
+struct FratID
+{
+    explicit FratID(const uint32_t _ID) :
+        ID(_ID)
+    {}
+
+    uint32_t ID;
+};
+
 struct Drat
 {
     Drat()
@@ -89,12 +112,125 @@ struct Drat
         return *this;
     }
 
+    virtual Drat& operator<<(const FratID)
+    {
+        return *this;
+    }
+
+    //ID for a new clause. 0 if the proof does not number its clauses
+    virtual uint32_t new_ID()
+    {
+        return 0;
+    }
+
+    //IDs of the clauses in the solver, 0 if the proof does not number its
+    //clauses or has no such clause
+    virtual uint32_t ID_of(const Clause& /*cl*/)
+    {
+        return 0;
+    }
+
+    virtual uint32_t bin_ID(const Lit /*lit1*/, const Lit /*lit2*/)
+    {
+        return 0;
+    }
+
+    //The clause, already in the proof with ID, is now in the solver. The
+    //lits variant is for units and binary clauses
+    virtual void set_ID(const Clause& /*cl*/, const uint32_t /*ID*/)
+    {
+    }
+
+    virtual void set_ID(const vector<Lit>& /*lits*/, const uint32_t /*ID*/)
+    {
+    }
+
+    //The clause leaves the solver but stays in the proof, its ID is returned
+    //and has to be deleted or finalised by the caller
+    virtual uint32_t release_ID(const Clause& /*cl*/)
+    {
+        return 0;
+    }
+
+    virtual uint32_t release_ID(const Lit /*lit1*/, const Lit /*lit2*/)
+    {
+        return 0;
+    }
+
+    //Called by ClauseAllocator::consolidate() once the clauses are moved,
+    //before the old memory is freed
+    virtual void clauses_moved()
+    {
+    }
+
     virtual void setFile(std::ostream*)
     {
     }
 
     virtual void flush();
 
+    virtual void set_async(const unsigned /*num_bufs*/)
+    {
+    }
+
+    virtual void set_shared(std::mutex* /*file_mutex*/)
+    {
+    }
+
+    //Clause given to the solver, in outer numbering. Returns its ID
+    virtual uint32_t add_original(const vector<Lit>& /*outer_lits*/)
+    {
+        return 0;
+    }
+
+    virtual bool hints_needed()
+    {
+        return false;
+    }
+
+    //ID of the unit clause of lit, 0 if the proof has none
+    virtual uint32_t unit_ID(const Lit /*lit*/)
+    {
+        return 0;
+    }
+
+    //Waits for the proof to be checked, if it is checked at all. l_True if
+    //the empty clause has been verified to follow
+    virtual lbool verify_unsat()
+    {
+        return l_Undef;
+    }
+
+    //IDs of the clauses the next added clause can be derived from, in the
+    //order in which they become unit, the last one being in conflict
+    virtual void set_hints(const vector<uint32_t>& /*hints*/)
+    {
+    }
+
+    //Once the empty clause has been added, all clauses that are still
+    //around must be listed, see Solver::finalize_frat()
+    virtual bool must_finalize()
+    {
+        return false;
+    }
+
+    //For the IDs the caller keeps
+    virtual void finalize(
+        const uint32_t /*ID*/
+        , const vector<Lit>& /*lits*/
+        , const bool /*outer_numbering*/ = false)
+    {
+    }
+
+    //The clauses whose IDs the proof keeps, and the empty clause
+    virtual void finalize_kept()
+    {
+    }
+
+    virtual void print_stats() const
+    {
+    }
+
     int buf_len;
     unsigned char* drup_buf = NULL;
     unsigned char* buf_ptr = NULL;
@@ -118,8 +254,12 @@ struct DratFile: public Drat
 
     virtual ~DratFile()
     {
+        stop_writer();
         delete[] drup_buf;
         delete[] del_buf;
+        for(unsigned char* buf: free_bufs) {
+            delete[] buf;
+        }
     }
 
     #ifdef STATS_NEEDED
@@ -182,14 +322,133 @@ struct DratFile: public Drat
     void flush() override
     {
         binDRUP_flush();
+        if (writer.joinable()) {
+            std::unique_lock<std::mutex> lock(mu);
+            const auto start = std::chrono::steady_clock::now();
+            buf_freed.wait(lock, [this]{return to_write.empty() && !writing;});
+            add_blocked_time(start);
+        }
     }
 
+    //Hands the buffer over to the writer thread when async, and
+    //only blocks if all buffers are waiting to be written
     void binDRUP_flush() {
-        drup_file->write((const char*)drup_buf, buf_len);
+        if (!writer.joinable()) {
+            const auto start = std::chrono::steady_clock::now();
+            write_to_file(drup_buf, buf_len);
+            add_blocked_time(start);
+            bytes_written += buf_len;
+        } else {
+            std::unique_lock<std::mutex> lock(mu);
+            to_write.push_back(std::make_pair(drup_buf, buf_len));
+            has_work.notify_one();
+            if (free_bufs.empty()) {
+                const auto start = std::chrono::steady_clock::now();
+                buf_freed.wait(lock, [this]{return !free_bufs.empty();});
+                add_blocked_time(start);
+                num_blocked++;
+            }
+            drup_buf = free_bufs.back();
+            free_bufs.pop_back();
+        }
+        num_flushes++;
         buf_ptr = drup_buf;
         buf_len = 0;
     }
 
+    void write_to_file(const unsigned char* buf, const int len)
+    {
+        if (file_mutex) {
+            std::lock_guard<std::mutex> lock(*file_mutex);
+            drup_file->write((const char*)buf, len);
+        } else {
+            drup_file->write((const char*)buf, len);
+        }
+    }
+
+    //The file is written by multiple solvers. Since a clause deleted by one
+    //may still be used by the others, deletions are not written at all.
+    void set_shared(std::mutex* _file_mutex) override
+    {
+        file_mutex = _file_mutex;
+        skip_deletes = true;
+    }
+
+    void set_async(const unsigned num_bufs) override
+    {
+        assert(buf_len == 0);
+        if (writer.joinable() || num_bufs < 2) {
+            return;
+        }
+
+        //drup_buf is one of the buffers
+        for(unsigned i = 1; i < num_bufs; i++) {
+            free_bufs.push_back(new unsigned char[2 * 1024 * 1024]);
+        }
+        writer = std::thread(&DratFile::write_loop, this);
+    }
+
+    void write_loop()
+    {
+        std::unique_lock<std::mutex> lock(mu);
+        while(true) {
+            has_work.wait(lock, [this]{return !to_write.empty() || must_stop;});
+            if (to_write.empty()) {
+                break;
+            }
+            std::pair<unsigned char*, int> buf = to_write.front();
+            to_write.pop_front();
+            writing = true;
+
+            lock.unlock();
+            write_to_file(buf.first, buf.second);
+            lock.lock();
+
+            bytes_written += buf.second;
+            writing = false;
+            free_bufs.push_back(buf.first);
+            buf_freed.notify_one();
+        }
+    }
+
+    void stop_writer()
+    {
+        if (!writer.joinable()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            must_stop = true;
+            has_work.notify_one();
+        }
+        writer.join();
+    }
+
+    void add_blocked_time(const std::chrono::steady_clock::time_point start)
+    {
+        const std::chrono::duration<double> d =
+            std::chrono::steady_clock::now() - start;
+        time_blocked += d.count();
+    }
+
+    void print_stats() const override
+    {
+        print_stats_line("c DRAT written"
+            , (double)bytes_written/(1024.0*1024.0)
+            , "MB"
+        );
+        print_stats_line("c DRAT buffer flushes"
+            , num_flushes
+            , num_blocked
+            , "blocked on full"
+        );
+        print_stats_line("c DRAT time blocked"
+            , time_blocked
+            , "s"
+        );
+    }
+
     void setFile(std::ostream* _file) override
     {
         drup_file = _file;
@@ -226,6 +485,10 @@ struct DratFile: public Drat
 
     Drat& operator<<(const Lit lit) override
     {
+        if (skipping_delete) {
+            return *this;
+        }
+
         if (must_delete_next) {
 #ifdef DEBUG_DRAT
             cout << "dLIT ";
@@ -249,6 +512,10 @@ struct DratFile: public Drat
 
     Drat& operator<<(const Clause& cl) override
     {
+        if (skipping_delete) {
+            return *this;
+        }
+
         if (must_delete_next) {
 #ifdef DEBUG_DRAT
             cout << "d ";
@@ -288,6 +555,10 @@ struct DratFile: public Drat
 
     Drat& operator<<(const vector<Lit>& cl) override
     {
+        if (skipping_delete) {
+            return *this;
+        }
+
         if (must_delete_next) {
 #ifdef DEBUG_DRAT
             cout << "d ";
@@ -316,7 +587,9 @@ struct DratFile: public Drat
         switch (flag)
         {
             case DratFlag::fin:
-                if (must_delete_next) {
+                if (skipping_delete) {
+                    skipping_delete = false;
+                } else if (must_delete_next) {
                     *del_ptr++ = 0;
                     del_len++;
                     delete_filled = true;
@@ -352,6 +625,10 @@ struct DratFile: public Drat
 
             case DratFlag::findelay:
                 assert(delete_filled);
+                if (skip_deletes) {
+                    forget_delay();
+                    break;
+                }
                 memcpy(buf_ptr, del_buf, del_len);
                 buf_len += del_len;
                 buf_ptr += del_len;
@@ -380,6 +657,10 @@ struct DratFile: public Drat
                 id_set = false;
                 #endif
                 forget_delay();
+                if (skip_deletes) {
+                    skipping_delete = true;
+                    break;
+                }
                 *buf_ptr++ = 'd';
                 buf_len++;
                 break;
@@ -390,6 +671,28 @@ struct DratFile: public Drat
 
     std::ostream* drup_file = NULL;
     vector<uint32_t>& interToOuterMain;
+
+    //Asynchronous writing
+    std::thread writer;
+    std::mutex mu;
+    std::condition_variable has_work;
+    std::condition_variable buf_freed;
+    std::deque<std::pair<unsigned char*, int> > to_write;
+    vector<unsigned char*> free_bufs;
+    bool writing = false;
+    bool must_stop = false;
+
+    //Shared between solvers
+    std::mutex* file_mutex = NULL;
+    bool skip_deletes = false;
+    bool skipping_delete = false;
+
+    //Stats
+    uint64_t bytes_written = 0;
+    uint64_t num_flushes = 0;
+    uint64_t num_blocked = 0;
+    double time_blocked = 0.0;
+
     #ifdef STATS_NEEDED
     int64_t ID = 0;
     int64_t sumConflicts = std::numeric_limits<int64_t>::max();
@@ -398,6 +701,553 @@ struct DratFile: public Drat
     #endif
 };
 
+/**
+@brief Writes the proof in the text FRAT format
+
+Every clause gets an ID from new_ID(). The IDs of the clauses in the solver
+are kept here, out of the solver's own data structures: units by their
+literal, binary clauses by their literals and longer clauses by their offset
+in the ClauseAllocator. These tables only exist when the proof is written.
+A clause added with an explicit FratID is not kept, the caller deletes or
+finalises it. Added clauses may carry LRAT-style hints: the IDs of the
+clauses that, in order, become unit and finally conflict once the negation
+of the clause is assumed. Every ID ends up deleted or finalised, so the
+checker never has to guess which clause a step refers to.
+*/
+struct FratFile: public Drat
+{
+    FratFile(vector<uint32_t>& _interToOuterMain, ClauseAllocator& _cl_alloc) :
+        interToOuterMain(_interToOuterMain)
+        , cl_alloc(_cl_alloc)
+    {
+    }
+
+    virtual ~FratFile()
+    {
+    }
+
+    bool enabled() override
+    {
+        return true;
+    }
+
+    bool hints_needed() override
+    {
+        return empty_ID == 0;
+    }
+
+    void setFile(std::ostream* _file) override
+    {
+        frat_file = _file;
+    }
+
+    void flush() override
+    {
+        frat_file->write(out.data(), out.size());
+        bytes_written += out.size();
+        out.clear();
+    }
+
+    bool something_delayed() override
+    {
+        return delete_filled;
+    }
+
+    void forget_delay() override
+    {
+        delayed.clear();
+        delayed_ID = 0;
+        delayed_cl = false;
+        delete_filled = false;
+    }
+
+    uint32_t new_ID() override
+    {
+        if (next_ID == std::numeric_limits<uint32_t>::max()) {
+            std::cerr << "ERROR: Ran out of clause IDs for the FRAT proof" << std::endl;
+            std::exit(-1);
+        }
+        return next_ID++;
+    }
+
+    uint32_t add_original(const vector<Lit>& outer_lits) override
+    {
+        cur.clear();
+        for(const Lit l: outer_lits) {
+            cur.push_back(to_int(l, false));
+        }
+        const uint32_t ID = new_ID();
+        emit('o', cur, ID, NULL);
+        return ID;
+    }
+
+    uint32_t unit_ID(const Lit lit) override
+    {
+        return unit_IDs_of(to_outer(lit));
+    }
+
+    uint32_t ID_of(const Clause& cl) override
+    {
+        const auto it = long_IDs.find(cl_alloc.get_offset(&cl));
+        return it == long_IDs.end() ? 0 : it->second;
+    }
+
+    uint32_t bin_ID(const Lit lit1, const Lit lit2) override
+    {
+        const auto it = bin_IDs.find(bin_key(to_outer(lit1), to_outer(lit2)));
+        return it == bin_IDs.end() ? 0 : it->second;
+    }
+
+    void set_ID(const Clause& cl, const uint32_t ID) override
+    {
+        long_IDs[cl_alloc.get_offset(&cl)] = ID;
+    }
+
+    void set_ID(const vector<Lit>& lits, const uint32_t ID) override
+    {
+        if (lits.size() == 1) {
+            uint32_t& unit = unit_IDs_of(to_outer(lits[0]));
+            if (unit == 0) {
+                unit = ID;
+                return;
+            }
+            //Already known by another ID, this one is of no use
+            cur.clear();
+            cur.push_back(to_int(lits[0]));
+            emit('d', cur, ID, NULL);
+        } else {
+            assert(lits.size() == 2);
+            bin_IDs.insert(std::make_pair(
+                bin_key(to_outer(lits[0]), to_outer(lits[1])), ID));
+        }
+    }
+
+    uint32_t release_ID(const Clause& cl) override
+    {
+        const auto it = long_IDs.find(cl_alloc.get_offset(&cl));
+        if (it == long_IDs.end()) {
+            return 0;
+        }
+        const uint32_t ID = it->second;
+        long_IDs.erase(it);
+        return ID;
+    }
+
+    uint32_t release_ID(const Lit lit1, const Lit lit2) override
+    {
+        return take_bin_ID(bin_key(to_outer(lit1), to_outer(lit2)), 0);
+    }
+
+    //Clauses freed without being deleted from the proof are not moved,
+    //they are deleted now, while their literals are still there
+    void clauses_moved() override
+    {
+        std::unordered_map<ClOffset, uint32_t> moved;
+        moved.reserve(long_IDs.size());
+        for(const auto& it: long_IDs) {
+            const Clause* cl = cl_alloc.ptr(it.first);
+            if (cl->reloced) {
+                moved[cl_alloc.moved_to(cl)] = it.second;
+            } else {
+                assert(cl->freed());
+                cur.clear();
+                for(const Lit l: *cl) {
+                    cur.push_back(to_int(l));
+                }
+                emit('d', cur, it.second, NULL);
+            }
+        }
+        long_IDs.swap(moved);
+    }
+
+    void set_hints(const vector<uint32_t>& _hints) override
+    {
+        hints = _hints;
+        hints_set = true;
+    }
+
+    Drat& operator<<(const Lit lit) override
+    {
+        if (state == State::delay) {
+            delayed.push_back(to_int(lit));
+        } else {
+            cur.push_back(to_int(lit));
+        }
+        return *this;
+    }
+
+    Drat& operator<<(const Clause& cl) override
+    {
+        const ClOffset offs = cl_alloc.get_offset(&cl);
+        if (state == State::delay) {
+            if (delayed_ID == 0) {
+                delayed_ID = ID_of(cl);
+            }
+            delayed_cl = true;
+            delayed_offs = offs;
+        } else {
+            cur_cl = true;
+            cur_offs = offs;
+        }
+        for(const Lit l: cl) {
+            *this << l;
+        }
+        return *this;
+    }
+
+    Drat& operator<<(const vector<Lit>& cl) override
+    {
+        for(const Lit l: cl) {
+            *this << l;
+        }
+        return *this;
+    }
+
+    //The first ID given wins
+    Drat& operator<<(const FratID ID) override
+    {
+        if (state == State::delay) {
+            if (delayed_ID == 0) {
+                delayed_ID = ID.ID;
+            }
+        } else if (cur_ID == 0) {
+            cur_ID = ID.ID;
+        }
+        return *this;
+    }
+
+    Drat& operator<<(const DratFlag flag) override
+    {
+        switch (flag)
+        {
+            case DratFlag::fin:
+                if (state == State::add) {
+                    finish_add();
+                } else if (state == State::del) {
+                    delete_cl(cur, cur_ID, cur_cl, cur_offs);
+                } else if (state == State::delay) {
+                    delete_filled = true;
+                }
+                clear_cur();
+                state = State::none;
+                break;
+
+            case DratFlag::deldelay:
+                assert(!delete_filled);
+                forget_delay();
+                state = State::delay;
+                break;
+
+            case DratFlag::findelay:
+                assert(delete_filled);
+                delete_cl(delayed, delayed_ID, delayed_cl, delayed_offs);
+                forget_delay();
+                break;
+
+            case DratFlag::add:
+                clear_cur();
+                state = State::add;
+                break;
+
+            case DratFlag::del:
+                forget_delay();
+                clear_cur();
+                state = State::del;
+                break;
+        }
+
+        return *this;
+    }
+
+    bool must_finalize() override
+    {
+        return empty_ID != 0 && !finalized;
+    }
+
+    void finalize(
+        const uint32_t ID
+        , const vector<Lit>& lits
+        , const bool outer_numbering) override
+    {
+        cur.clear();
+        for(const Lit l: lits) {
+            cur.push_back(to_int(l, !outer_numbering));
+        }
+        emit('f', cur, ID, NULL);
+    }
+
+    void finalize_kept() override
+    {
+        for(uint32_t i = 0; i < unit_IDs.size(); i++) {
+            if (unit_IDs[i] != 0) {
+                cur.clear();
+                cur.push_back(to_int(Lit::toLit(i), false));
+                emit('f', cur, unit_IDs[i], NULL);
+            }
+        }
+        for(const auto& it: bin_IDs) {
+            cur.clear();
+            cur.push_back(to_int(Lit::toLit(it.first >> 32), false));
+            cur.push_back(to_int(Lit::toLit(it.first & 0xffffffffU), false));
+            emit('f', cur, it.second, NULL);
+        }
+        for(const auto& it: long_IDs) {
+            cur.clear();
+            for(const Lit l: *cl_alloc.ptr(it.first)) {
+                cur.push_back(to_int(l));
+            }
+            emit('f', cur, it.second, NULL);
+        }
+        cur.clear();
+        emit('f', cur, empty_ID, NULL);
+        finalized = true;
+        flush();
+    }
+
+    void print_stats() const override
+    {
+        print_stats_line("c FRAT written"
+            , (double)bytes_written/(1024.0*1024.0)
+            , "MB"
+        );
+        print_stats_line("c FRAT lemmas with hints"
+            , num_hinted
+            , stats_line_percent(num_hinted, num_added)
+            , "% of added"
+        );
+    }
+
+private:
+    enum class State {none, add, del, delay};
+
+    int to_int(const Lit l, const bool map = true) const
+    {
+        const uint32_t v = map ? interToOuterMain[l.var()] : l.var();
+        return l.sign() ? -(int)(v+1) : (int)(v+1);
+    }
+
+    Lit to_outer(const Lit l) const
+    {
+        return Lit(interToOuterMain[l.var()], l.sign());
+    }
+
+    uint32_t& unit_IDs_of(const Lit outer_lit)
+    {
+        if (unit_IDs.size() <= outer_lit.toInt()) {
+            unit_IDs.resize(outer_lit.toInt()+2, 0);
+        }
+        return unit_IDs[outer_lit.toInt()];
+    }
+
+    Lit outer_lit_of(const int x) const
+    {
+        return Lit(std::abs(x)-1, x < 0);
+    }
+
+    static uint64_t bin_key(Lit outer1, Lit outer2)
+    {
+        if (outer2 < outer1) {
+            std::swap(outer1, outer2);
+        }
+        return ((uint64_t)outer1.toInt() << 32) | outer2.toInt();
+    }
+
+    //Any copy of the clause, or the one with ID if it's not 0
+    uint32_t take_bin_ID(const uint64_t key, const uint32_t ID)
+    {
+        auto range = bin_IDs.equal_range(key);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (ID == 0 || it->second == ID) {
+                const uint32_t ret = it->second;
+                bin_IDs.erase(it);
+                return ret;
+            }
+        }
+        return 0;
+    }
+
+    void clear_cur()
+    {
+        cur.clear();
+        cur_ID = 0;
+        cur_cl = false;
+    }
+
+    void finish_add()
+    {
+        const vector<uint32_t>* h = NULL;
+        if (hints_set
+            && std::find(hints.begin(), hints.end(), 0U) == hints.end()
+        ) {
+            h = &hints;
+        }
+        hints_set = false;
+
+        //With an explicit ID the caller keeps the clause, see set_ID()
+        const bool keep = (cur_ID == 0);
+        const uint32_t ID = keep ? new_ID() : cur_ID;
+        switch(cur.size()) {
+            case 0:
+                if (cur_cl) {
+                    long_IDs.erase(cur_offs);
+                }
+                //Only the first empty clause is of interest
+                if (empty_ID != 0) {
+                    return;
+                }
+                empty_ID = ID;
+                break;
+
+            case 1: {
+                assert(keep);
+                if (cur_cl) {
+                    long_IDs.erase(cur_offs);
+                }
+                uint32_t& unit = unit_IDs_of(outer_lit_of(cur[0]));
+                if (unit != 0) {
+                    return;
+                }
+                unit = ID;
+                break;
+            }
+
+            case 2:
+                if (keep) {
+                    bin_IDs.insert(std::make_pair(
+                        bin_key(outer_lit_of(cur[0]), outer_lit_of(cur[1])), ID));
+                }
+                //Shrunk in place, the long clause is freed
+                if (cur_cl) {
+                    long_IDs.erase(cur_offs);
+                }
+                break;
+
+            default:
+                if (cur_cl) {
+                    long_IDs[cur_offs] = ID;
+                } else {
+                    //Caller must use set_ID() once it's allocated
+                    assert(!keep);
+                }
+                break;
+        }
+
+        num_added++;
+        if (h) {
+            num_hinted++;
+        }
+        emit('a', cur, ID, h);
+    }
+
+    //Units stay until the end, unless the very clause that gave the unit
+    //is deleted
+    void delete_cl(
+        const vector<int>& cl
+        , uint32_t ID
+        , const bool is_cl
+        , const ClOffset offs
+    ) {
+        switch(cl.size()) {
+            case 0:
+                return;
+
+            case 1: {
+                if (ID == 0) {
+                    return;
+                }
+                uint32_t& unit = unit_IDs_of(outer_lit_of(cl[0]));
+                if (unit == ID) {
+                    unit = 0;
+                }
+                break;
+            }
+
+            case 2: {
+                const uint32_t kept = take_bin_ID(
+                    bin_key(outer_lit_of(cl[0]), outer_lit_of(cl[1])), ID);
+                if (ID == 0) {
+                    ID = kept;
+                }
+                break;
+            }
+
+            default:
+                if (is_cl) {
+                    const auto it = long_IDs.find(offs);
+                    if (it != long_IDs.end() && (ID == 0 || it->second == ID)) {
+                        ID = it->second;
+                        long_IDs.erase(it);
+                    }
+                }
+                break;
+        }
+        //Every clause of the proof is known by its ID
+        assert(ID != 0);
+        emit('d', cl, ID, NULL);
+    }
+
+    void emit(
+        const char type
+        , const vector<int>& cl
+        , const uint32_t ID
+        , const vector<uint32_t>* h
+    ) {
+        out += type;
+        out += ' ';
+        out += std::to_string(ID);
+        for(const int x: cl) {
+            out += ' ';
+            out += std::to_string(x);
+        }
+        out += " 0";
+        if (h) {
+            out += " l";
+            for(const uint32_t x: *h) {
+                out += ' ';
+                out += std::to_string(x);
+            }
+            out += " 0";
+        }
+        out += '\n';
+        if (out.size() > 1048576) {
+            flush();
+        }
+    }
+
+    std::ostream* frat_file = NULL;
+    vector<uint32_t>& interToOuterMain;
+    ClauseAllocator& cl_alloc;
+    uint32_t next_ID = 1;
+    std::string out;
+
+    //IDs of the clauses in the solver. Units and binary clauses by their
+    //literals in outer numbering, the others by their offset
+    vector<uint32_t> unit_IDs;
+    std::unordered_multimap<uint64_t, uint32_t> bin_IDs;
+    std::unordered_map<ClOffset, uint32_t> long_IDs;
+    uint32_t empty_ID = 0;
+    bool finalized = false;
+
+    State state = State::none;
+    vector<int> cur;
+    uint32_t cur_ID = 0;
+    bool cur_cl = false;
+    ClOffset cur_offs = 0;
+    vector<int> delayed;
+    uint32_t delayed_ID = 0;
+    bool delayed_cl = false;
+    ClOffset delayed_offs = 0;
+    bool delete_filled = false;
+
+    vector<uint32_t> hints;
+    bool hints_set = false;
+
+    //Stats
+    uint64_t bytes_written = 0;
+    uint64_t num_added = 0;
+    uint64_t num_hinted = 0;
+};
+
 }
 
 #endif //__DRAT_H__
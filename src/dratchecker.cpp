@@ -0,0 +1,625 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "dratchecker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+using namespace CMSat;
+using std::vector;
+
+static const uint32_t no_reason = std::numeric_limits<uint32_t>::max();
+
+//Steps are handed over to the checker once a buffer holds this many words
+static const size_t step_buf_size = 1ULL << 18;
+
+DratChecker::DratChecker(vector<uint32_t>& _interToOuterMain, const unsigned num_bufs) :
+    interToOuterMain(_interToOuterMain)
+    , max_bufs(std::max(1U, num_bufs))
+{
+    buf.reserve(step_buf_size + 1024);
+    checker_thread = std::thread(&DratChecker::check_loop, this);
+}
+
+DratChecker::~DratChecker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        stop = true;
+    }
+    work_cond.notify_one();
+    checker_thread.join();
+}
+
+/////////////////////////
+// Solving thread
+/////////////////////////
+
+void DratChecker::start_step(const StepType type)
+{
+    step_at = buf.size();
+    buf.push_back(type);
+}
+
+void DratChecker::end_step()
+{
+    buf[step_at] |= (uint32_t)(buf.size() - step_at - 1) << 2;
+    if (buf.size() >= step_buf_size) {
+        hand_over();
+    }
+}
+
+uint32_t DratChecker::add_original(const vector<Lit>& outer_lits)
+{
+    start_step(step_orig);
+    for(const Lit l: outer_lits) {
+        buf.push_back(l.toInt());
+    }
+    end_step();
+    return 0;
+}
+
+Drat& DratChecker::operator<<(const Lit lit)
+{
+    const uint32_t outer = Lit(interToOuterMain[lit.var()], lit.sign()).toInt();
+    if (state == State::delay) {
+        delayed.push_back(outer);
+    } else if (state != State::none) {
+        buf.push_back(outer);
+    }
+    return *this;
+}
+
+Drat& DratChecker::operator<<(const Clause& cl)
+{
+    for(const Lit l: cl) {
+        *this << l;
+    }
+    return *this;
+}
+
+Drat& DratChecker::operator<<(const vector<Lit>& cl)
+{
+    for(const Lit l: cl) {
+        *this << l;
+    }
+    return *this;
+}
+
+Drat& DratChecker::operator<<(const DratFlag flag)
+{
+    switch (flag)
+    {
+        case DratFlag::fin:
+            if (state == State::add || state == State::del) {
+                end_step();
+            } else if (state == State::delay) {
+                delete_filled = true;
+            }
+            state = State::none;
+            break;
+
+        case DratFlag::deldelay:
+            assert(!delete_filled);
+            forget_delay();
+            state = State::delay;
+            break;
+
+        case DratFlag::findelay:
+            assert(delete_filled);
+            start_step(step_del);
+            buf.insert(buf.end(), delayed.begin(), delayed.end());
+            end_step();
+            forget_delay();
+            break;
+
+        case DratFlag::add:
+            start_step(step_add);
+            state = State::add;
+            break;
+
+        case DratFlag::del:
+            forget_delay();
+            start_step(step_del);
+            state = State::del;
+            break;
+    }
+
+    return *this;
+}
+
+void DratChecker::hand_over()
+{
+    if (buf.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mu);
+    if (to_check.size() >= max_bufs) {
+        num_blocked++;
+        const auto start = std::chrono::steady_clock::now();
+        done_cond.wait(lock, [&]{return to_check.size() < max_bufs;});
+        time_blocked += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+    to_check.push_back(std::move(buf));
+    if (!free_bufs.empty()) {
+        buf = std::move(free_bufs.back());
+        free_bufs.pop_back();
+    } else {
+        buf = vector<uint32_t>();
+        buf.reserve(step_buf_size + 1024);
+    }
+    lock.unlock();
+    work_cond.notify_one();
+}
+
+void DratChecker::flush()
+{
+    hand_over();
+}
+
+lbool DratChecker::verify_unsat()
+{
+    hand_over();
+    std::unique_lock<std::mutex> lock(mu);
+    done_cond.wait(lock, [&]{return to_check.empty() && !checking;});
+    return (refuted_shown && stats_shown.failed == 0) ? l_True : l_False;
+}
+
+void DratChecker::print_stats() const
+{
+    Stats s;
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        s = stats_shown;
+    }
+    print_stats_line("c DRAT check lemmas RUP"
+        , s.rup
+    );
+    print_stats_line("c DRAT check lemmas RAT"
+        , s.rat
+    );
+    print_stats_line("c DRAT check failed lemmas"
+        , s.failed
+        , s.first_failed
+        , "first failed"
+    );
+    print_stats_line("c DRAT check deletes ignored"
+        , s.del_reason + s.del_unknown
+        , stats_line_percent(s.del_reason + s.del_unknown, s.del)
+        , "% of deletes"
+    );
+    print_stats_line("c DRAT check time"
+        , s.check_time
+        , "s"
+    );
+    print_stats_line("c DRAT check garbage collections"
+        , s.gc
+    );
+    print_stats_line("c DRAT check props"
+        , s.props
+        , ratio_for_stat(s.props, s.check_time)
+        , "per sec"
+    );
+    print_stats_line("c DRAT check solver blocked"
+        , num_blocked
+        , time_blocked
+        , "s"
+    );
+}
+
+/////////////////////////
+// Checker thread
+/////////////////////////
+
+void DratChecker::check_loop()
+{
+    std::unique_lock<std::mutex> lock(mu);
+    while(true) {
+        work_cond.wait(lock, [&]{return stop || !to_check.empty();});
+        if (stop) {
+            return;
+        }
+
+        vector<uint32_t> steps = std::move(to_check.front());
+        to_check.pop_front();
+        checking = true;
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        check_steps(steps);
+        stats.check_time += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        steps.clear();
+
+        lock.lock();
+        free_bufs.push_back(std::move(steps));
+        stats_shown = stats;
+        refuted_shown = refuted;
+        checking = false;
+        done_cond.notify_all();
+    }
+}
+
+void DratChecker::check_steps(const vector<uint32_t>& steps)
+{
+    size_t at = 0;
+    while(at < steps.size()) {
+        const uint32_t type = steps[at] & 3;
+        const uint32_t size = steps[at] >> 2;
+        const uint32_t* lits = steps.data() + at + 1;
+        switch(type) {
+            case step_orig:
+                add_clause(lits, size, true);
+                break;
+
+            case step_add:
+                add_clause(lits, size, false);
+                break;
+
+            case step_del:
+                del_clause(lits, size);
+                break;
+
+            default:
+                assert(false);
+        }
+        at += 1 + size;
+    }
+}
+
+void DratChecker::new_vars(const uint32_t lit)
+{
+    if ((lit | 1) < vals.size()) {
+        return;
+    }
+    const size_t num_vars = (lit >> 1) + 1;
+    vals.resize(num_vars*2, 0);
+    watches.resize(num_vars*2);
+    reasons.resize(num_vars, no_reason);
+}
+
+//Sorted and without duplicates into cl_tmp. Returns false for tautologies
+bool DratChecker::normalise(const uint32_t* lits, const uint32_t size)
+{
+    cl_tmp.assign(lits, lits + size);
+    std::sort(cl_tmp.begin(), cl_tmp.end());
+    cl_tmp.erase(std::unique(cl_tmp.begin(), cl_tmp.end()), cl_tmp.end());
+    for(size_t i = 1; i < cl_tmp.size(); i++) {
+        if (cl_tmp[i] == (cl_tmp[i-1] ^ 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t DratChecker::hash_of(const vector<uint32_t>& cl) const
+{
+    uint64_t h = 14695981039346656037ULL;
+    for(const uint32_t l: cl) {
+        h ^= l;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void DratChecker::add_clause(const uint32_t* lits, const uint32_t size, const bool orig)
+{
+    for(uint32_t i = 0; i < size; i++) {
+        new_vars(lits[i]);
+    }
+
+    //Everything follows from the empty clause
+    if (refuted || !normalise(lits, size)) {
+        if (orig) {
+            stats.orig++;
+        } else {
+            stats.rup++;
+        }
+        return;
+    }
+
+    if (orig) {
+        stats.orig++;
+    } else if (is_rup(cl_tmp)) {
+        stats.rup++;
+    } else if (size > 0 && is_rat(lits[0])) {
+        stats.rat++;
+    } else {
+        stats.failed++;
+        if (stats.first_failed == 0) {
+            stats.first_failed = stats.rup + stats.rat + stats.failed;
+        }
+    }
+    store_clause();
+}
+
+void DratChecker::store_clause()
+{
+    const uint32_t ref = arena.size();
+    const uint32_t size = cl_tmp.size();
+    by_hash[hash_of(cl_tmp)].push_back(ref);
+    arena.push_back(size);
+    arena.push_back(0);
+    arena.insert(arena.end(), cl_tmp.begin(), cl_tmp.end());
+
+    //Watch the literals that are not false at the top level, if possible
+    uint32_t* lits = &arena[ref+2];
+    uint32_t non_false = 0;
+    for(uint32_t i = 0; i < size && non_false < 2; i++) {
+        if (value(lits[i]) != -1) {
+            std::swap(lits[non_false], lits[i]);
+            non_false++;
+        }
+    }
+    if (size >= 2) {
+        watches[lits[0]].push_back(ref);
+        watches[lits[1]].push_back(ref);
+    }
+
+    if (non_false == 0) {
+        refuted = true;
+    } else if (non_false == 1 && value(lits[0]) == 0) {
+        enqueue(lits[0], ref);
+        if (!propagate()) {
+            refuted = true;
+        }
+    }
+}
+
+uint32_t DratChecker::find_clause()
+{
+    auto it = by_hash.find(hash_of(cl_tmp));
+    if (it == by_hash.end()) {
+        return no_reason;
+    }
+    for(const uint32_t ref: it->second) {
+        if (arena[ref] != cl_tmp.size()) {
+            continue;
+        }
+        rat_tmp.assign(arena.begin() + ref + 2, arena.begin() + ref + 2 + arena[ref]);
+        std::sort(rat_tmp.begin(), rat_tmp.end());
+        if (rat_tmp == cl_tmp) {
+            return ref;
+        }
+    }
+    return no_reason;
+}
+
+void DratChecker::del_clause(const uint32_t* lits, const uint32_t size)
+{
+    stats.del++;
+    if (refuted) {
+        return;
+    }
+
+    uint32_t ref = no_reason;
+    if (normalise(lits, size)) {
+        ref = find_clause();
+    }
+    if (ref == no_reason) {
+        stats.del_unknown++;
+        return;
+    }
+
+    for(uint32_t i = 0; i < arena[ref]; i++) {
+        const uint32_t l = arena[ref+2+i];
+        if (value(l) == 1 && reasons[l>>1] == ref) {
+            stats.del_reason++;
+            return;
+        }
+    }
+
+    arena[ref+1] = 1;
+    wasted += arena[ref] + 2;
+    auto it = by_hash.find(hash_of(cl_tmp));
+    vector<uint32_t>& refs = it->second;
+    refs.erase(std::find(refs.begin(), refs.end(), ref));
+    if (refs.empty()) {
+        by_hash.erase(it);
+    }
+
+    if (wasted > (1ULL << 20) && wasted*2 > arena.size()) {
+        collect_garbage();
+    }
+}
+
+void DratChecker::enqueue(const uint32_t lit, const uint32_t reason)
+{
+    vals[lit] = 1;
+    vals[lit^1] = -1;
+    reasons[lit>>1] = reason;
+    trail.push_back(lit);
+}
+
+void DratChecker::backtrack(const size_t new_trail_size)
+{
+    for(size_t i = new_trail_size; i < trail.size(); i++) {
+        const uint32_t lit = trail[i];
+        vals[lit] = 0;
+        vals[lit^1] = 0;
+        reasons[lit>>1] = no_reason;
+    }
+    trail.resize(new_trail_size);
+    qhead = new_trail_size;
+}
+
+//Returns false on conflict. Deleted clauses are dropped from the watchlists
+bool DratChecker::propagate()
+{
+    while(qhead < trail.size()) {
+        const uint32_t false_lit = trail[qhead] ^ 1;
+        qhead++;
+        stats.props++;
+
+        vector<uint32_t>& ws = watches[false_lit];
+        size_t i = 0;
+        size_t j = 0;
+        for(; i < ws.size(); i++) {
+            const uint32_t ref = ws[i];
+            if (arena[ref+1]) {
+                continue;
+            }
+            const uint32_t size = arena[ref];
+            uint32_t* lits = &arena[ref+2];
+            if (lits[0] == false_lit) {
+                std::swap(lits[0], lits[1]);
+            }
+            if (value(lits[0]) == 1) {
+                ws[j++] = ref;
+                continue;
+            }
+
+            bool found = false;
+            for(uint32_t k = 2; k < size; k++) {
+                if (value(lits[k]) != -1) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1]].push_back(ref);
+                    found = true;
+                    break;
+                }
+            }
+            if (found) {
+                continue;
+            }
+
+            ws[j++] = ref;
+            if (value(lits[0]) == -1) {
+                for(i++; i < ws.size(); i++) {
+                    ws[j++] = ws[i];
+                }
+                ws.resize(j);
+                return false;
+            }
+            enqueue(lits[0], ref);
+        }
+        ws.resize(j);
+    }
+    return true;
+}
+
+//The top level is fully propagated, so only the negation of the clause
+//needs to be propagated on top of it
+bool DratChecker::is_rup(const vector<uint32_t>& cl)
+{
+    const size_t top_level = trail.size();
+    bool confl = false;
+    for(const uint32_t l: cl) {
+        if (value(l) == 1) {
+            confl = true;
+            break;
+        }
+        if (value(l) == 0) {
+            enqueue(l^1, no_reason);
+        }
+    }
+    if (!confl) {
+        confl = !propagate();
+    }
+    backtrack(top_level);
+    return confl;
+}
+
+//Every resolvent on the pivot must be RUP. Goes through the whole
+//database, but RAT lemmas are rare
+bool DratChecker::is_rat(const uint32_t pivot)
+{
+    const uint32_t neg = pivot ^ 1;
+    const vector<uint32_t> lemma = cl_tmp;
+    vector<uint32_t> resolvent;
+    for(uint32_t ref = 0; ref < arena.size(); ref += arena[ref] + 2) {
+        const uint32_t size = arena[ref];
+        if (arena[ref+1]) {
+            continue;
+        }
+        const uint32_t* lits = &arena[ref+2];
+        if (std::find(lits, lits + size, neg) == lits + size) {
+            continue;
+        }
+
+        resolvent = lemma;
+        for(uint32_t i = 0; i < size; i++) {
+            if (lits[i] != neg) {
+                resolvent.push_back(lits[i]);
+            }
+        }
+        std::sort(resolvent.begin(), resolvent.end());
+        resolvent.erase(std::unique(resolvent.begin(), resolvent.end()), resolvent.end());
+        bool tautology = false;
+        for(size_t i = 1; i < resolvent.size(); i++) {
+            if (resolvent[i] == (resolvent[i-1] ^ 1)) {
+                tautology = true;
+                break;
+            }
+        }
+        if (!tautology && !is_rup(resolvent)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DratChecker::collect_garbage()
+{
+    stats.gc++;
+    vector<uint32_t> new_arena;
+    new_arena.reserve(arena.size() - wasted);
+    for(uint32_t ref = 0; ref < arena.size(); ref += arena[ref] + 2) {
+        const uint32_t size = arena[ref];
+        if (arena[ref+1]) {
+            continue;
+        }
+        const uint32_t new_ref = new_arena.size();
+        new_arena.insert(new_arena.end()
+            , arena.begin() + ref, arena.begin() + ref + 2 + size);
+
+        //Forwarding address, distinct from the deleted marker
+        arena[ref+1] = new_ref + 2;
+    }
+
+    //Reasons are never deleted
+    for(uint32_t& r: reasons) {
+        if (r != no_reason) {
+            r = arena[r+1] - 2;
+        }
+    }
+    for(auto& it: by_hash) {
+        for(uint32_t& r: it.second) {
+            r = arena[r+1] - 2;
+        }
+    }
+
+    arena.swap(new_arena);
+    wasted = 0;
+    for(auto& ws: watches) {
+        ws.clear();
+    }
+    for(uint32_t ref = 0; ref < arena.size(); ref += arena[ref] + 2) {
+        if (arena[ref] >= 2) {
+            watches[arena[ref+2]].push_back(ref);
+            watches[arena[ref+3]].push_back(ref);
+        }
+    }
+}
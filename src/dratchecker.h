@@ -0,0 +1,167 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __DRATCHECKER_H__
+#define __DRATCHECKER_H__
+
+#include "drat.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace CMSat {
+
+/**
+@brief Checks the proof while it is being produced, instead of writing it out
+
+The steps are encoded into buffers that are handed over to a separate thread.
+That thread keeps its own copy of the clause database with its own watches,
+and checks every added clause to be RUP or, failing that, RAT on its first
+literal. As in drat-trim, deleting the reason of a top-level literal is
+ignored. The verdict is available once the solver has finished, through
+verify_unsat().
+*/
+class DratChecker: public Drat
+{
+public:
+    DratChecker(vector<uint32_t>& interToOuterMain, const unsigned num_bufs);
+    ~DratChecker() override;
+
+    bool enabled() override
+    {
+        return true;
+    }
+
+    bool something_delayed() override
+    {
+        return delete_filled;
+    }
+
+    void forget_delay() override
+    {
+        delayed.clear();
+        delete_filled = false;
+    }
+
+    uint32_t add_original(const vector<Lit>& outer_lits) override;
+    Drat& operator<<(const Lit lit) override;
+    Drat& operator<<(const Clause& cl) override;
+    Drat& operator<<(const vector<Lit>& cl) override;
+    Drat& operator<<(const DratFlag flag) override;
+    void flush() override;
+    lbool verify_unsat() override;
+    void print_stats() const override;
+
+private:
+    //Solving thread: steps are put into buf as a header of (size<<2)|type
+    //followed by the literals in outer numbering
+    enum class State {none, add, del, delay};
+    enum StepType {step_orig = 0, step_add = 1, step_del = 2};
+    void start_step(const StepType type);
+    void end_step();
+    void hand_over();
+
+    vector<uint32_t>& interToOuterMain;
+    vector<uint32_t> buf;
+    size_t step_at = 0;
+    State state = State::none;
+    vector<uint32_t> delayed;
+    bool delete_filled = false;
+
+    //Handing over buffers between the threads
+    void check_loop();
+    std::thread checker_thread;
+    mutable std::mutex mu;
+    std::condition_variable work_cond;
+    std::condition_variable done_cond;
+    std::deque<vector<uint32_t> > to_check;
+    vector<vector<uint32_t> > free_bufs;
+    const size_t max_bufs;
+    bool checking = false;
+    bool stop = false;
+
+    //Checker thread
+    void check_steps(const vector<uint32_t>& steps);
+    void add_clause(const uint32_t* lits, const uint32_t size, const bool orig);
+    void del_clause(const uint32_t* lits, const uint32_t size);
+    bool normalise(const uint32_t* lits, const uint32_t size);
+    bool is_rup(const vector<uint32_t>& cl);
+    bool is_rat(const uint32_t pivot);
+    void store_clause();
+    uint32_t find_clause();
+    bool propagate();
+    void enqueue(const uint32_t lit, const uint32_t reason);
+    void backtrack(const size_t new_trail_size);
+    void new_vars(const uint32_t lit);
+    void collect_garbage();
+    uint64_t hash_of(const vector<uint32_t>& cl) const;
+
+    int8_t value(const uint32_t lit) const
+    {
+        return vals[lit];
+    }
+
+    //Clauses are stored as: size, deleted flag, literals
+    vector<uint32_t> arena;
+    uint64_t wasted = 0;
+    vector<vector<uint32_t> > watches;
+    std::unordered_map<uint64_t, vector<uint32_t> > by_hash;
+    vector<int8_t> vals;
+    vector<uint32_t> reasons;
+    vector<uint32_t> trail;
+    size_t qhead = 0;
+    bool refuted = false;
+    vector<uint32_t> cl_tmp;
+    vector<uint32_t> rat_tmp;
+
+    struct Stats
+    {
+        uint64_t orig = 0;
+        uint64_t rup = 0;
+        uint64_t rat = 0;
+        uint64_t failed = 0;
+        uint64_t first_failed = 0;
+        uint64_t del = 0;
+        uint64_t del_reason = 0;
+        uint64_t del_unknown = 0;
+        uint64_t props = 0;
+        uint64_t gc = 0;
+        double check_time = 0;
+    };
+    //Updated by the checker thread, copied to stats_shown under mu
+    //after every buffer
+    Stats stats;
+    Stats stats_shown;
+    bool refuted_shown = false;
+
+    //Solving thread
+    uint64_t num_blocked = 0;
+    double time_blocked = 0;
+};
+
+}
+
+#endif //__DRATCHECKER_H__
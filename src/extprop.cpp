@@ -0,0 +1,564 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "extprop.h"
+#include "solver.h"
+#include "varreplacer.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace CMSat;
+using std::cout;
+using std::endl;
+
+ExtProp::ExtProp(Solver* _solver, ExternalPropagator* _prop) :
+    solver(_solver)
+    , prop(_prop)
+{
+}
+
+void ExtProp::add_observed_var(const uint32_t outside_var)
+{
+    assert(solver->decisionLevel() == 0);
+    if (outside_var >= observed.size()) {
+        observed.resize(outside_var+1, 0);
+    }
+    if (!observed[outside_var]) {
+        observed[outside_var] = 1;
+        num_observed++;
+    }
+    update_vars();
+}
+
+void ExtProp::remove_observed_var(const uint32_t outside_var)
+{
+    assert(solver->decisionLevel() == 0);
+    if (outside_var < observed.size() && observed[outside_var]) {
+        observed[outside_var] = 0;
+        num_observed--;
+    }
+    update_vars();
+}
+
+void ExtProp::reset_observed_vars()
+{
+    assert(solver->decisionLevel() == 0);
+    observed.clear();
+    num_observed = 0;
+    update_vars();
+}
+
+void ExtProp::mark_observed(vector<bool>& marks) const
+{
+    for(const auto& o: obs) {
+        if (o.first < marks.size()) {
+            marks[o.first] = true;
+        }
+    }
+}
+
+void ExtProp::update_vars()
+{
+    obs_inter.assign(observed.size(), lit_Undef);
+    obs.clear();
+    for(uint32_t var = 0; var < observed.size(); var++) {
+        if (!observed[var]) {
+            continue;
+        }
+        Lit lit = Lit(solver->map_to_with_bva(var), false);
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        obs_inter[var] = lit;
+        obs.push_back(std::make_pair(lit.var(), Lit(var, lit.sign())));
+    }
+    std::sort(obs.begin(), obs.end());
+
+    obs_at.assign(solver->nVarsOuter(), var_Undef);
+    for(uint32_t i = 0; i < obs.size(); i++) {
+        if (obs_at[obs[i].first] == var_Undef) {
+            obs_at[obs[i].first] = i;
+        }
+    }
+    reason_lit.resize(solver->nVarsOuter(), lit_Undef);
+}
+
+Lit ExtProp::to_inter(const Lit outside_lit) const
+{
+    if (outside_lit.var() >= obs_inter.size()
+        || obs_inter[outside_lit.var()] == lit_Undef
+    ) {
+        std::cerr
+        << "ERROR: The external propagator used variable "
+        << outside_lit.var() + 1
+        << " that is not observed"
+        << endl;
+        std::exit(-1);
+    }
+    return obs_inter[outside_lit.var()] ^ outside_lit.sign();
+}
+
+void ExtProp::to_inter(vector<Lit>& lits) const
+{
+    for(Lit& lit: lits) {
+        lit = to_inter(lit);
+    }
+}
+
+void ExtProp::notify_assignments()
+{
+    const vector<Trail>& trail = solver->trail;
+    const vector<uint32_t>& trail_lim = solver->trail_lim;
+    tmp_outside.clear();
+    for(; notified < trail.size(); notified++) {
+        while(level < trail_lim.size() && trail_lim[level] <= notified) {
+            if (!tmp_outside.empty()) {
+                prop->notify_assignment(tmp_outside);
+                tmp_outside.clear();
+            }
+            prop->notify_new_decision_level();
+            level++;
+        }
+
+        const Lit lit = trail[notified].lit;
+        if (lit.var() >= obs_at.size() || obs_at[lit.var()] == var_Undef) {
+            continue;
+        }
+        for(uint32_t i = obs_at[lit.var()]
+            ; i < obs.size() && obs[i].first == lit.var()
+            ; i++
+        ) {
+            tmp_outside.push_back(obs[i].second ^ lit.sign());
+        }
+    }
+    if (!tmp_outside.empty()) {
+        prop->notify_assignment(tmp_outside);
+        tmp_outside.clear();
+    }
+
+    //Levels without assignments, such as satisfied assumptions
+    for(; level < trail_lim.size(); level++) {
+        prop->notify_new_decision_level();
+    }
+}
+
+void ExtProp::backtrack(const uint32_t blevel)
+{
+    if (level > blevel) {
+        prop->notify_backtrack(blevel);
+        level = blevel;
+    }
+
+    const uint32_t trail_at = solver->trail_lim[blevel];
+    notified = std::min(notified, trail_at);
+    while(!pending.empty() && pending.back().second >= trail_at) {
+        const uint32_t var = pending.back().first;
+        if (reason_lit[var] != lit_Undef) {
+            reason_lit[var] = lit_Undef;
+            num_unexplained--;
+        }
+        pending.pop_back();
+    }
+}
+
+/**
+@brief Adds the propagator's clauses and propagations to the trail
+
+@returns l_False if UNSAT, l_True if the trail changed or confl got set,
+         l_Undef if there was nothing to do
+*/
+lbool ExtProp::propagate(PropBy& confl)
+{
+    assert(confl.isNULL());
+    lbool ret = l_Undef;
+
+    //Reasons that turned out to be units. Their vars look set at level 0,
+    //but they are still on the trail where they were propagated
+    if (!units.empty()) {
+        solver->cancelUntil(0);
+        for(const Lit unit: units) {
+            const Lit lit = to_inter(unit);
+            if (solver->value(lit) == l_False) {
+                solver->ok = false;
+                return l_False;
+            }
+            if (solver->value(lit) == l_Undef) {
+                solver->enqueue<false>(lit, 0, PropBy());
+            }
+        }
+        units.clear();
+        return l_True;
+    }
+
+    notify_assignments();
+
+    //Clauses first, they may backtrack
+    bool forgettable = false;
+    tmp_outside.clear();
+    while(prop->cb_add_external_clause(tmp_outside, forgettable)) {
+        model_rejected = false;
+        num_clauses++;
+        tmp = tmp_outside;
+        to_inter(tmp);
+        ret = add_clause(tmp, forgettable, confl);
+        if (ret != l_Undef) {
+            return ret;
+        }
+        tmp_outside.clear();
+        forgettable = false;
+    }
+    if (model_rejected) {
+        std::cerr
+        << "ERROR: The external propagator rejected a model"
+        << " without adding a clause"
+        << endl;
+        std::exit(-1);
+    }
+
+    Lit lit;
+    while((lit = prop->cb_propagate()) != lit_Undef) {
+        const Lit inter = to_inter(lit);
+        const lbool val = solver->value(inter);
+        if (val == l_True) {
+            continue;
+        }
+        num_props++;
+
+        if (val == l_Undef) {
+            const uint32_t lev = solver->decisionLevel();
+            solver->enqueue<false>(inter, lev, PropBy());
+            if (lev > 0) {
+                reason_lit[inter.var()] = lit;
+                pending.push_back(std::make_pair(inter.var(), solver->trail.size()-1));
+                num_unexplained++;
+            }
+            ret = l_True;
+            continue;
+        }
+
+        //Propagated a false literal, its reason is in conflict
+        num_reasons++;
+        tmp_outside.clear();
+        prop->cb_add_reason_clause(lit, tmp_outside);
+        tmp = tmp_outside;
+        to_inter(tmp);
+        if (std::find(tmp.begin(), tmp.end(), inter) == tmp.end()) {
+            std::cerr
+            << "ERROR: The reason clause of propagated literal "
+            << lit << " does not contain it"
+            << endl;
+            std::exit(-1);
+        }
+        const lbool confl_ret = add_clause(tmp, true, confl);
+        return confl_ret == l_Undef ? ret : confl_ret;
+    }
+
+    return ret;
+}
+
+/**
+@brief Adds a clause during search, at whatever decision level it is
+
+Backtracks, as needed, to where it propagates or is in conflict. When in
+conflict, confl is set, and the two watched literals are from the current
+decision level, as conflict analysis expects.
+*/
+lbool ExtProp::add_clause(vector<Lit>& lits, const bool red, PropBy& confl)
+{
+    std::sort(lits.begin(), lits.end());
+    Lit prev = lit_Undef;
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < lits.size(); i++) {
+        const Lit lit = lits[i];
+        if (lit == prev) {
+            continue;
+        }
+        if (lit == ~prev) {
+            return l_Undef;
+        }
+        prev = lit;
+        const lbool val = solver->value(lit);
+        if (val != l_Undef && solver->varData[lit.var()].level == 0) {
+            if (val == l_True) {
+                return l_Undef;
+            }
+            continue;
+        }
+        lits[j++] = lit;
+    }
+    lits.resize(j);
+
+    if (lits.empty()) {
+        solver->ok = false;
+        return l_False;
+    }
+    if (lits.size() == 1) {
+        solver->cancelUntil(0);
+        solver->enqueue<false>(lits[0], 0, PropBy());
+        return l_True;
+    }
+
+    //Unassigned and true literals first, then false ones by level
+    const auto rank = [&](const Lit lit) -> uint32_t {
+        if (solver->value(lit) != l_False) {
+            return std::numeric_limits<uint32_t>::max();
+        }
+        return solver->varData[lit.var()].level;
+    };
+    std::sort(lits.begin(), lits.end(), [&](const Lit a, const Lit b) {
+        return rank(a) > rank(b);
+    });
+
+    const lbool val0 = solver->value(lits[0]);
+    const uint32_t level0 = solver->varData[lits[0].var()].level;
+    const uint32_t level1 = solver->varData[lits[1].var()].level;
+    if (solver->value(lits[1]) != l_False
+        || (val0 == l_True && level0 <= level1)
+    ) {
+        attach(lits, red);
+        return l_Undef;
+    }
+
+    if (val0 == l_False && level0 == level1) {
+        solver->cancelUntil(level0);
+        confl = attach(lits, red);
+        if (lits.size() == 2) {
+            solver->failBinLit = lits[0];
+        }
+        return l_True;
+    }
+
+    //Propagates lits[0] at the level of lits[1]
+    solver->cancelUntil(level1);
+    const PropBy by = attach(lits, red);
+    solver->enqueue<false>(lits[0], solver->decisionLevel(), by);
+    return l_True;
+}
+
+PropBy ExtProp::attach(const vector<Lit>& lits, const bool red)
+{
+    if (lits.size() == 2) {
+        solver->attach_bin_clause(lits[0], lits[1], red, false);
+        return PropBy(lits[1], red);
+    }
+
+    Clause* cl = solver->cl_alloc.Clause_new(lits
+        , solver->sumConflicts
+        #ifdef STATS_NEEDED
+        , 0
+        #endif
+    );
+    const ClOffset offset = solver->cl_alloc.get_offset(cl);
+    if (red) {
+        cl->makeRed(solver->sumConflicts);
+        cl->stats.glue = cl->size();
+        cl->stats.activity = 0.0f;
+        cl->stats.which_red_array = 2;
+        solver->longRedCls[2].push_back(offset);
+    } else {
+        solver->longIrredCls.push_back(offset);
+    }
+    solver->attachClause(*cl, false);
+    return PropBy(offset);
+}
+
+void ExtProp::explain(const PropBy confl)
+{
+    if (num_unexplained == 0) {
+        return;
+    }
+
+    switch(confl.getType()) {
+        case PropByType::clause_t: {
+            const Clause& cl = *solver->cl_alloc.ptr(confl.get_offset());
+            for(const Lit lit: cl) {
+                stack.push_back(lit.var());
+            }
+            break;
+        }
+
+        case PropByType::binary_t:
+            stack.push_back(solver->failBinLit.var());
+            stack.push_back(confl.lit2().var());
+            break;
+
+        default:
+            assert(false && "Gauss is off with an external propagator");
+            return;
+    }
+    explain_cone();
+}
+
+void ExtProp::explain(const Lit lit)
+{
+    if (num_unexplained == 0) {
+        return;
+    }
+    stack.push_back(lit.var());
+    explain_cone();
+}
+
+//Asks for the reasons of the propagator's literals that conflict analysis
+//can reach from the vars on the stack
+void ExtProp::explain_cone()
+{
+    vector<uint16_t>& seen = solver->seen;
+    visited.clear();
+    for(const uint32_t var: stack) {
+        seen[var] = 1;
+        visited.push_back(var);
+    }
+
+    while(!stack.empty() && num_unexplained > 0) {
+        const uint32_t var = stack.back();
+        stack.pop_back();
+        if (solver->varData[var].level == 0) {
+            continue;
+        }
+        if (var < reason_lit.size() && reason_lit[var] != lit_Undef) {
+            explain_var(var);
+        }
+
+        const PropBy by = solver->varData[var].reason;
+        const auto push = [&](const uint32_t v) {
+            if (!seen[v]) {
+                seen[v] = 1;
+                visited.push_back(v);
+                stack.push_back(v);
+            }
+        };
+        switch(by.getType()) {
+            case PropByType::clause_t: {
+                const Clause& cl = *solver->cl_alloc.ptr(by.get_offset());
+                for(const Lit lit: cl) {
+                    push(lit.var());
+                }
+                break;
+            }
+
+            case PropByType::binary_t:
+                push(by.lit2().var());
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    for(const uint32_t var: visited) {
+        seen[var] = 0;
+    }
+    visited.clear();
+    stack.clear();
+}
+
+void ExtProp::explain_var(const uint32_t var)
+{
+    const Lit lit = reason_lit[var];
+    reason_lit[var] = lit_Undef;
+    num_unexplained--;
+    num_reasons++;
+
+    const Lit p = Lit(var, solver->value(var) == l_False);
+    tmp_outside.clear();
+    prop->cb_add_reason_clause(lit, tmp_outside);
+    tmp = tmp_outside;
+    to_inter(tmp);
+
+    //p goes to the front, the highest level literal after it
+    std::sort(tmp.begin(), tmp.end());
+    tmp.erase(std::unique(tmp.begin(), tmp.end()), tmp.end());
+    bool found = false;
+    reason.clear();
+    reason.push_back(p);
+    for(const Lit l: tmp) {
+        if (l == p) {
+            found = true;
+            continue;
+        }
+        if (solver->value(l) != l_False) {
+            std::cerr
+            << "ERROR: The reason clause of propagated literal "
+            << lit << " has a literal that is not false"
+            << endl;
+            std::exit(-1);
+        }
+        if (solver->varData[l.var()].level != 0) {
+            reason.push_back(l);
+        }
+    }
+    if (!found) {
+        std::cerr
+        << "ERROR: The reason clause of propagated literal "
+        << lit << " does not contain it"
+        << endl;
+        std::exit(-1);
+    }
+
+    if (reason.size() == 1) {
+        //Implied at level 0: analysis skips it, and it is added as a unit
+        solver->varData[var].level = 0;
+        units.push_back(lit);
+        return;
+    }
+
+    uint32_t highest = 1;
+    for(uint32_t i = 2; i < reason.size(); i++) {
+        if (solver->varData[reason[i].var()].level
+            > solver->varData[reason[highest].var()].level
+        ) {
+            highest = i;
+        }
+    }
+    std::swap(reason[1], reason[highest]);
+    solver->varData[var].reason = attach(reason, true);
+}
+
+/**
+@brief Asks the propagator about a full assignment
+
+@returns false if it rejected it. Its clauses are then added by the next
+         propagate()
+*/
+bool ExtProp::check_model()
+{
+    notify_assignments();
+    tmp_outside.clear();
+    for(const auto& o: obs) {
+        tmp_outside.push_back(o.second ^ (solver->value(o.first) == l_False));
+    }
+    if (prop->cb_check_found_model(tmp_outside)) {
+        return true;
+    }
+    num_models_rejected++;
+    model_rejected = true;
+    return false;
+}
+
+void ExtProp::print_stats() const
+{
+    print_stats_line("c ext observed vars", num_observed);
+    print_stats_line("c ext propagations", num_props);
+    print_stats_line("c ext reasons", num_reasons);
+    print_stats_line("c ext clauses", num_clauses);
+    print_stats_line("c ext models rejected", num_models_rejected);
+}
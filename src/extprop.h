@@ -0,0 +1,120 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef EXTPROP_H
+#define EXTPROP_H
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+#include "propby.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+/**
+@brief Connects an ExternalPropagator (IPASIR-UP style) to the search
+
+The propagator talks in outside literals of observed variables. These are
+mapped to inter literals once, and the map is rebuilt when the variables are
+renumbered. Equivalent literal replacement is off while a propagator is
+connected, but several observed variables may still have been replaced by the
+same inter variable before.
+
+Literals it propagates are put on the trail with a NULL reason, and their
+reason clause is only asked for when a conflict (or a failed assumption) is
+analysed and reaches them. The reason is then attached as a learnt clause and
+becomes the variable's reason, so the conflict analysis itself never sees
+external reasons.
+*/
+class ExtProp
+{
+    public:
+        ExtProp(Solver* solver, ExternalPropagator* prop);
+
+        //Outside vars, only at decision level 0
+        void add_observed_var(const uint32_t outside_var);
+        void remove_observed_var(const uint32_t outside_var);
+        void reset_observed_vars();
+        void mark_observed(vector<bool>& marks) const; ///<by inter var
+        void update_vars(); ///<after renumbering or new variables
+
+        //Search
+        void notify_assignments();
+        void backtrack(const uint32_t blevel); ///<before the trail is cut
+        lbool propagate(PropBy& confl);
+        bool check_model();
+        void explain(const PropBy confl);
+        void explain(const Lit lit);
+
+        void print_stats() const;
+
+    private:
+        Lit to_inter(const Lit outside_lit) const;
+        void to_inter(vector<Lit>& lits) const;
+        lbool add_clause(vector<Lit>& lits, const bool red, PropBy& confl);
+        PropBy attach(const vector<Lit>& lits, const bool red);
+        void explain_var(const uint32_t var);
+        void explain_cone();
+
+        Solver* solver;
+        ExternalPropagator* prop;
+
+        //Observed vars. obs_inter is by outside var, obs is sorted by inter
+        //var and obs_at points to the first entry of an inter var in it
+        vector<char> observed;
+        uint32_t num_observed = 0;
+        vector<Lit> obs_inter;
+        vector<std::pair<uint32_t, Lit>> obs;
+        vector<uint32_t> obs_at;
+
+        //What the propagator has been told
+        uint32_t notified = 0; ///<trail index
+        uint32_t level = 0;
+        bool model_rejected = false;
+
+        //Propagated outside lit by inter var, while its reason is not known.
+        //pending holds (var, trail index) of all of them, in trail order
+        vector<Lit> reason_lit;
+        vector<std::pair<uint32_t, uint32_t>> pending;
+        uint32_t num_unexplained = 0;
+        vector<Lit> units; ///<reasons of size 1, to be added at level 0
+
+        vector<Lit> tmp;
+        vector<Lit> tmp_outside;
+        vector<Lit> reason;
+        vector<uint32_t> stack;
+        vector<uint32_t> visited;
+
+        //Stats
+        uint64_t num_props = 0;
+        uint64_t num_reasons = 0;
+        uint64_t num_clauses = 0;
+        uint64_t num_models_rejected = 0;
+};
+
+} //end namespace
+
+#endif //EXTPROP_H
@@ -0,0 +1,114 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "hotprof.h"
+#include "solvertypes.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <mutex>
+#include <cstring>
+
+using std::cout;
+using std::endl;
+using namespace CMSat;
+
+const char* HotProf::name(Path p)
+{
+    switch(p) {
+        case search: return "search";
+        case propagate: return "propagate";
+        case analyze: return "analyze_conflict";
+        case gauss: return "gauss_jordan_elim";
+        case cancel_until: return "cancelUntil";
+        case decision: return "new_decision";
+        case reduce_db: return "reduce_db_if_needed";
+        default: return "unknown";
+    }
+}
+
+void HotProf::clear()
+{
+    memset(acc, 0, sizeof(acc));
+    start_ticks = hotprof_ticks();
+    start_time = std::chrono::steady_clock::now();
+}
+
+void HotProf::print_and_clear(uint32_t thread_num)
+{
+    //Threads finish together, don't mix their lines
+    static std::mutex print_mutex;
+    std::lock_guard<std::mutex> lock(print_mutex);
+
+    const double secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    const double ticks_per_sec = secs > 0 ?
+        (double)(hotprof_ticks() - start_ticks)/secs : 0;
+    const auto to_secs = [&](uint64_t ticks) {
+        return ticks_per_sec > 0 ? (double)ticks/ticks_per_sec : 0.0;
+    };
+
+    cout << "c ------- HOT PATH PROFILE, THREAD " << thread_num << " -------" << endl;
+    cout << "c " << std::left << std::setw(20) << "path" << std::right
+    << std::setw(10) << "time(s)"
+    << std::setw(8) << "%srch"
+    << std::setw(14) << "calls"
+    << std::setw(12) << "ticks/call"
+    << endl;
+    const uint64_t search_ticks = acc[search].ticks;
+    for(int p = 0; p < num_paths; p++) {
+        const Acc& a = acc[p];
+        cout << "c " << std::left << std::setw(20) << name((Path)p) << std::right
+        << std::fixed << std::setprecision(2)
+        << std::setw(10) << to_secs(a.ticks)
+        << std::setw(8) << stats_line_percent(a.ticks, search_ticks)
+        << std::setw(14) << a.calls
+        << std::setw(12) << std::setprecision(0) << ratio_for_stat(a.ticks, a.calls)
+        << endl;
+    }
+
+    //Histograms: bucket 2^b holds calls that took [2^b, 2^(b+1)) ticks
+    for(int p = 0; p < num_paths; p++) {
+        const Acc& a = acc[p];
+        uint64_t samples = 0;
+        for(uint32_t b = 0; b < num_buckets; b++) {
+            samples += a.hist[b];
+        }
+        if (samples == 0) {
+            continue;
+        }
+        std::stringstream ss;
+        for(uint32_t b = 0; b < num_buckets; b++) {
+            if (a.hist[b] == 0) {
+                continue;
+            }
+            ss << " 2^" << b << ":" << std::fixed << std::setprecision(1)
+            << stats_line_percent(a.hist[b], samples) << "%";
+        }
+        cout << "c hist " << name((Path)p) << " (ticks/call, 1 in "
+        << sample_every << " calls, " << samples << " samples):" << ss.str() << endl;
+    }
+    cout << "c ------- HOT PATH PROFILE END -------" << endl;
+
+    clear();
+}
@@ -0,0 +1,149 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __HOTPROF_H__
+#define __HOTPROF_H__
+
+//Cycle accounting of the search hot paths. Only with -DHOTPATH_PROFILE=ON,
+//otherwise HOTPROF() and HOTPROF_IF() expand to nothing.
+
+#ifdef HOTPATH_PROFILE
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define HOTPROF_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOTPROF_RDTSC
+#endif
+
+namespace CMSat {
+
+///Cycles on x86, nanoseconds elsewhere. HotProf calibrates either to seconds
+inline uint64_t hotprof_ticks()
+{
+    #ifdef HOTPROF_RDTSC
+    return __rdtsc();
+    #else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+/**
+@brief Per-thread accumulators of the ticks spent in the search hot paths
+
+Every timed call adds its ticks and a call to its path. Every sample_every-th
+call also goes into a log2 histogram of the ticks per call, which shows
+whether a path is slow because of a few long calls or many short ones.
+Timed paths may nest (cancelUntil is called from conflict handling), so the
+paths are not disjoint, they are shown as a share of the time in search().
+*/
+class HotProf
+{
+public:
+    enum Path {
+        search, propagate, analyze, gauss, cancel_until, decision, reduce_db,
+        num_paths
+    };
+    static const uint32_t num_buckets = 48;
+    static const uint32_t sample_every = 64;
+
+    HotProf()
+    {
+        clear();
+    }
+
+    void add(Path p, uint64_t ticks)
+    {
+        Acc& a = acc[p];
+        a.ticks += ticks;
+        a.calls++;
+        if ((a.calls & (sample_every-1)) == 0) {
+            uint32_t b = 0;
+            while((ticks >> b) > 1 && b < num_buckets-1) {
+                b++;
+            }
+            a.hist[b]++;
+        }
+    }
+
+    ///Prints the breakdown and the histograms, then starts over
+    void print_and_clear(uint32_t thread_num);
+    void clear();
+
+private:
+    struct Acc
+    {
+        uint64_t ticks;
+        uint64_t calls;
+        uint64_t hist[num_buckets];
+    };
+    static const char* name(Path p);
+
+    Acc acc[num_paths];
+    uint64_t start_ticks;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+class HotProfTimer
+{
+public:
+    HotProfTimer(HotProf& _prof, HotProf::Path _path, bool _on = true) :
+        prof(_prof)
+        , path(_path)
+        , on(_on)
+        , start(_on ? hotprof_ticks() : 0)
+    {}
+
+    ~HotProfTimer()
+    {
+        if (on) {
+            prof.add(path, hotprof_ticks() - start);
+        }
+    }
+
+private:
+    HotProf& prof;
+    const HotProf::Path path;
+    const bool on;
+    const uint64_t start;
+};
+
+}
+
+#define HOTPROF(prof, p) \
+    CMSat::HotProfTimer hotprof_timer_##p(prof, CMSat::HotProf::p)
+#define HOTPROF_IF(prof, p, cond) \
+    CMSat::HotProfTimer hotprof_timer_##p(prof, CMSat::HotProf::p, cond)
+
+#else
+
+#define HOTPROF(prof, p)
+#define HOTPROF_IF(prof, p, cond)
+
+#endif //HOTPATH_PROFILE
+
+#endif //__HOTPROF_H__
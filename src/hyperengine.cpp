@@ -167,8 +167,24 @@ Lit HyperEngine::propagate_bfs(const uint64_t timeout)
 }
 
 //Add binary clause to deepest common ancestor
-void HyperEngine::add_hyper_bin(const Lit p)
+void HyperEngine::add_hyper_bin(const Lit p, const Clause& cl)
 {
+    assert(value(p.var()) == l_Undef);
+
+    #ifdef VERBOSE_DEBUG_FULLPROP
+    cout << "Enqueing " << p
+    << " with ancestor clause: " << cl
+    << endl;
+     #endif
+
+    currAncestors.clear();
+    for (const Lit l: cl) {
+        if (l != p) {
+            assert(value(l) == l_False);
+            if (varData[l.var()].level != 0)
+                currAncestors.push_back(~l);
+        }
+    }
     propStats.otfHyperTime += 2;
 
     Lit deepestAncestor = lit_Undef;
@@ -180,6 +196,9 @@ void HyperEngine::add_hyper_bin(const Lit p)
         cout << "Adding hyper-bin clause: " << p << " , " << ~deepestAncestor << endl;
         #endif
         needToAddBinClause.insert(BinaryClause(p, ~deepestAncestor, true));
+        if (drat->hints_needed()) {
+            set_hyper_bin_hints(p, deepestAncestor, cl);
+        }
         *drat << add << p << (~deepestAncestor)
         #ifdef STATS_NEEDED
         << 0
@@ -383,31 +402,44 @@ bool HyperEngine::is_ancestor_of(
     return false;
 }
 
-void HyperEngine::add_hyper_bin(const Lit p, const Clause& cl)
-{
-    assert(value(p.var()) == l_Undef);
-
-    #ifdef VERBOSE_DEBUG_FULLPROP
-    cout << "Enqueing " << p
-    << " with ancestor clause: " << cl
-    << endl;
-     #endif
-
-    currAncestors.clear();
-    size_t i = 0;
-    for (Clause::const_iterator
-        it = cl.begin(), end = cl.end()
-        ; it != end
-        ; ++it, i++
-    ) {
-        if (*it != p) {
-            assert(value(*it) == l_False);
-            if (varData[it->var()].level != 0)
-                currAncestors.push_back(~*it);
+//With ancestor and ~p assumed, the binary clauses on the paths from the
+//ancestor to the false literals of cl become unit one by one, then cl
+//is in conflict
+void HyperEngine::set_hyper_bin_hints(
+    const Lit p
+    , const Lit ancestor
+    , const Clause& cl
+) {
+    hyper_bin_hints.clear();
+    for(const Lit l: cl) {
+        if (l != p && varData[l.var()].level == 0) {
+            hyper_bin_hints.push_back(drat->unit_ID(~l));
         }
     }
-
-    add_hyper_bin(p);
+    for(const Lit l: cl) {
+        if (l == p || varData[l.var()].level == 0) {
+            continue;
+        }
+        hyper_bin_path.clear();
+        for(Lit x = ~l
+            ; x != ancestor && x != lit_Undef && !seen[x.toInt()]
+            ; x = varData[x.var()].reason.getAncestor()
+        ) {
+            seen[x.toInt()] = 1;
+            toClear.push_back(x);
+            hyper_bin_path.push_back(x);
+        }
+        for(auto it = hyper_bin_path.rbegin(); it != hyper_bin_path.rend(); ++it) {
+            const Lit anc = varData[it->var()].reason.getAncestor();
+            hyper_bin_hints.push_back(anc == lit_Undef ? 0 : drat->bin_ID(~anc, *it));
+        }
+    }
+    for(const Lit x: toClear) {
+        seen[x.toInt()] = 0;
+    }
+    toClear.clear();
+    hyper_bin_hints.push_back(drat->ID_of(cl));
+    drat->set_hints(hyper_bin_hints);
 }
 
 //Analyze why did we fail at decision level 1
@@ -555,6 +587,7 @@ void HyperEngine::remove_bin_clause(Lit lit)
         //must ALWAYS be true
         if (it != needToAddBinClause.end()) {
             propStats.otfHyperTime += 2;
+            *drat << del << it->getLit1() << it->getLit2() << fin;
             needToAddBinClause.erase(it);
         }
         //This will subsume the clause later, so don't remove it
@@ -664,6 +697,8 @@ size_t HyperEngine::mem_used() const
     size_t mem = 0;
     mem += PropEngine::mem_used();
     mem += currAncestors.capacity()*sizeof(Lit);
+    mem += hyper_bin_path.capacity()*sizeof(Lit);
+    mem += hyper_bin_hints.capacity()*sizeof(uint32_t);
 
     return mem;
 }
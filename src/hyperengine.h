@@ -49,9 +49,6 @@ public:
     set<BinaryClause> needToAddBinClause;       ///<We store here hyper-binary clauses to be added at the end of propagateFull()
     set<BinaryClause> uselessBin;
 
-    ///Add hyper-binary clause given this bin clause
-    void  add_hyper_bin(Lit p);
-
     ///Add hyper-binary clause given this large clause
     void  add_hyper_bin(Lit p, const Clause& cl);
 
@@ -59,6 +56,7 @@ public:
 
 private:
     Lit   analyzeFail(PropBy propBy);
+    void  set_hyper_bin_hints(const Lit p, const Lit ancestor, const Clause& cl);
     Lit   remove_which_bin_due_to_trans_red(Lit conflict, Lit thisAncestor, const bool thisStepRed);
     void  remove_bin_clause(Lit lit);
     bool  is_ancestor_of(
@@ -86,6 +84,8 @@ private:
     );
 
     vector<Lit> currAncestors;
+    vector<Lit> hyper_bin_path;
+    vector<uint32_t> hyper_bin_hints;
 };
 
 }
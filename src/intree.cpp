@@ -367,6 +367,11 @@ bool InTree::handle_lit_popped_from_queue(const Lit lit, const Lit other_lit, co
             removedRedBin += tmp.second;
         }
         solver->uselessBin.clear();
+
+        //Hyper-binaries of a failed literal are not attached
+        for(const BinaryClause& b: solver->needToAddBinClause) {
+            *(solver->drat) << del << b.getLit1() << b.getLit2() << fin;
+        }
         solver->needToAddBinClause.clear();
     }
 
@@ -32,13 +32,114 @@ IN THE SOFTWARE.
 #include <cassert>
 #include <string.h>
 #include "constants.h"
+extern "C" {
+#include "ipasir.h"
+}
 
 using std::vector;
 using namespace CMSat;
+
+static int to_dimacs(const Lit lit)
+{
+    return lit.sign() ? -(int)(lit.var()+1) : (int)(lit.var()+1);
+}
+
+static Lit from_dimacs(const int lit)
+{
+    return Lit(std::abs(lit)-1, lit < 0);
+}
+
+//Calls the C callbacks of an IPASIR-UP propagator, a missing callback
+//does nothing
+class IpasirUpPropagator : public ExternalPropagator
+{
+public:
+    IpasirUpPropagator(void* _state, const ipasir_up_propagator& _cbs) :
+        state(_state)
+        , cbs(_cbs)
+    {
+    }
+
+    void notify_assignment(const vector<Lit>& lits) override
+    {
+        if (cbs.notify_assignment) {
+            set_ints(lits);
+            cbs.notify_assignment(state, ints.data(), ints.size());
+        }
+    }
+
+    void notify_new_decision_level() override
+    {
+        if (cbs.notify_new_decision_level) {
+            cbs.notify_new_decision_level(state);
+        }
+    }
+
+    void notify_backtrack(uint32_t new_level) override
+    {
+        if (cbs.notify_backtrack) {
+            cbs.notify_backtrack(state, new_level);
+        }
+    }
+
+    bool cb_check_found_model(const vector<Lit>& model) override
+    {
+        if (!cbs.cb_check_found_model) {
+            return true;
+        }
+        set_ints(model);
+        return cbs.cb_check_found_model(state, ints.data(), ints.size()) != 0;
+    }
+
+    Lit cb_propagate() override
+    {
+        const int lit = cbs.cb_propagate ? cbs.cb_propagate(state) : 0;
+        return lit == 0 ? lit_Undef : from_dimacs(lit);
+    }
+
+    void cb_add_reason_clause(Lit propagated, vector<Lit>& reason) override
+    {
+        int lit;
+        while((lit = cbs.cb_add_reason_clause_lit(state, to_dimacs(propagated))) != 0) {
+            reason.push_back(from_dimacs(lit));
+        }
+    }
+
+    bool cb_add_external_clause(vector<Lit>& clause, bool& forgettable) override
+    {
+        int is_forgettable = 0;
+        if (!cbs.cb_has_external_clause
+            || !cbs.cb_has_external_clause(state, &is_forgettable)
+        ) {
+            return false;
+        }
+        forgettable = is_forgettable != 0;
+        int lit;
+        while((lit = cbs.cb_add_external_clause_lit(state)) != 0) {
+            clause.push_back(from_dimacs(lit));
+        }
+        return true;
+    }
+
+private:
+    void set_ints(const vector<Lit>& lits)
+    {
+        ints.clear();
+        for(const Lit lit: lits) {
+            ints.push_back(to_dimacs(lit));
+        }
+    }
+
+    void* state;
+    ipasir_up_propagator cbs;
+    vector<int> ints;
+};
+
 struct MySolver {
     ~MySolver()
     {
         delete solver;
+        delete propagator;
     }
 
     MySolver()
@@ -47,6 +148,7 @@ struct MySolver {
     }
 
     SATSolver* solver;
+    IpasirUpPropagator* propagator = NULL;
     vector<Lit> clause;
     vector<Lit> assumptions;
     vector<Lit> last_conflict;
@@ -238,9 +340,55 @@ DLL_PUBLIC int ipasir_failed (void * solver, int lit)
  * Required state: INPUT or SAT or UNSAT
  * State after: INPUT or SAT or UNSAT
  */
-DLL_PUBLIC void ipasir_set_terminate (void * /*solver*/, void * /*state*/, int (* /*terminate*/)(void * state))
+DLL_PUBLIC void ipasir_set_terminate (void * solver, void * state, int (*terminate)(void * state))
 {
-    //this is complicated.
+    MySolver* s = (MySolver*)solver;
+    if (terminate == NULL) {
+        s->solver->set_terminate_callback(nullptr);
+        return;
+    }
+    s->solver->set_terminate_callback([=]() {
+        return terminate(state) != 0;
+    });
+}
+
+DLL_PUBLIC void ipasir_connect_external_propagator (void * solver, void * state, const ipasir_up_propagator * propagator)
+{
+    MySolver* s = (MySolver*)solver;
+    IpasirUpPropagator* old = s->propagator;
+    s->propagator = new IpasirUpPropagator(state, *propagator);
+    s->solver->connect_external_propagator(s->propagator);
+    delete old;
+}
+
+DLL_PUBLIC void ipasir_disconnect_external_propagator (void * solver)
+{
+    MySolver* s = (MySolver*)solver;
+    s->solver->disconnect_external_propagator();
+    delete s->propagator;
+    s->propagator = NULL;
+}
+
+DLL_PUBLIC void ipasir_add_observed_var (void * solver, int var)
+{
+    MySolver* s = (MySolver*)solver;
+    const uint32_t v = std::abs(var)-1;
+    if (v >= s->solver->nVars()) {
+        s->solver->new_vars(v - s->solver->nVars() + 1);
+    }
+    s->solver->add_observed_var(v);
+}
+
+DLL_PUBLIC void ipasir_remove_observed_var (void * solver, int var)
+{
+    MySolver* s = (MySolver*)solver;
+    s->solver->remove_observed_var(std::abs(var)-1);
+}
+
+DLL_PUBLIC void ipasir_reset_observed_vars (void * solver)
+{
+    MySolver* s = (MySolver*)solver;
+    s->solver->reset_observed_vars();
 }
 
 DLL_PUBLIC void ipasir_set_learn (void * /*solver*/, void * /*state*/, int /*max_length*/, void (* /*learn*/)(void * state, int * clause))
@@ -149,4 +149,54 @@ void ipasir_set_terminate (void * solver, void * state, int (*terminate)(void *
  */
 void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int * clause));
 
+/**
+ * IPASIR-UP: user propagators. The propagator is a set of callbacks, all
+ * called with the "state" given at connection. Literals are DIMACS integers
+ * over the observed variables.
+ *   - notify_assignment: "size" observed literals became true
+ *   - notify_new_decision_level, notify_backtrack: assignments above
+ *     "new_level" are undone
+ *   - cb_check_found_model: all variables are assigned, "model" has the
+ *     observed literals. Return 0 to reject it, then a clause must follow
+ *     through cb_has_external_clause
+ *   - cb_propagate: a literal implied under the current assignment, or 0
+ *   - cb_add_reason_clause_lit: the reason clause of a propagated literal,
+ *     one literal per call, then 0. Only asked for when needed
+ *   - cb_has_external_clause: non-zero if there is a clause to add, then
+ *     cb_add_external_clause_lit gives its literals one by one, then 0.
+ *     Setting "*is_forgettable" to non-zero makes it a learnt clause
+ * The callbacks must not call back into the solver.
+ */
+typedef struct ipasir_up_propagator {
+    void (*notify_assignment) (void * state, const int * lits, int size);
+    void (*notify_new_decision_level) (void * state);
+    void (*notify_backtrack) (void * state, int new_level);
+    int (*cb_check_found_model) (void * state, const int * model, int size);
+    int (*cb_propagate) (void * state);
+    int (*cb_add_reason_clause_lit) (void * state, int propagated_lit);
+    int (*cb_has_external_clause) (void * state, int * is_forgettable);
+    int (*cb_add_external_clause_lit) (void * state);
+} ipasir_up_propagator;
+
+/**
+ * Connect a propagator, replacing the one connected before if any. The
+ * callbacks are copied, "state" must stay valid while connected.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+void ipasir_connect_external_propagator (void * solver, void * state, const ipasir_up_propagator * propagator);
+void ipasir_disconnect_external_propagator (void * solver);
+
+/**
+ * Only observed variables can be in the propagator's literals. They are
+ * not eliminated by the solver. A propagator must be connected.
+ *
+ * Required state: INPUT or SAT or UNSAT
+ * State after: INPUT
+ */
+void ipasir_add_observed_var (void * solver, int var);
+void ipasir_remove_observed_var (void * solver, int var);
+void ipasir_reset_observed_vars (void * solver);
+
 #endif
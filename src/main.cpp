@@ -324,6 +324,20 @@ void Main::add_supported_options()
         , "[0..] Random seed")
     ("threads,t", po::value(&num_threads)->default_value(1)
         ,"Number of threads")
+    ("net", po::value(&conf.net_sync)
+        , "Share units, binaries and short clauses with other processes solving the same CNF through cryptominisat5_hub at HOST:PORT or unix:PATH")
+    ("checkpoint", po::value(&conf.checkpoint_file)
+        , "Periodically, and when interrupted, write the full solver state to this file (FILE.N for thread N)")
+    ("checkpointevery", po::value(&conf.checkpoint_every)->default_value(conf.checkpoint_every)
+        , "Wall-clock seconds between two checkpoints")
+    ("resume", po::value(&resume_fname)
+        , "Continue from the checkpoint in this file instead of reading a CNF. Use the same number of threads and options as the run that wrote it")
+    ("metrics", po::value(&conf.metrics_listen)
+        , "Serve live solver metrics in the Prometheus text format over HTTP at HOST:PORT or unix:PATH")
+    ("metricsfile", po::value(&conf.metrics_file)
+        , "Periodically write live solver metrics as JSON to this file")
+    ("metricsevery", po::value(&conf.metrics_every)->default_value(conf.metrics_every)
+        , "Wall-clock seconds between two samples of the live metrics")
     ("maxtime", po::value(&maxtime),
         "Stop solving after this much time (s)")
     ("maxconfl", po::value(&maxconfl),
@@ -374,6 +388,12 @@ void Main::add_supported_options()
         , "How often should we use inverted best polarities instead of stable")
     ("polarbestmult", po::value(&conf.polar_best_multip_n)->default_value(conf.polar_best_multip_n)
         , "How often should we use best polarities instead of stable")
+    ("rephase", po::value(&conf.do_rephase)->default_value(conf.do_rephase)
+        , "Periodically reset the saved polarities according to the rephase schedule")
+    ("rephasefirst", po::value(&conf.rephase_first)->default_value(conf.rephase_first)
+        , "Conflicts until the first rephase. The N-th rephase happens N times this many conflicts after the previous one")
+    ("rephasesched", po::value(&conf.rephase_schedule)->default_value(conf.rephase_schedule)
+        , "Rephase schedule, cycled through. Allowed tokens: orig (all negative), inv (all positive), best (longest trail), walk (SLS best assignment), rnd (random)")
     ;
 
 
@@ -392,6 +412,10 @@ void Main::add_supported_options()
         , "The multiplier used to determine if we should restart during glue-based restart")
     ("ratiogluegeom", po::value(&conf.ratio_glue_geom)->default_value(conf.ratio_glue_geom)
         , "Ratio of glue vs geometric restarts -- more is more glue")
+    ("reusetrail", po::value(&conf.do_reuse_trail)->default_value(conf.do_reuse_trail)
+        , "At restart, only backtrack to the first decision whose variable has a lower activity than the next variable to be decided on")
+    ("reuseassumps", po::value(&conf.do_reuse_assumps)->default_value(conf.do_reuse_assumps)
+        , "Keep the propagated assumptions when solve() returns, and only backtrack to the first assumption that differs at the next call")
     ;
 
     std::ostringstream s_incclean;
@@ -434,6 +458,14 @@ void Main::add_supported_options()
     ("branchstr"
         , po::value(&conf.branch_strategy_setup)->default_value(conf.branch_strategy_setup)
         , "Branch strategy. E.g. 'vmtf+vsids+maple+rnd'")
+    ("modeswitch", po::value(&conf.do_mode_switch)->default_value(conf.do_mode_switch)
+        , "Alternate between focused (VSIDS, glue restarts) and stable (Maple, luby restarts, stable polarities) search. Overrides --branchstr")
+    ("modeswitchfirst", po::value(&conf.mode_switch_first)->default_value(conf.mode_switch_first)
+        , "Number of conflicts in the first focused and stable mode")
+    ("modeswitchinc", po::value(&conf.mode_switch_inc)->default_value(conf.mode_switch_inc)
+        , "Multiply the length of the modes by this after every focused+stable cycle")
+    ("stablelev2mult", po::value(&conf.stable_lev2_reduce_mult)->default_value(conf.stable_lev2_reduce_mult)
+        , "In stable mode, reduce lev2 clauses this many times less often")
     ;
 
 
@@ -705,9 +737,17 @@ void Main::add_supported_options()
     ("sql", po::value(&sql)->default_value(0)
         , "Write to SQL. 0 = no SQL, 1 or 2 = sqlite")
     ("sqlitedb", po::value(&sqlite_filename)
-        , "Where to put the SQLite database")
+        , "Where to put the SQLite database, or the binary trace with '--sqltrace 1'")
     ("sqlitedboverwrite", po::value(&conf.sql_overwrite_file)->default_value(conf.sql_overwrite_file)
         , "Overwrite the SQLite database file if it exists")
+    ("sqlasync", po::value(&conf.sql_async)->default_value(conf.sql_async)
+        , "Write to the SQLite database from a background thread, in WAL mode. Otherwise, rows are inserted by the solving thread itself")
+    ("sqlcommitevery", po::value(&conf.sql_commit_every)->default_value(conf.sql_commit_every)
+        , "With '--sqlasync 1', commit the SQLite transaction after this many rows")
+    ("sqltrace", po::value(&conf.sql_trace)->default_value(conf.sql_trace)
+        , "Instead of the SQLite database, write an append-only binary trace of the same data. Convert it to the database with cmsat_trace2sql. With several threads, thread N writes to FILE.N")
+    ("sqltracecompress", po::value(&conf.sql_trace_compress)->default_value(conf.sql_trace_compress)
+        , "Compress the blocks of the binary trace with zlib")
     ("cldatadumpratio", po::value(&conf.dump_individual_cldata_ratio)->default_value(conf.dump_individual_cldata_ratio)
         , "Only dump this ratio of clauses' data, randomly selected. Since machine learning doesn't need that much data, this can reduce the data you have to deal with.")
     ("cllockdatagen", po::value(&conf.lock_for_data_gen_ratio)->default_value(conf.lock_for_data_gen_ratio)
@@ -739,7 +779,13 @@ void Main::add_supported_options()
     ("compsvar", po::value(&conf.compVarLimit)->default_value(conf.compVarLimit)
         , "Only use components in case the number of variables is below this limit")
     ("compslimit", po::value(&conf.comp_find_time_limitM)->default_value(conf.comp_find_time_limitM)
-        , "Limit how much time is spent in component-finding");
+        , "Limit how much time is spent in component-finding")
+    ("compsthreads", po::value(&conf.comp_threads)->default_value(conf.comp_threads)
+        , "Solve the components on this many threads")
+    ("compsbatch", po::value(&conf.comp_batch_vars)->default_value(conf.comp_batch_vars)
+        , "Solve components smaller than this many vars together in one sub-solver, up to this many vars")
+    ("compscache", po::value(&conf.comp_cache)->default_value(conf.comp_cache)
+        , "Reuse the solutions of unchanged components across solve() calls");
 
     po::options_description distillOptions("Distill options");
     distillOptions.add_options()
@@ -796,6 +842,10 @@ void Main::add_supported_options()
     hiddenOptions.add_options()
     ("sync", po::value(&conf.sync_every_confl)->default_value(conf.sync_every_confl)
         , "Sync threads every N conflicts")
+    ("netmaxsize", po::value(&conf.net_share_max_size)->default_value(conf.net_share_max_size)
+        , "Share learnt clauses up to this size with other processes")
+    ("netmaxglue", po::value(&conf.net_share_max_glue)->default_value(conf.net_share_max_glue)
+        , "Share learnt clauses up to this glue with other processes")
     ("dratdebug", po::bool_switch(&dratDebug)
         , "Output DRAT verification into the console. Helpful to see where DRAT fails -- use in conjunction with --verb 20")
     ("clearinter", po::value(&need_clean_exit)->default_value(0)
@@ -810,6 +860,10 @@ void Main::add_supported_options()
         , "The maximum for scc search depth")
     ("simdrat", po::value(&conf.simulate_drat)->default_value(conf.simulate_drat)
         , "Simulate DRAT")
+    ("dratbufs", po::value(&conf.drat_async_bufs)->default_value(conf.drat_async_bufs)
+        , "Number of 2MB buffers to hand to a separate DRAT writer thread. 0 = write from the solving thread")
+    ("frat", po::value(&conf.frat_proof)->default_value(conf.frat_proof)
+        , "Write the proof in the text FRAT format, with LRAT-style hints where the solver has them. Single-threaded only")
     ("sampling", po::value(&sampling_vars_str)->default_value(sampling_vars_str)
         , "Sampling vars, separated by comma")
     ("onlysampling", po::bool_switch(&only_sampling_solution)
@@ -821,6 +875,8 @@ void Main::add_supported_options()
     ("input", po::value< vector<string> >(), "file(s) to read")
     ("drat,d", po::value(&dratfilname)
         , "Put DRAT verification information into this file")
+    ("checkproof", po::bool_switch(&check_proof)
+        , "Check the DRAT proof on a separate thread while solving, without writing it out")
     ;
 
 #ifdef USE_BOSPHORUS
@@ -1238,7 +1294,8 @@ void Main::manually_parse_some_options()
         }
 
         if (!vm.count("sqlitedb")) {
-            sqlite_filename = filesToRead[0] + ".sqlite";
+            sqlite_filename = filesToRead[0] +
+                (conf.sql_trace ? ".cmstrace" : ".sqlite");
         } else {
             sqlite_filename = vm["sqlitedb"].as<string>();
         }
@@ -1282,6 +1339,27 @@ void Main::manually_parse_some_options()
         }
     }
 
+    if (!conf.net_sync.empty() && (vm.count("drat") || check_proof || conf.preprocess != 0)) {
+        cout << "ERROR: --net cannot be combined with a proof or with preprocessing" << endl;
+        std::exit(-1);
+    }
+
+    if ((!conf.checkpoint_file.empty() || !resume_fname.empty())
+        && (vm.count("drat") || check_proof || conf.preprocess != 0)
+    ) {
+        cout << "ERROR: checkpoints cannot be combined with a proof or with preprocessing" << endl;
+        std::exit(-1);
+    }
+    if (!conf.checkpoint_file.empty()) {
+        //So that the state is written when interrupted
+        need_clean_exit = 1;
+    }
+
+    if (check_proof && (vm.count("drat") || conf.preprocess != 0)) {
+        cout << "ERROR: --checkproof cannot be combined with a DRAT file or with preprocessing" << endl;
+        std::exit(-1);
+    }
+
     if (conf.preprocess == 0 &&
         (vm.count("drat") || conf.simulate_drat)
     ) {
@@ -1383,6 +1461,9 @@ int Main::solve()
     if (dratf) {
         solver->set_drat(dratf, clause_ID_needed);
     }
+    if (check_proof) {
+        solver->set_drat_check();
+    }
     if (vm.count("maxtime")) {
         solver->set_max_time(maxtime);
     }
@@ -1419,7 +1500,17 @@ int Main::solve()
 
     //Parse in DIMACS (maybe gzipped) files
     //solver->log_to_file("mydump.cnf");
-    if (conf.preprocess != 2) {
+    if (!resume_fname.empty()) {
+        if (conf.verbosity && !filesToRead.empty()) {
+            cout << "c Resuming from checkpoint, not reading the CNF" << endl;
+        }
+        try {
+            solver->load_checkpoint(resume_fname);
+        } catch (std::runtime_error& e) {
+            std::cerr << e.what() << endl;
+            std::exit(-1);
+        }
+    } else if (conf.preprocess != 2) {
         parseInAllFiles(solver);
     }
     if (!assump_filename.empty()) {
@@ -1452,6 +1543,11 @@ int Main::solve()
             dump_red_file();
         }
     }
+    if (check_proof && ret == l_False) {
+        cout << "c DRAT check: "
+        << (solver->get_drat_check_result() == l_True ? "VERIFIED" : "FAILED")
+        << endl;
+    }
     printResultFunc(&cout, false, ret);
     if (resultfile) {
         printResultFunc(resultfile, true, ret);
@@ -1465,6 +1561,7 @@ lbool Main::multi_solutions()
     if (max_nr_of_solutions == 1
         && conf.preprocess == 0
         && dratf == NULL
+        && !check_proof
         && !conf.simulate_drat
         && debugLib.empty()
     ) {
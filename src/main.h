@@ -120,6 +120,7 @@ class Main: public MainCommon
         bool only_sampling_solution = false;
         std::string assump_filename;
         vector<Lit> assumps;
+        string resume_fname;
 
 
         //Files to read & write
@@ -132,6 +133,7 @@ class Main: public MainCommon
 
         //Drat checker
         bool clause_ID_needed = false;
+        bool check_proof = false;
 };
 
 #endif //MAIN_H
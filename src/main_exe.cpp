@@ -42,6 +42,7 @@ int main(int argc, char** argv)
         main.parseCommandLine();
 
         signal(SIGINT, SIGINT_handler);
+        signal(SIGTERM, SIGINT_handler);
         ret = main.solve();
     } catch (CMSat::TooManyVarsError& e) {
         std::cerr << "ERROR! Variable requested is far too large" << std::endl;
@@ -152,10 +152,6 @@ public:
         solver = &S;
         if (dratf) {
             solver->set_drat(dratf, false);
-            if (num_threads > 1) {
-                cout << "ERROR: Cannot have DRAT and multiple threads." << endl;
-                exit(-1);
-            }
         }
         solver->set_num_threads(num_threads);
 
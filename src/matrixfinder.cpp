@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "sqlstats.h"
 #include "xorfinder.h"
 #include "varreplacer.h"
+#include "unionfind.h"
 
 #include <set>
 #include <map>
@@ -73,28 +74,6 @@ inline bool MatrixFinder::firstPartOfSecond(const Xor& c1, const Xor& c2) const
     return (i1 == c1.size());
 }
 
-inline bool MatrixFinder::belong_same_matrix(const Xor& x)
-{
-    uint32_t comp_num = std::numeric_limits<uint32_t>::max();
-    for (uint32_t v : x) {
-        if (table[v] == var_Undef) {
-            //Belongs to none, abort
-            return false;
-        }
-
-        if (comp_num == std::numeric_limits<uint32_t>::max()) {
-            //Belongs to this one
-            comp_num = table[v];
-        } else {
-            if (comp_num != table[v]) {
-                //Another var in this XOR belongs to another component
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
 bool MatrixFinder::findMatrixes(bool& can_detach, bool simplify_xors)
 {
     assert(solver->decisionLevel() == 0);
@@ -173,39 +152,29 @@ bool MatrixFinder::findMatrixes(bool& can_detach, bool simplify_xors)
         return true;
     }
 
-    vector<uint32_t> newSet;
-    set<uint32_t> tomerge;
+    //Xors sharing a var go into the same matrix
+    UnionFind uf;
+    uf.resize(solver->nVars());
     for (const Xor& x : xors) {
-        if (belong_same_matrix(x)) {
-            continue;
-        }
-
-        tomerge.clear();
-        newSet.clear();
         for (uint32_t v : x) {
-            if (table[v] != var_Undef)
-                tomerge.insert(table[v]);
-            else
-                newSet.push_back(v);
-        }
-        if (tomerge.size() == 1) {
-            const uint32_t into = *tomerge.begin();
-            auto intoReverse = reverseTable.find(into);
-            for (uint32_t i = 0; i < newSet.size(); i++) {
-                intoReverse->second.push_back(newSet[i]);
-                table[newSet[i]] = into;
-            }
-            continue;
+            table[v] = 0; //in some xor, matrix is set below
+            uf.unite(x[0], v);
         }
+    }
 
-        for (uint32_t v: tomerge) {
-            newSet.insert(newSet.end(), reverseTable[v].begin(), reverseTable[v].end());
-            reverseTable.erase(v);
+    //Matrices are numbered in the order of their first xor
+    vector<uint32_t> root_to_matrix(solver->nVars(), var_Undef);
+    for (const Xor& x : xors) {
+        const uint32_t root = uf.find(x[0]);
+        if (root_to_matrix[root] == var_Undef) {
+            root_to_matrix[root] = matrix_no++;
+        }
+    }
+    for (uint32_t v = 0; v < solver->nVars(); v++) {
+        if (table[v] != var_Undef) {
+            table[v] = root_to_matrix[uf.find(v)];
+            reverseTable[table[v]].push_back(v);
         }
-        for (uint32_t i = 0; i < newSet.size(); i++)
-            table[newSet[i]] = matrix_no;
-        reverseTable[matrix_no] = newSet;
-        matrix_no++;
     }
 
     #ifdef VERBOSE_DEBUG
@@ -83,7 +83,6 @@ class MatrixFinder {
 
         inline uint32_t fingerprint(const Xor& c) const;
         inline bool firstPartOfSecond(const Xor& c1, const Xor& c2) const;
-        inline bool belong_same_matrix(const Xor& x);
 
         map<uint32_t, vector<uint32_t> > reverseTable; //matrix -> vars
         vector<uint32_t> table; //var -> matrix
@@ -0,0 +1,402 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "metrics.h"
+#include "netsync.h"
+#include "time_mem.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CMSat;
+
+static uint64_t get(const std::atomic<uint64_t>& a)
+{
+    return a.load(std::memory_order_relaxed);
+}
+
+const char* SolverMetrics::mem_name(Mem m)
+{
+    switch(m) {
+        case mem_solver: return "solver";
+        case mem_vardata: return "vardata";
+        case mem_longclauses: return "longclauses";
+        case mem_watch_alloc: return "watch-alloc";
+        case mem_watch_array: return "watch-array";
+        case mem_renumber: return "renumber";
+        case mem_occsimplifier: return "occsimplifier";
+        case mem_varreplacer: return "varreplacer";
+        case mem_comphandler: return "component";
+        case mem_rss: return "rss";
+        default: return "unknown";
+    }
+}
+
+MetricsExporter::MetricsExporter(
+    const vector<const SolverMetrics*>& _sources
+    , const string& listen_addr
+    , const string& _json_file
+    , double _every_secs
+) :
+    sources(_sources)
+    , json_file(_json_file)
+    , every_secs(std::max(_every_secs, 0.1))
+    , last(_sources.size())
+    , confl_per_sec(_sources.size(), 0)
+    , props_per_sec(_sources.size(), 0)
+    , dec_per_sec(_sources.size(), 0)
+    , stop(false)
+{
+    if (!listen_addr.empty()) {
+        //Throws std::runtime_error if the address is taken or wrong
+        listen_fd = net::listen_on(listen_addr);
+    }
+    #ifndef _WIN32
+    if (pipe(wake_fds) != 0) {
+        if (listen_fd != -1) {
+            net::close_fd(listen_fd);
+        }
+        throw std::runtime_error(
+            string("ERROR: cannot create a pipe for the metrics: ") + strerror(errno));
+    }
+    #endif
+    start_time = last_time = realTimeSec();
+    thread = std::thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop.store(true);
+    #ifndef _WIN32
+    const char c = 0;
+    if (write(wake_fds[1], &c, 1) < 0) {
+        //The thread wakes up at the next sample anyway
+    }
+    #endif
+    thread.join();
+
+    //Last values, so the file shows how it ended
+    take_sample();
+    if (!json_file.empty()) {
+        write_json();
+    }
+    #ifndef _WIN32
+    close(wake_fds[0]);
+    close(wake_fds[1]);
+    #endif
+    if (listen_fd != -1) {
+        net::close_fd(listen_fd);
+    }
+}
+
+void MetricsExporter::take_sample()
+{
+    const double now = realTimeSec();
+    const double elapsed = now - last_time;
+    for(size_t i = 0; i < sources.size(); i++) {
+        const SolverMetrics& m = *sources[i];
+        Sample s;
+        s.conflicts = get(m.conflicts);
+        s.propagations = get(m.propagations);
+        s.decisions = get(m.decisions);
+        if (elapsed > 0) {
+            confl_per_sec[i] = (double)(s.conflicts - last[i].conflicts)/elapsed;
+            props_per_sec[i] = (double)(s.propagations - last[i].propagations)/elapsed;
+            dec_per_sec[i] = (double)(s.decisions - last[i].decisions)/elapsed;
+        }
+        last[i] = s;
+    }
+    last_time = now;
+}
+
+#ifndef _WIN32
+void MetricsExporter::run()
+{
+    double next_sample = realTimeSec() + every_secs;
+    while(!stop.load()) {
+        pollfd fds[2];
+        fds[0].fd = wake_fds[0];
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = listen_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+        const int num_fds = listen_fd == -1 ? 1 : 2;
+
+        const double wait = std::max(0.0, next_sample - realTimeSec());
+        const int ret = poll(fds, num_fds, (int)(wait*1000.0) + 1);
+        if (ret < 0 && errno != EINTR) {
+            cerr << "c WARNING: metrics poll failed: " << strerror(errno) << endl;
+            return;
+        }
+        if (stop.load()) {
+            break;
+        }
+
+        if (realTimeSec() >= next_sample) {
+            take_sample();
+            if (!json_file.empty()) {
+                write_json();
+            }
+            next_sample = realTimeSec() + every_secs;
+        }
+        if (ret > 0 && num_fds == 2 && (fds[1].revents & POLLIN)) {
+            serve_one();
+        }
+    }
+}
+#else
+//No sockets here, so there is nothing to wait on but the clock. Only the
+//JSON file is written
+void MetricsExporter::run()
+{
+    double next_sample = realTimeSec() + every_secs;
+    while(!stop.load()) {
+        const double wait = std::min(0.1, std::max(0.0, next_sample - realTimeSec()));
+        std::this_thread::sleep_for(std::chrono::milliseconds((int)(wait*1000.0) + 1));
+        if (stop.load()) {
+            break;
+        }
+
+        if (realTimeSec() >= next_sample) {
+            take_sample();
+            if (!json_file.empty()) {
+                write_json();
+            }
+            next_sample = realTimeSec() + every_secs;
+        }
+    }
+}
+#endif //_WIN32
+
+string MetricsExporter::to_json() const
+{
+    std::stringstream ss;
+    ss << "{\"uptime_secs\": " << realTimeSec() - start_time
+    << ", \"threads\": [";
+    for(size_t i = 0; i < sources.size(); i++) {
+        const SolverMetrics& m = *sources[i];
+        ss << (i > 0 ? ", " : "") << "{"
+        << "\"thread\": " << i
+        << ", \"conflicts\": " << get(m.conflicts)
+        << ", \"propagations\": " << get(m.propagations)
+        << ", \"decisions\": " << get(m.decisions)
+        << ", \"restarts\": " << get(m.restarts)
+        << ", \"conflicts_per_sec\": " << confl_per_sec[i]
+        << ", \"props_per_sec\": " << props_per_sec[i]
+        << ", \"decisions_per_sec\": " << dec_per_sec[i]
+        << ", \"trail_size\": " << get(m.trail_size)
+        << ", \"free_vars\": " << get(m.free_vars)
+        << ", \"clauses\": {"
+        << "\"irred_long\": " << get(m.irred_long)
+        << ", \"irred_bins\": " << get(m.irred_bins)
+        << ", \"red_bins\": " << get(m.red_bins)
+        << ", \"red_long_tier0\": " << get(m.red_long[0])
+        << ", \"red_long_tier1\": " << get(m.red_long[1])
+        << ", \"red_long_tier2\": " << get(m.red_long[2])
+        << "}, \"sharing\": {"
+        << "\"sent_units\": " << get(m.sent_units)
+        << ", \"recv_units\": " << get(m.recv_units)
+        << ", \"sent_bins\": " << get(m.sent_bins)
+        << ", \"recv_bins\": " << get(m.recv_bins)
+        << ", \"net_sent_cls\": " << get(m.net_sent_cls)
+        << ", \"net_recv_cls\": " << get(m.net_recv_cls)
+        << "}, \"memory_bytes\": {";
+        for(int k = 0; k < SolverMetrics::num_mem; k++) {
+            ss << (k > 0 ? ", " : "") << "\""
+            << SolverMetrics::mem_name((SolverMetrics::Mem)k) << "\": "
+            << get(m.mem[k]);
+        }
+        ss << "}}";
+    }
+    ss << "]}" << endl;
+    return ss.str();
+}
+
+void MetricsExporter::write_json() const
+{
+    const string tmp = json_file + ".tmp";
+    {
+        std::ofstream f(tmp.c_str());
+        f << to_json();
+        if (!f) {
+            cerr << "c WARNING: could not write metrics to '" << tmp << "'" << endl;
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), json_file.c_str()) != 0) {
+        cerr << "c WARNING: could not rename '" << tmp << "' to '"
+        << json_file << "': " << strerror(errno) << endl;
+    }
+}
+
+string MetricsExporter::to_prometheus() const
+{
+    std::stringstream ss;
+    const auto header = [&](const char* name, const char* type, const char* help) {
+        ss << "# HELP cms_" << name << " " << help << "\n"
+        << "# TYPE cms_" << name << " " << type << "\n";
+    };
+    const auto per_thread = [&](
+        const char* name, const char* type, const char* help
+        , const std::atomic<uint64_t> SolverMetrics::*field
+    ) {
+        header(name, type, help);
+        for(size_t i = 0; i < sources.size(); i++) {
+            ss << "cms_" << name << "{thread=\"" << i << "\"} "
+            << get((*sources[i]).*field) << "\n";
+        }
+    };
+    const auto rate = [&](const char* name, const char* help, const vector<double>& v) {
+        header(name, "gauge", help);
+        for(size_t i = 0; i < v.size(); i++) {
+            ss << "cms_" << name << "{thread=\"" << i << "\"} " << v[i] << "\n";
+        }
+    };
+
+    header("uptime_seconds", "gauge", "Wall-clock seconds since solving started");
+    ss << "cms_uptime_seconds " << realTimeSec() - start_time << "\n";
+
+    per_thread("conflicts_total", "counter", "Conflicts", &SolverMetrics::conflicts);
+    per_thread("propagations_total", "counter", "Propagations", &SolverMetrics::propagations);
+    per_thread("decisions_total", "counter", "Decisions", &SolverMetrics::decisions);
+    per_thread("restarts_total", "counter", "Restarts", &SolverMetrics::restarts);
+    rate("conflicts_per_second", "Conflicts per second over the last interval", confl_per_sec);
+    rate("propagations_per_second", "Propagations per second over the last interval", props_per_sec);
+    rate("decisions_per_second", "Decisions per second over the last interval", dec_per_sec);
+    per_thread("trail_size", "gauge", "Assigned variables at the last restart", &SolverMetrics::trail_size);
+    per_thread("free_vars", "gauge", "Variables not yet fixed, removed or eliminated", &SolverMetrics::free_vars);
+
+    header("clauses", "gauge", "Clauses in the database, by kind");
+    for(size_t i = 0; i < sources.size(); i++) {
+        const SolverMetrics& m = *sources[i];
+        const std::pair<const char*, uint64_t> kinds[] = {
+            {"irred_long", get(m.irred_long)},
+            {"irred_bin", get(m.irred_bins)},
+            {"red_bin", get(m.red_bins)},
+            {"red_long_tier0", get(m.red_long[0])},
+            {"red_long_tier1", get(m.red_long[1])},
+            {"red_long_tier2", get(m.red_long[2])}
+        };
+        for(const auto& k: kinds) {
+            ss << "cms_clauses{thread=\"" << i << "\",kind=\"" << k.first
+            << "\"} " << k.second << "\n";
+        }
+    }
+
+    header("shared_total", "counter", "Units, binaries and clauses shared with other threads or processes");
+    for(size_t i = 0; i < sources.size(); i++) {
+        const SolverMetrics& m = *sources[i];
+        const std::pair<const char*, uint64_t> kinds[] = {
+            {"sent_units", get(m.sent_units)},
+            {"recv_units", get(m.recv_units)},
+            {"sent_bins", get(m.sent_bins)},
+            {"recv_bins", get(m.recv_bins)},
+            {"net_sent_cls", get(m.net_sent_cls)},
+            {"net_recv_cls", get(m.net_recv_cls)}
+        };
+        for(const auto& k: kinds) {
+            ss << "cms_shared_total{thread=\"" << i << "\",what=\"" << k.first
+            << "\"} " << k.second << "\n";
+        }
+    }
+
+    header("memory_bytes", "gauge", "Memory use by component, at the last simplification");
+    for(size_t i = 0; i < sources.size(); i++) {
+        for(int k = 0; k < SolverMetrics::num_mem; k++) {
+            ss << "cms_memory_bytes{thread=\"" << i << "\",component=\""
+            << SolverMetrics::mem_name((SolverMetrics::Mem)k) << "\"} "
+            << get(sources[i]->mem[k]) << "\n";
+        }
+    }
+    return ss.str();
+}
+
+#ifndef _WIN32
+void MetricsExporter::serve_one()
+{
+    const int fd = accept(listen_fd, NULL, NULL);
+    if (fd == -1) {
+        return;
+    }
+
+    //The answer is the same whatever is asked. Read the request so that the
+    //client doesn't get a reset, but don't wait long for it
+    timeval tv;
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    string req;
+    char buf[1024];
+    while(req.size() < 8192 && req.find("\r\n\r\n") == string::npos) {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            break;
+        }
+        req.append(buf, n);
+    }
+
+    const string body = to_prometheus();
+    std::stringstream ss;
+    ss << "HTTP/1.0 200 OK\r\n"
+    << "Content-Type: text/plain; version=0.0.4\r\n"
+    << "Content-Length: " << body.size() << "\r\n"
+    << "Connection: close\r\n\r\n"
+    << body;
+    const string resp = ss.str();
+    #ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+    size_t at = 0;
+    while(at < resp.size()) {
+        const ssize_t n = send(fd, resp.data() + at, resp.size() - at, flags);
+        if (n <= 0) {
+            break;
+        }
+        at += n;
+    }
+    net::close_fd(fd);
+}
+#else
+void MetricsExporter::serve_one()
+{
+}
+#endif //_WIN32
@@ -0,0 +1,140 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using std::vector;
+using std::string;
+
+namespace CMSat {
+
+/**
+@brief Live counters of one solver thread
+
+Written only by the thread the solver runs on: the search counters at every
+restart, the memory use at every search/simplification iteration. Every
+field is a relaxed atomic, so the exporter reads them without locking, and
+without slowing down search. A snapshot is not consistent across fields,
+which is fine for monitoring.
+*/
+struct SolverMetrics
+{
+    enum Mem {
+        mem_solver, mem_vardata, mem_longclauses, mem_watch_alloc,
+        mem_watch_array, mem_renumber, mem_occsimplifier, mem_varreplacer,
+        mem_comphandler, mem_rss, num_mem
+    };
+    static const char* mem_name(Mem m);
+
+    void set(std::atomic<uint64_t>& field, uint64_t val)
+    {
+        field.store(val, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> conflicts{0};
+    std::atomic<uint64_t> propagations{0};
+    std::atomic<uint64_t> decisions{0};
+    std::atomic<uint64_t> restarts{0};
+    std::atomic<uint64_t> trail_size{0};
+    std::atomic<uint64_t> free_vars{0};
+
+    std::atomic<uint64_t> irred_long{0};
+    std::atomic<uint64_t> irred_bins{0};
+    std::atomic<uint64_t> red_bins{0};
+    std::atomic<uint64_t> red_long[3] = {{0}, {0}, {0}};
+
+    //Sharing between threads, and between processes with --net
+    std::atomic<uint64_t> sent_units{0};
+    std::atomic<uint64_t> recv_units{0};
+    std::atomic<uint64_t> sent_bins{0};
+    std::atomic<uint64_t> recv_bins{0};
+    std::atomic<uint64_t> net_sent_cls{0};
+    std::atomic<uint64_t> net_recv_cls{0};
+
+    std::atomic<uint64_t> mem[num_mem] = {};
+};
+
+/**
+@brief Publishes the SolverMetrics of all threads of a SATSolver
+
+A background thread that, every so often, computes rates from the counters
+and writes them as JSON to a file (via a temporary file and a rename, so
+readers never see half of it). It can also listen on HOST:PORT or
+unix:PATH and answer every request with the metrics in the Prometheus text
+format, over HTTP/1.0. On Windows, only the JSON file is supported.
+*/
+class MetricsExporter
+{
+public:
+    MetricsExporter(
+        const vector<const SolverMetrics*>& sources
+        , const string& listen_addr
+        , const string& json_file
+        , double every_secs
+    );
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+private:
+    struct Sample
+    {
+        uint64_t conflicts = 0;
+        uint64_t propagations = 0;
+        uint64_t decisions = 0;
+    };
+
+    void run();
+    void take_sample();
+    string to_json() const;
+    string to_prometheus() const;
+    void write_json() const;
+    void serve_one();
+
+    const vector<const SolverMetrics*> sources;
+    const string json_file;
+    const double every_secs;
+    int listen_fd = -1;
+
+    //Only touched by the exporter thread
+    vector<Sample> last;
+    vector<double> confl_per_sec;
+    vector<double> props_per_sec;
+    vector<double> dec_per_sec;
+    double last_time;
+    double start_time;
+
+    std::atomic<bool> stop;
+    int wake_fds[2] = {-1, -1};
+    std::thread thread;
+};
+
+}
+
+#endif //__METRICS_H__
@@ -0,0 +1,584 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "netsync.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+using namespace CMSat;
+using namespace CMSat::net;
+
+//When the hub is slow to read, batches are held back instead of growing the
+//output buffer without bound. If the hub stays slow for so long that the held
+//batch gets this big, too, it is dropped
+static const size_t max_pending_write = 16U*1024U*1024U;
+static const size_t max_held_batch = max_pending_write/sizeof(uint32_t);
+
+///////////////////////////////////////
+// Encoding
+///////////////////////////////////////
+
+void net::put_varint(vector<uint8_t>& out, uint64_t val)
+{
+    while (val >= 0x80) {
+        out.push_back((uint8_t)(val | 0x80));
+        val >>= 7;
+    }
+    out.push_back((uint8_t)val);
+}
+
+bool net::get_varint(const uint8_t*& at, const uint8_t* end, uint64_t& val)
+{
+    val = 0;
+    for(uint32_t shift = 0; shift < 64; shift += 7) {
+        if (at == end) {
+            return false;
+        }
+        const uint8_t b = *at++;
+        val |= (uint64_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void net::encode_clauses(vector<uint32_t>& flat, vector<uint8_t>& out)
+{
+    size_t at = 0;
+    while(at < flat.size()) {
+        const uint32_t sz = flat[at++];
+        uint32_t* lits = flat.data() + at;
+        std::sort(lits, lits + sz);
+        put_varint(out, sz);
+        uint32_t prev = 0;
+        for(uint32_t i = 0; i < sz; i++) {
+            put_varint(out, lits[i] - prev);
+            prev = lits[i];
+        }
+        at += sz;
+    }
+}
+
+bool net::decode_clauses(const uint8_t* at, size_t len, vector<uint32_t>& flat)
+{
+    const uint8_t* end = at + len;
+    while(at != end) {
+        uint64_t sz;
+        if (!get_varint(at, end, sz) || sz == 0 || sz > len) {
+            return false;
+        }
+        flat.push_back(sz);
+        uint64_t lit = 0;
+        for(uint64_t i = 0; i < sz; i++) {
+            uint64_t delta;
+            if (!get_varint(at, end, delta)) {
+                return false;
+            }
+            lit += delta;
+            if (lit > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+            flat.push_back(lit);
+        }
+    }
+    return true;
+}
+
+uint64_t net::clause_hash(const uint32_t* lits, uint32_t size)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ size;
+    for(uint32_t i = 0; i < size; i++) {
+        h ^= lits[i];
+        h *= 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+///////////////////////////////////////
+// Sockets
+///////////////////////////////////////
+
+#ifndef _WIN32
+static void throw_error(const string& what)
+{
+    const string err = "ERROR: " + what + ": " + strerror(errno);
+    throw std::runtime_error(err);
+}
+
+static void set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        throw_error("cannot make socket non-blocking");
+    }
+    #ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    #endif
+}
+
+static bool would_block()
+{
+    #if EAGAIN == EWOULDBLOCK
+    return errno == EAGAIN;
+    #else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+    #endif
+}
+
+static bool is_unix_addr(const string& addr)
+{
+    return addr.compare(0, 5, "unix:") == 0;
+}
+
+static void fill_unix_addr(const string& addr, sockaddr_un& sa)
+{
+    const string path = addr.substr(5);
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(sa.sun_path)) {
+        throw std::runtime_error("ERROR: invalid unix socket path '" + path + "'");
+    }
+    memcpy(sa.sun_path, path.c_str(), path.size());
+}
+
+static addrinfo* resolve(const string& addr, bool passive)
+{
+    const size_t colon = addr.rfind(':');
+    if (colon == string::npos) {
+        throw std::runtime_error(
+            "ERROR: address '" + addr + "' must be HOST:PORT or unix:PATH");
+    }
+    const string host = addr.substr(0, colon);
+    const string port = addr.substr(colon+1);
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) {
+        hints.ai_flags = AI_PASSIVE;
+    }
+    addrinfo* res = NULL;
+    const bool any = host.empty() || host == "*";
+    int err = getaddrinfo(any ? NULL : host.c_str(), port.c_str(), &hints, &res);
+    if (err != 0) {
+        throw std::runtime_error(
+            "ERROR: cannot resolve '" + addr + "': " + gai_strerror(err));
+    }
+    return res;
+}
+
+int net::connect_to(const string& addr)
+{
+    int fd = -1;
+    if (is_unix_addr(addr)) {
+        sockaddr_un sa;
+        fill_unix_addr(addr, sa);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            throw_error("cannot create socket");
+        }
+        if (connect(fd, (sockaddr*)&sa, sizeof(sa)) == -1) {
+            ::close(fd);
+            throw_error("cannot connect to hub at '" + addr + "'");
+        }
+    } else {
+        addrinfo* res = resolve(addr, false);
+        for(addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd == -1) {
+                continue;
+            }
+            if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        if (fd == -1) {
+            throw_error("cannot connect to hub at '" + addr + "'");
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    set_nonblocking(fd);
+
+    return fd;
+}
+
+int net::listen_on(const string& addr)
+{
+    int fd = -1;
+    if (is_unix_addr(addr)) {
+        sockaddr_un sa;
+        fill_unix_addr(addr, sa);
+        unlink(sa.sun_path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) {
+            throw_error("cannot create socket");
+        }
+        if (bind(fd, (sockaddr*)&sa, sizeof(sa)) == -1) {
+            ::close(fd);
+            throw_error("cannot bind to '" + addr + "'");
+        }
+    } else {
+        addrinfo* res = resolve(addr, true);
+        for(addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd == -1) {
+                continue;
+            }
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+                break;
+            }
+            ::close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        if (fd == -1) {
+            throw_error("cannot bind to '" + addr + "'");
+        }
+    }
+    if (listen(fd, 64) == -1) {
+        ::close(fd);
+        throw_error("cannot listen on '" + addr + "'");
+    }
+    set_nonblocking(fd);
+
+    return fd;
+}
+
+void net::close_fd(int fd)
+{
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+
+bool Conn::write_some()
+{
+    #ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    while(out_at < out.size()) {
+        ssize_t n = send(fd, out.data() + out_at, out.size() - out_at, flags);
+        if (n > 0) {
+            out_at += n;
+            bytes_sent += n;
+        } else if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n == -1 && would_block()) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    if (out_at == out.size()) {
+        out.clear();
+        out_at = 0;
+    } else if (out_at > (1U<<20) && out_at*2 > out.size()) {
+        out.erase(out.begin(), out.begin() + out_at);
+        out_at = 0;
+    }
+    return true;
+}
+
+bool Conn::read_some()
+{
+    uint8_t buf[1U<<16];
+    while(true) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            in.insert(in.end(), buf, buf + n);
+            bytes_recv += n;
+        } else if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n == -1 && would_block()) {
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+bool Conn::flush_all()
+{
+    while(want_write()) {
+        if (!write_some()) {
+            return false;
+        }
+        if (!want_write()) {
+            break;
+        }
+        pollfd p;
+        p.fd = fd;
+        p.events = POLLOUT;
+        p.revents = 0;
+        if (poll(&p, 1, 10000) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#else //_WIN32
+
+int net::connect_to(const string&)
+{
+    throw std::runtime_error("ERROR: distributed solving is not supported on Windows");
+}
+
+int net::listen_on(const string&)
+{
+    throw std::runtime_error("ERROR: distributed solving is not supported on Windows");
+}
+
+void net::close_fd(int)
+{
+}
+
+bool Conn::write_some()
+{
+    return false;
+}
+
+bool Conn::read_some()
+{
+    return false;
+}
+
+bool Conn::flush_all()
+{
+    return false;
+}
+#endif //_WIN32
+
+///////////////////////////////////////
+// Framing
+///////////////////////////////////////
+
+Conn::Conn(int _fd) :
+    fd(_fd)
+{
+}
+
+Conn::~Conn()
+{
+    close_fd(fd);
+}
+
+void Conn::queue(MsgType type, const vector<uint8_t>& payload)
+{
+    const uint32_t len = payload.size();
+    out.push_back((uint8_t)type);
+    for(uint32_t i = 0; i < 4; i++) {
+        out.push_back((uint8_t)(len >> (8*i)));
+    }
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool Conn::next_msg(MsgType& type, vector<uint8_t>& payload, bool& malformed)
+{
+    malformed = false;
+    if (in.size() - in_at < header_size) {
+        return false;
+    }
+
+    const uint8_t* h = in.data() + in_at;
+    uint32_t len = 0;
+    for(uint32_t i = 0; i < 4; i++) {
+        len |= (uint32_t)h[1+i] << (8*i);
+    }
+    if (len > max_payload) {
+        malformed = true;
+        return false;
+    }
+    if (in.size() - in_at < header_size + len) {
+        return false;
+    }
+
+    type = (MsgType)h[0];
+    payload.assign(h + header_size, h + header_size + len);
+    in_at += header_size + len;
+    if (in_at == in.size()) {
+        in.clear();
+        in_at = 0;
+    } else if (in_at > (1U<<20) && in_at*2 > in.size()) {
+        in.erase(in.begin(), in.begin() + in_at);
+        in_at = 0;
+    }
+    return true;
+}
+
+///////////////////////////////////////
+// Client
+///////////////////////////////////////
+
+Client::Client(const string& addr) :
+    conn(connect_to(addr))
+{
+}
+
+void Client::add_clause(const vector<uint32_t>& lits)
+{
+    tmp = lits;
+    std::sort(tmp.begin(), tmp.end());
+    if (!known.insert(clause_hash(tmp.data(), tmp.size())).second) {
+        stats.dedup_cls++;
+        return;
+    }
+    batch.push_back(tmp.size());
+    batch.insert(batch.end(), tmp.begin(), tmp.end());
+    stats.sent_cls++;
+}
+
+void Client::send_batch(uint32_t num_vars)
+{
+    if (!alive) {
+        batch.clear();
+        return;
+    }
+
+    if (!hello_sent) {
+        payload.clear();
+        put_varint(payload, num_vars);
+        conn.queue(MsgType::hello, payload);
+        hello_sent = true;
+    }
+
+    if (!batch.empty()) {
+        if (conn.pending_write() <= max_pending_write) {
+            payload.clear();
+            encode_clauses(batch, payload);
+            conn.queue(MsgType::clauses, payload);
+            stats.batches++;
+            batch.clear();
+        } else if (batch.size() > max_held_batch) {
+            drop_batch();
+        } else {
+            //Keep it, it goes out with the next call
+            stats.held_batches++;
+        }
+    }
+
+    if (!conn.write_some()) {
+        alive = false;
+    }
+}
+
+//The hub has never seen these clauses, so they may be sent again later
+void Client::drop_batch()
+{
+    size_t at = 0;
+    while(at < batch.size()) {
+        const uint32_t sz = batch[at];
+        known.erase(clause_hash(batch.data() + at + 1, sz));
+        stats.sent_cls--;
+        at += 1 + sz;
+    }
+    batch.clear();
+    stats.dropped_batches++;
+}
+
+bool Client::receive(vector<uint32_t>& flat, bool& got_done)
+{
+    got_done = false;
+    if (!alive) {
+        return false;
+    }
+
+    //Even if the hub has gone, process what it has sent before
+    const bool read_ok = conn.read_some();
+
+    MsgType type;
+    bool malformed;
+    while(conn.next_msg(type, payload, malformed)) {
+        if (type == MsgType::done) {
+            got_done = true;
+        } else if (type == MsgType::clauses) {
+            const size_t start = flat.size();
+            if (!decode_clauses(payload.data(), payload.size(), flat)) {
+                flat.resize(start);
+                continue;
+            }
+            size_t at = start;
+            while(at < flat.size()) {
+                const uint32_t sz = flat[at];
+                known.insert(clause_hash(flat.data() + at + 1, sz));
+                stats.recv_cls++;
+                at += 1 + sz;
+            }
+        }
+    }
+
+    if (!read_ok || malformed) {
+        alive = false;
+    }
+    return alive;
+}
+
+void Client::send_done()
+{
+    if (!alive || done_sent) {
+        return;
+    }
+    done_sent = true;
+    payload.clear();
+    conn.queue(MsgType::done, payload);
+    if (!conn.flush_all()) {
+        alive = false;
+    }
+}
+
+Client::Stats Client::get_stats() const
+{
+    Stats s = stats;
+    s.bytes_sent = conn.bytes_sent;
+    s.bytes_recv = conn.bytes_recv;
+    return s;
+}
@@ -0,0 +1,173 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __NETSYNC_H__
+#define __NETSYNC_H__
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_set>
+
+using std::vector;
+using std::string;
+
+namespace CMSat {
+
+/**
+@brief Wire format and transport of distributed clause sharing
+
+Solver processes connect to a hub (see cmsat_hub.cpp), which forwards what
+one process sends to all the others. Every frame is a one-byte type, followed
+by the payload length as 4 bytes little-endian, followed by the payload.
+
+Clauses travel as a flat array of [size, lit, lit, ...] where every lit is
+Lit::toInt() in outside numbering. Units are clauses of size 1. In the
+payload, every number is a varint, and the sorted literals of a clause are
+delta-coded, so a short clause typically takes a few bytes.
+*/
+namespace net {
+
+enum class MsgType : uint8_t {
+    hello = 1,   ///<payload: number of variables
+    clauses = 2, ///<payload: encoded clauses
+    done = 3     ///<someone found the answer, stop. No payload
+};
+
+static const size_t header_size = 5;
+static const size_t max_payload = 64U*1024U*1024U;
+
+void put_varint(vector<uint8_t>& out, uint64_t val);
+bool get_varint(const uint8_t*& at, const uint8_t* end, uint64_t& val);
+
+///Sorts the literals of every clause in place, then encodes them
+void encode_clauses(vector<uint32_t>& flat, vector<uint8_t>& out);
+
+///Returns false if the payload is malformed
+bool decode_clauses(const uint8_t* at, size_t len, vector<uint32_t>& flat);
+
+///Literals must be sorted
+uint64_t clause_hash(const uint32_t* lits, uint32_t size);
+
+///"host:port" or "unix:/path". Throw std::runtime_error on failure
+int connect_to(const string& addr);
+int listen_on(const string& addr);
+void close_fd(int fd);
+
+/**
+@brief One non-blocking, framed connection
+*/
+class Conn
+{
+public:
+    explicit Conn(int fd);
+    ~Conn();
+    Conn(const Conn&) = delete;
+    Conn& operator=(const Conn&) = delete;
+
+    void queue(MsgType type, const vector<uint8_t>& payload);
+    bool want_write() const
+    {
+        return out_at < out.size();
+    }
+    size_t pending_write() const
+    {
+        return out.size() - out_at;
+    }
+
+    ///Both return false if the connection is gone
+    bool write_some();
+    bool read_some();
+
+    ///Blocks until everything queued has been written
+    bool flush_all();
+
+    ///Pops the next complete frame. Returns false if there is none
+    bool next_msg(MsgType& type, vector<uint8_t>& payload, bool& malformed);
+
+    int fd;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_recv = 0;
+
+private:
+    vector<uint8_t> in;
+    size_t in_at = 0;
+    vector<uint8_t> out;
+    size_t out_at = 0;
+};
+
+/**
+@brief The solver side: batches what is to be sent, and drops what the hub
+already knows about
+*/
+class Client
+{
+public:
+    explicit Client(const string& addr);
+
+    ///Literals are Lit::toInt(), outside numbering
+    void add_clause(const vector<uint32_t>& lits);
+
+    ///Sends the batch collected since the last call. If the hub is not
+    ///reading, the batch is held back and sent with a later call, or dropped
+    ///if it gets too large. Dropped clauses may be added again
+    void send_batch(uint32_t num_vars);
+
+    ///Appends the received clauses to flat. Returns false if the connection
+    ///is gone. got_done is set if another process has finished
+    bool receive(vector<uint32_t>& flat, bool& got_done);
+
+    ///Tells the others to stop, and waits until that is sent
+    void send_done();
+
+    struct Stats
+    {
+        uint64_t sent_cls = 0;
+        uint64_t recv_cls = 0;
+        uint64_t dedup_cls = 0;
+        uint64_t batches = 0;
+        uint64_t held_batches = 0;
+        uint64_t dropped_batches = 0;
+        uint64_t bytes_sent = 0;
+        uint64_t bytes_recv = 0;
+    };
+    Stats get_stats() const;
+
+private:
+    Conn conn;
+    bool alive = true;
+    bool hello_sent = false;
+    bool done_sent = false;
+    vector<uint32_t> batch;
+    vector<uint32_t> tmp;
+    vector<uint8_t> payload;
+    std::unordered_set<uint64_t> known;
+    Stats stats;
+
+    void drop_batch();
+};
+
+}
+}
+
+#endif //__NETSYNC_H__
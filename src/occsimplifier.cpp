@@ -31,8 +31,8 @@ THE SOFTWARE.
 #include <set>
 #include <iostream>
 #include <limits>
-#include <cmath>
 #include <functional>
+#include <cmath>
 
 
 #include "popcnt.h"
@@ -52,6 +52,7 @@ THE SOFTWARE.
 #include "subsumeimplicit.h"
 #include "sqlstats.h"
 #include "datasync.h"
+#include "extprop.h"
 #include "xorfinder.h"
 #include "bva.h"
 #include "trim.h"
@@ -122,7 +123,7 @@ OccSimplifier::~OccSimplifier()
 void OccSimplifier::new_var(const uint32_t /*orig_outer*/)
 {
     n_occurs.insert(n_occurs.end(), 2, 0);
-    if (solver->conf.sampling_vars) {
+    if (!sampling_vars_occsimp.empty()) {
         sampling_vars_occsimp.insert(sampling_vars_occsimp.end(), 1, 0);
     }
 }
@@ -130,7 +131,7 @@ void OccSimplifier::new_var(const uint32_t /*orig_outer*/)
 void OccSimplifier::new_vars(size_t n)
 {
     n_occurs.insert(n_occurs.end(), n*2ULL, 0);
-    if (solver->conf.sampling_vars) {
+    if (!sampling_vars_occsimp.empty()) {
         sampling_vars_occsimp.insert(sampling_vars_occsimp.end(), n, 0);
     }
 }
@@ -226,51 +227,122 @@ void OccSimplifier::extend_model(SolutionExtender* extender)
     #endif
 
     //go through in reverse order
-    vector<Lit> lits;
     for (int i = (int)blockedClauses.size()-1; i >= 0; i--) {
-        BlockedClauses* it = &blockedClauses[i];
-        if (it->toRemove) {
+        const BlockedClauses& blocked = blockedClauses[i];
+        if (blocked.toRemove) {
             continue;
         }
+        extend_model_blocked(extender, blocked);
+    }
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [extend] Extended " << blockedClauses.size() << " var-elim clauses" << endl;
+    }
+}
 
-        Lit blockedOn = solver->varReplacer->get_lit_replaced_with_outer(it->at(0, blkcls));
-        size_t at = 1;
-        bool satisfied = false;
-        lits.clear();
-        while(at < it->size()) {
-            //built clause, reached marker, "lits" is now valid
-            if (it->at(at, blkcls) == lit_Undef) {
-                if (!satisfied) {
-                    bool var_set = extender->addClause(lits, blockedOn.var());
-
-                    #ifndef DEBUG_VARELIM
-                    //all should be satisfied in fact
-                    //no need to go any further
-                    if (var_set) {
-                        break;
-                    }
-                    #endif
+void OccSimplifier::extend_model_blocked(
+    SolutionExtender* extender
+    , const BlockedClauses& blocked
+) {
+    vector<Lit>& lits = tmp_extend_lits;
+    Lit blockedOn = solver->varReplacer->get_lit_replaced_with_outer(blocked.at(0, blkcls));
+    size_t at = 1;
+    bool satisfied = false;
+    lits.clear();
+    while(at < blocked.size()) {
+        //built clause, reached marker, "lits" is now valid
+        if (blocked.at(at, blkcls) == lit_Undef) {
+            if (!satisfied) {
+                bool var_set = extender->addClause(lits, blockedOn.var());
+
+                #ifndef DEBUG_VARELIM
+                //all should be satisfied in fact
+                //no need to go any further
+                if (var_set) {
+                    break;
                 }
-                satisfied = false;
-                lits.clear();
+                #endif
+            }
+            satisfied = false;
+            lits.clear();
 
-            //Building clause, "lits" is not yet valid
-            } else if (!satisfied) {
-                Lit l = it->at(at, blkcls);
-                l = solver->varReplacer->get_lit_replaced_with_outer(l);
-                lits.push_back(l);
+        //Building clause, "lits" is not yet valid
+        } else if (!satisfied) {
+            Lit l = blocked.at(at, blkcls);
+            l = solver->varReplacer->get_lit_replaced_with_outer(l);
+            lits.push_back(l);
 
-                //Blocked clause can be skipped, it's satisfied
-                if (solver->model_value(l) == l_True) {
-                    satisfied = true;
-                }
+            //Blocked clause can be skipped, it's satisfied
+            if (solver->model_value(l) == l_True) {
+                satisfied = true;
+            }
+        }
+        at++;
+    }
+    extender->dummyBlocked(blockedOn.var());
+}
+
+//Like extend_model(), but only for the blocked clauses that the value of the
+//outer vars in "vars" depend on: those of the vars themselves, then those of
+//the eliminated vars in them, and so on. The rest of the eliminated vars stay
+//l_Undef. Vars must be their own replacement.
+void OccSimplifier::extend_model_projected(
+    SolutionExtender* extender
+    , const vector<uint32_t>& vars
+) {
+    if (!blockedMapBuilt) {
+        buildBlockedMap();
+    }
+    extend_needed.resize(solver->nVarsOuter(), 0);
+
+    //Collect the blocked clause groups the vars depend on. A group only
+    //contains vars that were eliminated after it, i.e. whose group is later
+    vector<uint32_t>& todo = tmp_extend_vars;
+    vector<uint32_t>& groups = tmp_extend_groups;
+    todo.clear();
+    groups.clear();
+    for(const uint32_t var: vars) {
+        if (!extend_needed[var]) {
+            extend_needed[var] = 1;
+            todo.push_back(var);
+        }
+    }
+    for(size_t i = 0; i < todo.size(); i++) {
+        const uint32_t var = todo[i];
+        const uint32_t at = blk_var_to_cls[var];
+        if (at == std::numeric_limits<uint32_t>::max()
+            || blockedClauses[at].toRemove
+            || solver->model_value(var) != l_Undef
+        ) {
+            continue;
+        }
+        groups.push_back(at);
+
+        const BlockedClauses& blocked = blockedClauses[at];
+        for(size_t x = 1; x < blocked.size(); x++) {
+            const Lit l = blocked.at(x, blkcls);
+            if (l == lit_Undef) {
+                continue;
+            }
+            const uint32_t v = solver->varReplacer->get_var_replaced_with_outer(l.var());
+            if (!extend_needed[v]) {
+                extend_needed[v] = 1;
+                todo.push_back(v);
             }
-            at++;
         }
-        extender->dummyBlocked(blockedOn.var());
+    }
+    for(const uint32_t var: todo) {
+        extend_needed[var] = 0;
+    }
+
+    //Same order as extend_model()
+    std::sort(groups.begin(), groups.end(), std::greater<uint32_t>());
+    for(const uint32_t at: groups) {
+        extend_model_blocked(extender, blockedClauses[at]);
     }
     if (solver->conf.verbosity >= 2) {
-        cout << "c [extend] Extended " << blockedClauses.size() << " var-elim clauses" << endl;
+        cout << "c [extend] Extended " << groups.size() << " var-elim clauses"
+        << " out of " << blockedClauses.size()
+        << " for " << vars.size() << " vars" << endl;
     }
 }
 
@@ -331,6 +403,8 @@ lbool OccSimplifier::clean_clause(ClOffset offset)
     bool satisfied = false;
     Clause& cl = *solver->cl_alloc.ptr(offset);
     (*solver->drat) << deldelay << cl << fin;
+    const bool hints = solver->drat->hints_needed();
+    frat_hints.clear();
 
     Lit* i = cl.begin();
     Lit* j = cl.begin();
@@ -346,6 +420,8 @@ lbool OccSimplifier::clean_clause(ClOffset offset)
 
         if (solver->value(*i) == l_True)
             satisfied = true;
+        else if (hints)
+            frat_hints.push_back(solver->drat->unit_ID(~*i));
 
         if (solver->value(*i) == l_True
             || solver->value(*i) == l_False
@@ -379,6 +455,10 @@ lbool OccSimplifier::clean_clause(ClOffset offset)
     }
 
     if (i-j > 0) {
+        if (hints) {
+            frat_hints.push_back(solver->drat->ID_of(cl));
+            solver->drat->set_hints(frat_hints);
+        }
         (*solver->drat) << add << cl
         #ifdef STATS_NEEDED
         << solver->sumConflicts
@@ -438,6 +518,8 @@ bool OccSimplifier::complete_clean_clause(Clause& cl)
         solver->litStats.irredLits -= cl.size();
     }
 
+    const bool hints = solver->drat->hints_needed();
+    frat_hints.clear();
     Lit *i = cl.begin();
     Lit *j = i;
     for (Lit *end = cl.end(); i != end; i++) {
@@ -449,6 +531,8 @@ bool OccSimplifier::complete_clean_clause(Clause& cl)
 
         if (solver->value(*i) == l_Undef) {
             *j++ = *i;
+        } else if (hints) {
+            frat_hints.push_back(solver->drat->unit_ID(~*i));
         }
     }
     cl.shrink(i-j);
@@ -456,6 +540,10 @@ bool OccSimplifier::complete_clean_clause(Clause& cl)
 
     //Drat
     if (i - j > 0) {
+        if (hints) {
+            frat_hints.push_back(solver->drat->ID_of(cl));
+            solver->drat->set_hints(frat_hints);
+        }
         (*solver->drat) << add << cl
         #ifdef STATS_NEEDED
         << solver->sumConflicts
@@ -621,6 +709,7 @@ void OccSimplifier::add_back_to_solver()
 
         if (check_varelim_when_adding_back_cl(cl)) {
             //The clause wasn't linked in but needs removal now
+            (*solver->drat) << del << *cl << fin;
             if (cl->red()) {
                 solver->litStats.redLits -= cl->size();
             } else {
@@ -752,7 +841,7 @@ bool OccSimplifier::can_eliminate_var(const uint32_t var) const
     if (solver->value(var) != l_Undef
         || solver->varData[var].removed != Removed::none
         || solver->var_inside_assumptions(var) != l_Undef
-        || (solver->conf.sampling_vars && sampling_vars_occsimp[var])
+        || (!sampling_vars_occsimp.empty() && sampling_vars_occsimp[var])
     ) {
         return false;
     }
@@ -1504,16 +1593,23 @@ bool OccSimplifier::simplify(const bool _startup, const std::string schedule)
 
 
     sampling_vars_occsimp.clear();
-    if (solver->conf.sampling_vars) {
+    if (solver->conf.sampling_vars || solver->extprop) {
         sampling_vars_occsimp.resize(solver->nVars(), false);
-        for(uint32_t outside_var: *solver->conf.sampling_vars) {
-            uint32_t outer_var = solver->map_to_with_bva(outside_var);
-            outer_var = solver->varReplacer->get_var_replaced_with_outer(outer_var);
-            uint32_t int_var = solver->map_outer_to_inter(outer_var);
-            if (int_var < solver->nVars()) {
-                sampling_vars_occsimp[int_var] = true;
+        if (solver->conf.sampling_vars) {
+            for(uint32_t outside_var: *solver->conf.sampling_vars) {
+                uint32_t outer_var = solver->map_to_with_bva(outside_var);
+                outer_var = solver->varReplacer->get_var_replaced_with_outer(outer_var);
+                uint32_t int_var = solver->map_outer_to_inter(outer_var);
+                if (int_var < solver->nVars()) {
+                    sampling_vars_occsimp[int_var] = true;
+                }
             }
         }
+
+        //The external propagator's clauses may come any time
+        if (solver->extprop) {
+            solver->extprop->mark_observed(sampling_vars_occsimp);
+        }
     } else {
         sampling_vars_occsimp.shrink_to_fit();
     }
@@ -1630,6 +1726,10 @@ bool OccSimplifier::perform_ternary(Clause* cl, ClOffset offs)
         for(uint32_t i = 0; i < newcl.size; i++) {
             tmp.push_back(newcl.lits[i]);
         }
+        if (solver->drat->hints_needed()) {
+            solver->frat_hints.push_back(newcl.ID1);
+            solver->frat_hints.push_back(newcl.ID2);
+        }
 
         Clause* newCl = solver->add_clause_int(
             tmp //Literals in new clause
@@ -1729,6 +1829,8 @@ void OccSimplifier::check_ternary_cl(Clause* cl, ClOffset offs, watch_subarray w
                 }
 
                 if (newcl.size == 2 || newcl.size == 3) {
+                    newcl.ID1 = solver->drat->ID_of(*cl);
+                    newcl.ID2 = solver->drat->ID_of(*cl2);
                     if (newcl.size == 2) {
                         runStats.ternary_added_bin++;
                     } else {
@@ -1921,7 +2023,7 @@ bool OccSimplifier::uneliminate(uint32_t var)
     while(bat < blockedClauses[at_blocked_cls].size()) {
         Lit l = blockedClauses[at_blocked_cls].at(bat, blkcls);
         if (l == lit_Undef) {
-            solver->addClause(lits);
+            solver->addClause(lits, false, blk_ID(blockedClauses[at_blocked_cls].start + bat));
             if (!solver->okay()) {
                 return false;
             }
@@ -1935,6 +2037,31 @@ bool OccSimplifier::uneliminate(uint32_t var)
     return solver->okay();
 }
 
+uint32_t OccSimplifier::blk_ID(const uint64_t at) const
+{
+    return at < blkcls_IDs.size() ? blkcls_IDs[at] : 0;
+}
+
+void OccSimplifier::finalize_frat()
+{
+    vector<Lit> lits;
+    for(const BlockedClauses& blocked: blockedClauses) {
+        if (blocked.toRemove) {
+            continue;
+        }
+        lits.clear();
+        for(uint64_t at = 1; at < blocked.size(); at++) {
+            const Lit l = blocked.at(at, blkcls);
+            if (l == lit_Undef) {
+                solver->drat->finalize(blk_ID(blocked.start + at), lits, true);
+                lits.clear();
+            } else {
+                lits.push_back(l);
+            }
+        }
+    }
+}
+
 void OccSimplifier::remove_by_drat_recently_blocked_clauses(size_t origBlockedSize)
 {
     if (! ((*solver->drat).enabled() || solver->conf.simulate_drat) )
@@ -2134,6 +2261,9 @@ void OccSimplifier::cleanBlockedClauses()
 
     uint64_t i_blkcls = 0;
     uint64_t j_blkcls = 0;
+    if (!blkcls_IDs.empty()) {
+        blkcls_IDs.resize(blkcls.size(), 0);
+    }
     for (vector<BlockedClauses>::iterator
         end = blockedClauses.end()
         ; i != end
@@ -2166,6 +2296,9 @@ void OccSimplifier::cleanBlockedClauses()
             //don't copy if we don't need to
             if (!blockedMapBuilt) {
                 for(size_t x = 0; x < sz; x++) {
+                    if (!blkcls_IDs.empty()) {
+                        blkcls_IDs[j_blkcls] = blkcls_IDs[i_blkcls];
+                    }
                     blkcls[j_blkcls++] = blkcls[i_blkcls++];
                 }
             } else {
@@ -2179,6 +2312,9 @@ void OccSimplifier::cleanBlockedClauses()
         }
     }
     blkcls.resize(j_blkcls);
+    if (!blkcls_IDs.empty()) {
+        blkcls_IDs.resize(j_blkcls);
+    }
     blockedClauses.resize(blockedClauses.size()-(i-j));
     can_remove_blocked_clauses = false;
 }
@@ -2213,7 +2349,7 @@ void OccSimplifier::rem_cls_from_watch_due_to_varelim(
 
                 lits.resize(cl.size());
                 std::copy(cl.begin(), cl.end(), lits.begin());
-                add_clause_to_blck(lits);
+                add_clause_to_blck(lits, solver->drat->release_ID(cl));
             } else {
                 red = true;
                 bvestats.longRedClRemThroughElim++;
@@ -2240,7 +2376,7 @@ void OccSimplifier::rem_cls_from_watch_due_to_varelim(
             lits[0] = lit;
             lits[1] = watch.lit2();
             if (!watch.red()) {
-                add_clause_to_blck(lits);
+                add_clause_to_blck(lits, solver->drat->release_ID(lits[0], lits[1]));
                 n_occurs[lits[0].toInt()]--;
                 n_occurs[lits[1].toInt()]--;
             } else {
@@ -2266,7 +2402,9 @@ void OccSimplifier::rem_cls_from_watch_due_to_varelim(
     }
 }
 
-void OccSimplifier::add_clause_to_blck(const vector<Lit>& lits)
+//The irredundant clauses of eliminated variables stay in the FRAT proof,
+//ID is kept to re-add or finalise them
+void OccSimplifier::add_clause_to_blck(const vector<Lit>& lits, const uint32_t ID)
 {
     for(const Lit& l: lits) {
         removed_cl_with_var.touch(l.var());
@@ -2280,6 +2418,10 @@ void OccSimplifier::add_clause_to_blck(const vector<Lit>& lits)
     }
     blkcls.push_back(lit_Undef);
     blockedClauses.back().end = blkcls.size();
+    if (ID != 0) {
+        blkcls_IDs.resize(blkcls.size(), 0);
+        blkcls_IDs.back() = ID;
+    }
 }
 
 void OccSimplifier::find_gate(
@@ -2485,7 +2627,7 @@ int OccSimplifier::test_elim_and_fill_resolvents(const uint32_t var)
             }
             //must clear marking that has been set due to gate
             stats.marked_clause = 0;
-            resolvents.add_resolvent(dummy, stats, is_xor);
+            resolvents.add_resolvent(dummy, stats, is_xor, frat_ID(lit, *it), frat_ID(~lit, *it2));
         }
     }
 
@@ -2698,8 +2840,13 @@ bool OccSimplifier::maybe_eliminate(const uint32_t var)
     rem_cls_from_watch_due_to_varelim(solver->watches[lit], lit);
     rem_cls_from_watch_due_to_varelim(solver->watches[~lit], ~lit);
 
-    //Add resolvents
+    //Add resolvents. The positive clause becomes unit, the negative one
+    //is then in conflict
     while(!resolvents.empty()) {
+        if (solver->drat->hints_needed()) {
+            solver->frat_hints.push_back(resolvents.back_data().pos_ID);
+            solver->frat_hints.push_back(resolvents.back_data().neg_ID);
+        }
         if (!add_varelim_resolvent(resolvents.back_lits(),
             resolvents.back_stats(), resolvents.back_xor())
         ) {
@@ -2715,6 +2862,18 @@ end:
     return true; //eliminated!
 }
 
+//ID of the clause in the watchlist of lit, only looked up for hints
+uint32_t OccSimplifier::frat_ID(const Lit lit, const Watched& w) const
+{
+    if (!solver->drat->hints_needed()) {
+        return 0;
+    }
+    if (w.isBin()) {
+        return solver->drat->bin_ID(lit, w.lit2());
+    }
+    return solver->drat->ID_of(*solver->cl_alloc.ptr(w.get_offset()));
+}
+
 void OccSimplifier::add_pos_lits_to_dummy_and_seen(
     const Watched ps
     , const Lit posLit
@@ -3158,6 +3317,7 @@ size_t OccSimplifier::mem_used() const
     b += blockedClauses.capacity()*sizeof(BlockedClauses);
     b += blkcls.capacity()*sizeof(Lit);
     b += blk_var_to_cls.size()*sizeof(uint32_t);
+    b += extend_needed.capacity();
     b += velim_order.mem_used();
     b += varElimComplexity.capacity()*sizeof(int)*2;
     b += elim_calc_need_update.mem_used();
@@ -3317,6 +3477,7 @@ void OccSimplifier::save_state(SimpleOutFile& f)
     }
     f.put_vector(blkcls);
     f.put_struct(globalStats);
+    f.put_struct(bvestats_global);
     f.put_uint32_t(anythingHasBeenBlocked);
 
 
@@ -3330,7 +3491,9 @@ void OccSimplifier::load_state(SimpleInFile& f)
         blockedClauses.push_back(b);
     }
     f.get_vector(blkcls);
+    blkcls_IDs.clear();
     f.get_struct(globalStats);
+    f.get_struct(bvestats_global);
     anythingHasBeenBlocked = f.get_uint32_t();
 
     blockedMapBuilt = false;
@@ -3343,3 +3506,18 @@ void OccSimplifier::load_state(SimpleInFile& f)
         }
     }
 }
+
+//What save_state() of "other" would write, without cleaning "other" up
+void OccSimplifier::copy_state_from(const OccSimplifier& other)
+{
+    blockedClauses = other.blockedClauses;
+    blkcls = other.blkcls;
+    blkcls_IDs.clear();
+    globalStats = other.globalStats;
+    bvestats_global = other.bvestats_global;
+    anythingHasBeenBlocked = other.anythingHasBeenBlocked;
+
+    cleanBlockedClauses();
+    blockedMapBuilt = false;
+    buildBlockedMap();
+}
@@ -221,9 +221,22 @@ public:
     void print_gatefinder_stats() const;
     uint32_t dump_blocked_clauses(std::ostream* outfile) const;
 
+    //Calls f(lits, size) for each group of clauses removed by elimination.
+    //Lits are outer, lits[0] is the eliminated one, clauses end in lit_Undef
+    template<class F>
+    void for_each_blocked_clause_group(F f) const
+    {
+        for (const BlockedClauses& blocked: blockedClauses) {
+            if (!blocked.toRemove) {
+                f(blkcls.data() + blocked.start, blocked.size());
+            }
+        }
+    }
+
     //UnElimination
     void print_blocked_clauses_reverse() const;
     void extend_model(SolutionExtender* extender);
+    void extend_model_projected(SolutionExtender* extender, const vector<uint32_t>& vars);
     uint32_t get_num_elimed_vars() const
     {
         return bvestats_global.numVarsElimed;
@@ -264,6 +277,8 @@ public:
     void sort_occurs_and_set_abst();
     void save_state(SimpleOutFile& f);
     void load_state(SimpleInFile& f);
+    void copy_state_from(const OccSimplifier& other);
+    void finalize_frat();
     vector<ClOffset> added_long_cl;
     TouchListLit added_cl_to_var;
     vector<uint32_t> n_occurs;
@@ -300,6 +315,8 @@ private:
     struct Tri {
         Lit lits[3];
         uint32_t size = 0;
+        uint32_t ID1 = 0; ///<FRAT IDs of the clauses it was resolved from
+        uint32_t ID2 = 0;
 
         Tri () :
             size(0)
@@ -309,6 +326,8 @@ private:
         {
             memcpy(lits, other.lits, sizeof(Lit)*3);
             size = other.size;
+            ID1 = other.ID1;
+            ID2 = other.ID2;
         }
     };
     vector<Tri> cl_to_add_ternary;
@@ -390,6 +409,7 @@ private:
     bool        handleUpdatedClause(ClOffset c);
     uint32_t    sum_irred_cls_longs() const;
     uint32_t    sum_irred_cls_longs_lits() const;
+    vector<uint32_t> frat_hints;
 
     struct watch_sort_smallest_first {
         bool operator()(const Watched& first, const Watched& second)
@@ -428,7 +448,7 @@ private:
     void        rem_cls_from_watch_due_to_varelim(watch_subarray todo, const Lit lit);
     vector<Lit> tmp_rem_lits;
     vec<Watched> tmp_rem_cls_copy;
-    void        add_clause_to_blck(const vector<Lit>& lits);
+    void        add_clause_to_blck(const vector<Lit>& lits, const uint32_t ID);
     void        set_var_as_eliminated(const uint32_t var, const Lit lit);
     bool        can_eliminate_var(const uint32_t var) const;
     bool        clear_vars_from_cls_that_have_been_set(size_t& last_trail);
@@ -455,13 +475,24 @@ private:
         ResolventData()
         {}
 
-        ResolventData(const ClauseStats& cls, const bool _is_xor) :
+        ResolventData(
+            const ClauseStats& cls
+            , const bool _is_xor
+            , const uint32_t _pos_ID
+            , const uint32_t _neg_ID
+        ) :
             stats(cls),
-            is_xor(_is_xor)
+            is_xor(_is_xor),
+            pos_ID(_pos_ID),
+            neg_ID(_neg_ID)
         {}
 
         ClauseStats stats;
         bool is_xor;
+
+        //FRAT IDs of the clauses it was resolved from
+        uint32_t pos_ID;
+        uint32_t neg_ID;
     };
 
     struct Resolvents {
@@ -471,14 +502,20 @@ private:
         void clear() {
             at = 0;
         }
-        void add_resolvent(const vector<Lit>& res, const ClauseStats& stats, bool is_xor) {
+        void add_resolvent(
+            const vector<Lit>& res
+            , const ClauseStats& stats
+            , bool is_xor
+            , const uint32_t pos_ID
+            , const uint32_t neg_ID
+        ) {
             if (resolvents_lits.size() < at+1) {
                 resolvents_lits.resize(at+1);
                 resolvents_stats.resize(at+1);
             }
 
             resolvents_lits[at] = res;
-            resolvents_stats[at] = ResolventData(stats, is_xor);
+            resolvents_stats[at] = ResolventData(stats, is_xor, pos_ID, neg_ID);
             at++;
         }
         vector<Lit>& back_lits() {
@@ -493,6 +530,10 @@ private:
             assert(at > 0);
             return resolvents_stats[at-1].is_xor;
         }
+        const ResolventData& back_data() const {
+            assert(at > 0);
+            return resolvents_stats[at-1];
+        }
         void pop() {
             at--;
         }
@@ -528,6 +569,7 @@ private:
         , const Watched qs
         , const Lit noPosLit
     );
+    uint32_t frat_ID(const Lit lit, const Watched& w) const;
     void add_pos_lits_to_dummy_and_seen(
         const Watched ps
         , const Lit posLit
@@ -550,12 +592,19 @@ private:
     //Blocked clause elimination
     bool anythingHasBeenBlocked;
     vector<Lit> blkcls;
+    vector<uint32_t> blkcls_IDs; ///<FRAT IDs at the lit_Undef ending each clause in blkcls, empty if none
     vector<BlockedClauses> blockedClauses; ///<maps var(outer!!) to postion in blockedClauses
     vector<uint32_t> blk_var_to_cls;
     bool blockedMapBuilt;
     void buildBlockedMap();
     void cleanBlockedClauses();
+    uint32_t blk_ID(const uint64_t at) const;
     bool can_remove_blocked_clauses = false;
+    void extend_model_blocked(SolutionExtender* extender, const BlockedClauses& blocked);
+    vector<char> extend_needed; ///<outer var, scratch of extend_model_projected()
+    vector<uint32_t> tmp_extend_vars;
+    vector<uint32_t> tmp_extend_groups;
+    vector<Lit> tmp_extend_lits;
 
     //validity checking
     void sanityCheckElimedVars();
@@ -568,11 +568,13 @@ bool PropEngine::propagate_binary_clause_occur(const Watched& ws)
 {
     const lbool val = value(ws.lit2());
     if (val == l_False) {
+        *drat << add << fin;
         return false;
     }
 
     if (val == l_Undef) {
         enqueue(ws.lit2());
+        *drat << add << ws.lit2() << fin;
         #ifdef STATS_NEEDED
         if (ws.red())
             propStats.propsBinRed++;
@@ -611,6 +613,7 @@ bool PropEngine::propagate_long_clause_occur(const ClOffset offset)
 
     //Problem is UNSAT
     if (numUndef == 0) {
+        *drat << add << fin;
         return false;
     }
 
@@ -618,6 +621,7 @@ bool PropEngine::propagate_long_clause_occur(const ClOffset offset)
         return true;
 
     enqueue(lastUndef);
+    *drat << add << lastUndef << fin;
     #ifdef STATS_NEEDED
     if (cl.red())
         propStats.propsLongRed++;
@@ -644,6 +648,55 @@ void PropEngine::load_state(SimpleInFile& f)
     CNF::load_state(f);
 }
 
+void PropEngine::save_checkpoint(SimpleOutFile& f) const
+{
+    assert(decisionLevel() == 0);
+    CNF::save_checkpoint(f);
+
+    f.put_vector(trail);
+    f.put_vector(var_act_vsids);
+    f.put_vector(var_act_maple);
+    f.put_struct(var_decay);
+    f.put_struct(maple_step_size);
+    f.put_struct(max_vsids_act);
+    f.put_struct(max_cl_act);
+    f.put_struct(simpDB_props);
+}
+
+void PropEngine::load_checkpoint(SimpleInFile& f)
+{
+    CNF::load_checkpoint(f);
+
+    f.get_vector(trail);
+    f.get_vector(var_act_vsids);
+    f.get_vector(var_act_maple);
+    f.get_struct(var_decay);
+    f.get_struct(maple_step_size);
+    f.get_struct(max_vsids_act);
+    f.get_struct(max_cl_act);
+    f.get_struct(simpDB_props);
+
+    //Watches are rebuilt by the caller, everything on the trail will be
+    //propagated again
+    qhead = 0;
+}
+
+void PropEngine::copy_checkpoint_from(const PropEngine& other)
+{
+    CNF::copy_checkpoint_from(other);
+
+    trail = other.trail;
+    trail_lim = other.trail_lim;
+    qhead = other.qhead;
+    var_act_vsids = other.var_act_vsids;
+    var_act_maple = other.var_act_maple;
+    var_decay = other.var_decay;
+    maple_step_size = other.maple_step_size;
+    max_vsids_act = other.max_vsids_act;
+    max_cl_act = other.max_cl_act;
+    simpDB_props = other.simpDB_props;
+}
+
 #ifdef STATS_NEEDED_BRANCH
 void PropEngine::sql_dump_vardata_picktime(uint32_t v, PropBy from)
 {
@@ -169,6 +169,9 @@ protected:
     //For state saving
     void save_state(SimpleOutFile& f) const;
     void load_state(SimpleInFile& f);
+    void save_checkpoint(SimpleOutFile& f) const;
+    void load_checkpoint(SimpleInFile& f);
+    void copy_checkpoint_from(const PropEngine& other);
 
     //Stats for conflicts
     ConflCausedBy lastConflictCausedBy;
@@ -181,6 +184,7 @@ protected:
     Lit                 failBinLit;       ///< Used to store which watches[lit] we were looking through when conflict occured
 
     friend class EGaussian;
+    friend class ExtProp;
 
     PropBy propagate_any_order_fast();
     template<bool update_bogoprops>
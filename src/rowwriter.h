@@ -0,0 +1,79 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __ROWWRITER_H__
+#define __ROWWRITER_H__
+
+#include <sqlite3.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using std::vector;
+using std::string;
+
+namespace CMSat {
+
+/**
+@brief Where SQLiteStats puts the rows it collects
+
+SQLiteStats turns the solver's state into rows of the tables in
+cmsat_tablestructure.sql, value by value, as if it was binding them to the
+prepared INSERT of the table. The writer decides what happens to them:
+SQLiteWriter inserts them into the database, TraceWriter appends them to a
+binary trace that cmsat_trace2sql converts to the database later.
+*/
+class RowWriter
+{
+public:
+    virtual ~RowWriter() {}
+
+    ///Called once for every prepared INSERT before any row is written
+    virtual void add_table(
+        const char* /*name*/
+        , sqlite3_stmt* /*stmt*/
+        , const vector<string>& /*cols*/
+    ) {}
+
+    virtual void bind_int(sqlite3_stmt* stmt, int pos, int val) = 0;
+    virtual void bind_int64(sqlite3_stmt* stmt, int pos, int64_t val) = 0;
+    virtual void bind_double(sqlite3_stmt* stmt, int pos, double val) = 0;
+    virtual void bind_null(sqlite3_stmt* stmt, int pos) = 0;
+    virtual void bind_text(sqlite3_stmt* stmt, int pos, const string& val) = 0;
+
+    ///Ends the row bound to the statement. Name must be a string that
+    ///outlives the writer
+    virtual void step(sqlite3_stmt* stmt, const char* name) = 0;
+
+    ///Executes SQL text, in order with the rows
+    virtual void exec(const string& sql, const char* name) = 0;
+
+    virtual void begin_transaction() = 0;
+    virtual void end_transaction() = 0;
+
+    ///Makes sure everything is written. Called by the destructor
+    virtual void finish() = 0;
+};
+
+}
+
+#endif //__ROWWRITER_H__
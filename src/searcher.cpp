@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include <ratio>
 #include "sqlstats.h"
 #include "datasync.h"
+#include "extprop.h"
+#include "metrics.h"
 #include "reducedb.h"
 #include "watchalgos.h"
 #include "hasher.h"
@@ -43,6 +45,8 @@ THE SOFTWARE.
 #include "xorfinder.h"
 #include "vardistgen.h"
 #include "solvertypes.h"
+#include "sls.h"
+#include "trim.h"
 #ifdef USE_GAUSS
 #include "gaussian.h"
 #endif
@@ -774,6 +778,8 @@ void Searcher::analyze_conflict(
     glue_before_minim
     #endif
 ) {
+    HOTPROF(hotprof, analyze);
+
     //Set up environment
     #if defined(STATS_NEEDED_BRANCH) || defined(FINAL_PREDICTOR_BRANCH)
     assert(level_used_for_cl.empty());
@@ -1237,6 +1243,33 @@ void Searcher::check_need_gauss_jordan_disable()
 }
 #endif
 
+void Searcher::update_search_metrics()
+{
+    SolverMetrics& m = *metrics;
+    m.set(m.conflicts, sumConflicts);
+    m.set(m.propagations, solver->sumPropStats.propagations + propStats.propagations);
+    m.set(m.decisions, solver->sumSearchStats.decisions + stats.decisions);
+    m.set(m.restarts, solver->sumSearchStats.numRestarts + stats.numRestarts);
+    m.set(m.trail_size, trail.size());
+
+    m.set(m.irred_long, longIrredCls.size());
+    m.set(m.irred_bins, binTri.irredBins);
+    m.set(m.red_bins, binTri.redBins);
+    for(uint32_t i = 0; i < longRedCls.size() && i < 3; i++) {
+        m.set(m.red_long[i], longRedCls[i].size());
+    }
+
+    const DataSync::Stats& sync = solver->datasync->get_stats();
+    m.set(m.sent_units, sync.sentUnitData);
+    m.set(m.recv_units, sync.recvUnitData);
+    m.set(m.sent_bins, sync.sentBinData);
+    m.set(m.recv_bins, sync.recvBinData);
+    uint64_t net_sent, net_recv;
+    solver->datasync->get_net_cls(net_sent, net_recv);
+    m.set(m.net_sent_cls, net_sent);
+    m.set(m.net_recv_cls, net_recv);
+}
+
 lbool Searcher::search()
 {
     assert(ok);
@@ -1244,10 +1277,14 @@ lbool Searcher::search()
     check_no_duplicate_lits_anywhere();
     check_order_heap_sanity();
     #endif
+    HOTPROF(hotprof, search);
     const double myTime = cpuTime();
 
     //Stats reset & update
     stats.numRestarts++;
+    if (metrics) {
+        update_search_metrics();
+    }
     hist.clear();
     hist.reset_glue_hist_size(conf.shortTermHistorySize);
 
@@ -1266,9 +1303,29 @@ lbool Searcher::search()
         #ifdef USE_GAUSS
         gqhead = qhead;
         #endif
-        confl = propagate_any_order_fast();
+        const size_t trail_before = trail.size();
+        {
+            HOTPROF(hotprof, propagate);
+            confl = propagate_any_order_fast();
+        }
+        add_level0_units_to_drat(trail_before);
+
+        //The external propagator's turn once propagation is done
+        if (confl.isNULL() && extprop != NULL) {
+            const lbool ext_ret = extprop->propagate(confl);
+            if (ext_ret == l_False) {
+                search_ret = l_False;
+                goto end;
+            }
+            if (ext_ret == l_True && confl.isNULL()) {
+                continue;
+            }
+        }
 
         if (!confl.isNULL()) {
+            if (extprop != NULL) {
+                extprop->explain(confl);
+            }
             update_branch_params();
 
             #ifdef STATS_NEEDED
@@ -1315,6 +1372,10 @@ lbool Searcher::search()
             }
             reduce_db_if_needed();
             lbool dec_ret = new_decision<false>();
+            if (dec_ret == l_True && extprop != NULL && !extprop->check_model()) {
+                //Rejected, its clauses come at the next propagation
+                continue;
+            }
             if (dec_ret != l_Undef) {
                 search_ret = dec_ret;
                 goto end;
@@ -1323,8 +1384,18 @@ lbool Searcher::search()
     }
     max_confl_this_phase -= (int64_t)params.conflictsDoneThisRestart;
 
-    cancelUntil<true, false>(0);
+    cancelUntil<true, false>(reuse_trail_level());
+    if (decisionLevel() > 0) {
+        stats.trailReuseRestarts++;
+        stats.trailReuseLevels += decisionLevel();
+        stats.trailReuseAssigns += trail.size() - trail_lim[0];
+    }
     confl = propagate<false>();
+    if (!confl.isNULL() && decisionLevel() > 0) {
+        //The kept trail is in conflict, do a full restart instead
+        cancelUntil<true, false>(0);
+        confl = propagate<false>();
+    }
     if (!confl.isNULL()) {
         ok = false;
         search_ret = l_False;
@@ -1380,6 +1451,7 @@ void Searcher::dump_search_sql(const double myTime)
 template<bool update_bogoprops>
 lbool Searcher::new_decision()
 {
+    HOTPROF(hotprof, decision);
 #ifdef SLOW_DEBUG
     assert(solver->prop_at_head());
 #endif
@@ -1401,6 +1473,9 @@ lbool Searcher::new_decision()
             }
             #endif
         } else if (value(p) == l_False) {
+            if (extprop != NULL) {
+                extprop->explain(p);
+            }
             analyze_final_confl_with_assumptions(~p, conflict);
             return l_False;
         } else {
@@ -1480,6 +1555,9 @@ template<bool update_bogoprops>
 void Searcher::attach_and_enqueue_learnt_clause(
     Clause* cl, const uint32_t level, const bool enq)
 {
+    solver->datasync->signal_learnt_to_ext(
+        learnt_clause, cl == NULL ? learnt_clause.size() : cl->stats.glue);
+
     switch (learnt_clause.size()) {
         case 0:
             assert(false);
@@ -1508,6 +1586,7 @@ void Searcher::attach_and_enqueue_learnt_clause(
         default:
             //Long learnt
             stats.learntLongs++;
+            solver->datasync->signalNewLongClause(learnt_clause, cl->stats.glue);
             solver->attachClause(*cl, enq);
             if (enq) enqueue(learnt_clause[0], level, PropBy(cl_alloc.get_offset(cl)));
             #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
@@ -1555,6 +1634,180 @@ void Searcher::print_learnt_clause() const
     }
 }
 
+//ID of the clause that propagated 'var', 0 if there is none
+uint32_t Searcher::reason_ID(const uint32_t var) const
+{
+    const PropBy& reason = varData[var].reason;
+    switch (reason.getType()) {
+        case binary_t:
+            return drat->bin_ID(Lit(var, value(var) == l_False), reason.lit2());
+
+        case clause_t:
+            return drat->ID_of(*cl_alloc.ptr(reason.get_offset()));
+
+        default:
+            return 0;
+    }
+}
+
+//ID of the conflicting clause, 0 if there is none
+uint32_t Searcher::confl_ID(const PropBy confl, const Lit confl_lit) const
+{
+    switch (confl.getType()) {
+        case binary_t:
+            return drat->bin_ID(confl_lit, confl.lit2());
+
+        case clause_t:
+            return drat->ID_of(*cl_alloc.ptr(confl.get_offset()));
+
+        default:
+            return 0;
+    }
+}
+
+//Finds the clauses that, once the negation of the clause is assumed,
+//become unit one after the other and finally conflict. The level 0 units
+//come first, then the reasons in an order where every reason comes after
+//the reasons of the literals it depends on.
+bool Searcher::build_hints(
+    const vector<Lit>& lits
+    , const PropBy confl
+    , const Lit confl_lit
+    , vector<uint32_t>& out_hints
+) {
+    const Lit bin_lit = (confl_lit == lit_Undef) ? failBinLit : confl_lit;
+    confl_lits.clear();
+    switch (confl.getType()) {
+        case binary_t:
+            confl_lits.push_back(bin_lit);
+            confl_lits.push_back(confl.lit2());
+            break;
+
+        case clause_t: {
+            const Clause& cl = *cl_alloc.ptr(confl.get_offset());
+            confl_lits.assign(cl.begin(), cl.end());
+            break;
+        }
+
+        default:
+            out_hints.clear();
+            return false;
+    }
+
+    return build_hints(lits, confl_lits, confl_ID(confl, bin_lit), out_hints);
+}
+
+bool Searcher::build_hints(
+    const vector<Lit>& lits
+    , const vector<Lit>& confl_cl
+    , const uint32_t confl_cl_ID
+    , vector<uint32_t>& out_hints
+) {
+    out_hints.clear();
+    assert(toClear.empty());
+    assert(hint_stack.empty());
+
+    for(const Lit l: lits) {
+        seen[l.var()] = 1;
+        toClear.push_back(l);
+    }
+    for(const Lit l: confl_cl) {
+        if (!seen[l.var()]) {
+            hint_stack.push_back(l.var());
+        }
+    }
+    const auto push_lit = [&](const Lit l) {
+        if (!seen[l.var()]) {
+            hint_stack.push_back(l.var());
+        }
+    };
+
+    //Reasons are emitted when the marker of the variable is popped, which
+    //is after the variables they depend on have all been visited
+    const uint32_t emit_marker = 1U << 31;
+    vector<uint32_t> reason_order;
+    bool explainable = true;
+    while(explainable && !hint_stack.empty()) {
+        const uint32_t v = hint_stack.back();
+        hint_stack.pop_back();
+        if (v & emit_marker) {
+            reason_order.push_back(v & ~emit_marker);
+            continue;
+        }
+        if (seen[v]) {
+            continue;
+        }
+        seen[v] = 1;
+        toClear.push_back(Lit(v, false));
+
+        if (varData[v].level == 0) {
+            out_hints.push_back(drat->unit_ID(Lit(v, value(v) == l_False)));
+            continue;
+        }
+
+        const PropBy& reason = varData[v].reason;
+        hint_stack.push_back(v | emit_marker);
+        switch (reason.getType()) {
+            case binary_t:
+                push_lit(reason.lit2());
+                break;
+
+            case clause_t:
+                for(const Lit l: *cl_alloc.ptr(reason.get_offset())) {
+                    if (l.var() != v) {
+                        push_lit(l);
+                    }
+                }
+                break;
+
+            default:
+                //Decision or XOR, we can't explain it with clauses
+                explainable = false;
+                break;
+        }
+    }
+
+    if (explainable) {
+        for(const uint32_t v: reason_order) {
+            out_hints.push_back(reason_ID(v));
+        }
+        out_hints.push_back(confl_cl_ID);
+    }
+
+    hint_stack.clear();
+    for(const Lit l: toClear) {
+        seen[l.var()] = 0;
+    }
+    toClear.clear();
+
+    return explainable;
+}
+
+//Hints for a unit or empty clause derived at level 0: the units of all the
+//other literals, followed by the reason or conflicting clause
+void Searcher::build_unit_hints(const uint32_t var, const PropBy confl)
+{
+    hints.clear();
+    const PropBy& reason = (var == var_Undef) ? confl : varData[var].reason;
+    if (reason.getType() == binary_t) {
+        if (var == var_Undef) {
+            hints.push_back(drat->unit_ID(~failBinLit));
+        }
+        hints.push_back(drat->unit_ID(~reason.lit2()));
+    } else if (reason.getType() == clause_t) {
+        for(const Lit l: *cl_alloc.ptr(reason.get_offset())) {
+            if (l.var() != var) {
+                hints.push_back(drat->unit_ID(~l));
+            }
+        }
+    } else {
+        return;
+    }
+
+    hints.push_back(var == var_Undef ? confl_ID(confl, failBinLit) : reason_ID(var));
+    drat->set_hints(hints);
+}
+
 #ifdef STATS_NEEDED
 void Searcher::sql_dump_last_in_solver()
 {
@@ -1804,6 +2057,17 @@ bool Searcher::handle_conflict(PropBy confl)
 
     ConflictData data = find_conflict_level(confl);
     if (data.nHighestLevel == 0) {
+        if (drat->enabled()) {
+            if (drat->hints_needed()) {
+                build_unit_hints(var_Undef, confl);
+            }
+            *drat << add
+            #ifdef STATS_NEEDED
+            << 0
+            << sumConflicts
+            #endif
+            << fin;
+        }
         return false;
     }
 
@@ -1817,6 +2081,11 @@ bool Searcher::handle_conflict(PropBy confl)
         , glue_before_minim         //return glue before minimization here
     );
     print_learnt_clause();
+    if (drat->hints_needed()
+        && build_hints(learnt_clause, confl, lit_Undef, hints)
+    ) {
+        drat->set_hints(hints);
+    }
 
     update_history_stats(backtrack_level, glue);
     uint32_t old_decision_level = decisionLevel();
@@ -1842,13 +2111,25 @@ bool Searcher::handle_conflict(PropBy confl)
     }
 
     // check chrono backtrack condition
-    if (conf.diff_declev_for_chrono > -1
+    if (backtrack_level < enum_floor) {
+        //Enumeration must keep its flipped levels: jump only down to them,
+        //the clause is asserted out of order below
+        cancelUntil(enum_floor);
+    } else if (conf.diff_declev_for_chrono > -1
         && (((int)decisionLevel() - (int)backtrack_level) >= conf.diff_declev_for_chrono)
     ) {
-        chrono_backtrack++;
-        cancelUntil(data.nHighestLevel -1);
+        const uint32_t chrono_level = data.nHighestLevel -1;
+        stats.chronoBacktrack++;
+
+        //Assignments between the asserting level and the chrono level
+        //that a non-chronological jump would have to re-propagate
+        if (chrono_level > backtrack_level) {
+            stats.chronoSavedAssigns +=
+                trail_lim[chrono_level] - trail_lim[backtrack_level];
+        }
+        cancelUntil(chrono_level);
     } else {
-        non_chrono_backtrack++;
+        stats.nonChronoBacktrack++;
         cancelUntil(backtrack_level);
     }
 
@@ -1951,7 +2232,13 @@ void Searcher::print_restart_header()
         << " " << std::setw(4) << "bran"
         << " " << std::setw(5) << "nres"
         << " " << std::setw(5) << "conf"
-        << " " << std::setw(5) << "freevar"
+        << " " << std::setw(5) << "freevar";
+
+        if (conf.do_reuse_trail) {
+            cout << " " << std::setw(5) << "reuse";
+        }
+
+        cout
         << " " << std::setw(5) << "IrrL"
         << " " << std::setw(5) << "IrrB"
         << " " << std::setw(7) << "l/longC"
@@ -1998,6 +2285,11 @@ void Searcher::print_restart_stats_base() const
     }
 
     cout << " " << std::setw(7) << solver->get_num_free_vars();
+
+    if (conf.do_reuse_trail) {
+        cout << " " << std::setw(5) << std::fixed << std::setprecision(2)
+        << ratio_for_stat(stats.trailReuseLevels, stats.numRestarts);
+    }
 }
 
 struct MyInvSorter {
@@ -2077,6 +2369,7 @@ void Searcher::reset_temp_cl_num()
 
 void Searcher::reduce_db_if_needed()
 {
+    HOTPROF(hotprof, reduce_db);
     #if defined(FINAL_PREDICTOR) || defined(STATS_NEEDED)
     if (conf.every_lev3_reduce != 0
         && sumConflicts >= next_lev3_reduce
@@ -2106,7 +2399,11 @@ void Searcher::reduce_db_if_needed()
         if (sumConflicts >= next_lev2_reduce) {
             solver->reduceDB->handle_lev2();
             cl_alloc.consolidate(solver);
-            next_lev2_reduce = sumConflicts + conf.every_lev2_reduce;
+            uint64_t every = conf.every_lev2_reduce;
+            if (conf.do_mode_switch && search_mode == SearchMode::stable) {
+                every = (double)every * conf.stable_lev2_reduce_mult;
+            }
+            next_lev2_reduce = sumConflicts + every;
         }
     } else {
         if (longRedCls[2].size() > cur_max_temp_red_lev2_cls) {
@@ -2436,6 +2733,7 @@ bool Searcher::must_abort(const lbool status) {
         return true;
     }
 
+    poll_user_callbacks();
     if (solver->must_interrupt_asap()) {
         if (conf.verbosity >= 3) {
             cout
@@ -2448,12 +2746,73 @@ bool Searcher::must_abort(const lbool status) {
     return false;
 }
 
+void Searcher::set_terminate_callback(std::function<bool()> callback)
+{
+    terminate_cb = callback;
+}
+
+void Searcher::set_progress_callback(
+    std::function<void(const SolveProgress&)> callback
+    , const double every_secs
+) {
+    progress_cb = callback;
+    progress_every = every_secs;
+    last_progress_time = 0;
+}
+
+//Called at restarts and every 256 conflicts. Termination goes through the
+//interrupt flag shared by all threads, so only the first thread has to poll
+void Searcher::poll_user_callbacks()
+{
+    if (progress_cb) {
+        const double now = realTimeSec();
+        if (now - last_progress_time >= progress_every) {
+            last_progress_time = now;
+            SolveProgress p;
+            p.conflicts = sumConflicts;
+            p.propagations = solver->sumPropStats.propagations + propStats.propagations;
+            p.decisions = solver->sumSearchStats.decisions + stats.decisions;
+            p.restarts = solver->sumSearchStats.numRestarts + stats.numRestarts;
+            p.trail_size = trail.size();
+            p.decision_level = decisionLevel();
+            progress_cb(p);
+        }
+    }
+
+    if (terminate_cb
+        && !solver->must_interrupt_asap()
+        && terminate_cb()
+    ) {
+        if (conf.verbosity >= 3) {
+            cout << "c terminate callback returned true" << endl;
+        }
+        solver->set_must_interrupt_asap();
+    }
+}
+
 void Searcher::setup_polarity_strategy()
 {
     //Set to default first
     polarity_mode = conf.polarity_mode;
     polar_stable_longest_trail_this_iter = 0;
 
+    //The search mode decides, not the iteration number
+    if (conf.do_mode_switch) {
+        if (polarity_mode == PolarityMode::polarmode_automatic
+            && search_mode == SearchMode::stable
+        ) {
+            polarity_mode = PolarityMode::polarmode_stable;
+        }
+
+        if (conf.verbosity) {
+            cout << "c [polar]"
+            << " polar mode: " << getNameOfPolarmodeType(polarity_mode)
+            << " search mode: " << search_mode_to_string(search_mode)
+            << endl;
+        }
+        return;
+    }
+
     if (polarity_mode == PolarityMode::polarmode_automatic) {
         if (branch_strategy_num > 0 &&
             conf.polar_stable_every_n > 0 &&
@@ -2514,6 +2873,236 @@ void Searcher::setup_polarity_strategy()
     }
 }
 
+/**
+@brief Sets up branching and restarts for the current search mode
+
+Focused mode uses VSIDS and glue-based restarts, stable mode uses Maple and
+luby restarts. Both have their own activities and heap, and the VSIDS/Maple
+decay is kept separately for each mode.
+*/
+void Searcher::setup_search_mode()
+{
+    if (mode_switch_len == 0) {
+        mode_switch_len = conf.mode_switch_first;
+        mode_switch_at = sumConflicts + mode_switch_len;
+    }
+
+    switch(search_mode) {
+        case SearchMode::focused:
+            branch_strategy = branch::vsids;
+            branch_strategy_str = "VSIDSX";
+            branch_strategy_str_short = "vsx";
+            var_decay = mode_var_decay[0];
+            var_decay_max = 0.95;
+            cur_rest_type = Restart::glue;
+            break;
+
+        case SearchMode::stable:
+            branch_strategy = branch::maple;
+            branch_strategy_str = "MAPLE2";
+            branch_strategy_str_short = "mp2";
+            var_decay = mode_var_decay[1];
+            var_decay_max = 0.90;
+            cur_rest_type = Restart::luby;
+            break;
+    }
+
+    mode_start_confl = stats.conflStats.numConflicts;
+    mode_start_props = propStats.propagations;
+    mode_start_time = cpuTime();
+
+    if (conf.verbosity) {
+        cout << "c [mode] " << search_mode_to_string(search_mode)
+        << " branching: " << branch_type_to_string(branch_strategy)
+        << " restart: " << getNameOfRestartType(cur_rest_type)
+        << " switch at confl: " << mode_switch_at
+        << endl;
+    }
+}
+
+void Searcher::account_search_mode_stats()
+{
+    const uint64_t confl = stats.conflStats.numConflicts - mode_start_confl;
+    const uint64_t props = propStats.propagations - mode_start_props;
+    const double time_used = cpuTime() - mode_start_time;
+
+    switch(search_mode) {
+        case SearchMode::focused:
+            stats.focusedConfl += confl;
+            stats.focusedProps += props;
+            stats.focusedTime += time_used;
+            break;
+
+        case SearchMode::stable:
+            stats.stableConfl += confl;
+            stats.stableProps += props;
+            stats.stableTime += time_used;
+            break;
+    }
+
+    mode_start_confl = stats.conflStats.numConflicts;
+    mode_start_props = propStats.propagations;
+    mode_start_time = cpuTime();
+}
+
+/**
+@brief Switches between focused and stable mode at a restart
+
+The length of the modes grows geometrically with every focused+stable
+cycle. Returns false if the problem became UNSAT while going to level 0.
+*/
+bool Searcher::switch_search_mode()
+{
+    if (!cancel_reused_trail()) {
+        return false;
+    }
+    account_search_mode_stats();
+    stats.modeSwitches++;
+
+    switch(search_mode) {
+        case SearchMode::focused:
+            mode_var_decay[0] = var_decay;
+            search_mode = SearchMode::stable;
+            break;
+
+        case SearchMode::stable:
+            mode_var_decay[1] = var_decay;
+            search_mode = SearchMode::focused;
+            mode_switch_len = (double)mode_switch_len * conf.mode_switch_inc;
+            break;
+    }
+    mode_switch_at = sumConflicts + mode_switch_len;
+
+    //Variables unassigned in the other mode were only put back into
+    //the other mode's heap
+    for(uint32_t v = 0; v < nVars(); v++) {
+        if (varData[v].removed == Removed::none
+            && value(v) == l_Undef
+        ) {
+            insert_var_order_all(v);
+        }
+    }
+
+    setup_search_mode();
+    setup_restart_strategy();
+    setup_polarity_strategy();
+
+    return true;
+}
+
+void Searcher::setup_rephase_schedule()
+{
+    rephase_sched.clear();
+
+    //Rephasing only makes sense when the saved polarities are used
+    if (!conf.do_rephase
+        || conf.polarity_mode != PolarityMode::polarmode_automatic
+    ) {
+        return;
+    }
+
+    std::istringstream ss(conf.rephase_schedule + ",");
+    std::string token;
+    while(std::getline(ss, token, ',')) {
+        token = trim(token);
+        if (token.empty()) {
+            continue;
+        }
+
+        if (token == "orig") {
+            rephase_sched.push_back(Rephase::orig);
+        } else if (token == "inv") {
+            rephase_sched.push_back(Rephase::inv);
+        } else if (token == "best") {
+            rephase_sched.push_back(Rephase::best);
+        } else if (token == "walk") {
+            rephase_sched.push_back(Rephase::walk);
+        } else if (token == "rnd") {
+            rephase_sched.push_back(Rephase::rnd);
+        } else {
+            cout << "ERROR: rephase type '" << token << "' does not exist."
+            << " Only 'orig', 'inv', 'best', 'walk' and 'rnd' are acceptable."
+            << endl;
+            exit(-1);
+        }
+    }
+
+    if (next_rephase == 0) {
+        next_rephase = sumConflicts + conf.rephase_first;
+    }
+}
+
+/**
+@brief Resets the saved polarities according to the rephase schedule
+
+The N-th rephase is followed by the next one N*rephase_first conflicts later.
+Returns false if the problem became UNSAT while getting back to level 0 for
+the SLS-based (walk) rephasing.
+*/
+bool Searcher::rephase()
+{
+    const Rephase type = rephase_sched[rephase_num % rephase_sched.size()];
+    rephase_num++;
+    next_rephase = sumConflicts + (uint64_t)conf.rephase_first * (rephase_num+1);
+    stats.rephases++;
+
+    switch(type) {
+        case Rephase::orig:
+            for(uint32_t i = 0; i < nVars(); i++) {
+                varData[i].polarity = false;
+            }
+            break;
+
+        case Rephase::inv:
+            for(uint32_t i = 0; i < nVars(); i++) {
+                varData[i].polarity = true;
+            }
+            break;
+
+        case Rephase::best:
+            for(uint32_t i = 0; i < nVars(); i++) {
+                varData[i].polarity = varData[i].best_polarity;
+            }
+            break;
+
+        case Rephase::walk: {
+            //SLS works on the level-0 simplified problem
+            if (!cancel_reused_trail()) {
+                return false;
+            }
+
+            //SLS starts from the current polarities, and its best
+            //assignment becomes the new phase
+            const int backup_get_phase = conf.sls_get_phase;
+            conf.sls_get_phase = true;
+            SLS sls(solver);
+            sls.run(num_sls_called);
+            num_sls_called++;
+            conf.sls_get_phase = backup_get_phase;
+            stats.rephaseWalks++;
+            break;
+        }
+
+        case Rephase::rnd:
+            for(uint32_t i = 0; i < nVars(); i++) {
+                varData[i].polarity = mtrand.randInt(1);
+            }
+            break;
+    }
+
+    //Stable polarities must be re-learnt from the new phases
+    polar_stable_longest_trail_this_iter = 0;
+
+    if (conf.verbosity >= 2) {
+        cout << "c [rephase] " << std::setw(4) << rephase_type_to_string(type)
+        << " at confl " << sumConflicts
+        << " next at " << next_rephase
+        << endl;
+    }
+
+    return true;
+}
+
 lbool Searcher::solve(
     const uint64_t _max_confls
 ) {
@@ -2535,11 +3124,16 @@ lbool Searcher::solve(
     resetStats();
     lbool status = l_Undef;
 
-    set_branch_strategy(branch_strategy_num);
+    if (conf.do_mode_switch) {
+        setup_search_mode();
+    } else {
+        set_branch_strategy(branch_strategy_num);
+    }
     setup_restart_strategy();
     check_calc_satzilla_features(true);
     check_calc_vardist_features(true);
     setup_polarity_strategy();
+    setup_rephase_schedule();
 
     while(stats.conflStats.numConflicts < max_confl_per_search_solve_call
         && status == l_Undef
@@ -2560,11 +3154,31 @@ lbool Searcher::solve(
             goto end;
         }
 
+        if (status == l_Undef
+            && conf.do_mode_switch
+            && sumConflicts >= mode_switch_at
+            && !switch_search_mode()
+        ) {
+            status = l_False;
+            goto end;
+        }
+
+        if (status == l_Undef
+            && !rephase_sched.empty()
+            && sumConflicts >= next_rephase
+            && !rephase()
+        ) {
+            status = l_False;
+            goto end;
+        }
+
         if (status == l_Undef &&
             conf.do_distill_clauses &&
             sumConflicts > next_distill
         ) {
-            if (!solver->distill_long_cls->distill(true, false)) {
+            if (!cancel_reused_trail()
+                || !solver->distill_long_cls->distill(true, false)
+            ) {
                 status = l_False;
                 goto end;
             }
@@ -2575,6 +3189,12 @@ lbool Searcher::solve(
     }
 
     end:
+    if (status == l_Undef && !cancel_reused_trail()) {
+        status = l_False;
+    }
+    if (conf.do_mode_switch) {
+        account_search_mode_stats();
+    }
     finish_up_solve(status);
     if (status == l_Undef) {
         branch_strategy_num++;
@@ -2712,6 +3332,288 @@ inline void Searcher::print_local_restart_budget()
     }
 }
 
+/**
+@brief Level to backtrack to at restart so that the trail is reused
+
+After a full restart the decisions at the bottom of the trail would be made
+again as long as their variables outrank the variable that would be picked
+next. Those levels, and all the assumption levels, are kept.
+*/
+uint32_t Searcher::reuse_trail_level()
+{
+    if (!conf.do_reuse_trail
+        || decisionLevel() == 0
+        //Clause sharing must happen at level 0
+        || solver->datasync->sync_due()
+        //Clause cleaning must happen at level 0
+        || getTrailSize() > lastCleanZeroDepthAssigns + (double)nVars()*0.05
+    ) {
+        return 0;
+    }
+
+    Heap<VarOrderLt> &order_heap = (branch_strategy == branch::vsids) ? order_heap_vsids : order_heap_maple;
+    const vector<ActAndOffset>& act = (branch_strategy == branch::vsids) ? var_act_vsids : var_act_maple;
+
+    //Assigned variables at the top would be popped at the next decision anyway
+    while (!order_heap.empty() && value(order_heap[0]) != l_Undef) {
+        order_heap.removeMin();
+    }
+
+    uint32_t level = std::min<uint32_t>(assumptions.size(), decisionLevel());
+    if (order_heap.empty()) {
+        return level;
+    }
+
+    const double next_act = act[order_heap[0]].combine();
+    while (level < decisionLevel()) {
+        const Lit dec = trail[trail_lim[level]].lit;
+        if (act[dec.var()].combine() <= next_act) {
+            break;
+        }
+        level++;
+    }
+
+    return level;
+}
+
+//Assumption levels left on the trail when solve() returns, so that the
+//next call with the same first assumptions doesn't have to redo them
+uint32_t Searcher::assump_levels_to_keep() const
+{
+    if (!conf.do_reuse_assumps
+        || !ok
+        || get_num_bva_vars() > 0
+        //Matrices are set up, and XORs detached, at level 0
+        || xor_clauses_updated
+        || detached_xor_clauses
+        || !xorclauses.empty()
+        #ifdef USE_GAUSS
+        || !gmatrices.empty()
+        #endif
+    ) {
+        return 0;
+    }
+
+    //Assumptions are always decided first, one per level
+    return std::min<uint32_t>(assumptions.size(), decisionLevel());
+}
+
+void Searcher::cancel_to_kept_assumps()
+{
+    cancelUntil(assump_levels_to_keep());
+
+    //due to chrono BT we need to propagate once more
+    PropBy confl = propagate<false>();
+    if (!confl.isNULL() && decisionLevel() > 0) {
+        cancelUntil(0);
+        confl = propagate<false>();
+    }
+    assert(confl.isNULL());
+}
+
+bool Searcher::cancel_reused_trail()
+{
+    if (decisionLevel() == 0) {
+        return true;
+    }
+
+    cancelUntil<true, false>(0);
+    PropBy confl = propagate<false>();
+    if (!confl.isNULL()) {
+        ok = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+@brief Enumerates the models projected to 'proj' without blocking clauses
+
+The projection variables are decided before all others. Once a model is found,
+the highest projection decision that is not yet flipped is undone and its
+negation is put on the trail as a "flipped" decision, i.e. a decision whose
+other branch has been fully enumerated. A conflict that only involves levels
+up to the highest flipped level means that the subtree is exhausted, and it is
+handled the same way. All other conflicts are learnt as usual, but never
+backjump below the highest flipped level. Hence every learnt clause is implied
+by the CNF alone, and no projected model is found twice. Restarts also go back
+to the highest flipped level only, and re-order the projection vars by activity.
+
+'found' is called with the projected model on the trail, and returns false
+to stop. Returns the number of models found, and leaves the solver at level 0.
+*/
+uint64_t Searcher::enumerate_projected(
+    const vector<Lit>& proj
+    , const uint64_t limit
+    , const std::function<bool()>& found
+) {
+    assert(ok);
+    assert(decisionLevel() == 0);
+    assert(qhead == trail.size());
+    const double myTime = cpuTime();
+
+    resetStats();
+    if (conf.do_mode_switch) {
+        setup_search_mode();
+    } else {
+        set_branch_strategy(branch_strategy_num);
+    }
+    setup_polarity_strategy();
+    params.clear();
+
+    vector<Lit> order = proj;
+    vector<char> flipped(1, 0); ///<Per level: its decision is a flipped one
+    uint32_t free_level = std::numeric_limits<uint32_t>::max(); ///<Lowest level deciding a non-projection var
+    uint32_t at = 0; ///<All projection vars in 'order' before this one are set
+    uint64_t num_models = 0;
+    uint64_t num_flips = 0;
+    uint64_t num_restarts = 0;
+    uint64_t next_restart = 0;
+    enum_floor = 0;
+
+    const auto restart = [&]() {
+        cancelUntil(enum_floor);
+        flipped.resize(decisionLevel()+1);
+        free_level = std::numeric_limits<uint32_t>::max();
+        at = 0;
+
+        const vector<ActAndOffset>& act =
+            (branch_strategy == branch::maple) ? var_act_maple : var_act_vsids;
+        std::sort(order.begin(), order.end(), [&](const Lit a, const Lit b) {
+            return act[a.var()].combine() > act[b.var()].combine();
+        });
+        stats.numRestarts++;
+        next_restart = stats.conflStats.numConflicts
+            + luby(2, num_restarts++) * (double)conf.restart_first;
+    };
+    restart();
+
+    //The subtree under level 'lev' is exhausted: flip the highest projection
+    //decision at or below it that has not been flipped yet
+    const auto next_subtree = [&](uint32_t lev) -> bool {
+        lev = std::min(lev, free_level-1);
+        while(lev > 0 && flipped[lev]) {
+            lev--;
+        }
+        if (lev == 0) {
+            return false;
+        }
+
+        const Lit dec = trail[trail_lim[lev-1]].lit;
+        assert(varData[dec.var()].reason == PropBy());
+        cancelUntil(lev-1);
+        new_decision_level();
+        enqueue<false>(~dec);
+        flipped.resize(decisionLevel()+1);
+        flipped[decisionLevel()] = 1;
+        enum_floor = decisionLevel();
+        free_level = std::numeric_limits<uint32_t>::max();
+        at = 0;
+        num_flips++;
+        return true;
+    };
+
+    while(num_models < limit && !must_interrupt_asap()) {
+        PropBy confl = propagate_any_order_fast();
+        if (!confl.isNULL()) {
+            const ConflictData data = find_conflict_level(confl);
+            if (data.nHighestLevel == 0) {
+                ok = false;
+                break;
+            }
+            if (data.nHighestLevel <= enum_floor) {
+                stats.conflStats.numConflicts++;
+                sumConflicts++;
+                if (!next_subtree(data.nHighestLevel)) {
+                    break;
+                }
+                if (stats.conflStats.numConflicts >= next_restart) {
+                    restart();
+                }
+                continue;
+            }
+
+            update_branch_params();
+            if (!handle_conflict(confl)) {
+                ok = false;
+                break;
+            }
+            assert(decisionLevel() >= enum_floor);
+            flipped.resize(decisionLevel()+1);
+            if (free_level > decisionLevel()) {
+                free_level = std::numeric_limits<uint32_t>::max();
+            }
+            at = 0;
+            if (stats.conflStats.numConflicts >= next_restart) {
+                restart();
+            }
+            continue;
+        }
+
+        reduce_db_if_needed();
+        Lit next = lit_Undef;
+        for(; at < order.size(); at++) {
+            const uint32_t var = order[at].var();
+            if (value(var) == l_Undef) {
+                next = Lit(var, !pick_polarity(var));
+                break;
+            }
+        }
+        if (next != lit_Undef && decisionLevel() >= free_level) {
+            //A projection var got unset under a non-projection decision,
+            //which then could not be flipped. Decide the projection first.
+            assert(free_level > enum_floor);
+            cancelUntil(free_level-1);
+            flipped.resize(decisionLevel()+1);
+            free_level = std::numeric_limits<uint32_t>::max();
+            at = 0;
+            continue;
+        }
+
+        if (next == lit_Undef) {
+            next = pickBranchLit();
+            if (next == lit_Undef) {
+                num_models++;
+                if (!found()
+                    || num_models >= limit
+                    || !next_subtree(decisionLevel())
+                ) {
+                    break;
+                }
+                continue;
+            }
+            if (free_level == std::numeric_limits<uint32_t>::max()) {
+                free_level = decisionLevel()+1;
+            }
+        }
+
+        stats.decisions++;
+        sumDecisions++;
+        new_decision_level();
+        enqueue<false>(next);
+        flipped.resize(decisionLevel()+1);
+        flipped[decisionLevel()] = 0;
+    }
+
+    enum_floor = 0;
+    cancelUntil(0);
+    if (ok && !propagate<false>().isNULL()) {
+        ok = false;
+    }
+
+    if (conf.verbosity) {
+        cout << "c [enum] models: " << num_models
+        << " flips: " << num_flips
+        << " confl: " << stats.conflStats.numConflicts
+        << " restarts: " << num_restarts
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+
+    return num_models;
+}
+
 void Searcher::check_need_restart()
 {
     if ((stats.conflStats.numConflicts & 0xff) == 0xff) {
@@ -2720,6 +3622,7 @@ void Searcher::check_need_restart()
             params.needToStopSearch = true;
         }
 
+        poll_user_callbacks();
         if (must_interrupt_asap())  {
             if (conf.verbosity >= 3)
                 cout << "c must_interrupt_asap() is set, restartig as soon as possible!" << endl;
@@ -2813,12 +3716,7 @@ void Searcher::finish_up_solve(const lbool status)
         #endif
         assert(solver->prop_at_head());
         model = assigns;
-        cancelUntil(0);
-        assert(decisionLevel() == 0);
-
-        //due to chrono BT we need to propagate once more
-        PropBy confl = propagate<false>();
-        assert(confl.isNULL());
+        cancel_to_kept_assumps();
         assert(solver->prop_at_head());
         #ifdef SLOW_DEBUG
         print_solution_varreplace_status();
@@ -2827,11 +3725,10 @@ void Searcher::finish_up_solve(const lbool status)
         if (conflict.size() == 0) {
             ok = false;
         }
-        cancelUntil(0);
         if (ok) {
-            //due to chrono BT we need to propagate once more
-            PropBy confl = propagate<false>();
-            assert(confl.isNULL());
+            cancel_to_kept_assumps();
+        } else {
+            cancelUntil(0);
         }
     } else if (status == l_Undef) {
         assert(decisionLevel() == 0);
@@ -3053,6 +3950,7 @@ size_t Searcher::hyper_bin_res_all(const bool check_for_set_values)
         if (check_for_set_values
             && (val1 == l_True || val2 == l_True)
         ) {
+            *drat << del << it->getLit1() << it->getLit2() << fin;
             continue;
         }
 
@@ -3071,6 +3969,7 @@ size_t Searcher::hyper_bin_res_all(const bool check_for_set_values)
 #ifdef USE_GAUSS
 Searcher::gauss_ret Searcher::gauss_jordan_elim()
 {
+    HOTPROF(hotprof, gauss);
     #ifdef VERBOSE_DEBUG
     cout << "Gauss searcher::Gauss_elimination called, declevel: " << decisionLevel() << endl;
     #endif
@@ -3246,6 +4145,41 @@ std::pair<size_t, size_t> Searcher::remove_useless_bins(bool except_marked)
     return std::make_pair(removedIrred, removedRed);
 }
 
+//Drat -- If declevel 0 propagation, we have to add the unitaries.
+//With chronological backtracking, level 0 literals can also be
+//propagated at a higher decision level
+void Searcher::add_level0_units_to_drat(const size_t from)
+{
+    if ((decisionLevel() != 0 && conf.diff_declev_for_chrono <= -1)
+        || !(drat->enabled() || conf.simulate_drat)
+    ) {
+        return;
+    }
+
+    for(size_t i = from; i < trail.size(); i++) {
+        if (varData[trail[i].lit.var()].level != 0) {
+            continue;
+        }
+        #ifdef DEBUG_DRAT
+        if (conf.verbosity >= 6) {
+            cout
+            << "c 0-level enqueue:"
+            << trail[i]
+            << endl;
+        }
+        #endif
+        if (drat->hints_needed()) {
+            build_unit_hints(trail[i].lit.var(), PropBy());
+        }
+        *drat << add << trail[i].lit
+        #ifdef STATS_NEEDED
+        << 0
+        << sumConflicts
+        #endif
+        << fin;
+    }
+}
+
 template<bool update_bogoprops>
 PropBy Searcher::propagate() {
     const size_t origTrailSize = trail.size();
@@ -3253,34 +4187,19 @@ PropBy Searcher::propagate() {
     PropBy ret;
     ret = propagate_any_order<update_bogoprops>();
 
-    //Drat -- If declevel 0 propagation, we have to add the unitaries
-    if (decisionLevel() == 0 &&
-        (drat->enabled() || conf.simulate_drat)
+    add_level0_units_to_drat(origTrailSize);
+    if (decisionLevel() == 0 && !ret.isNULL()
+        && (drat->enabled() || conf.simulate_drat)
     ) {
-        for(size_t i = origTrailSize; i < trail.size(); i++) {
-            #ifdef DEBUG_DRAT
-            if (conf.verbosity >= 6) {
-                cout
-                << "c 0-level enqueue:"
-                << trail[i]
-                << endl;
-            }
-            #endif
-            *drat << add << trail[i].lit
-            #ifdef STATS_NEEDED
-            << 0
-            << sumConflicts
-            #endif
-            << fin;
-        }
-        if (!ret.isNULL()) {
-            *drat << add
-            #ifdef STATS_NEEDED
-            << 0
-            << sumConflicts
-            #endif
-            << fin;
+        if (drat->hints_needed()) {
+            build_unit_hints(var_Undef, ret);
         }
+        *drat << add
+        #ifdef STATS_NEEDED
+        << 0
+        << sumConflicts
+        #endif
+        << fin;
     }
 
     return ret;
@@ -3475,7 +4394,7 @@ uint64_t Searcher::read_binary_cls(
     {
         const Lit lit1 = f.get_lit();
         const Lit lit2 = f.get_lit();
-        attach_bin_clause(lit1, lit2, red);
+        attach_bin_clause(lit1, lit2, red, 0);
     }
     return num;
 }
@@ -3529,6 +4448,108 @@ void Searcher::load_state(SimpleInFile& f, const lbool status)
     }
 }
 
+void Searcher::save_checkpoint(SimpleOutFile& f) const
+{
+    PropEngine::save_checkpoint(f);
+
+    //The long clauses are in the arena, only the binary ones need to be
+    //written, from the watches
+    write_binary_cls(f, false);
+    write_binary_cls(f, true);
+
+    f.put_struct(var_inc_vsids);
+    f.put_struct(cla_inc);
+    MTRand::uint32 rnd[MTRand::SAVE];
+    mtrand.save(rnd);
+    f.put_struct(rnd);
+
+    f.put_uint32_t(branch_strategy_num);
+    f.put_struct(search_mode);
+    f.put_uint64_t(mode_switch_len);
+    f.put_uint64_t(mode_switch_at);
+    f.put_uint32_t(rephase_num);
+    f.put_uint64_t(next_rephase);
+    f.put_uint64_t(next_distill);
+    f.put_uint64_t(next_lev1_reduce);
+    f.put_uint64_t(next_lev2_reduce);
+    f.put_uint64_t(next_lev3_reduce);
+    f.put_uint64_t(more_red_minim_limit_binary_actual);
+    f.put_uint32_t(num_search_called);
+}
+
+void Searcher::load_checkpoint(SimpleInFile& f)
+{
+    PropEngine::load_checkpoint(f);
+
+    //The counts were loaded with the rest of the CNF, what is read must match
+    const BinTriStats saved_bins = binTri;
+    if (read_binary_cls(f, false) != saved_bins.irredBins
+        || read_binary_cls(f, true) != saved_bins.redBins
+    ) {
+        throw std::runtime_error("ERROR: checkpoint is corrupt");
+    }
+    for(const ClOffset offs: longIrredCls) {
+        attachClause(*cl_alloc.ptr(offs), false);
+    }
+    for(const auto& lredcls: longRedCls) {
+        for(const ClOffset offs: lredcls) {
+            attachClause(*cl_alloc.ptr(offs), false);
+        }
+    }
+
+    f.get_struct(var_inc_vsids);
+    f.get_struct(cla_inc);
+    MTRand::uint32 rnd[MTRand::SAVE];
+    f.get_struct(rnd);
+    mtrand.load(rnd);
+
+    branch_strategy_num = f.get_uint32_t();
+    f.get_struct(search_mode);
+    mode_switch_len = f.get_uint64_t();
+    mode_switch_at = f.get_uint64_t();
+    rephase_num = f.get_uint32_t();
+    next_rephase = f.get_uint64_t();
+    next_distill = f.get_uint64_t();
+    next_lev1_reduce = f.get_uint64_t();
+    next_lev2_reduce = f.get_uint64_t();
+    next_lev3_reduce = f.get_uint64_t();
+    more_red_minim_limit_binary_actual = f.get_uint64_t();
+    num_search_called = f.get_uint32_t();
+    lastCleanZeroDepthAssigns = trail.size();
+
+    rebuildOrderHeap();
+}
+
+//Only this copy is backtracked to level 0, "other" is not touched. What is
+//left on the trail must still be propagated.
+void Searcher::copy_checkpoint_from(const Searcher& other)
+{
+    PropEngine::copy_checkpoint_from(other);
+    cancelUntil<false, true>(0);
+
+    var_inc_vsids = other.var_inc_vsids;
+    cla_inc = other.cla_inc;
+    MTRand::uint32 rnd[MTRand::SAVE];
+    other.mtrand.save(rnd);
+    mtrand.load(rnd);
+
+    branch_strategy_num = other.branch_strategy_num;
+    search_mode = other.search_mode;
+    mode_switch_len = other.mode_switch_len;
+    mode_switch_at = other.mode_switch_at;
+    rephase_num = other.rephase_num;
+    next_rephase = other.next_rephase;
+    next_distill = other.next_distill;
+    next_lev1_reduce = other.next_lev1_reduce;
+    next_lev2_reduce = other.next_lev2_reduce;
+    next_lev3_reduce = other.next_lev3_reduce;
+    more_red_minim_limit_binary_actual = other.more_red_minim_limit_binary_actual;
+    num_search_called = other.num_search_called;
+    lastCleanZeroDepthAssigns = trail.size();
+
+    rebuildOrderHeap();
+}
+
 inline void Searcher::update_polarities_on_backtrack()
 {
     if (polarity_mode == PolarityMode::polarmode_stable &&
@@ -3568,6 +4589,8 @@ void Searcher::cancelUntil<false, true>(uint32_t level);
 template<bool do_insert_var_order, bool update_bogoprops>
 void Searcher::cancelUntil(uint32_t blevel)
 {
+    //Not the backtracking of probing and distillation
+    HOTPROF_IF(hotprof, cancel_until, do_insert_var_order);
     #ifdef VERBOSE_DEBUG
     cout << "Canceling until level " << blevel;
     if (blevel > 0) cout << " sublevel: " << trail_lim[blevel];
@@ -3575,6 +4598,9 @@ void Searcher::cancelUntil(uint32_t blevel)
     #endif
 
     if (decisionLevel() > blevel) {
+        if (extprop != NULL) {
+            extprop->backtrack(blevel);
+        }
         update_polarities_on_backtrack();
 
         add_tmp_canceluntil.clear();
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #define __SEARCHER_H__
 
 #include <array>
+#include <functional>
 
 #include "propengine.h"
 #include "solvertypes.h"
@@ -33,6 +34,7 @@ THE SOFTWARE.
 #include "simplefile.h"
 #include "searchstats.h"
 #include "gqueuedata.h"
+#include "hotprof.h"
 
 #ifdef CMS_TESTING_ENABLED
 #include "gtest/gtest_prod.h"
@@ -43,9 +45,11 @@ namespace CMSat {
 
 class Solver;
 class SQLStats;
+struct SolverMetrics;
 class VarReplacer;
 class EGaussian;
 class DistillerLong;
+class ExtProp;
 class ClusteringImp;
 
 using std::string;
@@ -76,14 +80,23 @@ class Searcher : public HyperEngine
             uint64_t max_confls
         );
         void finish_up_solve(lbool status);
+        uint64_t enumerate_projected(
+            const vector<Lit>& proj
+            , const uint64_t limit
+            , const std::function<bool()>& found
+        );
         void reduce_db_if_needed();
         void clean_clauses_if_needed();
         void check_calc_satzilla_features(bool force = false);
         void check_calc_vardist_features(bool force = false);
         void dump_search_loop_stats(double myTime);
         bool must_abort(lbool status);
+        void set_terminate_callback(std::function<bool()> callback);
+        void set_progress_callback(
+            std::function<void(const SolveProgress&)> callback, double every_secs);
         uint64_t luby_loop_num = 0;
         MTRand mtrand; ///< random number generator
+        ExtProp* extprop = NULL; ///<Owned by Solver, NULL unless connected
 
 
         vector<lbool>  model;
@@ -135,10 +148,20 @@ class Searcher : public HyperEngine
         template<bool do_insert_var_order = true, bool update_bogoprops = false>
         void cancelUntil(uint32_t level); ///<Backtrack until a certain level.
         ConflictData find_conflict_level(PropBy& pb);
-        uint32_t chrono_backtrack = 0;
-        uint32_t non_chrono_backtrack = 0;
 
         SQLStats* sqlStats = NULL;
+        SolverMetrics* metrics = NULL; ///<Owned by Solver, NULL unless live metrics are on
+        #ifdef HOTPATH_PROFILE
+        HotProf hotprof;
+        #endif
+        void update_search_metrics();
+
+        //User callbacks, only the first thread has them
+        void poll_user_callbacks();
+        std::function<bool()> terminate_cb;
+        std::function<void(const SolveProgress&)> progress_cb;
+        double progress_every = 1;
+        double last_progress_time = 0;
         ClusteringImp *clustering = NULL;
         void consolidate_watches(const bool full);
 
@@ -170,6 +193,23 @@ class Searcher : public HyperEngine
             vector<Lit>& out_learnt,
             bool True_confl
         );
+        //Proof hints of 'lits', whose negation propagates to 'confl'.
+        //'confl_lit' is the other literal of a binary 'confl', lit_Undef
+        //if it is the one propagation failed on. Returns
+        //false if the conflict can't be explained with clauses
+        bool build_hints(
+            const vector<Lit>& lits
+            , const PropBy confl
+            , const Lit confl_lit
+            , vector<uint32_t>& out_hints
+        );
+        //Same, but the conflicting clause is given by its literals and ID
+        bool build_hints(
+            const vector<Lit>& lits
+            , const vector<Lit>& confl_cl
+            , const uint32_t confl_cl_ID
+            , vector<uint32_t>& out_hints
+        );
 
         #ifdef STATS_NEEDED
         void dump_restart_sql(rst_dat_type type, int64_t clauseID = -1);
@@ -215,6 +255,25 @@ class Searcher : public HyperEngine
         void   setup_polarity_strategy();
         void   update_polarities_on_backtrack();
 
+        //Focused/stable search modes
+        void   setup_search_mode();
+        bool   switch_search_mode();
+        void   account_search_mode_stats();
+        SearchMode search_mode = SearchMode::focused;
+        uint64_t mode_switch_len = 0;
+        uint64_t mode_switch_at = 0;
+        double   mode_var_decay[2] = {0.80, 0.90};
+        uint64_t mode_start_confl = 0;
+        uint64_t mode_start_props = 0;
+        double   mode_start_time = 0.0;
+
+        //Rephasing
+        void   setup_rephase_schedule();
+        bool   rephase();
+        vector<Rephase> rephase_sched;
+        uint32_t rephase_num = 0;
+        uint64_t next_rephase = 0;
+
     protected:
         Solver* solver;
         lbool search();
@@ -236,6 +295,9 @@ class Searcher : public HyperEngine
         ///////////////
         void save_state(SimpleOutFile& f, const lbool status) const;
         void load_state(SimpleInFile& f, const lbool status);
+        void save_checkpoint(SimpleOutFile& f) const;
+        void load_checkpoint(SimpleInFile& f);
+        void copy_checkpoint_from(const Searcher& other);
         void write_long_cls(
             const vector<ClOffset>& clauses
             , SimpleOutFile& f
@@ -279,6 +341,15 @@ class Searcher : public HyperEngine
         void  attach_and_enqueue_learnt_clause(Clause* cl, const uint32_t level, const bool enqueue);
         void  print_learning_debug_info() const;
         void  print_learnt_clause() const;
+
+        //Proof hints for the learnt clause
+        vector<uint32_t> hints;
+        vector<uint32_t> hint_stack;
+        vector<Lit> confl_lits;
+        void build_unit_hints(const uint32_t var, const PropBy confl);
+        uint32_t reason_ID(const uint32_t var) const;
+        uint32_t confl_ID(const PropBy confl, const Lit confl_lit) const;
+        void add_level0_units_to_drat(const size_t from);
         template<bool update_bogoprops>
         void add_literals_from_confl_to_learnt(const PropBy confl, const Lit p, uint32_t nDecisionLevel);
         template<bool update_bogoprops>
@@ -352,6 +423,11 @@ class Searcher : public HyperEngine
         int64_t max_confl_this_phase;
         void  check_need_restart();
         void  check_blocking_restart();
+        uint32_t reuse_trail_level();
+        bool  cancel_reused_trail();
+        uint32_t assump_levels_to_keep() const;
+        void cancel_to_kept_assumps();
+        uint32_t enum_floor = 0; ///<Highest flipped level of enumerate_projected(), conflicts must not backjump below it
         bool blocked_restart = false;
         uint64_t max_confl_per_search_solve_call;
         uint32_t num_search_called = 0;
@@ -386,6 +462,7 @@ class Searcher : public HyperEngine
 
         friend class Gaussian;
         friend class DistillerLong;
+        friend class ExtProp;
         #ifdef CMS_TESTING_ENABLED
         FRIEND_TEST(SearcherTest, pickpolar_rnd);
         FRIEND_TEST(SearcherTest, pickpolar_pos);
@@ -29,6 +29,9 @@ SearchStats& SearchStats::operator+=(const SearchStats& other)
     numRestarts += other.numRestarts;
     blocked_restart += other.blocked_restart;
     blocked_restart_same += other.blocked_restart_same;
+    trailReuseRestarts += other.trailReuseRestarts;
+    trailReuseLevels += other.trailReuseLevels;
+    trailReuseAssigns += other.trailReuseAssigns;
 
     //Decisions
     decisions += other.decisions;
@@ -36,6 +39,19 @@ SearchStats& SearchStats::operator+=(const SearchStats& other)
     decisionsRand += other.decisionsRand;
     decisionFlippedPolar += other.decisionFlippedPolar;
 
+    //Rephasing
+    rephases += other.rephases;
+    rephaseWalks += other.rephaseWalks;
+
+    //Focused/stable modes
+    modeSwitches += other.modeSwitches;
+    focusedConfl += other.focusedConfl;
+    focusedProps += other.focusedProps;
+    focusedTime += other.focusedTime;
+    stableConfl += other.stableConfl;
+    stableProps += other.stableProps;
+    stableTime += other.stableTime;
+
     //Conflict minimisation stats
     litsRedNonMin += other.litsRedNonMin;
     litsRedFinal += other.litsRedFinal;
@@ -66,6 +82,11 @@ SearchStats& SearchStats::operator+=(const SearchStats& other)
     otfSubsumedLitsGained += other.otfSubsumedLitsGained;
     red_cl_in_which0 += other.red_cl_in_which0;
 
+    //Chronological backtracking
+    chronoBacktrack += other.chronoBacktrack;
+    nonChronoBacktrack += other.nonChronoBacktrack;
+    chronoSavedAssigns += other.chronoSavedAssigns;
+
     //Hyper-bin & transitive reduction
     advancedPropCalled += other.advancedPropCalled;
     hyperBinAdded += other.hyperBinAdded;
@@ -87,6 +108,9 @@ SearchStats& SearchStats::operator-=(const SearchStats& other)
     numRestarts -= other.numRestarts;
     blocked_restart -= other.blocked_restart;
     blocked_restart_same -= other.blocked_restart_same;
+    trailReuseRestarts -= other.trailReuseRestarts;
+    trailReuseLevels -= other.trailReuseLevels;
+    trailReuseAssigns -= other.trailReuseAssigns;
 
     //Decisions
     decisions -= other.decisions;
@@ -94,6 +118,19 @@ SearchStats& SearchStats::operator-=(const SearchStats& other)
     decisionsRand -= other.decisionsRand;
     decisionFlippedPolar -= other.decisionFlippedPolar;
 
+    //Rephasing
+    rephases -= other.rephases;
+    rephaseWalks -= other.rephaseWalks;
+
+    //Focused/stable modes
+    modeSwitches -= other.modeSwitches;
+    focusedConfl -= other.focusedConfl;
+    focusedProps -= other.focusedProps;
+    focusedTime -= other.focusedTime;
+    stableConfl -= other.stableConfl;
+    stableProps -= other.stableProps;
+    stableTime -= other.stableTime;
+
     //Conflict minimisation stats
     litsRedNonMin -= other.litsRedNonMin;
     litsRedFinal -= other.litsRedFinal;
@@ -123,6 +160,11 @@ SearchStats& SearchStats::operator-=(const SearchStats& other)
     otfSubsumedLitsGained -= other.otfSubsumedLitsGained;
     red_cl_in_which0 -= other.red_cl_in_which0;
 
+    //Chronological backtracking
+    chronoBacktrack -= other.chronoBacktrack;
+    nonChronoBacktrack -= other.nonChronoBacktrack;
+    chronoSavedAssigns -= other.chronoSavedAssigns;
+
     //Hyper-bin & transitive reduction
     advancedPropCalled -= other.advancedPropCalled;
     hyperBinAdded -= other.hyperBinAdded;
@@ -160,6 +202,21 @@ void SearchStats::printCommon(uint64_t props, bool do_print_times) const
         , "per normal restart"
 
     );
+    print_stats_line("c trail reuse restarts"
+        , trailReuseRestarts
+        , stats_line_percent(trailReuseRestarts, numRestarts)
+        , "% of restarts"
+    );
+    print_stats_line("c trail reuse levels"
+        , trailReuseLevels
+        , ratio_for_stat(trailReuseLevels, numRestarts)
+        , "levels/restart"
+    );
+    print_stats_line("c trail reuse assigns"
+        , trailReuseAssigns
+        , ratio_for_stat(trailReuseAssigns, numRestarts)
+        , "assigns/restart"
+    );
     if (do_print_times)
     print_stats_line("c time", cpu_time);
     print_stats_line("c decisions", decisions
@@ -175,6 +232,36 @@ void SearchStats::printCommon(uint64_t props, bool do_print_times) const
     print_stats_line("c decisions/conflicts"
         , float_div(decisions, conflStats.numConflicts)
     );
+
+    print_stats_line("c rephases"
+        , rephases
+        , rephaseWalks
+        , "of them walk"
+    );
+
+    if (focusedConfl + stableConfl > 0) {
+        print_stats_line("c mode switches", modeSwitches);
+        print_stats_line("c focused confl/s"
+            , print_value_kilo_mega(focusedConfl, false)
+            , ratio_for_stat(focusedConfl, focusedTime)
+            , "confl/s"
+        );
+        print_stats_line("c focused props/s"
+            , print_value_kilo_mega(focusedProps, false)
+            , print_value_kilo_mega(ratio_for_stat(focusedProps, focusedTime), false)
+            , "props/s"
+        );
+        print_stats_line("c stable confl/s"
+            , print_value_kilo_mega(stableConfl, false)
+            , ratio_for_stat(stableConfl, stableTime)
+            , "confl/s"
+        );
+        print_stats_line("c stable props/s"
+            , print_value_kilo_mega(stableProps, false)
+            , print_value_kilo_mega(ratio_for_stat(stableProps, stableTime), false)
+            , "props/s"
+        );
+    }
 }
 
 void SearchStats::print_short(uint64_t props, bool do_print_times) const
@@ -198,6 +285,18 @@ void SearchStats::print_short(uint64_t props, bool do_print_times) const
         , stats_line_percent(red_cl_in_which0, conflStats.numConflicts)
         , "% of confl"
     );
+
+    print_stats_line("c chrono backtracks"
+        , chronoBacktrack
+        , stats_line_percent(chronoBacktrack, chronoBacktrack + nonChronoBacktrack)
+        , "% of backtracks"
+    );
+
+    print_stats_line("c chrono saved assigns"
+        , chronoSavedAssigns
+        , ratio_for_stat(chronoSavedAssigns, conflStats.numConflicts)
+        , "assigns/confl"
+    );
 }
 
 void SearchStats::print(uint64_t props, bool do_print_times) const
@@ -231,6 +330,18 @@ void SearchStats::print(uint64_t props, bool do_print_times) const
         , "% of confl"
     );
 
+    cout << "c CHRONO BACKTRACK stats" << endl;
+    print_stats_line("c chrono backtracks"
+        , chronoBacktrack
+        , stats_line_percent(chronoBacktrack, chronoBacktrack + nonChronoBacktrack)
+        , "% of backtracks"
+    );
+    print_stats_line("c chrono saved assigns"
+        , chronoSavedAssigns
+        , ratio_for_stat(chronoSavedAssigns, conflStats.numConflicts)
+        , "assigns/confl"
+    );
+
     cout << "c SEAMLESS HYPERBIN&TRANS-RED stats" << endl;
     print_stats_line("c advProp called"
         , advancedPropCalled
@@ -50,6 +50,9 @@ public:
     uint64_t blocked_restart = 0;
     uint64_t blocked_restart_same = 0;
     uint64_t numRestarts = 0;
+    uint64_t trailReuseRestarts = 0;
+    uint64_t trailReuseLevels = 0;
+    uint64_t trailReuseAssigns = 0;
 
     //Decisions
     uint64_t  decisions = 0;
@@ -57,6 +60,19 @@ public:
     uint64_t  decisionsRand = 0;
     uint64_t  decisionFlippedPolar = 0;
 
+    //Rephasing
+    uint64_t rephases = 0;
+    uint64_t rephaseWalks = 0;
+
+    //Focused/stable modes
+    uint64_t modeSwitches = 0;
+    uint64_t focusedConfl = 0;
+    uint64_t focusedProps = 0;
+    double   focusedTime = 0.0;
+    uint64_t stableConfl = 0;
+    uint64_t stableProps = 0;
+    double   stableTime = 0.0;
+
     //Clause shrinking
     uint64_t litsRedNonMin = 0;
     uint64_t litsRedFinal = 0;
@@ -84,6 +100,11 @@ public:
     uint64_t otfSubsumedLitsGained = 0;
     uint64_t red_cl_in_which0 = 0;
 
+    //Chronological backtracking
+    uint64_t chronoBacktrack = 0;
+    uint64_t nonChronoBacktrack = 0;
+    uint64_t chronoSavedAssigns = 0;
+
     //Hyper-bin & transitive reduction
     uint64_t advancedPropCalled = 0;
     uint64_t hyperBinAdded = 0;
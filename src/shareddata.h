@@ -71,6 +71,7 @@ class SharedData
         vector<Spec> bins;
         std::mutex unit_mutex;
         std::mutex bin_mutex;
+        std::mutex drat_mutex;
 
         uint32_t num_threads;
 
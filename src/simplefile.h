@@ -27,6 +27,14 @@ THE SOFTWARE.
 #include <iostream>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using std::ios;
 
 #include "solvertypes.h"
@@ -85,6 +93,17 @@ public:
         put(&d, sizeof(T));
     }
 
+    void put_raw(const void* ptr, size_t num)
+    {
+        put(ptr, num);
+    }
+
+    ///Flushes and closes the file, throws if anything could not be written
+    void finish()
+    {
+        outf->close();
+    }
+
 private:
     std::ofstream* outf = NULL;
     //vector<char> buffer;
@@ -95,11 +114,38 @@ private:
     }
 };
 
+/**
+@brief Reads back what SimpleOutFile wrote
+
+Where possible, the file is mmap()-ed, so that large arrays (e.g. the clause
+arena of a checkpoint) are read with a single memcpy() instead of through the
+stream buffers.
+*/
 class SimpleInFile
 {
 public:
     void start(const string& fname)
     {
+        #if !defined(_WIN32)
+        fd = open(fname.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd == -1 || fstat(fd, &st) != 0) {
+            cout << "Error opening file " << fname.c_str() << endl;
+            exit(-1);
+        }
+        map_size = st.st_size;
+        if (map_size > 0) {
+            void* m = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) {
+                cout << "Error mapping file " << fname.c_str() << endl;
+                exit(-1);
+            }
+            #ifdef MADV_SEQUENTIAL
+            madvise(m, map_size, MADV_SEQUENTIAL);
+            #endif
+            map = (const char*)m;
+        }
+        #else
         try {
             inf = new std::ifstream(fname.c_str(), ios::in | ios::binary);
             inf->exceptions(~std::ios::goodbit);
@@ -107,24 +153,34 @@ public:
             cout << "Error opening file " << fname.c_str() << endl;
             exit(-1);
         }
+        #endif
     }
 
     ~SimpleInFile()
     {
+        #if !defined(_WIN32)
+        if (map != NULL) {
+            munmap((void*)map, map_size);
+        }
+        if (fd != -1) {
+            close(fd);
+        }
+        #else
         delete inf;
+        #endif
     }
 
     uint32_t get_uint32_t()
     {
         uint32_t val = 0;
-        inf->read((char*)&val, 4);
+        get_raw(&val, 1, 4);
         return val;
     }
 
     uint64_t get_uint64_t()
     {
         uint64_t val = 0;
-        inf->read((char*)&val, 8);
+        get_raw(&val, 1, 8);
         return val;
     }
 
@@ -137,18 +193,23 @@ public:
     lbool get_lbool()
     {
         lbool l;
-        inf->read((char*)&l, sizeof(lbool));
+        get_raw(&l, 1, sizeof(lbool));
         return l;
     }
 
     template<class T>
     void get_vector(vector<T>& d)
     {
-        assert(d.empty());
+        d.clear();
         uint64_t sz = get_uint64_t();
         if (sz == 0)
             return;
 
+        #if !defined(_WIN32)
+        if (sz > (map_size - at)/sizeof(T)) {
+            throw std::runtime_error("ERROR: file is truncated");
+        }
+        #endif
         d.resize(sz);
         get_raw(&d[0], d.size(), sizeof(T));
     }
@@ -156,16 +217,34 @@ public:
     template<class T>
     void get_struct(T& d)
     {
-        inf->read((char*)&d, sizeof(T));
+        get_raw(&d, 1, sizeof(T));
     }
 
-private:
-    std::ifstream* inf = NULL;
-
     void get_raw(void* ptr, size_t num, size_t elem_sz)
     {
+        #if !defined(_WIN32)
+        const size_t bytes = num*elem_sz;
+        if (bytes > map_size - at) {
+            throw std::runtime_error("ERROR: file is truncated");
+        }
+        if (bytes > 0) {
+            memcpy(ptr, map + at, bytes);
+        }
+        at += bytes;
+        #else
         inf->read((char*)ptr, num*elem_sz);
+        #endif
     }
+
+private:
+    #if !defined(_WIN32)
+    int fd = -1;
+    const char* map = NULL;
+    size_t map_size = 0;
+    size_t at = 0;
+    #else
+    std::ifstream* inf = NULL;
+    #endif
 };
 
 }
@@ -82,6 +82,30 @@ void SolutionExtender::extend()
     solver->varReplacer->extend_model_set_undef();
 }
 
+//Only sets the outer vars in "vars" and what they depend on, see
+//OccSimplifier::extend_model_projected()
+void SolutionExtender::extend_projected(const vector<uint32_t>& vars)
+{
+    //Extend variables already set
+    solver->varReplacer->extend_model_already_set();
+
+    vector<uint32_t> replaced_with;
+    for(const uint32_t var: vars) {
+        replaced_with.push_back(solver->varReplacer->get_var_replaced_with_outer(var));
+    }
+    if (simplifier) {
+        simplifier->extend_model_projected(this, replaced_with);
+    }
+
+    //Nothing constrains these, like in extend_model_set_undef()
+    for(const uint32_t var: replaced_with) {
+        if (solver->model_value(var) == l_Undef) {
+            solver->model[var] = l_False;
+            solver->varReplacer->extend_model(var);
+        }
+    }
+}
+
 inline bool SolutionExtender::satisfied(const vector< Lit >& lits) const
 {
     for(const Lit lit: lits) {
@@ -41,6 +41,7 @@ class SolutionExtender
     public:
         SolutionExtender(Solver* _solver, OccSimplifier* simplifier);
         void extend();
+        void extend_projected(const vector<uint32_t>& vars);
         bool addClause(const vector<Lit>& lits, const uint32_t blockedOn);
         void dummyBlocked(const uint32_t blockedOn);
 
@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "completedetachreattacher.h"
 #include "compfinder.h"
 #include "comphandler.h"
+#include "comptracker.h"
 #include "subsumestrengthen.h"
 #include "watchalgos.h"
 #include "clauseallocator.h"
@@ -51,6 +52,8 @@ THE SOFTWARE.
 #include "distillerlongwithimpl.h"
 #include "str_impl_w_impl.h"
 #include "datasync.h"
+#include "extprop.h"
+#include "metrics.h"
 #include "reducedb.h"
 #include "clausedumper.h"
 #include "sccfinder.h"
@@ -117,6 +120,7 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
     if (conf.doCompHandler) {
         compHandler = new CompHandler(this);
     }
+    compTracker = new CompTracker(this);
     if (conf.doStrSubImplicit) {
         subsumeImplicit = new SubsumeImplicit(this);
     }
@@ -137,7 +141,10 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
 Solver::~Solver()
 {
     delete compHandler;
+    delete compTracker;
+    delete extprop;
     delete sqlStats;
+    delete metrics;
     delete intree;
     delete occsimplifier;
     delete distill_long_cls;
@@ -396,7 +403,7 @@ Clause* Solver::add_clause_int(
     , const bool sorted
 ) {
     assert(ok);
-    assert(decisionLevel() == 0);
+    assert(decisionLevel() <= kept_assumps.size());
     assert(!attach_long || qhead == trail.size());
     #ifdef VERBOSE_DEBUG
     cout << "add_clause_int clause " << lits << endl;
@@ -418,6 +425,7 @@ Clause* Solver::add_clause_int(
         if (finalLits) {
             finalLits->clear();
         }
+        frat_hints.clear();
         return NULL;
     }
 
@@ -430,6 +438,7 @@ Clause* Solver::add_clause_int(
         *finalLits = ps;
     }
 
+    uint32_t frat_ID = 0;
     if (addDrat) {
         size_t i = 0;
         if (drat_first != lit_Undef) {
@@ -440,7 +449,14 @@ Clause* Solver::add_clause_int(
             }
         }
         std::swap(ps[0], ps[i]);
-        *drat << add << ps
+        //Long clauses are only known to the proof once allocated
+        if (ps.size() > 2) {
+            frat_ID = drat->new_ID();
+        }
+        if (!frat_hints.empty() && drat->hints_needed()) {
+            set_hints_removed_lits(lits, ps.size());
+        }
+        *drat << add << FratID(frat_ID) << ps
         #ifdef STATS_NEEDED
         << cl_stats.ID << sumConflicts
         #endif
@@ -452,6 +468,8 @@ Clause* Solver::add_clause_int(
         }
     }
 
+    frat_hints.clear();
+
     //Handle special cases
     switch (ps.size()) {
         case 0:
@@ -489,6 +507,9 @@ Clause* Solver::add_clause_int(
                 c->makeRed(sumConflicts);
             }
             c->stats = cl_stats;
+            if (frat_ID != 0) {
+                drat->set_ID(*c, frat_ID);
+            }
             #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
             c->stats.introduced_at_conflict = introduced_at_conflict;
             assert(!c->red() || introduced_at_conflict != 0 || sumConflicts == 0);
@@ -509,6 +530,24 @@ Clause* Solver::add_clause_int(
     }
 }
 
+//The hints of the caller are for the clause before the literals false at
+//level 0 were removed, their units have to come first
+void Solver::set_hints_removed_lits(const vector<Lit>& lits, const size_t final_size)
+{
+    tmp_hints.clear();
+    if (final_size < lits.size()) {
+        for(const Lit l: lits) {
+            if (value(l) == l_False) {
+                tmp_hints.push_back(drat->unit_ID(~l));
+            }
+        }
+        std::sort(tmp_hints.begin(), tmp_hints.end());
+        tmp_hints.erase(std::unique(tmp_hints.begin(), tmp_hints.end()), tmp_hints.end());
+    }
+    tmp_hints.insert(tmp_hints.end(), frat_hints.begin(), frat_hints.end());
+    drat->set_hints(tmp_hints);
+}
+
 void Solver::attachClause(
     const Clause& cl
     , const bool checkAttach
@@ -524,6 +563,7 @@ void Solver::attachClause(
         litStats.redLits += cl.size();
     } else {
         litStats.irredLits += cl.size();
+        compTracker->attached_clause(cl);
     }
 
     //Call Solver's function for heavy-lifting
@@ -545,6 +585,7 @@ void Solver::attach_bin_clause(
         binTri.redBins++;
     } else {
         binTri.irredBins++;
+        compTracker->attached_bin(lit1, lit2);
     }
 
     //Call Solver's function for heavy-lifting
@@ -590,7 +631,7 @@ bool Solver::addClauseHelper(vector<Lit>& ps)
         return false;
 
     //Sanity checks
-    assert(decisionLevel() == 0);
+    assert(decisionLevel() <= kept_assumps.size());
     assert(qhead == trail.size());
 
     //Check for too long clauses
@@ -696,13 +737,15 @@ bool Solver::addClauseHelper(vector<Lit>& ps)
     return true;
 }
 
-bool Solver::addClause(const vector<Lit>& lits, bool red)
+bool Solver::addClause(const vector<Lit>& lits, bool red, const uint32_t ID)
 {
     vector<Lit> ps = lits;
-    return Solver::addClauseInt(ps, red);
+    return Solver::addClauseInt(ps, red, ID);
 }
 
-bool Solver::addClauseInt(vector<Lit>& ps, bool red)
+//ps is in outer numbering. If it is already in the FRAT proof, ID is its ID
+//there, and the clause keeps it unless it changes here
+bool Solver::addClauseInt(vector<Lit>& ps, bool red, const uint32_t ID)
 {
     if (conf.perform_occur_based_simp && occsimplifier->getAnythingHasBeenBlocked()) {
         std::cerr
@@ -716,13 +759,52 @@ bool Solver::addClauseInt(vector<Lit>& ps, bool red)
     cout << "Adding clause " << ps << endl;
     #endif //VERBOSE_DEBUG
     const size_t origTrailSize = trail.size();
+    //Can't be a member, uneliminating in addClauseHelper() adds clauses
+    vector<Lit> frat_orig;
+    if (ID != 0) {
+        frat_orig = ps;
+    }
 
-    if (!addClauseHelper(ps)) {
+    const bool helper_ok = addClauseHelper(ps);
+    if (ID != 0) {
+        for(Lit& l: frat_orig) {
+            l = map_outer_to_inter(l);
+        }
+    }
+    if (!helper_ok) {
+        if (ID != 0) {
+            *drat << del << FratID(ID) << frat_orig << fin;
+        }
         return false;
     }
 
     std::sort(ps.begin(), ps.end());
 
+    //In the FRAT proof the clause is the original one as long as
+    //no literal was replaced or cleaned away. Otherwise the new one
+    //is added before it is used for propagation
+    bool unchanged = false;
+    ClauseStats cl_stats;
+    if (ID != 0) {
+        std::sort(frat_orig.begin(), frat_orig.end());
+        const bool same_lits = (frat_orig == ps);
+        unchanged = same_lits;
+        for(size_t i = 0; i < ps.size() && unchanged; i++) {
+            if (value(ps[i]) != l_Undef
+                || (i > 0 && ps[i].var() == ps[i-1].var())
+            ) {
+                unchanged = false;
+            }
+        }
+        if (!unchanged && same_lits) {
+            frat_hints.push_back(ID);
+        }
+        //Units propagate as soon as they are added
+        if (unchanged && !ps.empty() && ps.size() <= 2) {
+            drat->set_ID(ps, ID);
+        }
+    }
+
     vector<Lit> *pFinalCl = NULL;
     if (drat->enabled() || conf.simulate_drat) {
         finalCl_tmp.clear();
@@ -731,16 +813,22 @@ bool Solver::addClauseInt(vector<Lit>& ps, bool red)
     Clause *cl = add_clause_int(
         ps
         , red
-        , ClauseStats() //default stats
+        , cl_stats
         , true //yes, attach
         , pFinalCl
-        , false //add drat?
+        , ID != 0 && !unchanged //add drat?
         , lit_Undef
         , true
     );
 
     //Drat -- We manipulated the clause, delete
-    if ((drat->enabled() || conf.simulate_drat)
+    if (ID != 0) {
+        if (!unchanged) {
+            *drat << del << FratID(ID) << frat_orig << fin;
+        } else if (cl != NULL) {
+            drat->set_ID(*cl, ID);
+        }
+    } else if ((drat->enabled() || conf.simulate_drat)
         && ps != finalCl_tmp
     ) {
         //Dump only if non-empty (UNSAT handled later)
@@ -1043,6 +1131,11 @@ bool Solver::renumber_variables(bool must_renumber)
         interToOuter2[i*2+1] = interToOuter[i]*2+1;
     }
 
+    //The trail is lost, tell the propagator about it first
+    if (extprop) {
+        extprop->notify_assignments();
+    }
+
     renumber_clauses(outerToInter);
     CNF::updateVars(outerToInter, interToOuter, interToOuter2);
     PropEngine::updateVars(outerToInter, interToOuter);
@@ -1056,6 +1149,9 @@ bool Solver::renumber_variables(bool must_renumber)
     //Update sub-elements' vars
     varReplacer->updateVars(outerToInter, interToOuter);
     datasync->updateVars(outerToInter, interToOuter);
+    if (extprop) {
+        extprop->update_vars();
+    }
 
     //Tests
     test_renumbering();
@@ -1117,6 +1213,7 @@ void Solver::new_vars(size_t n)
     if (compHandler) {
         compHandler->new_vars(n);
     }
+    compTracker->new_vars(n);
     datasync->new_vars(n);
 }
 
@@ -1134,6 +1231,7 @@ void Solver::new_var(const bool bva, const uint32_t orig_outer)
         compHandler->new_var(orig_outer);
     }
     if (orig_outer == std::numeric_limits<uint32_t>::max()) {
+        compTracker->new_var();
         datasync->new_var(bva);
     }
 
@@ -1185,7 +1283,15 @@ void Solver::set_assumptions()
     } else {
         inter_assumptions_tmp = outside_assumptions;
     }
-    addClauseHelper(inter_assumptions_tmp);
+    if (decisionLevel() == 0) {
+        addClauseHelper(inter_assumptions_tmp);
+    } else {
+        //Kept assumption levels: reuse_kept_assumps() checked that no
+        //variable has to be added back
+        for(Lit& lit: inter_assumptions_tmp) {
+            lit = map_outer_to_inter(varReplacer->get_lit_replaced_with_outer(lit));
+        }
+    }
     assert(inter_assumptions_tmp.size() == outside_assumptions.size());
 
     assumptions.resize(inter_assumptions_tmp.size());
@@ -1359,11 +1465,18 @@ void Solver::extend_solution(const bool only_sampling_solution)
         compHandler->addSavedState(model);
     }
 
+    SolutionExtender extender(this, occsimplifier);
     if (!only_sampling_solution) {
-        SolutionExtender extender(this, occsimplifier);
         extender.extend();
     } else {
-        varReplacer->extend_model_already_set();
+        //Sampling vars eliminated before they were set need their
+        //eliminated clauses, but only those
+        assert(conf.sampling_vars);
+        vector<uint32_t> outer_vars;
+        for(const uint32_t var: *conf.sampling_vars) {
+            outer_vars.push_back(map_to_with_bva(var));
+        }
+        extender.extend_projected(outer_vars);
     }
 
     //map back without BVA
@@ -1575,6 +1688,7 @@ lbool Solver::solve_with_assumptions(
     longest_trail_ever = 0; //reset: probably new clauses, changed assumptions
     fresh_solver = false;
     move_to_outside_assumps(_assumptions);
+    reuse_kept_assumps();
     set_assumptions();
     #ifdef SLOW_DEBUG
     if (ok) {
@@ -1635,12 +1749,7 @@ lbool Solver::solve_with_assumptions(
     }
 
     //If still unknown, simplify
-    if (status == l_Undef
-        && nVars() > 0
-        && conf.do_simplify_problem
-        && conf.simplify_at_startup
-        && (solveStats.num_simplify == 0 || conf.simplify_at_every_startup)
-    ) {
+    if (status == l_Undef && startup_simplify_due()) {
         status = simplify_problem(!conf.full_simplify_at_startup);
     }
 
@@ -1654,6 +1763,11 @@ lbool Solver::solve_with_assumptions(
     if (sqlStats) {
         sqlStats->finishup(status);
     }
+    #ifdef HOTPATH_PROFILE
+    if (conf.verbosity) {
+        hotprof.print_and_clear(conf.thread_num);
+    }
+    #endif
 
     if (conf.preprocess == 1) {
         cancelUntil(0);
@@ -1689,14 +1803,335 @@ lbool Solver::solve_with_assumptions(
     assumptions.clear();
     conf.max_confl = std::numeric_limits<long>::max();
     conf.maxTime = std::numeric_limits<double>::max();
+    if (!okay()) {
+        //FRAT: not all ways to UNSAT put the empty clause into the proof,
+        //and it must be there before the clauses still around are listed
+        if (drat->hints_needed()) {
+            add_empty_cl_to_drat();
+        }
+        finalize_frat();
+    }
     drat->flush();
+    datasync->flush_ext_export();
+    drat_check_result = l_Undef;
+    if (status == l_False && !okay()) {
+        drat_check_result = drat->verify_unsat();
+    }
     conf.conf_needed = true;
-    assert(decisionLevel()== 0);
+    assert(decisionLevel() <= outside_assumptions.size());
     assert(!ok || solver->prop_at_head());
+    kept_assumps.assign(
+        outside_assumptions.begin(), outside_assumptions.begin() + decisionLevel());
 
     return status;
 }
 
+//Calls 'callback' with every model projected to the outside variables in
+//'projection' (all variables if NULL), at most 'limit' times. Unlike banning
+//every solution and calling solve() again, no clauses are added: the search
+//continues from the trail of the previous model, see enumerate_projected()
+uint64_t Solver::enumerate(
+    const std::function<bool(const vector<lbool>&)>& callback
+    , const vector<uint32_t>* projection
+    , const uint64_t limit
+) {
+    fresh_solver = false;
+    drop_kept_assumps();
+    if (!okay() || limit == 0) {
+        return 0;
+    }
+
+    #ifdef USE_GAUSS
+    //The search below does not run the matrices
+    if (!fully_undo_xor_detach()) {
+        return 0;
+    }
+    clear_gauss_matrices();
+    #endif
+
+    vector<uint32_t> proj_outside;
+    if (projection) {
+        proj_outside = *projection;
+    } else {
+        for(uint32_t i = 0; i < nVarsOutside(); i++) {
+            proj_outside.push_back(i);
+        }
+    }
+    vector<Lit> proj;
+    for(const uint32_t var: proj_outside) {
+        if (var >= nVarsOutside()) {
+            std::cerr
+            << "ERROR: Projection variable " << var + 1
+            << " given, but max var is "
+            << nVarsOutside()
+            << endl;
+            std::exit(-1);
+        }
+        proj.push_back(Lit(var, false));
+    }
+
+    //Projection vars must be there to be decided on: undo their elimination,
+    //decomposition and replacement
+    back_number_from_outside_to_outer(proj);
+    proj = back_number_from_outside_to_outer_tmp;
+    if (!addClauseHelper(proj)) {
+        return 0;
+    }
+    if (!propagate<false>().isNULL()) {
+        ok = false;
+        return 0;
+    }
+
+    //Replaced vars may end up the same, decide every var once
+    vector<Lit> decide;
+    for(const Lit lit: proj) {
+        if (!seen[lit.var()]) {
+            seen[lit.var()] = 1;
+            decide.push_back(lit);
+        }
+    }
+    for(const Lit lit: decide) {
+        seen[lit.var()] = 0;
+    }
+
+    vector<lbool> proj_model(nVarsOutside(), l_Undef);
+    const auto found = [&]() -> bool {
+        for(uint32_t i = 0; i < proj.size(); i++) {
+            proj_model[proj_outside[i]] = value(proj[i]);
+        }
+        return callback(proj_model);
+    };
+    const uint64_t num = enumerate_projected(decide, limit, found);
+    #ifdef HOTPATH_PROFILE
+    if (conf.verbosity) {
+        hotprof.print_and_clear(conf.thread_num);
+    }
+    #endif
+
+    sumSearchStats += Searcher::get_stats();
+    sumPropStats += propStats;
+    propStats.clear();
+    Searcher::resetStats();
+
+    return num;
+}
+
+void Solver::connect_external_propagator(ExternalPropagator* prop)
+{
+    drop_kept_assumps();
+    if (extprop == NULL) {
+        conf_before_extprop = conf;
+    }
+    delete extprop;
+    extprop = new ExtProp(this, prop);
+
+    //These would not know about the theory. Chronological backtracking is
+    //off so that levels are notified in trail order
+    conf.doCompHandler = false;
+    conf.doFindAndReplaceEqLits = false;
+    conf.doFindXors = false;
+    conf.gaussconf.doMatrixFind = false;
+    conf.doBreakid = false;
+    conf.diff_declev_for_chrono = -1;
+    #ifdef USE_GAUSS
+    clear_gauss_matrices();
+    #endif
+}
+
+void Solver::disconnect_external_propagator()
+{
+    drop_kept_assumps();
+    if (extprop == NULL) {
+        return;
+    }
+    delete extprop;
+    extprop = NULL;
+
+    conf.doCompHandler = conf_before_extprop.doCompHandler;
+    conf.doFindAndReplaceEqLits = conf_before_extprop.doFindAndReplaceEqLits;
+    conf.doFindXors = conf_before_extprop.doFindXors;
+    conf.gaussconf.doMatrixFind = conf_before_extprop.gaussconf.doMatrixFind;
+    conf.doBreakid = conf_before_extprop.doBreakid;
+    conf.diff_declev_for_chrono = conf_before_extprop.diff_declev_for_chrono;
+}
+
+bool Solver::external_propagator_connected() const
+{
+    return extprop != NULL;
+}
+
+void Solver::add_observed_var(const uint32_t var)
+{
+    if (var >= nVarsOutside()) {
+        std::cerr
+        << "ERROR: Observed variable " << var + 1
+        << " given, but max var is "
+        << nVarsOutside()
+        << endl;
+        std::exit(-1);
+    }
+    drop_kept_assumps();
+    if (!ok) {
+        return;
+    }
+
+    //The var must stay in the CNF: undo its elimination and decomposition
+    vector<Lit> lits;
+    lits.push_back(Lit(var, false));
+    back_number_from_outside_to_outer(lits);
+    lits = back_number_from_outside_to_outer_tmp;
+    if (!addClauseHelper(lits)) {
+        return;
+    }
+    if (!propagate<false>().isNULL()) {
+        ok = false;
+        return;
+    }
+    extprop->add_observed_var(var);
+}
+
+void Solver::remove_observed_var(const uint32_t var)
+{
+    drop_kept_assumps();
+    extprop->remove_observed_var(var);
+}
+
+void Solver::reset_observed_vars()
+{
+    drop_kept_assumps();
+    extprop->reset_observed_vars();
+}
+
+bool Solver::startup_simplify_due() const
+{
+    return nVars() > 0
+        && conf.do_simplify_problem
+        && conf.simplify_at_startup
+        && (solveStats.num_simplify == 0 || conf.simplify_at_every_startup);
+}
+
+//Backtracks the levels kept by the previous solve() to the first assumption
+//that differs, so that the shared prefix is not decided and propagated again
+void Solver::reuse_kept_assumps()
+{
+    uint32_t keep = 0;
+    while(keep < kept_assumps.size()
+        && keep < outside_assumptions.size()
+        && kept_assumps[keep] == outside_assumptions[keep]
+    ) {
+        keep++;
+    }
+
+    //These must start from level 0
+    if (startup_simplify_due()
+        || conf.preprocess != 0
+        || (conf.reconfigure_val != 0
+            && !already_reconfigured
+            && solveStats.num_simplify == conf.reconfigure_at)
+    ) {
+        keep = 0;
+    }
+    for(uint32_t i = 0; i < outside_assumptions.size() && keep > 0; i++) {
+        if (!assump_usable_on_kept_trail(outside_assumptions[i])) {
+            keep = 0;
+        }
+    }
+
+    drop_kept_assumps(keep);
+    if (decisionLevel() > 0) {
+        solveStats.assump_reuse_calls++;
+        solveStats.assump_reuse_levels += decisionLevel();
+    }
+    kept_assumps.clear();
+}
+
+//set_assumptions() can only skip addClauseHelper() if the variable needs
+//nothing added back: not eliminated, decomposed or renumbered away
+bool Solver::assump_usable_on_kept_trail(const Lit lit) const
+{
+    if (lit.var() >= nVarsOutside()) {
+        return false;
+    }
+    const Lit outer = varReplacer->get_lit_replaced_with_outer(map_to_with_bva(lit));
+    const Lit inter = map_outer_to_inter(outer);
+    return inter.var() < nVars()
+        && varData[inter.var()].removed == Removed::none;
+}
+
+void Solver::drop_kept_assumps(const uint32_t level)
+{
+    if (kept_assumps.size() > level) {
+        kept_assumps.resize(level);
+    }
+    if (decisionLevel() <= level) {
+        return;
+    }
+
+    cancelUntil(level);
+
+    //due to chrono BT we need to propagate once more
+    PropBy confl = propagate<false>();
+    if (!confl.isNULL() && decisionLevel() > 0) {
+        kept_assumps.clear();
+        cancelUntil(0);
+        confl = propagate<false>();
+    }
+    if (!confl.isNULL()) {
+        ok = false;
+    }
+}
+
+//A clause added between solve() calls keeps the kept levels below all of its
+//literals: all its literals are then unassigned or fixed at level 0, so it is
+//attached exactly as it would be at level 0. Clauses that become unit or
+//need variables added back need level 0.
+void Solver::cancel_kept_assumps_for_clause(const vector<Lit>& outer_lits)
+{
+    if (decisionLevel() == 0) {
+        return;
+    }
+
+    uint32_t min_level = std::numeric_limits<uint32_t>::max();
+    uint32_t free_vars = 0;
+    for(const Lit outer: outer_lits) {
+        if (outer.var() >= nVarsOuter()) {
+            drop_kept_assumps();
+            return;
+        }
+        const Lit lit = map_outer_to_inter(varReplacer->get_lit_replaced_with_outer(outer));
+        if (lit.var() >= nVars()
+            || varData[lit.var()].removed != Removed::none
+        ) {
+            drop_kept_assumps();
+            return;
+        }
+        if (value(lit) != l_Undef && varData[lit.var()].level == 0) {
+            if (value(lit) == l_True) {
+                //Satisfied for good, nothing will be attached
+                return;
+            }
+            continue;
+        }
+        if (value(lit) != l_Undef) {
+            min_level = std::min(min_level, varData[lit.var()].level);
+        }
+        if (!seen[lit.var()]) {
+            seen[lit.var()] = 1;
+            free_vars++;
+        }
+    }
+    for(const Lit outer: outer_lits) {
+        const Lit lit = map_outer_to_inter(varReplacer->get_lit_replaced_with_outer(outer));
+        seen[lit.var()] = 0;
+    }
+
+    if (free_vars < 2) {
+        drop_kept_assumps();
+    } else if (min_level != std::numeric_limits<uint32_t>::max()) {
+        drop_kept_assumps(min_level-1);
+    }
+}
+
 void Solver::check_reconfigure()
 {
     if (nVars() > 2
@@ -1825,6 +2260,35 @@ void Solver::dump_memory_stats_to_sql()
     );
 }
 
+const SolverMetrics* Solver::enable_metrics()
+{
+    if (metrics == NULL) {
+        metrics = new SolverMetrics;
+    }
+    return metrics;
+}
+
+void Solver::update_metrics()
+{
+    SolverMetrics& m = *metrics;
+    update_search_metrics();
+    m.set(m.free_vars, get_num_free_vars());
+
+    m.set(m.mem[SolverMetrics::mem_solver], mem_used());
+    m.set(m.mem[SolverMetrics::mem_vardata], mem_used_vardata());
+    m.set(m.mem[SolverMetrics::mem_longclauses], CNF::mem_used_longclauses());
+    m.set(m.mem[SolverMetrics::mem_watch_alloc], watches.mem_used_alloc());
+    m.set(m.mem[SolverMetrics::mem_watch_array], watches.mem_used_array());
+    m.set(m.mem[SolverMetrics::mem_renumber], CNF::mem_used_renumberer());
+    m.set(m.mem[SolverMetrics::mem_occsimplifier]
+        , occsimplifier ? occsimplifier->mem_used() : 0);
+    m.set(m.mem[SolverMetrics::mem_varreplacer], varReplacer->mem_used());
+    m.set(m.mem[SolverMetrics::mem_comphandler]
+        , compHandler ? compHandler->mem_used() : 0);
+    double vm_mem_used = 0;
+    m.set(m.mem[SolverMetrics::mem_rss], memUsedTotal(vm_mem_used));
+}
+
 long Solver::calc_num_confl_to_do_this_iter(const size_t iteration_num) const
 {
     double iter_num = std::min<size_t>(iteration_num, 100ULL);
@@ -1858,6 +2322,9 @@ lbool Solver::iterate_until_solved()
             print_clause_size_distrib();
         }
         dump_memory_stats_to_sql();
+        if (metrics) {
+            update_metrics();
+        }
 
         const long num_confl = calc_num_confl_to_do_this_iter(iteration_num);
         if (num_confl <= 0) {
@@ -1902,9 +2369,15 @@ lbool Solver::iterate_until_solved()
         if (status == l_Undef) {
             check_reconfigure();
         }
+        if (status == l_Undef) {
+            status = check_checkpoint();
+        }
     }
 
     end:
+    if (metrics) {
+        update_metrics();
+    }
     return status;
 }
 
@@ -1934,7 +2407,7 @@ void Solver::handle_found_solution(const lbool status, const bool only_sampling_
     double mytime = cpuTime();
     if (status == l_True) {
         extend_solution(only_sampling_solution);
-        cancelUntil(0);
+        cancelUntil(assump_levels_to_keep());
         assert(solver->prop_at_head());
 
         #ifdef DEBUG_ATTACH_MORE
@@ -1942,7 +2415,7 @@ void Solver::handle_found_solution(const lbool status, const bool only_sampling_
         test_all_clause_attached();
         #endif
     } else if (status == l_False) {
-        cancelUntil(0);
+        cancelUntil(assump_levels_to_keep());
 
         for(const Lit lit: conflict) {
             if (value(lit) == l_Undef) {
@@ -2282,6 +2755,31 @@ void CMSat::Solver::print_stats(const double cpu_time, const double cpu_time_tot
     } else if (conf.verbStats == 1) {
         print_min_stats(cpu_time, cpu_time_total);
     }
+    if (solveStats.assump_reuse_calls > 0) {
+        print_stats_line("c assump reuse calls"
+            , solveStats.assump_reuse_calls
+            , stats_line_percent(solveStats.assump_reuse_calls, solveStats.num_solve_calls)
+            , "% of solve calls"
+        );
+        print_stats_line("c assump reuse levels"
+            , solveStats.assump_reuse_levels
+            , ratio_for_stat(solveStats.assump_reuse_levels, solveStats.assump_reuse_calls)
+            , "levels/reuse"
+        );
+    }
+
+    if (drat->enabled()) {
+        drat->print_stats();
+    }
+    if (datasync->net_enabled()) {
+        datasync->print_net_stats();
+    }
+    if (datasync->ext_enabled()) {
+        datasync->print_ext_stats();
+    }
+    if (extprop) {
+        extprop->print_stats();
+    }
 }
 
 void Solver::print_min_stats(const double cpu_time, const double cpu_time_total) const
@@ -2614,6 +3112,15 @@ void Solver::print_mem_stats() const
     );
     account += mem;
 
+    mem = compTracker->mem_used();
+    print_stats_line("c Mem for component tracker"
+        , mem/(1024UL*1024UL)
+        , "MB"
+        , stats_line_percent(mem, rss_mem_used)
+        , "%"
+    );
+    account += mem;
+
     if (compHandler) {
         mem = compHandler->mem_used();
         print_stats_line("c Mem for component handler"
@@ -2729,6 +3236,29 @@ void Solver::print_clause_size_distrib()
 }
 
 
+//Each var gets the smallest var of its component, vars set at level 0 get
+//var_Undef
+vector<uint32_t> Solver::get_outside_var_components()
+{
+    vector<uint32_t> comps = compTracker->get_outer_comps();
+    if (get_num_bva_vars() != 0) {
+        comps = map_back_vars_to_without_bva(comps);
+    }
+
+    vector<uint32_t> comp_to_smallest(nVarsOuter(), var_Undef);
+    for(uint32_t i = 0; i < comps.size(); i++) {
+        if (comps[i] == var_Undef) {
+            continue;
+        }
+        if (comp_to_smallest[comps[i]] == var_Undef) {
+            comp_to_smallest[comps[i]] = i;
+        }
+        comps[i] = comp_to_smallest[comps[i]];
+    }
+
+    return comps;
+}
+
 vector<Lit> Solver::get_zero_assigned_lits(const bool backnumber,
                                            const bool only_nvars) const
 {
@@ -3122,11 +3652,23 @@ bool Solver::add_clause_outer(const vector<Lit>& lits, bool red)
     check_too_large_variable_number(lits);
     #endif
     back_number_from_outside_to_outer(lits);
-    return addClauseInt(back_number_from_outside_to_outer_tmp, red);
+    cancel_kept_assumps_for_clause(back_number_from_outside_to_outer_tmp);
+    if (!ok) {
+        return false;
+    }
+    uint32_t ID = 0;
+    if (drat->enabled()) {
+        ID = drat->add_original(back_number_from_outside_to_outer_tmp);
+    }
+    if (!red) {
+        compTracker->add_clause(back_number_from_outside_to_outer_tmp);
+    }
+    return addClauseInt(back_number_from_outside_to_outer_tmp, red, ID);
 }
 
 bool Solver::add_xor_clause_outer(const vector<uint32_t>& vars, bool rhs)
 {
+    drop_kept_assumps();
     if (!ok) {
         return false;
     }
@@ -3140,6 +3682,7 @@ bool Solver::add_xor_clause_outer(const vector<uint32_t>& vars, bool rhs)
     #endif
 
     back_number_from_outside_to_outer(lits);
+    compTracker->add_clause(back_number_from_outside_to_outer_tmp, true);
     addClauseHelper(back_number_from_outside_to_outer_tmp);
     add_xor_clause_inter(back_number_from_outside_to_outer_tmp, rhs, true, false);
 
@@ -3522,6 +4065,361 @@ lbool Solver::load_state(const string& fname)
     return status;
 }
 
+static const char checkpoint_magic[8] = {'C', 'M', 'S', 'C', 'K', 'P', 'T', 0};
+static const uint32_t checkpoint_version = 2;
+
+//The clause arena and the stats are written as raw memory, so the file can
+//only be read back by the same build
+static vector<uint32_t> checkpoint_layout()
+{
+    vector<uint32_t> layout;
+    layout.push_back(sizeof(BASE_DATA_TYPE));
+    layout.push_back(sizeof(Clause));
+    layout.push_back(sizeof(ClauseStats));
+    layout.push_back(sizeof(VarData));
+    layout.push_back(sizeof(Trail));
+    layout.push_back(sizeof(ActAndOffset));
+    layout.push_back(sizeof(SearchStats));
+    layout.push_back(sizeof(PropStats));
+    layout.push_back(sizeof(OccSimplifier::Stats));
+    layout.push_back(sizeof(BVEStats));
+    #ifdef STATS_NEEDED
+    layout.push_back(1);
+    #else
+    layout.push_back(0);
+    #endif
+    return layout;
+}
+
+static void checkpoint_error(const string& fname, const string& what)
+{
+    throw std::runtime_error(
+        "ERROR: cannot resume from checkpoint '" + fname + "': " + what);
+}
+
+string Solver::checkpoint_fname(const string& base) const
+{
+    if (conf.thread_num == 0) {
+        return base;
+    }
+    return base + "." + std::to_string(conf.thread_num);
+}
+
+//The file is written next to the target and renamed over it, so there is
+//always a complete checkpoint on disk, even if we are killed while writing
+void Solver::save_checkpoint(const string& fname)
+{
+    const string tmp_fname = fname + ".tmp";
+    {
+        SimpleOutFile f;
+        f.start(tmp_fname);
+        save_checkpoint(f);
+        f.finish();
+    }
+    if (std::rename(tmp_fname.c_str(), fname.c_str()) != 0) {
+        throw std::runtime_error("cannot rename " + tmp_fname + " to " + fname);
+    }
+}
+
+void Solver::save_checkpoint(SimpleOutFile& f) const
+{
+    assert(decisionLevel() == 0);
+    assert(assumptions.empty());
+    assert(!detached_xor_clauses);
+
+    f.put_raw(checkpoint_magic, sizeof(checkpoint_magic));
+    f.put_uint32_t(checkpoint_version);
+    f.put_vector(checkpoint_layout());
+    f.put_uint32_t(conf.thread_num);
+    f.put_uint32_t(occsimplifier != NULL);
+    f.put_uint32_t(nVarsOuter());
+    f.put_uint32_t(get_num_bva_vars());
+    f.put_uint32_t(already_reconfigured);
+    f.put_uint32_t(conf.reconfigure_val);
+    f.put_uint32_t(adjusted_glue_cutoff_if_too_many);
+    f.put_uint32_t(conf.glue_put_lev0_if_below_or_eq);
+
+    //They were not eliminated, they must not be after loading either
+    f.put_uint32_t(conf.sampling_vars != NULL);
+    if (conf.sampling_vars) {
+        f.put_vector(*conf.sampling_vars);
+    }
+
+    Searcher::save_checkpoint(f);
+    f.put_struct(sumSearchStats);
+    f.put_struct(sumPropStats);
+    f.put_struct(solveStats);
+    f.put_uint64_t(last_full_watch_consolidate);
+
+    varReplacer->save_state(f);
+    if (occsimplifier) {
+        occsimplifier->save_state(f);
+    }
+}
+
+//With "any_thread", a checkpoint of another thread can be loaded, see
+//save_snapshot()
+void Solver::load_checkpoint(const string& fname, const bool any_thread)
+{
+    SimpleInFile f;
+    f.start(fname);
+    load_checkpoint(f, fname, any_thread);
+}
+
+//"fname" is only for the error messages
+void Solver::load_checkpoint(SimpleInFile& f, const string& fname, const bool any_thread)
+{
+    if (nVarsOuter() != 0) {
+        checkpoint_error(fname, "the solver already has variables");
+    }
+    const double myTime = cpuTime();
+
+    char magic[sizeof(checkpoint_magic)];
+    f.get_raw(magic, 1, sizeof(magic));
+    if (memcmp(magic, checkpoint_magic, sizeof(magic)) != 0) {
+        checkpoint_error(fname, "not a checkpoint file");
+    }
+    if (f.get_uint32_t() != checkpoint_version) {
+        checkpoint_error(fname, "written by a different version of the solver");
+    }
+    vector<uint32_t> layout;
+    f.get_vector(layout);
+    if (layout != checkpoint_layout()) {
+        checkpoint_error(fname, "written by a differently compiled solver");
+    }
+    const uint32_t thread_num = f.get_uint32_t();
+    if (thread_num != conf.thread_num && !any_thread) {
+        checkpoint_error(fname, "written by thread " + std::to_string(thread_num)
+            + ", not by thread " + std::to_string(conf.thread_num));
+    }
+    if ((bool)f.get_uint32_t() != (occsimplifier != NULL)) {
+        checkpoint_error(fname, "occurrence-based simplification was set differently");
+    }
+    const uint32_t num_outer = f.get_uint32_t();
+    const uint32_t num_bva = f.get_uint32_t();
+    if (num_bva > num_outer) {
+        checkpoint_error(fname, "file is corrupt");
+    }
+    //Another thread's configuration is not taken over
+    const bool reconfigured = f.get_uint32_t();
+    const int reconfigure_val = f.get_uint32_t();
+    if (thread_num == conf.thread_num) {
+        already_reconfigured = reconfigured;
+        conf.reconfigure_val = reconfigure_val;
+        if (already_reconfigured) {
+            reconfigure(conf.reconfigure_val);
+        }
+    }
+    adjusted_glue_cutoff_if_too_many = f.get_uint32_t();
+    conf.glue_put_lev0_if_below_or_eq = f.get_uint32_t();
+
+    //Unless the caller has set its own
+    if (f.get_uint32_t()) {
+        f.get_vector(loaded_sampling_vars);
+        for(const uint32_t var: loaded_sampling_vars) {
+            if (var >= num_outer - num_bva) {
+                checkpoint_error(fname, "file is corrupt");
+            }
+        }
+        if (conf.sampling_vars == NULL) {
+            conf.sampling_vars = &loaded_sampling_vars;
+        }
+    }
+
+    //Creates all the per-variable datastructures, which are then overwritten
+    new_vars(num_outer - num_bva);
+    for(uint32_t i = 0; i < num_bva; i++) {
+        new_var(true);
+    }
+    fresh_solver = false;
+
+    Searcher::load_checkpoint(f);
+    if (thread_num != conf.thread_num) {
+        mtrand.seed(conf.origSeed);
+    }
+    f.get_struct(sumSearchStats);
+    f.get_struct(sumPropStats);
+    f.get_struct(solveStats);
+    last_full_watch_consolidate = f.get_uint64_t();
+
+    varReplacer->load_state(f);
+    if (occsimplifier) {
+        occsimplifier->load_state(f);
+    }
+    save_on_var_memory(minNumVars);
+
+    if (okay()) {
+        ok = propagate<false>().isNULL();
+    }
+    last_checkpoint_time = realTimeSec();
+
+    if (conf.verbosity) {
+        cout << "c [checkpoint] resumed from " << fname
+        << " vars: " << nVars()
+        << " irred cls: " << longIrredCls.size()
+        << " confl: " << sumConflicts
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
+//Called between iterations of the search and when solve() returns without
+//an answer. Write errors don't stop the search.
+void Solver::write_checkpoint()
+{
+    drop_kept_assumps();
+    if (conf.checkpoint_file.empty()
+        || !okay()
+        || !assumptions.empty()
+        || (compHandler && compHandler->get_num_vars_removed() > 0)
+    ) {
+        return;
+    }
+    cancelUntil(0);
+    #ifdef USE_GAUSS
+    if (!fully_undo_xor_detach()) {
+        return;
+    }
+    #endif
+
+    const double myTime = cpuTime();
+    const string fname = checkpoint_fname(conf.checkpoint_file);
+    last_checkpoint_time = realTimeSec();
+    try {
+        save_checkpoint(fname);
+    } catch (std::exception& e) {
+        cout << "c WARNING: could not write checkpoint to '" << fname
+        << "': " << e.what() << endl;
+        return;
+    }
+
+    if (conf.verbosity) {
+        cout << "c [checkpoint] written to " << fname
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
+//Runs the startup simplification unless the problem has been simplified
+//already, even if it is not set to run at startup, and writes the result as
+//a checkpoint. Any thread of a fresh solver can load it, so the same
+//simplified problem can be solved many times without simplifying again
+void Solver::save_snapshot(const string& fname)
+{
+    drop_kept_assumps();
+    if (compHandler && compHandler->get_num_vars_removed() > 0) {
+        throw std::runtime_error(
+            "ERROR: cannot write snapshot: components have been solved separately");
+    }
+    //Solved components would not be part of the file
+    conf.doCompHandler = false;
+
+    fresh_solver = false;
+    if (okay()
+        && nVars() > 0
+        && conf.do_simplify_problem
+        && solveStats.num_simplify == 0
+    ) {
+        outside_assumptions.clear();
+        set_assumptions();
+        check_and_upd_config_parameters();
+        datasync->rebuild_bva_map();
+        check_reconfigure();
+
+        bool backup_sls = conf.doSLS;
+        bool backup_breakid = conf.doBreakid;
+        conf.doSLS = false;
+        conf.doBreakid = false;
+        simplify_problem(!conf.full_simplify_at_startup);
+        conf.doSLS = backup_sls;
+        conf.doBreakid = backup_breakid;
+        unfill_assumptions_set();
+        assumptions.clear();
+    }
+    cancelUntil(0);
+    #ifdef USE_GAUSS
+    if (okay()) {
+        fully_undo_xor_detach();
+    }
+    #endif
+
+    const double myTime = cpuTime();
+    save_checkpoint(fname);
+    if (conf.verbosity) {
+        cout << "c [snapshot] written to " << fname
+        << " vars: " << nVars()
+        << " irred cls: " << longIrredCls.size()
+        << " elimed: " << (occsimplifier ? occsimplifier->get_num_elimed_vars() : 0)
+        << conf.print_times(cpuTime() - myTime)
+        << endl;
+    }
+}
+
+//This solver must be fresh and configured like "other". The state is copied
+//as load_checkpoint() would load it, but directly: the clause arena is copied
+//as one block, so clause offsets in watches and reasons stay valid. "other"
+//is not changed, its kept assumptions and detached XORs are only undone in
+//the copy.
+void Solver::copy_state_from(const Solver* other)
+{
+    assert(nVarsOuter() == 0);
+    if (other->compHandler && other->compHandler->get_num_vars_removed() > 0) {
+        throw std::runtime_error(
+            "ERROR: cannot copy solver: components have been solved separately");
+    }
+
+    already_reconfigured = other->already_reconfigured;
+    adjusted_glue_cutoff_if_too_many = other->adjusted_glue_cutoff_if_too_many;
+
+    //Must not point into the other solver
+    if (conf.sampling_vars == &other->loaded_sampling_vars) {
+        loaded_sampling_vars = other->loaded_sampling_vars;
+        conf.sampling_vars = &loaded_sampling_vars;
+    }
+
+    //Creates all the per-variable datastructures, which are then overwritten
+    new_vars(other->nVarsOuter() - other->get_num_bva_vars());
+    for(uint32_t i = 0; i < other->get_num_bva_vars(); i++) {
+        new_var(true);
+    }
+    fresh_solver = false;
+
+    Searcher::copy_checkpoint_from(*other);
+    sumSearchStats = other->sumSearchStats;
+    sumPropStats = other->sumPropStats;
+    solveStats = other->solveStats;
+    last_full_watch_consolidate = other->last_full_watch_consolidate;
+
+    varReplacer->copy_state_from(*other->varReplacer);
+    if (occsimplifier) {
+        assert(other->occsimplifier);
+        occsimplifier->copy_state_from(*other->occsimplifier);
+    }
+    save_on_var_memory(minNumVars);
+
+    if (okay()) {
+        ok = propagate<false>().isNULL();
+    }
+    #ifdef USE_GAUSS
+    if (okay()) {
+        fully_undo_xor_detach();
+    }
+    #endif
+    last_checkpoint_time = realTimeSec();
+}
+
+lbool Solver::check_checkpoint()
+{
+    if (conf.checkpoint_file.empty()
+        || realTimeSec() - last_checkpoint_time < conf.checkpoint_every
+    ) {
+        return l_Undef;
+    }
+
+    write_checkpoint();
+    return okay() ? l_Undef : l_False;
+}
+
 lbool Solver::load_solution_from_file(const string& fname)
 {
     //At this point, model is set up, we just need to fill the l_Undef in
@@ -3812,6 +4710,7 @@ void Solver::open_file_and_dump_red_clauses(const std::string &fname) const
 
 vector<Xor> Solver::get_recovered_xors(const bool xor_together_xors)
 {
+    drop_kept_assumps();
     vector<Xor> xors_ret;
     if (xor_together_xors && okay()) {
         auto xors = xorclauses;
@@ -4018,6 +4917,7 @@ bool Solver::init_all_matrices()
 
 void Solver::start_getting_small_clauses(const uint32_t max_len, const uint32_t max_glue)
 {
+    drop_kept_assumps();
     if (!ok) {
         std::cerr << "ERROR: the system is in UNSAT state, learnt clauses are meaningless!" <<endl;
         exit(-1);
@@ -4139,9 +5039,26 @@ void Solver::add_empty_cl_to_drat()
     << sumConflicts
     #endif
     << fin;
+    finalize_frat();
     drat->flush();
 }
 
+//FRAT: once the empty clause is in, every clause that is still around
+//is listed. The proof keeps the IDs of the clauses in the solver, the
+//equivalences and the eliminated clauses are kept elsewhere
+void Solver::finalize_frat()
+{
+    if (!drat->must_finalize()) {
+        return;
+    }
+
+    varReplacer->finalize_frat();
+    if (occsimplifier) {
+        occsimplifier->finalize_frat();
+    }
+    drat->finalize_kept();
+}
+
 void Solver::check_assigns_for_assumptions() const
 {
     for (const auto& ass: assumptions) {
@@ -4241,6 +5158,7 @@ vector<ActAndOffset> Solver::get_vsids_scores() const
 bool Solver::implied_by(const std::vector<Lit>& lits,
                                   std::vector<Lit>& out_implied)
 {
+    drop_kept_assumps();
     if (get_num_bva_vars() != 0) {
         cout << "ERROR: get_num_bva_vars(): " << get_num_bva_vars() << endl;
         assert(false && "ERROR: BVA is currently not allowed at implied_by(), please turn it off");
@@ -58,6 +58,7 @@ class CalcDefPolars;
 class SolutionExtender;
 class CompFinder;
 class CompHandler;
+class CompTracker;
 class CardFinder;
 class SubsumeStrengthen;
 class SubsumeImplicit;
@@ -72,6 +73,8 @@ struct SolveStats
     uint32_t num_simplify = 0;
     uint32_t num_simplify_this_solve_call = 0;
     uint32_t num_solve_calls = 0;
+    uint64_t assump_reuse_calls = 0; ///<solve() calls that started from kept assumption levels
+    uint64_t assump_reuse_levels = 0;
 };
 
 class Solver : public Searcher
@@ -92,10 +95,25 @@ class Solver : public Searcher
 
         lbool solve_with_assumptions(const vector<Lit>* _assumptions, bool only_indep_solution);
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = NULL);
+        uint64_t enumerate(
+            const std::function<bool(const vector<lbool>&)>& callback
+            , const vector<uint32_t>* projection
+            , const uint64_t limit
+        );
         void  set_shared_data(SharedData* shared_data);
 
+        //External propagator, vars are outside vars
+        void connect_external_propagator(ExternalPropagator* prop);
+        void disconnect_external_propagator();
+        bool external_propagator_connected() const;
+        void add_observed_var(const uint32_t var);
+        void remove_observed_var(const uint32_t var);
+        void reset_observed_vars();
+
         //drat for SAT problems
         void add_empty_cl_to_drat();
+        void finalize_frat();
+        lbool drat_check_result = l_Undef; ///<Verdict of the proof checker on the last UNSAT
 
         //Querying model
         lbool model_value (const Lit p) const;  ///<Found model value for lit
@@ -127,6 +145,7 @@ class Solver : public Searcher
         static const char* get_compilation_env();
 
         vector<Lit> get_zero_assigned_lits(const bool backnumber = true, bool only_nvars = false) const;
+        vector<uint32_t> get_outside_var_components();
         void     print_stats(const double cpu_time, const double cpu_time_total) const;
         void     print_stats_time(const double cpu_time, const double cpu_time_total) const;
         void     print_clause_stats() const;
@@ -148,6 +167,7 @@ class Solver : public Searcher
         void check_stats(const bool allowFreed = false) const;
         void reset_vsids();
         void enable_comphandler();
+        void drop_kept_assumps(const uint32_t level = 0); ///<Everything that needs level 0 between solve() calls must call this
 
 
         //Checks
@@ -167,6 +187,7 @@ class Solver : public Searcher
         DistillerLongWithImpl* dist_long_with_impl = NULL;
         StrImplWImpl* dist_impl_with_impl = NULL;
         CompHandler*           compHandler = NULL;
+        CompTracker*           compTracker = NULL;
         CardFinder*            card_finder = NULL;
 
         SearchStats sumSearchStats;
@@ -181,12 +202,20 @@ class Solver : public Searcher
         //State load/unload
         void save_state(const string& fname, const lbool status) const;
         lbool load_state(const string& fname);
+        string checkpoint_fname(const string& base) const;
+        void save_checkpoint(const string& fname);
+        void save_checkpoint(SimpleOutFile& f) const;
+        void load_checkpoint(const string& fname, const bool any_thread = false);
+        void load_checkpoint(SimpleInFile& f, const string& fname, const bool any_thread);
+        void write_checkpoint();
+        void save_snapshot(const string& fname);
+        void copy_state_from(const Solver* other);
         template<typename A>
         void parse_v_line(A* in, const size_t lineNum);
         lbool load_solution_from_file(const string& fname);
 
         uint64_t getNumLongClauses() const;
-        bool addClause(const vector<Lit>& ps, const bool red = false);
+        bool addClause(const vector<Lit>& ps, const bool red = false, const uint32_t ID = 0);
         bool add_xor_clause_inter(
             const vector< Lit >& lits
             , bool rhs
@@ -235,6 +264,7 @@ class Solver : public Searcher
             , const uint32_t origSize
             , const Clause* address
         );
+        vector<uint32_t> frat_hints; ///<Hints for the next add_clause_int(), see Drat::set_hints()
         Clause* add_clause_int(
             const vector<Lit>& lits
             , const bool red = false
@@ -249,6 +279,8 @@ class Solver : public Searcher
         template<class T> vector<uint32_t> xor_outer_numbered(const T& cl) const;
         size_t mem_used() const;
         void dump_memory_stats_to_sql();
+        const SolverMetrics* enable_metrics(); ///<Allocates the live metrics on the first call
+        void update_metrics();
         void set_sqlite(string filename);
         //Not Private for testing (maybe could be called from outside)
         bool renumber_variables(bool must_renumber = true);
@@ -305,6 +337,10 @@ class Solver : public Searcher
 
         vector<Lit> add_clause_int_tmp_cl;
         lbool iterate_until_solved();
+        lbool check_checkpoint();
+        double last_checkpoint_time = realTimeSec();
+        vector<uint32_t> loaded_sampling_vars; ///<conf.sampling_vars points here if it came from a checkpoint
+        SolverConf conf_before_extprop; ///<What connect_external_propagator() turned off, restored at disconnect
         uint64_t mem_used_vardata() const;
         void check_reconfigure();
         void reconfigure(int val);
@@ -312,6 +348,8 @@ class Solver : public Searcher
         long calc_num_confl_to_do_this_iter(const size_t iteration_num) const;
 
         vector<Lit> finalCl_tmp;
+        vector<uint32_t> tmp_hints;
+        void set_hints_removed_lits(const vector<Lit>& lits, const size_t final_size);
         bool sort_and_clean_clause(
             vector<Lit>& ps
             , const vector<Lit>& origCl
@@ -348,12 +386,19 @@ class Solver : public Searcher
         }
         vector<Lit> outside_assumptions;
 
+        //Assumption levels kept on the trail between solve() calls
+        vector<Lit> kept_assumps; ///<Outside assumptions of the kept levels, level i+1 is kept_assumps[i]
+        void reuse_kept_assumps();
+        bool assump_usable_on_kept_trail(const Lit lit) const;
+        void cancel_kept_assumps_for_clause(const vector<Lit>& outer_lits);
+
         //Stats printing
         void print_norm_stats(const double cpu_time, const double cpu_time_total) const;
         void print_min_stats(const double cpu_time, const double cpu_time_total) const;
         void print_full_restart_stat(const double cpu_time, const double cpu_time_total) const;
 
         lbool simplify_problem(const bool startup);
+        bool startup_simplify_due() const;
         lbool execute_inprocess_strategy(const bool startup, const string& strategy);
         SolveStats solveStats;
         void check_minimization_effectiveness(lbool status);
@@ -413,7 +458,7 @@ class Solver : public Searcher
         /////////////////////
         // Clauses
         bool addClauseHelper(vector<Lit>& ps);
-        bool addClauseInt(vector<Lit>& ps, const bool red = false);
+        bool addClauseInt(vector<Lit>& ps, const bool red = false, const uint32_t ID = 0);
 
         /////////////////
         // Debug
@@ -519,6 +564,7 @@ inline lbool Solver::simplify_with_assumptions(
     const vector<Lit>* _assumptions
 ) {
     fresh_solver = false;
+    drop_kept_assumps();
     move_to_outside_assumps(_assumptions);
     return simplify_problem_outside();
 }
@@ -74,6 +74,11 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , polar_best_inv_multip_n(9)
         , polar_best_multip_n(1000)
 
+        //Rephasing
+        , do_rephase(1)
+        , rephase_first(1000)
+        , rephase_schedule("best,walk,best,orig,best,walk,best,inv,best,rnd")
+
         //Clause cleaning
         , pred_short_size_mult(0.5)
         , pred_long_size_mult(0.5)
@@ -116,11 +121,19 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , shortTermHistorySize (50)
         , lower_bound_for_blocking_restart(10000)
         , ratio_glue_geom(5)
+        , do_reuse_trail(1)
+        , do_reuse_assumps(0)
         , doAlwaysFMinim(false)
 
         //branch strategy
         , branch_strategy_setup("maple1+maple2+vsids2+maple1+maple2+vsids1")
 
+        //Focused/stable mode switching
+        , do_mode_switch(0)
+        , mode_switch_first(1000)
+        , mode_switch_inc(2.0)
+        , stable_lev2_reduce_mult(2.0)
+
         //Clause minimisation
         , doRecursiveMinim (true)
         , doMinimRedMore(true)
@@ -165,6 +178,10 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , dump_individual_restarts_and_clauses(true)
         , dump_individual_cldata_ratio(0.01)
         , sql_overwrite_file(0)
+        , sql_async(1)
+        , sql_commit_every(100000)
+        , sql_trace(0)
+        , sql_trace_compress(1)
         , lock_for_data_gen_ratio(0.1)
 
         //Var-elim
@@ -358,6 +375,9 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , handlerFromSimpNum (0)
         , compVarLimit      (1ULL*1000ULL*1000ULL)
         , comp_find_time_limitM (500)
+        , comp_threads      (1)
+        , comp_batch_vars   (2000)
+        , comp_cache        (true)
 
         //Misc optimisations
         , doStrSubImplicit (true)
@@ -389,9 +409,17 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , global_multiplier_multiplier_max(3)
         , var_and_mem_out_mult(1.0)
 
-        //Multi-thread, MPI
+        //Multi-thread, distributed
         , sync_every_confl(20000)
         , thread_num(0)
+        , net_share_max_size(8)
+        , net_share_max_glue(2)
+
+        //Checkpointing
+        , checkpoint_every(600)
+
+        //Live metrics
+        , metrics_every(5)
 
         //misc
         , origSeed(0)
@@ -399,6 +427,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , reconfigure_at(2)
         , preprocess(0)
         , simulate_drat(false)
+        , drat_async_bufs(4)
+        , frat_proof(false)
         , saved_state_file("savedstate.dat")
 {
     ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
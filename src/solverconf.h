@@ -65,6 +65,37 @@ enum class PolarityMode {
     , polarmode_weighted
 };
 
+enum class Rephase {
+    orig
+    , inv
+    , best
+    , walk
+    , rnd
+};
+
+inline std::string rephase_type_to_string(const Rephase type)
+{
+    switch(type) {
+        case Rephase::orig:
+            return "orig";
+
+        case Rephase::inv:
+            return "inv";
+
+        case Rephase::best:
+            return "best";
+
+        case Rephase::walk:
+            return "walk";
+
+        case Rephase::rnd:
+            return "rnd";
+    }
+
+    assert(false && "oops, one of the rephase types has no string name");
+    return "ERR: undefined!";
+}
+
 enum class Restart {
     glue
     , geom
@@ -235,6 +266,11 @@ class DLL_PUBLIC SolverConf
         int polar_best_inv_multip_n;
         int polar_best_multip_n;
 
+        //Rephasing of saved polarities
+        int do_rephase;
+        uint32_t rephase_first;
+        string rephase_schedule;
+
         //Clause cleaning
         float pred_short_size_mult;
         float pred_long_size_mult;
@@ -281,11 +317,20 @@ class DLL_PUBLIC SolverConf
         unsigned  shortTermHistorySize; ///< Rolling avg. glue window size
         unsigned lower_bound_for_blocking_restart;
         double   ratio_glue_geom; //higher the number, the more glue will be done. 2 is 2x glue 1x geom
+        int      do_reuse_trail; ///<At restart, keep decision levels that would be re-decided anyway
+        int      do_reuse_assumps; ///<Keep the assumption levels between solve() calls, backtrack to the first differing one
         int doAlwaysFMinim;
 
         //Branch strategy
         string branch_strategy_setup;
 
+        //Switching between focused (VSIDS, glue restarts) and
+        //stable (Maple, luby restarts, stable polarities) search
+        int      do_mode_switch;
+        uint64_t mode_switch_first;
+        double   mode_switch_inc;
+        double   stable_lev2_reduce_mult;
+
         //Clause minimisation
         int doRecursiveMinim;
         int doMinimRedMore;  ///<Perform learnt clause minimisation using watchists' binary and tertiary clauses? ("strong minimization" in PrecoSat)
@@ -326,6 +371,10 @@ class DLL_PUBLIC SolverConf
         bool      dump_individual_restarts_and_clauses;
         double    dump_individual_cldata_ratio;
         int       sql_overwrite_file;
+        int       sql_async;
+        uint64_t  sql_commit_every;
+        int       sql_trace;
+        int       sql_trace_compress;
         double    lock_for_data_gen_ratio;
 
         //Steps
@@ -472,6 +521,9 @@ class DLL_PUBLIC SolverConf
         unsigned  handlerFromSimpNum;
         size_t    compVarLimit;
         unsigned long long  comp_find_time_limitM;
+        unsigned  comp_threads; ///<Threads solving the components
+        unsigned  comp_batch_vars; ///<Components below this size share a sub-solver, up to this many vars
+        int       comp_cache; ///<Reuse the solutions of components found by earlier calls
 
 
         //Misc Optimisations
@@ -505,9 +557,21 @@ class DLL_PUBLIC SolverConf
         double global_multiplier_multiplier_max;
         double var_and_mem_out_mult;
 
-        //Multi-thread, MPI
+        //Multi-thread, distributed
         unsigned long long sync_every_confl;
         unsigned thread_num;
+        std::string net_sync; ///<Hub to share clauses through, HOST:PORT or unix:PATH
+        unsigned net_share_max_size;
+        unsigned net_share_max_glue;
+
+        //Checkpointing
+        std::string checkpoint_file; ///<Empty = no checkpoints. Thread N>0 writes FILE.N
+        double checkpoint_every; ///<Wall-clock seconds between checkpoints
+
+        //Live metrics
+        std::string metrics_listen; ///<Empty = off. Prometheus text over HTTP on HOST:PORT or unix:PATH
+        std::string metrics_file; ///<Empty = off. JSON, rewritten every metrics_every seconds
+        double metrics_every; ///<Wall-clock seconds between two samples
 
         //Misc
         unsigned origSeed;
@@ -515,6 +579,8 @@ class DLL_PUBLIC SolverConf
         unsigned reconfigure_at;
         unsigned preprocess;
         int      simulate_drat;
+        unsigned drat_async_bufs; ///<0 = write DRAT from the solving thread
+        int      frat_proof; ///<Write text FRAT with hints instead of DRAT
         int      conf_needed = true;
         std::string simplified_cnf;
         std::string solution_file;
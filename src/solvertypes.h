@@ -79,6 +79,26 @@ inline std::string restart_type_to_string(const Restart type)
     return "Ooops, undefined!";
 }
 
+enum class SearchMode {
+    focused
+    , stable
+};
+
+inline std::string search_mode_to_string(const SearchMode mode)
+{
+    switch(mode) {
+        case SearchMode::focused:
+            return "focused";
+
+        case SearchMode::stable:
+            return "stable";
+    }
+
+    assert(false && "oops, one of the search modes has no string name");
+
+    return "Ooops, undefined!";
+}
+
 inline std::string branch_type_to_string(const branch type)
 {
     switch(type) {
@@ -33,14 +33,16 @@ THE SOFTWARE.
 #include "constants.h"
 #include "reducedb.h"
 #include "sql_tablestructure.h"
+#include "sqlitewriter.h"
+#include "tracewriter.h"
 #include "varreplacer.h"
 
 #define bind_null_or_double(stmt,bindat,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        writer->bind_null(stmt, bindat); \
     } else { \
-        sqlite3_bind_double(stmt, bindat, stucture.func()); \
+        writer->bind_double(stmt, bindat, stucture.func()); \
     }\
     bindat++; \
 }
@@ -48,9 +50,9 @@ THE SOFTWARE.
 #define bind_null_or_int(stmt,bindat,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        writer->bind_null(stmt, bindat); \
     } else { \
-        sqlite3_bind_int(stmt, bindat, stucture.func()); \
+        writer->bind_int(stmt, bindat, stucture.func()); \
     }\
     bindat++; \
 }
@@ -58,9 +60,9 @@ THE SOFTWARE.
 #define bind_null_or_int64(stmt,bindat,stucture,func) \
 { \
     if (stucture.num_data_elements() == 0) {\
-        sqlite3_bind_null(stmt, bindat); \
+        writer->bind_null(stmt, bindat); \
     } else { \
-        sqlite3_bind_int64(stmt, bindat, stucture.func()); \
+        writer->bind_int64(stmt, bindat, stucture.func()); \
     }\
     bindat++; \
 }
@@ -137,6 +139,9 @@ SQLiteStats::~SQLiteStats()
     if (!setup_ok)
         return;
 
+    //Everything queued must be written before the statements go away
+    delete writer;
+
     //Free all the prepared statements
     del_prepared_stmt(stmtRst);
     del_prepared_stmt(stmtVarRst);
@@ -171,8 +176,13 @@ bool SQLiteStats::setup(const Solver* solver)
         std::exit(-1);
     }
 
-    add_solverrun(solver);
-    addStartupData();
+    if (solver->conf.sql_trace) {
+        writer = new TraceWriter(filename, solver->conf.sql_trace_compress);
+    } else {
+        writer = new SQLiteWriter(
+            db, solver->conf.sql_async, solver->conf.sql_commit_every);
+    }
+
     init("timepassed", &stmtTimePassed);
     init("memused", &stmtMemUsed);
     init("satzilla_features", &stmtFeat);
@@ -188,6 +198,8 @@ bool SQLiteStats::setup(const Solver* solver)
     init("cl_last_in_solver", &stmt_delete_cl);
     init("var_dist", &stmt_var_dist);
     #endif
+    add_solverrun(solver);
+    addStartupData();
 
     return true;
 }
@@ -209,6 +221,21 @@ bool SQLiteStats::connectServer(const Solver* solver)
         exit(-1);
     }
 
+    //The trace is written by TraceWriter. The database is only needed for
+    //the table structure and the prepared statements that stand for tables
+    if (solver->conf.sql_trace) {
+        if (sqlite3_open(":memory:", &db)) {
+            cout << "c Cannot open in-memory sqlite database: "
+            << sqlite3_errmsg(db) << endl;
+            sqlite3_close(db);
+            return false;
+        }
+        if (solver->conf.verbosity) {
+            cout << "c writing binary SQL trace to: " << filename << endl;
+        }
+        return true;
+    }
+
     int rc = sqlite3_open(filename.c_str(), &db);
     if(rc) {
         cout << "c Cannot open sqlite database: " << sqlite3_errmsg(db) << endl;
@@ -222,8 +249,12 @@ bool SQLiteStats::connectServer(const Solver* solver)
         std::exit(-1);
     }
 
-    if (sqlite3_exec(db, "PRAGMA journal_mode = MEMORY", NULL, NULL, NULL)) {
-        cerr << "ERROR: Problem setting pragma journal_mode = MEMORY to SQLite DB" << endl;
+    //With a writer thread, WAL lets large transactions commit without
+    //rewriting the pages twice
+    const char* journal = solver->conf.sql_async ?
+        "PRAGMA journal_mode = WAL" : "PRAGMA journal_mode = MEMORY";
+    if (sqlite3_exec(db, journal, NULL, NULL, NULL)) {
+        cerr << "ERROR: Problem setting '" << journal << "' to SQLite DB" << endl;
         cerr << "c " << sqlite3_errmsg(db) << endl;
         std::exit(-1);
     }
@@ -238,20 +269,12 @@ bool SQLiteStats::connectServer(const Solver* solver)
 
 void SQLiteStats::begin_transaction()
 {
-    if (sqlite3_exec(db, "BEGIN TRANSACTION", NULL, NULL, NULL)) {
-        cerr << "ERROR: Beginning SQLITE transaction" << endl;
-        cerr << "c " << sqlite3_errmsg(db) << endl;
-        std::exit(-1);
-    }
+    writer->begin_transaction();
 }
 
 void SQLiteStats::end_transaction()
 {
-    if (sqlite3_exec(db, "END TRANSACTION", NULL, NULL, NULL)) {
-        cerr << "ERROR: Beginning SQLITE transaction" << endl;
-        cerr << "c " << sqlite3_errmsg(db) << endl;
-        std::exit(-1);
-    }
+    writer->end_transaction();
 }
 
 bool SQLiteStats::add_solverrun(const Solver* solver)
@@ -264,15 +287,7 @@ bool SQLiteStats::add_solverrun(const Solver* solver)
     << ");";
 
     //Inserting element into solverruns to get unique ID
-    const int rc = sqlite3_exec(db, ss.str().c_str(), NULL, NULL, NULL);
-    if (rc) {
-        if (solver->getConf().verbosity >= 6) {
-            cerr << "c ERROR Couldn't insert into table 'solverruns'" << endl;
-            cerr << "c " << sqlite3_errmsg(db) << endl;
-        }
-
-        return false;
-    }
+    writer->exec(ss.str(), "solverRun");
 
     return true;
 }
@@ -286,12 +301,7 @@ void SQLiteStats::add_tag(const std::pair<string, string>& tag)
     << ", '" << tag.second << "'"
     << ");";
 
-    //Inserting element into solverruns to get unique ID
-    if (sqlite3_exec(db, ss.str().c_str(), NULL, NULL, NULL)) {
-        cerr << "SQLite: ERROR Couldn't insert into table 'tags'" << endl;
-        assert(false);
-        std::exit(-1);
-    }
+    writer->exec(ss.str(), "tags");
 }
 
 void SQLiteStats::addStartupData()
@@ -302,12 +312,7 @@ void SQLiteStats::addStartupData()
     << "datetime('now')"
     << ");";
 
-    if (sqlite3_exec(db, ss.str().c_str(), NULL, NULL, NULL)) {
-        cerr << "ERROR Couldn't insert into table 'startup' : "
-        << sqlite3_errmsg(db) << endl;
-
-        std::exit(-1);
-    }
+    writer->exec(ss.str(), "startup");
 }
 
 void SQLiteStats::finishup(const lbool status)
@@ -319,10 +324,7 @@ void SQLiteStats::finishup(const lbool status)
     << "'" << status << "'"
     << ");";
 
-    if (sqlite3_exec(db, ss.str().c_str(), NULL, NULL, NULL)) {
-        cerr << "ERROR Couldn't insert into table 'finishup'" << endl;
-        std::exit(-1);
-    }
+    writer->exec(ss.str(), "finishup");
 }
 
 void SQLiteStats::writeQuestionMarks(
@@ -342,34 +344,6 @@ void SQLiteStats::writeQuestionMarks(
     ss << ")";
 }
 
-void SQLiteStats::run_sqlite_step(sqlite3_stmt* stmt, const char* name)
-{
-    int rc = sqlite3_step(stmt);
-    if (rc != SQLITE_DONE) {
-        cout
-        << "ERROR: while executing '" << name << "' SQLite prepared statement"
-        << endl;
-
-        cout << "Error from sqlite: "
-        << sqlite3_errmsg(db)
-        << endl;
-        cout << "Error code from sqlite: " << rc << endl;
-        std::exit(-1);
-    }
-
-    if (sqlite3_reset(stmt)) {
-        cerr << "Error calling sqlite3_reset on cl_last_in_solver" << endl;
-        std::exit(-1);
-    }
-
-    if (sqlite3_clear_bindings(stmt)) {
-        cerr << "Error calling sqlite3_clear_bindings on '"
-        << name << "'" << endl;
-        std::exit(-1);
-    }
-}
-
-
 void SQLiteStats::init(const char* name, sqlite3_stmt** stmt)
 {
     vector<string> cols = get_columns(name);
@@ -400,6 +374,7 @@ void SQLiteStats::init(const char* name, sqlite3_stmt** stmt)
         << endl;
         std::exit(-1);
     }
+    writer->add_table(name, *stmt, cols);
 }
 
 void SQLiteStats::mem_used(
@@ -410,14 +385,14 @@ void SQLiteStats::mem_used(
 ) {
     int bindAt = 1;
     //Position
-    sqlite3_bind_int64(stmtMemUsed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtMemUsed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtMemUsed, bindAt++, given_time);
+    writer->bind_int64(stmtMemUsed, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmtMemUsed, bindAt++, solver->sumConflicts);
+    writer->bind_double(stmtMemUsed, bindAt++, given_time);
     //memory stats
-    sqlite3_bind_text(stmtMemUsed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_int(stmtMemUsed, bindAt++, mem_used_mb);
+    writer->bind_text(stmtMemUsed, bindAt++, name);
+    writer->bind_int(stmtMemUsed, bindAt++, mem_used_mb);
 
-    run_sqlite_step(stmtMemUsed, "memused");
+    writer->step(stmtMemUsed, "memused");
 }
 
 void SQLiteStats::time_passed(
@@ -429,15 +404,15 @@ void SQLiteStats::time_passed(
 ) {
 
     int bindAt = 1;
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, cpuTime());
-    sqlite3_bind_text(stmtTimePassed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, time_passed);
-    sqlite3_bind_int(stmtTimePassed, bindAt++, time_out);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, percent_time_remain);
-
-    run_sqlite_step(stmtTimePassed, "timepassed");
+    writer->bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
+    writer->bind_double(stmtTimePassed, bindAt++, cpuTime());
+    writer->bind_text(stmtTimePassed, bindAt++, name);
+    writer->bind_double(stmtTimePassed, bindAt++, time_passed);
+    writer->bind_int(stmtTimePassed, bindAt++, time_out);
+    writer->bind_double(stmtTimePassed, bindAt++, percent_time_remain);
+
+    writer->step(stmtTimePassed, "timepassed");
 }
 
 void SQLiteStats::time_passed_min(
@@ -446,15 +421,15 @@ void SQLiteStats::time_passed_min(
     , double time_passed
 ) {
     int bindAt = 1;
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, cpuTime());
-    sqlite3_bind_text(stmtTimePassed, bindAt++, name.c_str(), -1, NULL);
-    sqlite3_bind_double(stmtTimePassed, bindAt++, time_passed);
-    sqlite3_bind_null(stmtTimePassed, bindAt++);
-    sqlite3_bind_null(stmtTimePassed, bindAt++);
-
-    run_sqlite_step(stmtTimePassed, "time_passed_min");
+    writer->bind_int64(stmtTimePassed, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmtTimePassed, bindAt++, solver->sumConflicts);
+    writer->bind_double(stmtTimePassed, bindAt++, cpuTime());
+    writer->bind_text(stmtTimePassed, bindAt++, name);
+    writer->bind_double(stmtTimePassed, bindAt++, time_passed);
+    writer->bind_null(stmtTimePassed, bindAt++);
+    writer->bind_null(stmtTimePassed, bindAt++);
+
+    writer->step(stmtTimePassed, "time_passed_min");
 }
 
 void SQLiteStats::satzilla_features(
@@ -463,89 +438,89 @@ void SQLiteStats::satzilla_features(
     , const SatZillaFeatures& satzilla_feat
 ) {
     int bindAt = 1;
-    sqlite3_bind_int64(stmtFeat, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtFeat, bindAt++, search->sumRestarts());
-    sqlite3_bind_int64(stmtFeat, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int(stmtFeat, bindAt++, solver->latest_satzilla_feature_calc);
+    writer->bind_int64(stmtFeat, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmtFeat, bindAt++, search->sumRestarts());
+    writer->bind_int64(stmtFeat, bindAt++, solver->sumConflicts);
+    writer->bind_int(stmtFeat, bindAt++, solver->latest_satzilla_feature_calc);
 
-    sqlite3_bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numVars);
-    sqlite3_bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numClauses);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.var_cl_ratio);
+    writer->bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numVars);
+    writer->bind_int64(stmtFeat, bindAt++, (uint64_t)satzilla_feat.numClauses);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.var_cl_ratio);
 
     //Clause distribution
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.binary);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.horn_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_spread);
-
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_std);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_spread);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.binary);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn_std);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.horn_spread);
+
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_std);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_var_spread);
+
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_std);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.vcg_cls_spread);
+
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_std);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_var_spread);
+
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_std);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.pnr_cls_spread);
 
     //Conflict clauses
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_size);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_glue);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_num_resolutions);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.learnt_bins_per_confl);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_size);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.confl_size_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_confl_glue);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.confl_glue_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_num_resolutions);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.num_resolutions_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.learnt_bins_per_confl);
 
     //Search
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_trail_depth_delta);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_min);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_max);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth_delta);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.props_per_confl);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.confl_per_restart);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.decisions_per_conflict);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.branch_depth_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_trail_depth_delta);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_min);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.trail_depth_delta_max);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.avg_branch_depth_delta);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.props_per_confl);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.confl_per_restart);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.decisions_per_conflict);
 
     //red stats
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_var);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.glue_distr_var);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.size_distr_var);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.red_cl_distrib.activity_distr_var);
 
     //irred stats
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_var);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_mean);
-    sqlite3_bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_var);
-
-    run_sqlite_step(stmtFeat, "satzilla_features");
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.glue_distr_var);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.size_distr_var);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_mean);
+    writer->bind_double(stmtFeat, bindAt++, satzilla_feat.irred_cl_distrib.activity_distr_var);
+
+    writer->step(stmtFeat, "satzilla_features");
 }
 
 #ifdef STATS_NEEDED
@@ -574,106 +549,106 @@ void SQLiteStats::restart(
     const BinTriStats& binTri = solver->getBinTriStats();
 
     int bindAt = 1;
-    sqlite3_bind_int64(stmt, bindAt++, restartID);
+    writer->bind_int64(stmt, bindAt++, restartID);
     if (clauseID == -1) {
-        sqlite3_bind_null(stmt, bindAt++);
+        writer->bind_null(stmt, bindAt++);
     } else {
-        sqlite3_bind_int64(stmt, bindAt++, clauseID);
+        writer->bind_int64(stmt, bindAt++, clauseID);
     }
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmt, bindAt++, search->sumRestarts());
-    sqlite3_bind_int64(stmt, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int(stmt, bindAt++, searchHist.num_conflicts_this_restart);
-    sqlite3_bind_int(stmt, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_double(stmt, bindAt++, cpuTime());
+    writer->bind_int64(stmt, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmt, bindAt++, search->sumRestarts());
+    writer->bind_int64(stmt, bindAt++, solver->sumConflicts);
+    writer->bind_int(stmt, bindAt++, searchHist.num_conflicts_this_restart);
+    writer->bind_int(stmt, bindAt++, solver->latest_satzilla_feature_calc);
+    writer->bind_double(stmt, bindAt++, cpuTime());
 
 
-    sqlite3_bind_int64(stmt, bindAt++, binTri.irredBins);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_long_irred_cls());
-    sqlite3_bind_int64(stmt, bindAt++, binTri.redBins);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_long_red_cls());
+    writer->bind_int64(stmt, bindAt++, binTri.irredBins);
+    writer->bind_int64(stmt, bindAt++, solver->get_num_long_irred_cls());
+    writer->bind_int64(stmt, bindAt++, binTri.redBins);
+    writer->bind_int64(stmt, bindAt++, solver->get_num_long_red_cls());
 
-    sqlite3_bind_int64(stmt, bindAt++, solver->litStats.irredLits);
-    sqlite3_bind_int64(stmt, bindAt++, solver->litStats.redLits);
+    writer->bind_int64(stmt, bindAt++, solver->litStats.irredLits);
+    writer->bind_int64(stmt, bindAt++, solver->litStats.redLits);
 
     //Conflict stats
     bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.glueHist.getLongtTerm().var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.glueHist.getLongtTerm().var()));
     bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.glueHist.getLongtTerm(),getMax);
 
     bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist, avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.conflSizeHist.var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.conflSizeHist.var()));
     bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist,getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.conflSizeHist,getMax);
 
     bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist, avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.numResolutionsHist.var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.numResolutionsHist.var()));
     bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist,getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.numResolutionsHist,getMax);
 
     //Search stats
     bind_null_or_double(stmt, bindAt,   searchHist.branchDepthHist,avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthHist.var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthHist.var()));
     bind_null_or_double(stmt, bindAt, searchHist.branchDepthHist,getMin);
     bind_null_or_double(stmt, bindAt, searchHist.branchDepthHist,getMax);
 
     bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthDeltaHist.var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.branchDepthDeltaHist.var()));
     bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.branchDepthDeltaHist,getMax);
 
     bind_null_or_double(stmt, bindAt, searchHist.trailDepthHist.getLongtTerm(),avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthHist.getLongtTerm().var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthHist.getLongtTerm().var()));
     bind_null_or_double(stmt, bindAt,   searchHist.trailDepthHist.getLongtTerm(),getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.trailDepthHist.getLongtTerm(),getMax);
 
     bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,avg);
-    sqlite3_bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthDeltaHist.var()));
+    writer->bind_double(stmt, bindAt++, std:: sqrt(searchHist.trailDepthDeltaHist.var()));
     bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,getMin);
     bind_null_or_double(stmt, bindAt,   searchHist.trailDepthDeltaHist,getMax);
 
     //Prop
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propsBinIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propsBinRed);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propsLongIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propsLongRed);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.propsBinIrred);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.propsBinRed);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.propsLongIrred);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.propsLongRed);
 
     //Confl
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.conflStats.conflsBinIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.conflStats.conflsBinRed);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.conflStats.conflsLongIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.conflStats.conflsLongRed);
+    writer->bind_int64(stmt, bindAt++, thisStats.conflStats.conflsBinIrred);
+    writer->bind_int64(stmt, bindAt++, thisStats.conflStats.conflsBinRed);
+    writer->bind_int64(stmt, bindAt++, thisStats.conflStats.conflsLongIrred);
+    writer->bind_int64(stmt, bindAt++, thisStats.conflStats.conflsLongRed);
 
     //Red
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntUnits);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntBins);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.learntLongs);
+    writer->bind_int64(stmt, bindAt++, thisStats.learntUnits);
+    writer->bind_int64(stmt, bindAt++, thisStats.learntBins);
+    writer->bind_int64(stmt, bindAt++, thisStats.learntLongs);
 
     //Resolv stats
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.binIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.binRed);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.longIrred);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.resolvs.longRed);
+    writer->bind_int64(stmt, bindAt++, thisStats.resolvs.binIrred);
+    writer->bind_int64(stmt, bindAt++, thisStats.resolvs.binRed);
+    writer->bind_int64(stmt, bindAt++, thisStats.resolvs.longIrred);
+    writer->bind_int64(stmt, bindAt++, thisStats.resolvs.longRed);
 
 
     //Var stats
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.propagations);
-    sqlite3_bind_int64(stmt, bindAt++, thisStats.decisions);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.propagations);
+    writer->bind_int64(stmt, bindAt++, thisStats.decisions);
 
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varFlipped);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varSetPos);
-    sqlite3_bind_int64(stmt, bindAt++, thisPropStats.varSetNeg);
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_free_vars());
-    sqlite3_bind_int64(stmt, bindAt++, solver->varReplacer->get_num_replaced_vars());
-    sqlite3_bind_int64(stmt, bindAt++, solver->get_num_vars_elimed());
-    sqlite3_bind_int64(stmt, bindAt++, search->getTrailSize());
+    writer->bind_int64(stmt, bindAt++, thisPropStats.varFlipped);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.varSetPos);
+    writer->bind_int64(stmt, bindAt++, thisPropStats.varSetNeg);
+    writer->bind_int64(stmt, bindAt++, solver->get_num_free_vars());
+    writer->bind_int64(stmt, bindAt++, solver->varReplacer->get_num_replaced_vars());
+    writer->bind_int64(stmt, bindAt++, solver->get_num_vars_elimed());
+    writer->bind_int64(stmt, bindAt++, search->getTrailSize());
 
     //strategy
-    sqlite3_bind_int(stmt, bindAt++, branch_type_to_int(solver->branch_strategy));
-    sqlite3_bind_int(stmt, bindAt++, restart_type_to_int(rest_type));
+    writer->bind_int(stmt, bindAt++, branch_type_to_int(solver->branch_strategy));
+    writer->bind_int(stmt, bindAt++, restart_type_to_int(rest_type));
 
-    run_sqlite_step(stmt, rst_dat_type_to_str(type));
+    writer->step(stmt, rst_dat_type_to_str(type));
 }
 
 void SQLiteStats::reduceDB(
@@ -688,38 +663,38 @@ void SQLiteStats::reduceDB(
     assert(cl->stats.dump_no != std::numeric_limits<uint16_t>::max());
 
     int bindAt = 1;
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, solver->sumRestarts());
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_text(stmtReduceDB, bindAt++, cur_restart_type.c_str(), -1, NULL);
-    sqlite3_bind_double(stmtReduceDB, bindAt++, cpuTime());
+    writer->bind_int64(stmtReduceDB, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmtReduceDB, bindAt++, solver->sumRestarts());
+    writer->bind_int64(stmtReduceDB, bindAt++, solver->sumConflicts);
+    writer->bind_int64(stmtReduceDB, bindAt++, solver->latest_satzilla_feature_calc);
+    writer->bind_text(stmtReduceDB, bindAt++, cur_restart_type);
+    writer->bind_double(stmtReduceDB, bindAt++, cpuTime());
 
     //data
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.ID);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.dump_no);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.conflicts_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.propagations_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.sum_propagations_made);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.clause_looked_at);
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, cl->stats.used_for_uip_creation);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.ID);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.dump_no);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.conflicts_made);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.propagations_made);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.sum_propagations_made);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.clause_looked_at);
+    writer->bind_int64(stmtReduceDB, bindAt++, cl->stats.used_for_uip_creation);
 
     int64_t last_touched_diff = solver->sumConflicts-cl->stats.last_touched;
-    sqlite3_bind_int64(stmtReduceDB, bindAt++, last_touched_diff);
-
-    sqlite3_bind_double(stmtReduceDB, bindAt++, (double)cl->stats.activity/(double)solver->get_cla_inc());
-    sqlite3_bind_int(stmtReduceDB, bindAt++, locked);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->used_in_xor());
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.glue);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->size());
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.ttl);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->is_ternary_resolvent);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, act_ranking_top_10);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, act_ranking);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, tot_cls_in_db);
-    sqlite3_bind_int(stmtReduceDB, bindAt++, cl->stats.sum_uip1_used);
-
-    run_sqlite_step(stmtReduceDB, "reduceDB");
+    writer->bind_int64(stmtReduceDB, bindAt++, last_touched_diff);
+
+    writer->bind_double(stmtReduceDB, bindAt++, (double)cl->stats.activity/(double)solver->get_cla_inc());
+    writer->bind_int(stmtReduceDB, bindAt++, locked);
+    writer->bind_int(stmtReduceDB, bindAt++, cl->used_in_xor());
+    writer->bind_int(stmtReduceDB, bindAt++, cl->stats.glue);
+    writer->bind_int(stmtReduceDB, bindAt++, cl->size());
+    writer->bind_int(stmtReduceDB, bindAt++, cl->stats.ttl);
+    writer->bind_int(stmtReduceDB, bindAt++, cl->is_ternary_resolvent);
+    writer->bind_int(stmtReduceDB, bindAt++, act_ranking_top_10);
+    writer->bind_int(stmtReduceDB, bindAt++, act_ranking);
+    writer->bind_int(stmtReduceDB, bindAt++, tot_cls_in_db);
+    writer->bind_int(stmtReduceDB, bindAt++, cl->stats.sum_uip1_used);
+
+    writer->step(stmtReduceDB, "reduceDB");
 }
 
 void SQLiteStats::dump_clause_stats(
@@ -741,38 +716,38 @@ void SQLiteStats::dump_clause_stats(
     uint32_t num_overlap_literals = antec_data.sum_size()-(antec_data.num()-1)-size;
 
     int bindAt = 1;
-    sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->get_solve_stats().num_simplify);
-    sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts());
+    writer->bind_int64(stmt_clause_stats, bindAt++, solver->get_solve_stats().num_simplify);
+    writer->bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts());
     if (solver->sumRestarts() == 0) {
-        sqlite3_bind_int64(stmt_clause_stats, bindAt++, 0);
+        writer->bind_int64(stmt_clause_stats, bindAt++, 0);
     } else {
-        sqlite3_bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts()-1);
+        writer->bind_int64(stmt_clause_stats, bindAt++, solver->sumRestarts()-1);
     }
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, solver->latest_satzilla_feature_calc);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, clid);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, restartID);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, orig_glue);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, glue_before_minim);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, size);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, conflicts_this_restart);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, num_overlap_literals);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.num());
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.sum_size());
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, is_decision);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, backtrack_level);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, decision_level);
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(1));
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(2));
-    sqlite3_bind_int64 (stmt_clause_stats, bindAt++, trail_depth);
-    sqlite3_bind_text  (stmt_clause_stats, bindAt++,  restart_type.c_str(), -1, NULL);
-
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.binIrred);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.binRed);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.longIrred);
-    sqlite3_bind_int   (stmt_clause_stats, bindAt++, antec_data.longRed);
+    writer->bind_int64 (stmt_clause_stats, bindAt++, solver->sumConflicts);
+    writer->bind_int   (stmt_clause_stats, bindAt++, solver->latest_satzilla_feature_calc);
+    writer->bind_int64 (stmt_clause_stats, bindAt++, clid);
+    writer->bind_int   (stmt_clause_stats, bindAt++, restartID);
+
+    writer->bind_int   (stmt_clause_stats, bindAt++, orig_glue);
+    writer->bind_int   (stmt_clause_stats, bindAt++, glue_before_minim);
+    writer->bind_int   (stmt_clause_stats, bindAt++, size);
+    writer->bind_int64 (stmt_clause_stats, bindAt++, conflicts_this_restart);
+    writer->bind_int   (stmt_clause_stats, bindAt++, num_overlap_literals);
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.num());
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.sum_size());
+    writer->bind_int   (stmt_clause_stats, bindAt++, is_decision);
+
+    writer->bind_int   (stmt_clause_stats, bindAt++, backtrack_level);
+    writer->bind_int64 (stmt_clause_stats, bindAt++, decision_level);
+    writer->bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(1));
+    writer->bind_int64 (stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.prev(2));
+    writer->bind_int64 (stmt_clause_stats, bindAt++, trail_depth);
+    writer->bind_text(stmt_clause_stats, bindAt++, restart_type);
+
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.binIrred);
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.binRed);
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.longIrred);
+    writer->bind_int   (stmt_clause_stats, bindAt++, antec_data.longRed);
 
     bind_null_or_double(stmt_clause_stats, bindAt, antec_data.glue_long_reds,avg);
     bind_null_or_double(stmt_clause_stats, bindAt, antec_data.glue_long_reds,avg);
@@ -795,17 +770,17 @@ void SQLiteStats::dump_clause_stats(
     bind_null_or_double(stmt_clause_stats, bindAt, hist.antec_data_sum_sizeHistLT,avg);
     bind_null_or_double(stmt_clause_stats, bindAt, hist.overlapHistLT,avg);
 
-    sqlite3_bind_double(stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.avg_nocheck());
-    sqlite3_bind_double(stmt_clause_stats, bindAt++, hist.trailDepthHist.avg_nocheck());
-    sqlite3_bind_double(stmt_clause_stats, bindAt++, hist.trailDepthHistLonger.avg_nocheck());
+    writer->bind_double(stmt_clause_stats, bindAt++, hist.branchDepthHistQueue.avg_nocheck());
+    writer->bind_double(stmt_clause_stats, bindAt++, hist.trailDepthHist.avg_nocheck());
+    writer->bind_double(stmt_clause_stats, bindAt++, hist.trailDepthHistLonger.avg_nocheck());
     bind_null_or_double(stmt_clause_stats, bindAt,   hist.numResolutionsHist,avg);
     bind_null_or_double(stmt_clause_stats, bindAt,   hist.conflSizeHist,avg);
     bind_null_or_double(stmt_clause_stats, bindAt,   hist.trailDepthDeltaHist,avg);
-    sqlite3_bind_double(stmt_clause_stats, bindAt++, hist.backtrackLevelHist.avg_nocheck());
-    sqlite3_bind_double(stmt_clause_stats, bindAt++, hist.glueHist.avg_nocheck());
+    writer->bind_double(stmt_clause_stats, bindAt++, hist.backtrackLevelHist.avg_nocheck());
+    writer->bind_double(stmt_clause_stats, bindAt++, hist.glueHist.avg_nocheck());
     bind_null_or_double(stmt_clause_stats, bindAt,   hist.glueHist.getLongtTerm(),avg);
 
-    run_sqlite_step(stmt_clause_stats, "dump_clause_stats");
+    writer->step(stmt_clause_stats, "dump_clause_stats");
 }
 
 #ifdef STATS_NEEDED_BRANCH
@@ -816,26 +791,26 @@ void SQLiteStats::var_data_fintime(
     , const double rel_activity
 ) {
     int bindAt = 1;
-    sqlite3_bind_int   (stmt_var_data_fintime, bindAt++, var);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.sumConflicts_at_picktime);
-
-    sqlite3_bind_double (stmt_var_data_fintime, bindAt++, rel_activity);
-
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_antecedents);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_glue);
-
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisions);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumPropagations);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedents);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedentsLits);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflictClauseLits);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisionBasedCl);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClLBD);
-    sqlite3_bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClSize);
-
-    run_sqlite_step(stmt_var_data_fintime, "var_data_fintime");
+    writer->bind_int   (stmt_var_data_fintime, bindAt++, var);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, vardata.sumConflicts_at_picktime);
+
+    writer->bind_double (stmt_var_data_fintime, bindAt++, rel_activity);
+
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_antecedents);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, vardata.inside_conflict_clause_glue);
+
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisions);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflicts);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumPropagations);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedents);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumAntecedentsLits);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumConflictClauseLits);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumDecisionBasedCl);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClLBD);
+    writer->bind_int64 (stmt_var_data_fintime, bindAt++, solver->sumClSize);
+
+    writer->step(stmt_var_data_fintime, "var_data_fintime");
 }
 
 void SQLiteStats::var_data_picktime(
@@ -845,54 +820,54 @@ void SQLiteStats::var_data_picktime(
     , const double rel_activity
 ) {
     int bindAt = 1;
-    sqlite3_bind_int   (stmt_var_data_picktime, bindAt++, var);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.level);
-    sqlite3_bind_double(stmt_var_data_picktime, bindAt++, rel_activity);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->latest_vardist_feature_calc);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue_during);
-
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided_pos);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated_pos);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_seen_in_1uip);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_decided_on);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_propagated);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_canceled);
-
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisions);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumPropagations);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedents);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedentsLits);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflictClauseLits);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisionBasedCl);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClLBD);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClSize);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflicts_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisions_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumPropagations_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedents_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedentsLits_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflictClauseLits_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisionBasedCl_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClLBD_below_during);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClSize_below_during);
-
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_flipped);
-
-    run_sqlite_step(stmt_var_data_picktime, "var_data_picktime");
+    writer->bind_int   (stmt_var_data_picktime, bindAt++, var);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.level);
+    writer->bind_double(stmt_var_data_picktime, bindAt++, rel_activity);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->latest_vardist_feature_calc);
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue);
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_antecedents_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.inside_conflict_clause_glue_during);
+
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_decided_pos);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.num_propagated_pos);
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_seen_in_1uip);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_decided_on);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_propagated);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_canceled);
+
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisions);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumPropagations);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedents);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumAntecedentsLits);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflictClauseLits);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumDecisionBasedCl);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClLBD);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumClSize);
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflicts_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisions_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumPropagations_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedents_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumAntecedentsLits_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumConflictClauseLits_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumDecisionBasedCl_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClLBD_below_during);
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, vardata.sumClSize_below_during);
+
+    writer->bind_int64 (stmt_var_data_picktime, bindAt++, solver->sumConflicts-vardata.last_flipped);
+
+    writer->step(stmt_var_data_picktime, "var_data_picktime");
 }
 
 void SQLiteStats::var_dist(
@@ -901,39 +876,39 @@ void SQLiteStats::var_dist(
     , const Solver* solver
 ) {
     int bindAt = 1;
-    sqlite3_bind_int(stmt_var_dist, bindAt++, var);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->latest_vardist_feature_calc);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->sumConflicts);
+    writer->bind_int(stmt_var_dist, bindAt++, var);
+    writer->bind_int64(stmt_var_dist, bindAt++, solver->latest_vardist_feature_calc);
+    writer->bind_int64(stmt_var_dist, bindAt++, solver->sumConflicts);
 
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->longIrredCls.size());
+    writer->bind_int64(stmt_var_dist, bindAt++, solver->longIrredCls.size());
     uint32_t num = 0;
     for(auto& x: solver->longRedCls) {
         num+=x.size();
     }
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, num);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->binTri.irredBins);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, solver->binTri.redBins);
-
-
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_bin_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_long_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.satisfies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.falsifies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_bin_it_appears_in);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_long_cls_it_appears_in);
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.red.sum_var_act_of_cls);
-
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_bin_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_long_clause);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.satisfies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.falsifies_cl);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_bin_it_appears_in);
-    sqlite3_bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_long_cls_it_appears_in);
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.irred.sum_var_act_of_cls);
-
-    sqlite3_bind_double(stmt_var_dist, bindAt++, data.tot_act_long_red_cls);
-
-    run_sqlite_step(stmt_var_dist, "var_dist");
+    writer->bind_int64(stmt_var_dist, bindAt++, num);
+    writer->bind_int64(stmt_var_dist, bindAt++, solver->binTri.irredBins);
+    writer->bind_int64(stmt_var_dist, bindAt++, solver->binTri.redBins);
+
+
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_bin_clause);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.num_times_in_long_clause);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.satisfies_cl);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.falsifies_cl);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_bin_it_appears_in);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.red.tot_num_lit_of_long_cls_it_appears_in);
+    writer->bind_double(stmt_var_dist, bindAt++, data.red.sum_var_act_of_cls);
+
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_bin_clause);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.num_times_in_long_clause);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.satisfies_cl);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.falsifies_cl);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_bin_it_appears_in);
+    writer->bind_int64(stmt_var_dist, bindAt++, data.irred.tot_num_lit_of_long_cls_it_appears_in);
+    writer->bind_double(stmt_var_dist, bindAt++, data.irred.sum_var_act_of_cls);
+
+    writer->bind_double(stmt_var_dist, bindAt++, data.tot_act_long_red_cls);
+
+    writer->step(stmt_var_dist, "var_dist");
 }
 
 void SQLiteStats::dec_var_clid(
@@ -944,11 +919,11 @@ void SQLiteStats::dec_var_clid(
     assert(clid != 0);
 
     int bindAt = 1;
-    sqlite3_bind_int(stmt_dec_var_clid, bindAt++, var);
-    sqlite3_bind_int64(stmt_dec_var_clid, bindAt++, sumConflicts_at_picktime);
-    sqlite3_bind_int64(stmt_dec_var_clid, bindAt++, clid);
+    writer->bind_int(stmt_dec_var_clid, bindAt++, var);
+    writer->bind_int64(stmt_dec_var_clid, bindAt++, sumConflicts_at_picktime);
+    writer->bind_int64(stmt_dec_var_clid, bindAt++, clid);
 
-    run_sqlite_step(stmt_dec_var_clid, "dec_var_clid");
+    writer->step(stmt_dec_var_clid, "dec_var_clid");
 }
 #endif
 
@@ -959,10 +934,10 @@ void SQLiteStats::cl_last_in_solver(
     assert(clid != 0);
 
     int bindAt = 1;
-    sqlite3_bind_int64(stmt_delete_cl, bindAt++, solver->sumConflicts);
-    sqlite3_bind_int64(stmt_delete_cl, bindAt++, clid);
+    writer->bind_int64(stmt_delete_cl, bindAt++, solver->sumConflicts);
+    writer->bind_int64(stmt_delete_cl, bindAt++, clid);
 
-    run_sqlite_step(stmt_delete_cl, "cl_last_in_solver");
+    writer->step(stmt_delete_cl, "cl_last_in_solver");
 }
 
 #endif
@@ -26,6 +26,8 @@ THE SOFTWARE.
 
 namespace CMSat {
 
+class RowWriter;
+
 class SQLiteStats: public SQLStats
 {
 public:
@@ -156,7 +158,6 @@ private:
     void init_var_data_picktime_STMT();
     void init_var_data_fintime_STMT();
     void init_dec_var_clid_STMT();
-    void run_sqlite_step(sqlite3_stmt* stmt, const char* name);
 
     void writeQuestionMarks(size_t num, std::stringstream& ss);
     void initReduceDBSTMT();
@@ -176,6 +177,7 @@ private:
     sqlite3_stmt *stmt_var_dist = NULL;
 
     sqlite3 *db = NULL;
+    RowWriter* writer = NULL;
     bool setup_ok = false;
     const string filename;
 };
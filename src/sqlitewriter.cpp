@@ -0,0 +1,322 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "sqlitewriter.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CMSat;
+
+//Without rows coming in, what has been written is committed after this long,
+//so that little is lost if the process is killed
+static const double idle_commit_secs = 2.0;
+
+SQLiteWriter::SQLiteWriter(sqlite3* _db, bool _async, uint64_t _commit_every) :
+    db(_db)
+    , async(_async)
+    , commit_every(_commit_every)
+    , head(0)
+    , tail(0)
+    , stop(false)
+{
+    if (async) {
+        ring.resize(ring_size);
+        writer = std::thread(&SQLiteWriter::writer_loop, this);
+    }
+}
+
+SQLiteWriter::~SQLiteWriter()
+{
+    finish();
+}
+
+void SQLiteWriter::finish()
+{
+    if (!writer.joinable()) {
+        return;
+    }
+    stop.store(true, std::memory_order_release);
+    writer.join();
+}
+
+SQLiteWriter::Cell& SQLiteWriter::add_cell(
+    CellType type
+    , const void* stmt
+    , int pos
+) {
+    if (row.empty()) {
+        Cell h;
+        h.type = CellType::row;
+        h.p = stmt;
+        row.push_back(h);
+    }
+    assert(row[0].p == stmt);
+    assert(pos >= 0 && pos <= 0xffff);
+
+    Cell c;
+    c.type = type;
+    c.pos = pos;
+    c.i = 0;
+    row.push_back(c);
+    return row.back();
+}
+
+void SQLiteWriter::add_text(const char* txt, size_t len)
+{
+    row.back().len = len;
+    const size_t at = row.size();
+    row.resize(at + (len + sizeof(Cell) - 1)/sizeof(Cell));
+    if (len > 0) {
+        memcpy(row.data() + at, txt, len);
+    }
+}
+
+void SQLiteWriter::bind_int(sqlite3_stmt* stmt, int pos, int val)
+{
+    add_cell(CellType::int64, stmt, pos).i = val;
+}
+
+void SQLiteWriter::bind_int64(sqlite3_stmt* stmt, int pos, int64_t val)
+{
+    add_cell(CellType::int64, stmt, pos).i = val;
+}
+
+void SQLiteWriter::bind_double(sqlite3_stmt* stmt, int pos, double val)
+{
+    add_cell(CellType::dbl, stmt, pos).d = val;
+}
+
+void SQLiteWriter::bind_null(sqlite3_stmt* stmt, int pos)
+{
+    add_cell(CellType::null, stmt, pos);
+}
+
+void SQLiteWriter::bind_text(sqlite3_stmt* stmt, int pos, const string& val)
+{
+    add_cell(CellType::text, stmt, pos);
+    add_text(val.data(), val.size());
+}
+
+void SQLiteWriter::step(sqlite3_stmt* stmt, const char* name)
+{
+    if (row.empty()) {
+        Cell h;
+        h.type = CellType::row;
+        h.p = stmt;
+        row.push_back(h);
+    }
+    end_row(name);
+}
+
+void SQLiteWriter::exec(const string& sql, const char* name)
+{
+    assert(row.empty());
+    Cell h;
+    h.type = CellType::exec;
+    h.p = NULL;
+    row.push_back(h);
+    add_cell(CellType::text, NULL, 0);
+    add_text(sql.data(), sql.size());
+    end_row(name);
+}
+
+void SQLiteWriter::end_row(const char* name)
+{
+    Cell n;
+    n.type = CellType::name;
+    n.p = name;
+    row.push_back(n);
+    row[0].len = row.size()-1;
+
+    if (!async) {
+        run_row(row.data());
+        row.clear();
+        return;
+    }
+
+    assert(row.size() <= ring_size);
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    //The writer is behind. Waiting is better than losing data
+    while (h + row.size() - tail.load(std::memory_order_acquire) > ring_size) {
+        std::this_thread::yield();
+    }
+    for(size_t i = 0; i < row.size(); i++) {
+        ring[(h + i) & (ring_size-1)] = row[i];
+    }
+    head.store(h + row.size(), std::memory_order_release);
+    row.clear();
+}
+
+void SQLiteWriter::begin_transaction()
+{
+    if (!async) {
+        run_exec("BEGIN TRANSACTION", "begin transaction");
+    }
+}
+
+void SQLiteWriter::end_transaction()
+{
+    if (!async) {
+        run_exec("END TRANSACTION", "end transaction");
+    }
+}
+
+size_t SQLiteWriter::run_row(const Cell* cells)
+{
+    const Cell& h = cells[0];
+    const size_t num = h.len;
+    const char* name = (const char*)cells[num].p;
+    assert(cells[num].type == CellType::name);
+    sqlite3_stmt* stmt = (sqlite3_stmt*)h.p;
+
+    for(size_t i = 1; i < num; i++) {
+        const Cell& c = cells[i];
+        switch(c.type) {
+            case CellType::int64:
+                sqlite3_bind_int64(stmt, c.pos, c.i);
+                break;
+            case CellType::dbl:
+                sqlite3_bind_double(stmt, c.pos, c.d);
+                break;
+            case CellType::null:
+                sqlite3_bind_null(stmt, c.pos);
+                break;
+            case CellType::text: {
+                text_tmp.assign((const char*)(cells + i + 1), c.len);
+                i += (c.len + sizeof(Cell) - 1)/sizeof(Cell);
+                if (h.type == CellType::row) {
+                    sqlite3_bind_text(
+                        stmt, c.pos, text_tmp.c_str(), -1, SQLITE_TRANSIENT);
+                }
+                break;
+            }
+            default:
+                assert(false);
+                break;
+        }
+    }
+
+    if (h.type == CellType::exec) {
+        run_exec(text_tmp.c_str(), name);
+    } else {
+        run_stmt(stmt, name);
+    }
+    return num+1;
+}
+
+void SQLiteWriter::run_stmt(sqlite3_stmt* stmt, const char* name)
+{
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        cout
+        << "ERROR: while executing '" << name << "' SQLite prepared statement"
+        << endl;
+
+        cout << "Error from sqlite: "
+        << sqlite3_errmsg(db)
+        << endl;
+        cout << "Error code from sqlite: " << rc << endl;
+        std::exit(-1);
+    }
+
+    if (sqlite3_reset(stmt)) {
+        cerr << "Error calling sqlite3_reset on '" << name << "'" << endl;
+        std::exit(-1);
+    }
+
+    if (sqlite3_clear_bindings(stmt)) {
+        cerr << "Error calling sqlite3_clear_bindings on '"
+        << name << "'" << endl;
+        std::exit(-1);
+    }
+}
+
+void SQLiteWriter::run_exec(const char* sql, const char* name)
+{
+    if (sqlite3_exec(db, sql, NULL, NULL, NULL)) {
+        cerr << "ERROR: SQLite failed at '" << name << "' : "
+        << sqlite3_errmsg(db) << endl;
+        std::exit(-1);
+    }
+}
+
+void SQLiteWriter::commit()
+{
+    if (in_transaction) {
+        run_exec("END TRANSACTION", "end transaction");
+        in_transaction = false;
+        rows_in_transaction = 0;
+    }
+}
+
+void SQLiteWriter::writer_loop()
+{
+    auto last_commit = std::chrono::steady_clock::now();
+    while(true) {
+        //Read stop first: if it was set, everything queued before is visible
+        const bool stopping = stop.load(std::memory_order_acquire);
+        const uint64_t h = head.load(std::memory_order_acquire);
+        uint64_t t = tail.load(std::memory_order_relaxed);
+
+        if (t == h) {
+            const double idle = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - last_commit).count();
+            if (stopping || idle > idle_commit_secs) {
+                commit();
+                last_commit = std::chrono::steady_clock::now();
+            }
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        while(t != h) {
+            const size_t num = ring[t & (ring_size-1)].len + 1;
+            staging.resize(num);
+            for(size_t i = 0; i < num; i++) {
+                staging[i] = ring[(t + i) & (ring_size-1)];
+            }
+            t += num;
+            tail.store(t, std::memory_order_release);
+
+            if (!in_transaction) {
+                run_exec("BEGIN TRANSACTION", "begin transaction");
+                in_transaction = true;
+            }
+            run_row(staging.data());
+            rows_in_transaction++;
+            if (rows_in_transaction >= commit_every) {
+                commit();
+                last_commit = std::chrono::steady_clock::now();
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __SQLITEWRITER_H__
+#define __SQLITEWRITER_H__
+
+#include "rowwriter.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace CMSat {
+
+/**
+@brief Executes the prepared INSERTs of SQLiteStats, possibly on a thread of
+its own
+
+The search thread only records what it would have bound to a prepared
+statement, as a row of fixed-size cells. In async mode the row is put into a
+single-producer single-consumer ring, and a background thread binds, steps
+and commits the rows, many thousands of them per transaction. Otherwise the
+row is executed right away, as before.
+
+A row is a header cell (statement, number of cells that follow), one cell
+per bound value, then a cell with the statement's name for error messages.
+Text is a cell with its length, followed by the characters in as many cells as
+needed. The producer only publishes a row once it is complete, so the writer
+never sees half of one.
+*/
+class SQLiteWriter: public RowWriter
+{
+public:
+    SQLiteWriter(sqlite3* db, bool async, uint64_t commit_every);
+    ~SQLiteWriter() override;
+    SQLiteWriter(const SQLiteWriter&) = delete;
+    SQLiteWriter& operator=(const SQLiteWriter&) = delete;
+
+    void bind_int(sqlite3_stmt* stmt, int pos, int val) override;
+    void bind_int64(sqlite3_stmt* stmt, int pos, int64_t val) override;
+    void bind_double(sqlite3_stmt* stmt, int pos, double val) override;
+    void bind_null(sqlite3_stmt* stmt, int pos) override;
+    void bind_text(sqlite3_stmt* stmt, int pos, const string& val) override;
+    void step(sqlite3_stmt* stmt, const char* name) override;
+    void exec(const string& sql, const char* name) override;
+
+    ///Only have an effect in synchronous mode. The writer thread manages its
+    ///own transactions
+    void begin_transaction() override;
+    void end_transaction() override;
+
+    ///Waits until everything queued is written and committed, then stops the
+    ///writer thread
+    void finish() override;
+
+    bool is_async() const
+    {
+        return async;
+    }
+
+private:
+    enum class CellType : uint8_t {
+        row = 1, exec = 2, name = 3, int64 = 4, dbl = 5, null = 6, text = 7
+    };
+
+    struct Cell
+    {
+        CellType type;
+        uint8_t pad = 0;
+        uint16_t pos = 0;
+        uint32_t len = 0;
+        union {
+            int64_t i;
+            double d;
+            const void* p;
+        };
+    };
+    static_assert(sizeof(Cell) == 16, "Cells must be fixed-size 16 bytes");
+
+    Cell& add_cell(CellType type, const void* stmt, int pos);
+    void add_text(const char* txt, size_t len);
+    void end_row(const char* name);
+
+    //Run by the writer, or by the search thread in synchronous mode
+    size_t run_row(const Cell* cells);
+    void run_stmt(sqlite3_stmt* stmt, const char* name);
+    void run_exec(const char* sql, const char* name);
+    void commit();
+    void writer_loop();
+
+    sqlite3* db;
+    const bool async;
+    const uint64_t commit_every;
+
+    //Row under construction, and a row taken out of the ring
+    vector<Cell> row;
+    vector<Cell> staging;
+
+    //Single-producer single-consumer ring. head is only written by the search
+    //thread, tail only by the writer
+    static const size_t ring_size = 1U << 16;
+    vector<Cell> ring;
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+    std::atomic<bool> stop;
+    std::thread writer;
+
+    //Only touched by the writer
+    bool in_transaction = false;
+    uint64_t rows_in_transaction = 0;
+    string text_tmp;
+};
+
+}
+
+#endif //__SQLITEWRITER_H__
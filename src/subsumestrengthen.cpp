@@ -206,7 +206,7 @@ SubsumeStrengthen::Sub1Ret SubsumeStrengthen::strengthen_subsume_and_unlink_and_
                 continue;
             }
             #endif
-            remove_literal(offset2, subsLits[j]);
+            remove_literal(offset2, subsLits[j], solver->drat->ID_of(cl));
 
             ret.str++;
             if (!solver->ok)
@@ -551,8 +551,11 @@ bool SubsumeStrengthen::handle_added_long_cl(
     return solver->okay();
 }
 
-void SubsumeStrengthen::remove_literal(ClOffset offset, const Lit toRemoveLit)
-{
+void SubsumeStrengthen::remove_literal(
+    ClOffset offset
+    , const Lit toRemoveLit
+    , const uint32_t str_ID
+) {
     Clause& cl = *solver->cl_alloc.ptr(offset);
     #ifdef VERBOSE_DEBUG
     cout << "-> Strenghtening clause :" << cl;
@@ -562,6 +565,13 @@ void SubsumeStrengthen::remove_literal(ClOffset offset, const Lit toRemoveLit)
     *simplifier->limit_to_decrease -= 5;
 
     (*solver->drat) << deldelay << cl << fin;
+    if (solver->drat->hints_needed()) {
+        //The strengthening clause falsifies toRemoveLit, the old one conflicts
+        frat_hints.clear();
+        frat_hints.push_back(str_ID);
+        frat_hints.push_back(solver->drat->ID_of(cl));
+        solver->drat->set_hints(frat_hints);
+    }
     cl.strengthen(toRemoveLit);
     simplifier->added_cl_to_var.touch(toRemoveLit.var());
     cl.recalc_abst_if_needed();
@@ -762,6 +772,7 @@ template<class T> void SubsumeStrengthen::find_subsumed(
                 //We cannot remove ourselves
                 if (numBinFound > 1) {
                     removeWBin(solver->watches, it->lit2(), ps[smallest], it->red());
+                    (*solver->drat) << del << ps[smallest] << it->lit2() << fin;
                     solver->binTri.irredBins--;
                     continue;
                 }
@@ -918,7 +929,7 @@ SubsumeStrengthen::Sub1Ret SubsumeStrengthen::backw_sub_str_long_with_implicit(
                 continue;
             }
             #endif
-            remove_literal(offset2, subsLits[j]);
+            remove_literal(offset2, subsLits[j], solver->drat->bin_ID(lits[0], lits[1]));
 
             ret.str++;
             if (!solver->ok)
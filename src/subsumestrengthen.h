@@ -121,7 +121,7 @@ private:
     );
 
     void randomise_clauses_order();
-    void remove_literal(ClOffset c, const Lit toRemoveLit);
+    void remove_literal(ClOffset c, const Lit toRemoveLit, const uint32_t str_ID);
 
     template<class T>
     size_t find_smallest_watchlist_for_clause(const T& ps) const;
@@ -155,6 +155,7 @@ private:
     vector<ClOffset> subs;
     vector<Lit> subsLits;
     vector<Lit> tmpLits;
+    vector<uint32_t> frat_hints;
     size_t tried_bin_tri = 0;
     uint64_t subsumedBin = 0;
     uint64_t strBin = 0;
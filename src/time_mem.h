@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <time.h>
 
 #include <ios>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -74,6 +75,14 @@ static inline double cpuTimeTotal(void)
 
 #endif
 
+//Wall-clock time, e.g. for doing something every N seconds irrespective of
+//how many threads are running
+static inline double realTimeSec(void)
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
 #if defined(__linux__)
 // process_mem_usage(double &, double &) - takes two doubles by reference,
 // attempts to read the system-dependent data for a process' virtual memory
@@ -0,0 +1,263 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "tracewriter.h"
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <cerrno>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using namespace CMSat;
+
+TraceWriter::TraceWriter(const string& _fname, bool _compress) :
+    fname(_fname)
+    , compress(_compress)
+{
+    #ifndef USE_ZLIB
+    if (compress) {
+        cout << "c WARNING: zlib was not compiled in, the trace will not be compressed"
+        << endl;
+        compress = false;
+    }
+    #endif
+
+    out = fopen(fname.c_str(), "wb");
+    if (out == NULL) {
+        cerr << "ERROR: cannot open trace file '" << fname << "' for writing: "
+        << strerror(errno) << endl;
+        std::exit(-1);
+    }
+    setvbuf(out, NULL, _IOFBF, 1U << 20);
+
+    put_bytes(trace_magic, sizeof(trace_magic));
+    put_u32(trace_version);
+    put_u32(compress ? trace_flag_zlib : 0);
+}
+
+TraceWriter::~TraceWriter()
+{
+    finish();
+}
+
+void TraceWriter::put_u8(uint8_t v)
+{
+    put_bytes(&v, 1);
+}
+
+void TraceWriter::put_u32(uint32_t v)
+{
+    uint8_t b[4];
+    for(uint32_t i = 0; i < 4; i++) {
+        b[i] = (v >> (8*i)) & 0xff;
+    }
+    put_bytes(b, 4);
+}
+
+void TraceWriter::put_str(const char* s, size_t len)
+{
+    put_u32(len);
+    put_bytes(s, len);
+}
+
+void TraceWriter::put_bytes(const void* data, size_t len)
+{
+    if (len > 0) {
+        fwrite(data, 1, len, out);
+    }
+}
+
+void TraceWriter::add_table(
+    const char* name
+    , sqlite3_stmt* stmt
+    , const vector<string>& cols
+) {
+    assert(tables.find(stmt) == tables.end());
+    Table& t = tables[stmt];
+    t.id = tables.size()-1;
+    t.num_cols = cols.size();
+    t.types.reserve((size_t)trace_block_rows*t.num_cols);
+    t.vals.reserve((size_t)trace_block_rows*t.num_cols);
+
+    put_u8((uint8_t)TraceRec::table);
+    put_u32(t.id);
+    put_str(name, strlen(name));
+    put_u32(t.num_cols);
+    for(const string& c: cols) {
+        put_str(c.data(), c.size());
+    }
+}
+
+TraceWriter::Table& TraceWriter::row_of(sqlite3_stmt* stmt)
+{
+    auto it = tables.find(stmt);
+    assert(it != tables.end());
+    Table& t = it->second;
+    if (!t.in_row) {
+        t.in_row = true;
+        t.types.resize(t.types.size() + t.num_cols, (uint8_t)TraceVal::null);
+        t.vals.resize(t.vals.size() + t.num_cols, 0);
+    }
+    return t;
+}
+
+void TraceWriter::set(sqlite3_stmt* stmt, int pos, TraceVal type, uint64_t val)
+{
+    Table& t = row_of(stmt);
+
+    //SQLite ignores values bound past the last column, and so do we
+    if (pos < 1 || (uint32_t)pos > t.num_cols) {
+        return;
+    }
+    const size_t at = (size_t)t.rows*t.num_cols + pos-1;
+    t.types[at] = (uint8_t)type;
+    t.vals[at] = val;
+}
+
+void TraceWriter::bind_int(sqlite3_stmt* stmt, int pos, int val)
+{
+    set(stmt, pos, TraceVal::int64, (uint64_t)(int64_t)val);
+}
+
+void TraceWriter::bind_int64(sqlite3_stmt* stmt, int pos, int64_t val)
+{
+    set(stmt, pos, TraceVal::int64, (uint64_t)val);
+}
+
+void TraceWriter::bind_double(sqlite3_stmt* stmt, int pos, double val)
+{
+    uint64_t v;
+    memcpy(&v, &val, sizeof(v));
+    set(stmt, pos, TraceVal::dbl, v);
+}
+
+void TraceWriter::bind_null(sqlite3_stmt* stmt, int pos)
+{
+    set(stmt, pos, TraceVal::null, 0);
+}
+
+void TraceWriter::bind_text(sqlite3_stmt* stmt, int pos, const string& val)
+{
+    auto it = text_ids.find(val);
+    if (it == text_ids.end()) {
+        const uint32_t id = text_ids.size();
+        it = text_ids.insert(std::make_pair(val, id)).first;
+        put_u8((uint8_t)TraceRec::text);
+        put_u32(id);
+        put_str(val.data(), val.size());
+    }
+    set(stmt, pos, TraceVal::text, it->second);
+}
+
+void TraceWriter::step(sqlite3_stmt* stmt, const char*)
+{
+    Table& t = row_of(stmt);
+    t.in_row = false;
+    t.rows++;
+    if (t.rows == trace_block_rows) {
+        flush_block(t);
+    }
+}
+
+void TraceWriter::exec(const string& sql, const char*)
+{
+    put_u8((uint8_t)TraceRec::sql);
+    put_str(sql.data(), sql.size());
+}
+
+void TraceWriter::flush_block(Table& t)
+{
+    assert(!t.in_row);
+    if (t.rows == 0) {
+        return;
+    }
+
+    //Column by column: values of the same column are alike, and compress
+    //far better next to each other
+    payload.resize((size_t)t.rows*t.num_cols*9);
+    uint8_t* at = payload.data();
+    for(uint32_t c = 0; c < t.num_cols; c++) {
+        for(uint32_t r = 0; r < t.rows; r++) {
+            *at++ = t.types[(size_t)r*t.num_cols + c];
+        }
+        for(uint32_t r = 0; r < t.rows; r++) {
+            const uint64_t v = t.vals[(size_t)r*t.num_cols + c];
+            for(uint32_t i = 0; i < 8; i++) {
+                *at++ = (v >> (8*i)) & 0xff;
+            }
+        }
+    }
+    assert(at == payload.data() + payload.size());
+
+    const uint8_t* data = payload.data();
+    size_t data_len = payload.size();
+    #ifdef USE_ZLIB
+    if (compress) {
+        uLongf len = compressBound(payload.size());
+        compressed.resize(len);
+        if (compress2(compressed.data(), &len, payload.data(), payload.size()
+            , Z_BEST_SPEED) != Z_OK
+        ) {
+            cerr << "ERROR: zlib could not compress the trace" << endl;
+            std::exit(-1);
+        }
+        data = compressed.data();
+        data_len = len;
+    }
+    #endif
+
+    put_u8((uint8_t)TraceRec::block);
+    put_u32(t.id);
+    put_u32(t.rows);
+    put_u32(payload.size());
+    put_u32(data_len);
+    put_bytes(data, data_len);
+
+    t.rows = 0;
+    t.types.clear();
+    t.vals.clear();
+}
+
+void TraceWriter::finish()
+{
+    if (out == NULL) {
+        return;
+    }
+
+    for(auto& t: tables) {
+        flush_block(t.second);
+    }
+    const bool write_err = ferror(out);
+    const bool close_err = fclose(out) != 0;
+    out = NULL;
+    if (write_err || close_err) {
+        cerr << "ERROR: could not write the trace file '" << fname << "'" << endl;
+        std::exit(-1);
+    }
+}
@@ -0,0 +1,127 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef __TRACEWRITER_H__
+#define __TRACEWRITER_H__
+
+#include "rowwriter.h"
+#include <unordered_map>
+#include <cstdio>
+
+namespace CMSat {
+
+/**
+@brief Binary trace of the statistics rows, instead of a SQLite database
+
+The trace is append-only. It starts with trace_magic, the format version and
+the flags, then a sequence of records, each starting with its TraceRec byte:
+
+- table: id, name, number of columns, column names
+- text: id, string. Text values in rows are the id of their text
+- sql: a statement to execute as-is
+- block: table id, number of rows, size of the payload before and after
+  compression, payload
+
+The payload of a block holds up to trace_block_rows rows of one table, column
+by column. For every column there is one type byte per row (a TraceVal) then
+one 8-byte value per row, so every row of a table has the same width.
+Numbers are 32-bit unsigned or raw 8-byte values, little-endian, and strings
+are a 32-bit length followed by the bytes.
+
+cmsat_trace2sql converts the trace to the SQLite database SQLiteStats would
+have written.
+*/
+static const char trace_magic[8] = {'C','M','S','T','R','A','C','E'};
+static const uint32_t trace_version = 1;
+static const uint32_t trace_flag_zlib = 1;
+static const uint32_t trace_block_rows = 4096;
+
+enum class TraceRec : uint8_t {
+    table = 1, text = 2, sql = 3, block = 4
+};
+
+enum class TraceVal : uint8_t {
+    null = 0, int64 = 1, dbl = 2, text = 3
+};
+
+class TraceWriter: public RowWriter
+{
+public:
+    TraceWriter(const string& fname, bool compress);
+    ~TraceWriter() override;
+
+    void add_table(
+        const char* name
+        , sqlite3_stmt* stmt
+        , const vector<string>& cols
+    ) override;
+
+    void bind_int(sqlite3_stmt* stmt, int pos, int val) override;
+    void bind_int64(sqlite3_stmt* stmt, int pos, int64_t val) override;
+    void bind_double(sqlite3_stmt* stmt, int pos, double val) override;
+    void bind_null(sqlite3_stmt* stmt, int pos) override;
+    void bind_text(sqlite3_stmt* stmt, int pos, const string& val) override;
+    void step(sqlite3_stmt* stmt, const char* name) override;
+    void exec(const string& sql, const char* name) override;
+
+    ///Blocks are written when they are full, transactions mean nothing here
+    void begin_transaction() override {}
+    void end_transaction() override {}
+
+    ///Writes the partially filled blocks and closes the file
+    void finish() override;
+
+private:
+    struct Table
+    {
+        uint32_t id;
+        uint32_t num_cols;
+        uint32_t rows = 0;
+        bool in_row = false;
+
+        //Row by row, num_cols values each
+        vector<uint8_t> types;
+        vector<uint64_t> vals;
+    };
+
+    Table& row_of(sqlite3_stmt* stmt);
+    void set(sqlite3_stmt* stmt, int pos, TraceVal type, uint64_t val);
+    void flush_block(Table& t);
+
+    void put_u8(uint8_t v);
+    void put_u32(uint32_t v);
+    void put_str(const char* s, size_t len);
+    void put_bytes(const void* data, size_t len);
+
+    const string fname;
+    FILE* out = NULL;
+    bool compress;
+
+    std::unordered_map<const sqlite3_stmt*, Table> tables;
+    std::unordered_map<string, uint32_t> text_ids;
+    vector<uint8_t> payload;
+    vector<uint8_t> compressed;
+};
+
+}
+
+#endif //__TRACEWRITER_H__
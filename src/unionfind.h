@@ -0,0 +1,109 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+namespace CMSat {
+
+using std::vector;
+
+/**
+@brief Disjoint sets over 0..size()-1, with union by size and path halving
+
+Sets can only be merged, never split again
+*/
+class UnionFind
+{
+    public:
+        void resize(const size_t n)
+        {
+            const size_t old = parent.size();
+            parent.resize(n);
+            sz.resize(n, 1);
+            for(size_t i = old; i < n; i++) {
+                parent[i] = i;
+            }
+        }
+
+        size_t size() const
+        {
+            return parent.size();
+        }
+
+        //Every element in its own set again
+        void reset()
+        {
+            for(size_t i = 0; i < parent.size(); i++) {
+                parent[i] = i;
+                sz[i] = 1;
+            }
+        }
+
+        uint32_t find(uint32_t x)
+        {
+            while(parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        ///Returns false if they were already in the same set
+        bool unite(uint32_t a, uint32_t b)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return false;
+            }
+            if (sz[a] < sz[b]) {
+                std::swap(a, b);
+            }
+            parent[b] = a;
+            sz[a] += sz[b];
+            return true;
+        }
+
+        uint32_t set_size(const uint32_t x)
+        {
+            return sz[find(x)];
+        }
+
+        size_t mem_used() const
+        {
+            return (parent.capacity() + sz.capacity())*sizeof(uint32_t);
+        }
+
+    private:
+        vector<uint32_t> parent;
+        vector<uint32_t> sz;
+};
+
+} //end namespace
+
+#endif //UNIONFIND_H
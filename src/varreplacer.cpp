@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include <iostream>
 #include <iomanip>
 #include <set>
+#include <algorithm>
 using std::cout;
 using std::endl;
 
@@ -381,12 +382,15 @@ inline void VarReplacer::updateBin(
     //Two lits are the same in BIN
     if (lit1 == lit2) {
         delayedEnqueue.push_back(lit2);
-        (*solver->drat) << add << lit2
-        #ifdef STATS_NEEDED
-        << 0
-        << solver->sumConflicts
-        #endif
-        << fin;
+        if (origLit1 < origLit2) {
+            set_bin_hints(origLit1, origLit2);
+            (*solver->drat) << add << lit2
+            #ifdef STATS_NEEDED
+            << 0
+            << solver->sumConflicts
+            #endif
+            << fin;
+        }
         remove = true;
     }
 
@@ -412,6 +416,7 @@ inline void VarReplacer::updateBin(
         //Delete&attach only once
         && (origLit1 < origLit2)
     ) {
+        set_bin_hints(origLit1, origLit2);
         (*solver->drat)
         << add << lit1 << lit2
         #ifdef STATS_NEEDED
@@ -429,6 +434,20 @@ inline void VarReplacer::updateBin(
     }
 }
 
+void VarReplacer::set_bin_hints(
+    const Lit origLit1
+    , const Lit origLit2
+) {
+    if (!solver->drat->hints_needed()) {
+        return;
+    }
+    frat_hints.clear();
+    add_frat_chain(origLit1, frat_hints);
+    add_frat_chain(origLit2, frat_hints);
+    frat_hints.push_back(solver->drat->bin_ID(origLit1, origLit2));
+    solver->drat->set_hints(frat_hints);
+}
+
 void VarReplacer::updateStatsFromImplStats()
 {
     assert(impl_tmp_stats.removedRedBin % 2 == 0);
@@ -539,13 +558,28 @@ bool VarReplacer::replace_set(vector<ClOffset>& cs)
         const Lit origLit1 = c[0];
         const Lit origLit2 = c[1];
 
+        //FRAT hints are the units of the false literals, the chains of
+        //equivalences of the replaced ones, then the original clause
+        const bool hints = solver->drat->hints_needed();
+        frat_hints.clear();
         for (Lit& l: c) {
             if (isReplaced_fast(l)) {
                 changed = true;
+                if (hints) {
+                    add_frat_chain(l, frat_hints);
+                }
                 l = get_lit_replaced_with_fast(l);
                 runStats.replacedLits++;
             }
         }
+        if (changed && hints) {
+            for (const Lit l: c) {
+                if (solver->value(l) == l_False) {
+                    frat_hints.insert(frat_hints.begin(), solver->drat->unit_ID(~l));
+                }
+            }
+            frat_hints.push_back(solver->drat->ID_of(c));
+        }
 
         if (changed && handleUpdatedClause(c, origLit1, origLit2)) {
             runStats.removedLongClauses++;
@@ -620,6 +654,9 @@ bool VarReplacer::handleUpdatedClause(
         c.setRemoved();
         return true;
     }
+    if (!frat_hints.empty()) {
+        solver->drat->set_hints(frat_hints);
+    }
     (*solver->drat) << add << c
     #ifdef STATS_NEEDED
     << solver->sumConflicts
@@ -778,34 +815,54 @@ bool VarReplacer::handleAlreadyReplaced(const Lit lit1, const Lit lit2)
 {
     //OOps, already inside, but with inverse polarity, UNSAT
     if (lit1.sign() != lit2.sign()) {
+        const uint32_t ID1 = solver->drat->new_ID();
+        const uint32_t ID2 = solver->drat->new_ID();
+        const bool hints = solver->drat->hints_needed();
+        if (hints) {
+            solver->drat->set_hints(equiv_hints1);
+        }
         (*solver->drat)
-        << add << ~lit1 << lit2
+        << add << FratID(ID1) << ~lit1 << lit2
         #ifdef STATS_NEEDED
         << 0
         << solver->sumConflicts
         #endif
-        << fin
+        << fin;
 
-        << add << lit1 << ~lit2
+        if (hints) {
+            solver->drat->set_hints(equiv_hints2);
+        }
+        (*solver->drat)
+        << add << FratID(ID2) << lit1 << ~lit2
         #ifdef STATS_NEEDED
         << 0
         << solver->sumConflicts
         #endif
-        << fin
+        << fin;
 
+        //lit2 is ~lit1, so ID2 is the unit lit1 and ID1 the unit ~lit1
+        if (hints) {
+            solver->drat->set_hints(vector<uint32_t>{ID2});
+        }
+        (*solver->drat)
         << add << lit1
         #ifdef STATS_NEEDED
         << 0
         << solver->sumConflicts
         #endif
-        << fin
+        << fin;
 
+        if (hints) {
+            solver->drat->set_hints(vector<uint32_t>{ID1});
+        }
+        (*solver->drat)
         << add << ~lit1
         #ifdef STATS_NEEDED
         << 0
         << solver->sumConflicts
         #endif
         << fin;
+        del_equiv_bins(lit1, lit2, ID1, ID2);
 
         solver->ok = false;
         return false;
@@ -849,13 +906,25 @@ bool VarReplacer::handleOneSet(
     , const lbool val1
     , const Lit lit2
     , const lbool val2
+    , const uint32_t ID1
+    , const uint32_t ID2
 ) {
     if (solver->ok) {
         Lit toEnqueue;
+        Lit set;
         if (val1 != l_Undef) {
             toEnqueue = lit2 ^ (val1 == l_False);
+            set = lit1 ^ (val1 == l_False);
         } else {
             toEnqueue = lit1 ^ (val2 == l_False);
+            set = lit2 ^ (val2 == l_False);
+        }
+        if (solver->drat->hints_needed()) {
+            //ID1 is -lit1 V lit2, ID2 is lit1 V -lit2
+            frat_hints.clear();
+            frat_hints.push_back(solver->drat->unit_ID(set));
+            frat_hints.push_back((set == lit1 || set == ~lit2) ? ID1 : ID2);
+            solver->drat->set_hints(frat_hints);
         }
         solver->enqueue(toEnqueue);
         (*solver->drat) << add << toEnqueue
@@ -902,19 +971,31 @@ bool VarReplacer::replace(
     //Move forward
     const Lit lit1 = get_lit_replaced_with(Lit(var1, false));
     const Lit lit2 = get_lit_replaced_with(Lit(var2, false)) ^ xor_is_true;
+    if (solver->drat->hints_needed()) {
+        set_equiv_hints(Lit(var1, false), Lit(var2, xor_is_true));
+    }
 
     //Already inside?
     if (lit1.var() == lit2.var()) {
         return handleAlreadyReplaced(lit1, lit2);
     }
+    const uint32_t ID1 = solver->drat->new_ID();
+    const uint32_t ID2 = solver->drat->new_ID();
+    if (solver->drat->hints_needed()) {
+        solver->drat->set_hints(equiv_hints1);
+    }
     (*solver->drat)
-    << add << ~lit1 << lit2
+    << add << FratID(ID1) << ~lit1 << lit2
     #ifdef STATS_NEEDED
     << 0
     << solver->sumConflicts
     #endif
-    << fin
-    << add << lit1 << ~lit2
+    << fin;
+    if (solver->drat->hints_needed()) {
+        solver->drat->set_hints(equiv_hints2);
+    }
+    (*solver->drat)
+    << add << FratID(ID2) << lit1 << ~lit2
     #ifdef STATS_NEEDED
     << 0
     << solver->sumConflicts
@@ -930,21 +1011,143 @@ bool VarReplacer::replace(
 
     //Both are set
     if (val1 != l_Undef && val2 != l_Undef) {
-        return replace_vars_already_set(lit1, val1, lit2, val2);
+        const bool ret = replace_vars_already_set(lit1, val1, lit2, val2);
+        del_equiv_bins(lit1, lit2, ID1, ID2);
+        return ret;
     }
 
     //exactly one set
     if ((val1 != l_Undef && val2 == l_Undef)
         || (val2 != l_Undef && val1 == l_Undef)
     ) {
-        return handleOneSet(lit1, val1, lit2, val2);
+        const bool ret = handleOneSet(lit1, val1, lit2, val2, ID1, ID2);
+        del_equiv_bins(lit1, lit2, ID1, ID2);
+        return ret;
     }
 
     assert(val1 == l_Undef && val2 == l_Undef);
 
     const Lit lit1_outer = solver->map_inter_to_outer(lit1);
     const Lit lit2_outer = solver->map_inter_to_outer(lit2);
-    return update_table_and_reversetable(lit1_outer, lit2_outer);
+    const bool ret = update_table_and_reversetable(lit1_outer, lit2_outer);
+
+    //Kept for the hints and the finalization of the proof
+    if (ID1 != 0) {
+        FratEquiv e;
+        uint32_t var;
+        if (table[lit1_outer.var()].var() != lit1_outer.var()) {
+            var = lit1_outer.var();
+            e.rep = lit2_outer ^ lit1_outer.sign();
+            e.pos_ID = lit1_outer.sign() ? ID2 : ID1;
+            e.neg_ID = lit1_outer.sign() ? ID1 : ID2;
+        } else {
+            var = lit2_outer.var();
+            e.rep = lit1_outer ^ lit2_outer.sign();
+            e.pos_ID = lit2_outer.sign() ? ID1 : ID2;
+            e.neg_ID = lit2_outer.sign() ? ID2 : ID1;
+        }
+        frat_equiv[var] = e;
+    }
+    return ret;
+}
+
+void VarReplacer::del_equiv_bins(
+    const Lit lit1
+    , const Lit lit2
+    , const uint32_t ID1
+    , const uint32_t ID2
+) {
+    (*solver->drat)
+    << del << FratID(ID1) << ~lit1 << lit2 << fin
+    << del << FratID(ID2) << lit1 << ~lit2 << fin;
+}
+
+//Hints of ~lit1 V lit2 and of lit1 V ~lit2 in replace(), where lit1 and
+//lit2 are what 'v1' and 'v2' are replaced with. 'v1' implies 'v2' and
+//the other way around through binary clauses, as SCC found them.
+void VarReplacer::set_equiv_hints(const Lit v1, const Lit v2)
+{
+    //lit1 makes v1 true, which makes v2 true, which conflicts with ~lit2
+    equiv_hints1.clear();
+    add_frat_chain(~v1, equiv_hints1);
+    add_impl_path(v1, v2, equiv_hints1);
+    add_frat_chain(v2, equiv_hints1);
+
+    equiv_hints2.clear();
+    add_frat_chain(~v2, equiv_hints2);
+    add_impl_path(v2, v1, equiv_hints2);
+    add_frat_chain(v1, equiv_hints2);
+}
+
+//Appends the IDs of the binary clauses that, in order, propagate 'to' from
+//'from', found with a breadth-first search. Appends 0 if there are none.
+void VarReplacer::add_impl_path(const Lit from, const Lit to, vector<uint32_t>& hints)
+{
+    impl_parent.resize(solver->nVars()*2);
+    impl_queue.clear();
+    impl_queue.push_back(from);
+    solver->seen[from.toInt()] = 1;
+    bool found = false;
+    for(size_t at = 0; at < impl_queue.size() && !found; at++) {
+        const Lit lit = impl_queue[at];
+        for(const Watched& w: solver->watches[~lit]) {
+            if (!w.isBin() || solver->seen[w.lit2().toInt()]) {
+                continue;
+            }
+            solver->seen[w.lit2().toInt()] = 1;
+            impl_parent[w.lit2().toInt()] = lit;
+            impl_queue.push_back(w.lit2());
+            if (w.lit2() == to) {
+                found = true;
+                break;
+            }
+        }
+    }
+    for(const Lit lit: impl_queue) {
+        solver->seen[lit.toInt()] = 0;
+    }
+
+    if (!found) {
+        hints.push_back(0);
+        return;
+    }
+    const size_t at = hints.size();
+    for(Lit lit = to; lit != from; lit = impl_parent[lit.toInt()]) {
+        hints.push_back(solver->drat->bin_ID(~impl_parent[lit.toInt()], lit));
+    }
+    std::reverse(hints.begin() + at, hints.end());
+}
+
+//Appends the IDs of the equivalences that, in order, make 'lit' false once
+//the literal it is replaced with is false. 'lit' is INTER
+void VarReplacer::add_frat_chain(const Lit lit, vector<uint32_t>& hints) const
+{
+    const size_t at = hints.size();
+    Lit cur = solver->map_inter_to_outer(lit);
+    while(table[cur.var()].var() != cur.var()) {
+        auto it = frat_equiv.find(cur.var());
+        if (it == frat_equiv.end()) {
+            //Replaced before it was kept track of, no hints then
+            hints.push_back(0);
+            return;
+        }
+        hints.push_back(cur.sign() ? it->second.neg_ID : it->second.pos_ID);
+        cur = it->second.rep ^ cur.sign();
+    }
+    std::reverse(hints.begin() + at, hints.end());
+}
+
+void VarReplacer::finalize_frat() const
+{
+    vector<Lit> lits(2);
+    for(const auto& it: frat_equiv) {
+        lits[0] = Lit(it.first, true);
+        lits[1] = it.second.rep;
+        solver->drat->finalize(it.second.pos_ID, lits, true);
+        lits[0] = Lit(it.first, false);
+        lits[1] = ~it.second.rep;
+        solver->drat->finalize(it.second.neg_ID, lits, true);
+    }
 }
 
 bool VarReplacer::update_table_and_reversetable(const Lit lit1, const Lit lit2)
@@ -1022,6 +1225,9 @@ bool VarReplacer::add_xor_as_bins(const BinaryXor& bin_xor)
 {
     ps_tmp[0] = Lit(bin_xor.vars[0], false);
     ps_tmp[1] = Lit(bin_xor.vars[1], true ^ bin_xor.rhs);
+    if (solver->drat->hints_needed()) {
+        add_impl_path(~ps_tmp[0], ps_tmp[1], solver->frat_hints);
+    }
     solver->add_clause_int(ps_tmp);
     if (!solver->ok) {
         return false;
@@ -1029,6 +1235,9 @@ bool VarReplacer::add_xor_as_bins(const BinaryXor& bin_xor)
 
     ps_tmp[0] = Lit(bin_xor.vars[0], true);
     ps_tmp[1] = Lit(bin_xor.vars[1], false ^ bin_xor.rhs);
+    if (solver->drat->hints_needed()) {
+        add_impl_path(~ps_tmp[0], ps_tmp[1], solver->frat_hints);
+    }
     solver->add_clause_int(ps_tmp);
     if (!solver->ok) {
         return false;
@@ -1322,6 +1531,13 @@ void VarReplacer::load_state(SimpleInFile& f)
     }
 }
 
+void VarReplacer::copy_state_from(const VarReplacer& other)
+{
+    table = other.table;
+    replacedVars = other.replacedVars;
+    reverseTable = other.reverseTable;
+}
+
 bool VarReplacer::get_scc_depth_warning_triggered() const
 {
     return scc_finder->depth_warning_triggered();
@@ -109,6 +109,8 @@ class VarReplacer
 
         void save_state(SimpleOutFile& f) const;
         void load_state(SimpleInFile& f);
+        void copy_state_from(const VarReplacer& other);
+        void finalize_frat() const;
 
     private:
         Solver* solver;
@@ -157,6 +159,12 @@ class VarReplacer
         //Helpers for replace()
         void replaceChecks(const uint32_t var1, const uint32_t var2) const;
         bool handleAlreadyReplaced(const Lit lit1, const Lit lit2);
+        void set_equiv_hints(const Lit v1, const Lit v2);
+        void add_impl_path(const Lit from, const Lit to, vector<uint32_t>& hints);
+        vector<uint32_t> equiv_hints1; ///< of ~lit1 V lit2 in replace()
+        vector<uint32_t> equiv_hints2; ///< of lit1 V ~lit2 in replace()
+        vector<Lit> impl_queue;
+        vector<Lit> impl_parent;
         bool replace_vars_already_set(
             const Lit lit1
             , const lbool val1
@@ -168,6 +176,8 @@ class VarReplacer
             , const lbool val1
             , const Lit lit2
             , const lbool val2
+            , const uint32_t ID1
+            , const uint32_t ID2
         );
 
         //Temporary used in replaceImplicit
@@ -211,6 +221,7 @@ class VarReplacer
             , Lit lit1
             , Lit lit2
         );
+        void set_bin_hints(const Lit origLit1, const Lit origLit2);
         void updateStatsFromImplStats();
 
         bool handleUpdatedClause(Clause& c, const Lit origLit1, const Lit origLit2);
@@ -234,6 +245,20 @@ class VarReplacer
         //Everything is OUTER here.
         map<uint32_t, vector<uint32_t> > reverseTable;
 
+        ///FRAT IDs of the two binary clauses that made a variable equivalent
+        ///to 'rep', the literal it was replaced with at the time. These stay
+        ///in the proof. Everything is OUTER here.
+        struct FratEquiv
+        {
+            Lit rep;
+            uint32_t pos_ID; ///< -var V rep
+            uint32_t neg_ID; ///< var V -rep
+        };
+        map<uint32_t, FratEquiv> frat_equiv;
+        void add_frat_chain(const Lit lit, vector<uint32_t>& hints) const;
+        void del_equiv_bins(const Lit lit1, const Lit lit2, const uint32_t ID1, const uint32_t ID2);
+        vector<uint32_t> frat_hints;
+
         //Stats
         void printReplaceStats() const;
         uint64_t replacedVars = 0; ///<Num vars replaced during var-replacement
@@ -25,6 +25,8 @@ THE SOFTWARE.
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
 #include <vector>
+#include <random>
+#include <algorithm>
 using std::vector;
 using namespace CMSat;
 
@@ -208,6 +210,135 @@ TEST_F(assump_interf, only_assump)
 }
 
 
+//Assumption levels kept between calls must not change any answer
+static void check_same_as_without_reuse(uint32_t seed, bool add_between)
+{
+    std::mt19937 rnd(seed);
+    const uint32_t num_vars = 60;
+    SolverConf conf;
+    conf.verbosity = 0;
+    conf.do_reuse_assumps = 1;
+    SolverConf conf_noreuse = conf;
+    conf_noreuse.do_reuse_assumps = 0;
+    SATSolver a(&conf);
+    SATSolver b(&conf_noreuse);
+    a.new_vars(num_vars);
+    b.new_vars(num_vars);
+
+    const auto rnd_lit = [&](uint32_t nvars) {
+        return Lit(rnd() % nvars, rnd() % 2);
+    };
+    for(uint32_t i = 0; i < 250; i++) {
+        vector<Lit> cl;
+        for(uint32_t j = 0; j < 3; j++) {
+            cl.push_back(rnd_lit(num_vars));
+        }
+        a.add_clause(cl);
+        b.add_clause(cl);
+    }
+
+    vector<Lit> assumps;
+    uint32_t reused = 0;
+    for(uint32_t call = 0; call < 300; call++) {
+        //Mostly a long shared prefix, as an incremental client would have
+        const uint32_t keep = assumps.empty() ? 0 : rnd() % (assumps.size()+1);
+        assumps.resize(std::max<uint32_t>(keep, assumps.size()*3/4));
+        while(assumps.size() < 12) {
+            assumps.push_back(rnd_lit(a.nVars()));
+        }
+        reused += keep > 0;
+
+        const lbool ret_a = a.solve(&assumps);
+        const lbool ret_b = b.solve(&assumps);
+        ASSERT_EQ(ret_a, ret_b);
+        if (ret_a == l_True) {
+            for(const Lit l: assumps) {
+                EXPECT_EQ(a.get_model()[l.var()], l_True ^ l.sign());
+            }
+        } else if (ret_a == l_False) {
+            for(const Lit l: a.get_conflict()) {
+                EXPECT_TRUE(std::find(assumps.begin(), assumps.end(), ~l) != assumps.end());
+            }
+        }
+
+        if (add_between && call % 5 == 0) {
+            a.new_var();
+            b.new_var();
+            vector<Lit> cl;
+            for(uint32_t j = 0; j < 3; j++) {
+                cl.push_back(rnd_lit(a.nVars()));
+            }
+            a.add_clause(cl);
+            b.add_clause(cl);
+        }
+    }
+    EXPECT_GT(reused, 0u);
+    EXPECT_EQ(a.okay(), b.okay());
+}
+
+TEST(assump_reuse, same_answers)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        check_same_as_without_reuse(seed, false);
+    }
+}
+
+TEST(assump_reuse, same_answers_adding_clauses)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        check_same_as_without_reuse(seed, true);
+    }
+}
+
+//The levels of a shared prefix must not be propagated again
+TEST(assump_reuse, shared_prefix_not_propagated_again)
+{
+    const uint32_t chain = 2000;
+    for(int reuse = 0; reuse < 2; reuse++) {
+        SolverConf conf;
+        conf.verbosity = 0;
+        conf.do_reuse_assumps = reuse;
+        SATSolver s(&conf);
+        s.new_vars(chain+1);
+        for(uint32_t i = 0; i+1 < chain; i++) {
+            s.add_clause(vector<Lit>{Lit(i, true), Lit(i+1, false)});
+        }
+
+        vector<Lit> assumps{Lit(0, false), Lit(chain, false)};
+        EXPECT_EQ(s.solve(&assumps), l_True);
+        EXPECT_GE(s.get_last_propagations(), chain);
+
+        assumps[1] = Lit(chain, true);
+        EXPECT_EQ(s.solve(&assumps), l_True);
+        if (reuse) {
+            EXPECT_LT(s.get_last_propagations(), 10u);
+        } else {
+            EXPECT_GE(s.get_last_propagations(), chain);
+        }
+    }
+}
+
+TEST(assump_reuse, reuse_then_unit)
+{
+    SolverConf conf;
+    conf.do_reuse_assumps = 1;
+    SATSolver* s = new SATSolver(&conf);
+    vector<Lit> assumps;
+    s->new_vars(3);
+    s->add_clause(vector<Lit>{Lit(0, true), Lit(1, false)});
+    assumps = {Lit(0, false), Lit(2, false)};
+    EXPECT_EQ(s->solve(&assumps), l_True);
+
+    //Unit under the kept assumption levels, must go to level 0
+    s->add_clause(vector<Lit>{Lit(1, true)});
+    EXPECT_EQ(s->solve(&assumps), l_False);
+    assumps = {Lit(2, false)};
+    EXPECT_EQ(s->solve(&assumps), l_True);
+    EXPECT_EQ(s->get_model()[0], l_False);
+    EXPECT_EQ(s->get_zero_assigned_lits().size(), 2u);
+    delete s;
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -23,9 +23,12 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <sstream>
+#include <map>
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
+#include "src/dratchecker.h"
 #include "test_helper.h"
 using namespace CMSat;
 #include <vector>
@@ -682,17 +685,6 @@ TEST(error_throw, multithread_0)
         , std::runtime_error);
 }
 
-TEST(error_throw, multithread_drat)
-{
-    SATSolver s;
-    std::ostream* os = NULL;
-    s.set_drat(os, false);
-
-    EXPECT_THROW({
-        s.set_num_threads(3);}
-        , std::runtime_error);
-}
-
 TEST(error_throw, toomany_vars)
 {
     SATSolver s;
@@ -722,6 +714,224 @@ TEST(error_throw, toomany_vars_single)
         , CMSat::TooManyVarsError);
 }
 
+//Runs a binary DRAT proof of the CNF through the in-process checker
+static lbool check_drat_proof(
+    const vector<vector<Lit>>& cls
+    , const std::string& proof
+) {
+    vector<std::pair<bool, vector<Lit>>> steps;
+    uint32_t num_vars = 0;
+    size_t at = 0;
+    while(at < proof.size()) {
+        const bool del = (proof[at++] == 'd');
+        vector<Lit> lits;
+        while(true) {
+            uint32_t x = 0;
+            uint32_t shift = 0;
+            uint8_t byte;
+            do {
+                byte = proof[at++];
+                x |= (uint32_t)(byte & 0x7f) << shift;
+                shift += 7;
+            } while(byte & 0x80);
+            if (x == 0) {
+                break;
+            }
+            lits.push_back(Lit((x >> 1)-1, x & 1));
+            num_vars = std::max(num_vars, x >> 1);
+        }
+        steps.push_back(std::make_pair(del, lits));
+    }
+    for(const auto& cl: cls) {
+        for(const Lit l: cl) {
+            num_vars = std::max(num_vars, l.var()+1);
+        }
+    }
+
+    vector<uint32_t> identity(num_vars);
+    for(uint32_t i = 0; i < num_vars; i++) {
+        identity[i] = i;
+    }
+    DratChecker checker(identity, 2);
+    for(const auto& cl: cls) {
+        checker.add_original(cl);
+    }
+    for(const auto& step: steps) {
+        checker << (step.first ? DratFlag::del : DratFlag::add)
+            << step.second << DratFlag::fin;
+    }
+    return checker.verify_unsat();
+}
+
+TEST(no_error_throw, multithread_drat)
+{
+    const uint32_t num_vars = 90;
+    const auto cls = random_3sat(1, num_vars, 540);
+    SATSolver s;
+    std::stringstream os;
+    s.set_drat(&os, false);
+    s.set_num_threads(4);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s.add_clause(cl);
+    }
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_False);
+    s.add_empty_cl_to_drat();
+    EXPECT_EQ(check_drat_proof(cls, os.str()), l_True);
+}
+
+//Checks the hints of a FRAT proof by unit propagation, and that all clauses
+//are deleted or finalised. Returns the number of added clauses with hints,
+//-1 if something is wrong
+static int check_frat_hints(const std::string& proof)
+{
+    std::map<uint32_t, vector<int>> cls;
+    std::istringstream in(proof);
+    std::string line;
+    int hinted = 0;
+    while(std::getline(in, line)) {
+        std::istringstream ss(line);
+        char type;
+        uint32_t ID;
+        int x;
+        ss >> type >> ID;
+        vector<int> lits;
+        while(ss >> x && x != 0) {
+            lits.push_back(x);
+        }
+        if (type == 'd' || type == 'f') {
+            if (cls.erase(ID) == 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        std::string hints_start;
+        if (type == 'a' && ss >> hints_start && hints_start == "l") {
+            std::map<int, bool> val;
+            for(const int l: lits) {
+                val[std::abs(l)] = l < 0;
+            }
+            bool confl = false;
+            uint32_t h;
+            while(!confl && ss >> h && h != 0) {
+                if (cls.count(h) == 0) {
+                    return -1;
+                }
+                uint32_t num_undef = 0;
+                int undef = 0;
+                for(const int l: cls[h]) {
+                    if (val.count(std::abs(l)) == 0) {
+                        num_undef++;
+                        undef = l;
+                    } else if (val[std::abs(l)] == (l > 0)) {
+                        return -1;
+                    }
+                }
+                if (num_undef > 1) {
+                    return -1;
+                }
+                confl = (num_undef == 0);
+                val[std::abs(undef)] = undef > 0;
+            }
+            if (!confl) {
+                return -1;
+            }
+            hinted++;
+        }
+        cls[ID] = lits;
+    }
+    return cls.empty() ? hinted : -1;
+}
+
+TEST(no_error_throw, frat_with_hints)
+{
+    SolverConf conf;
+    conf.frat_proof = true;
+    SATSolver s(&conf);
+    std::stringstream os;
+    s.set_drat(&os, false);
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1, 2"));
+    s.add_clause(str_to_cl("1, -2"));
+    s.add_clause(str_to_cl("-1, -2"));
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_False);
+    const std::string proof = os.str();
+    EXPECT_EQ(proof.find("o 1 1 2 0"), 0u);
+
+    //Every learnt clause, including the empty one, has correct hints
+    size_t num_added = 0;
+    for(size_t at = proof.find("\na "); at != std::string::npos; at = proof.find("\na ", at+1)) {
+        num_added++;
+    }
+    EXPECT_GT(num_added, 0u);
+    EXPECT_EQ(check_frat_hints(proof), (int)num_added);
+    EXPECT_NE(proof.find(" 0 l "), std::string::npos);
+    EXPECT_NE(proof.find("\nf "), std::string::npos);
+}
+
+TEST(error_throw, multithread_frat)
+{
+    SolverConf conf;
+    conf.frat_proof = true;
+    SATSolver s(&conf);
+    std::stringstream os;
+    s.set_drat(&os, false);
+    EXPECT_THROW({
+        s.set_num_threads(3);}
+        , std::runtime_error);
+}
+
+TEST(drat_check, unsat_verified)
+{
+    SATSolver s;
+    s.set_drat_check();
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1, 2"));
+    s.add_clause(str_to_cl("1, -2"));
+    s.add_clause(str_to_cl("-1, -2"));
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_False);
+    EXPECT_EQ(s.get_drat_check_result(), l_True);
+}
+
+TEST(drat_check, sat_not_checked)
+{
+    SATSolver s;
+    s.set_drat_check();
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(s.get_drat_check_result(), l_Undef);
+}
+
+TEST(drat_check, unsat_under_assumps_not_checked)
+{
+    SATSolver s;
+    s.set_drat_check();
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    vector<Lit> assumps = str_to_cl("-1, -2");
+    lbool ret = s.solve(&assumps);
+    EXPECT_EQ(ret, l_False);
+    EXPECT_EQ(s.get_drat_check_result(), l_Undef);
+    EXPECT_FALSE(s.get_conflict().empty());
+}
+
+TEST(error_throw, multithread_drat_check)
+{
+    SATSolver s;
+    s.set_drat_check();
+    EXPECT_THROW({
+        s.set_num_threads(3);}
+        , std::runtime_error);
+}
+
 TEST(no_error_throw, long_clause)
 {
     SATSolver s;
@@ -951,6 +1161,46 @@ TEST(sampling, indep2)
     EXPECT_EQ(s.get_model()[6], l_Undef);
 }
 
+TEST(sampling, indep_elimed_before)
+{
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        SolverConf conf;
+        conf.simplify_at_startup = true;
+        SATSolver s(&conf);
+        s.new_vars(30);
+
+        const auto cls = random_3sat(seed, 30, 100);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+
+        //Vars are eliminated here, before they become sampling vars
+        if (s.solve() != l_True) {
+            continue;
+        }
+        vector<uint32_t> x;
+        for(uint32_t v = 0; v < 30; v += 2) {
+            x.push_back(v);
+        }
+        s.set_sampling_vars(&x);
+        EXPECT_EQ(s.solve(NULL, true), l_True);
+        for(const uint32_t v: x) {
+            EXPECT_NE(s.get_model()[v], l_Undef);
+        }
+
+        //Clauses over sampling vars only must be satisfied
+        for(const auto& cl: cls) {
+            bool only_sampling = true;
+            bool sat = false;
+            for(const Lit l: cl) {
+                only_sampling &= (l.var() % 2 == 0);
+                sat |= (s.get_model()[l.var()] == boolToLBool(!l.sign()));
+            }
+            EXPECT_TRUE(!only_sampling || sat);
+        }
+    }
+}
+
 
 
 TEST(xor_recovery, find_1_3_xor)
@@ -1125,6 +1375,201 @@ TEST(xor_recovery, DISABLED_find_xor_renumber)
     EXPECT_EQ(xors[0].first, (vector<uint32_t>{1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U}));
 }
 
+static void add_random_3sat(SATSolver& s, uint32_t seed, uint32_t num_vars, uint32_t num_cls)
+{
+    s.new_vars(num_vars);
+    for(const auto& cl: random_3sat(seed, num_vars, num_cls)) {
+        s.add_clause(cl);
+    }
+}
+
+static vector<vector<Lit>> split_clauses(const vector<Lit>& flat)
+{
+    vector<vector<Lit>> ret(1);
+    for(const Lit l: flat) {
+        if (l == lit_Undef) {
+            ret.push_back(vector<Lit>());
+        } else {
+            ret.back().push_back(l);
+        }
+    }
+    EXPECT_TRUE(ret.back().empty()) << "last clause not ended";
+    ret.pop_back();
+    return ret;
+}
+
+TEST(learnt_exchange, export_small_implied)
+{
+    SATSolver s;
+    add_random_3sat(s, 1, 200, 850);
+    s.set_max_confl(5000);
+
+    vector<vector<Lit>> got;
+    uint32_t batches = 0;
+    s.set_learnt_clause_export([&](const vector<Lit>& cls) {
+        batches++;
+        for(const auto& cl: split_clauses(cls)) {
+            got.push_back(cl);
+        }
+        EXPECT_LE(split_clauses(cls).size(), 20U);
+    }, 5, 3, 20);
+    s.solve();
+    EXPECT_GT(got.size(), 0U);
+    EXPECT_GE(batches, got.size()/20);
+
+    SATSolver check;
+    add_random_3sat(check, 1, 200, 850);
+    for(uint32_t i = 0; i < got.size() && i < 30; i++) {
+        EXPECT_LE(got[i].size(), 5U);
+        vector<Lit> assumps;
+        for(const Lit l: got[i]) {
+            EXPECT_LT(l.var(), 200U);
+            assumps.push_back(~l);
+        }
+        EXPECT_EQ(check.solve(&assumps), l_False);
+    }
+}
+
+TEST(learnt_exchange, import_at_restarts)
+{
+    SATSolver s;
+    add_random_3sat(s, 2, 200, 800);
+    s.set_max_confl(3000);
+
+    //Forces var 7 to false, and ignores clauses over unknown variables
+    uint32_t polled = 0;
+    s.set_learnt_clause_import([&](vector<Lit>& cls) {
+        polled++;
+        cls.push_back(Lit(500, false));
+        cls.push_back(Lit(1, false));
+        cls.push_back(lit_Undef);
+        cls.push_back(Lit(7, true));
+        cls.push_back(lit_Undef);
+    });
+    const lbool ret = s.solve();
+    EXPECT_GT(polled, 0U);
+    if (ret == l_True) {
+        EXPECT_EQ(s.get_model()[7], l_False);
+    }
+    vector<Lit> zero = s.get_zero_assigned_lits();
+    EXPECT_NE(std::find(zero.begin(), zero.end(), Lit(7, true)), zero.end());
+
+    const uint32_t polled_before = polled;
+    s.set_learnt_clause_import(nullptr);
+    s.add_clause(vector<Lit>{Lit(8, false)});
+    s.solve();
+    EXPECT_EQ(polled, polled_before);
+}
+
+TEST(learnt_exchange, no_import_with_drat)
+{
+    SATSolver s;
+    std::stringstream drat;
+    s.set_drat(&drat, false);
+    EXPECT_THROW(
+        s.set_learnt_clause_import([](vector<Lit>&) {}),
+        std::runtime_error);
+}
+
+static void add_pigeonhole(SATSolver& s, uint32_t holes)
+{
+    s.new_vars((holes+1)*holes);
+    for(uint32_t p = 0; p <= holes; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) {
+            cl.push_back(Lit(p*holes+h, false));
+        }
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 <= holes; p1++) {
+            for(uint32_t p2 = p1+1; p2 <= holes; p2++) {
+                s.add_clause(vector<Lit>{Lit(p1*holes+h, true), Lit(p2*holes+h, true)});
+            }
+        }
+    }
+}
+
+TEST(no_error_throw, frat_hints_with_simplification)
+{
+    SolverConf conf;
+    conf.frat_proof = true;
+    conf.simplify_at_startup = true;
+    SATSolver s(&conf);
+    std::stringstream os;
+    s.set_drat(&os, false);
+    add_pigeonhole(s, 6);
+    lbool ret = s.solve();
+    EXPECT_EQ(ret, l_False);
+    EXPECT_GT(check_frat_hints(os.str()), 100);
+}
+
+TEST(user_callbacks, terminate)
+{
+    SATSolver s;
+    add_pigeonhole(s, 10);
+    uint32_t called = 0;
+    s.set_terminate_callback([&]() {
+        return ++called >= 5;
+    });
+    EXPECT_EQ(s.solve(), l_Undef);
+    EXPECT_EQ(called, 5U);
+    EXPECT_GT(s.get_sum_conflicts(), 0U);
+
+    //Polled again at the next call
+    EXPECT_EQ(s.solve(), l_Undef);
+    EXPECT_EQ(called, 6U);
+
+    s.set_terminate_callback(nullptr);
+    s.add_clause(vector<Lit>{Lit(0, true)});
+    s.add_clause(vector<Lit>{Lit(1, true)});
+    vector<Lit> assumps;
+    for(uint32_t h = 2; h < 10; h++) {
+        assumps.push_back(Lit(h, true));
+    }
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    EXPECT_EQ(called, 6U);
+}
+
+TEST(user_callbacks, terminate_threads)
+{
+    SATSolver s;
+    s.set_num_threads(3);
+    add_pigeonhole(s, 10);
+    s.set_terminate_callback([]() {
+        return true;
+    });
+    EXPECT_EQ(s.solve(), l_Undef);
+}
+
+TEST(user_callbacks, progress)
+{
+    SATSolver s;
+    add_pigeonhole(s, 9);
+    vector<SolveProgress> got;
+    s.set_progress_callback([&](const SolveProgress& p) {
+        got.push_back(p);
+    }, 0.0);
+    s.set_max_confl(3000);
+    EXPECT_EQ(s.solve(), l_Undef);
+    ASSERT_GT(got.size(), 3U);
+    for(size_t i = 1; i < got.size(); i++) {
+        EXPECT_GE(got[i].conflicts, got[i-1].conflicts);
+        EXPECT_GE(got[i].propagations, got[i-1].propagations);
+        EXPECT_GE(got[i].restarts, got[i-1].restarts);
+        EXPECT_LE(got[i].trail_size, s.nVars());
+    }
+    EXPECT_LE(got.back().conflicts, s.get_sum_conflicts());
+
+    //Rate-limited
+    got.clear();
+    s.set_progress_callback([&](const SolveProgress& p) {
+        got.push_back(p);
+    }, 1000.0);
+    s.set_max_confl(3000);
+    s.solve();
+    EXPECT_EQ(got.size(), 1U);
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
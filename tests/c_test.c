@@ -30,6 +30,23 @@ c_Lit new_lit(uint32_t var, bool neg) {
     return x;
 }
 
+static void count_exported(void* user_data, const c_Lit* lits, size_t num_lits) {
+    size_t i;
+    for(i = 0; i < num_lits; i++) {
+        if (lits[i].x == CMSAT_LIT_UNDEF) {
+            (*(size_t*)user_data)++;
+        }
+    }
+}
+
+static slice_Lit import_nothing(void* user_data) {
+    slice_Lit ret;
+    (void)user_data;
+    ret.vals = NULL;
+    ret.num_vals = 0;
+    return ret;
+}
+
 int main(void) {
     int new; // make sure this is actually compiled as C
 
@@ -49,6 +66,10 @@ int main(void) {
     clause[2] = new_lit(2, false);
     cmsat_add_clause(solver, clause, 3);
 
+    size_t num_exported = 0;
+    cmsat_set_learnt_clause_export(solver, count_exported, &num_exported, 8, 4, 128);
+    cmsat_set_learnt_clause_import(solver, import_nothing, NULL);
+
     c_lbool ret = cmsat_solve(solver);
     assert(ret.x == L_TRUE);
 
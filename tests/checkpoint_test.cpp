@@ -0,0 +1,129 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+static lbool solve_through_checkpoints(
+    const vector<vector<Lit>>& cls, uint32_t num_vars, unsigned threads
+    , vector<lbool>& model
+) {
+    const char* fname = "checkpoint_test.dat";
+    lbool ret;
+    {
+        SATSolver s;
+        s.set_num_threads(threads);
+        s.set_checkpoint(fname, 1e9);
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+        s.set_max_confl(300);
+        ret = s.solve();
+        model = s.get_model();
+    }
+
+    for(uint64_t limit = 600; ret == l_Undef; limit += 300) {
+        SATSolver s;
+        s.set_num_threads(threads);
+        s.set_checkpoint(fname, 1e9);
+        s.load_checkpoint(fname);
+        EXPECT_EQ(s.nVars(), num_vars);
+        s.set_max_confl(limit);
+        ret = s.solve();
+        if (ret == l_True) {
+            model = s.get_model();
+        }
+    }
+    std::remove(fname);
+    for(unsigned i = 1; i < threads; i++) {
+        std::remove((std::string(fname) + "." + std::to_string(i)).c_str());
+    }
+    return ret;
+}
+
+TEST(checkpoint, same_result_as_without)
+{
+    for(uint32_t seed = 0; seed < 6; seed++) {
+        const auto cls = random_3sat(seed, 150, 640);
+        SATSolver plain;
+        plain.new_vars(150);
+        for(const auto& cl: cls) {
+            plain.add_clause(cl);
+        }
+        const lbool expected = plain.solve();
+
+        vector<lbool> model;
+        const lbool ret = solve_through_checkpoints(cls, 150, 1, model);
+        EXPECT_EQ(ret, expected);
+        if (ret == l_True) {
+            EXPECT_TRUE(model_ok(cls, model));
+        }
+    }
+}
+
+TEST(checkpoint, multi_thread)
+{
+    for(uint32_t seed = 10; seed < 13; seed++) {
+        const auto cls = random_3sat(seed, 150, 640);
+        SATSolver plain;
+        plain.new_vars(150);
+        for(const auto& cl: cls) {
+            plain.add_clause(cl);
+        }
+        const lbool expected = plain.solve();
+
+        vector<lbool> model;
+        const lbool ret = solve_through_checkpoints(cls, 150, 2, model);
+        EXPECT_EQ(ret, expected);
+        if (ret == l_True) {
+            EXPECT_TRUE(model_ok(cls, model));
+        }
+    }
+}
+
+TEST(checkpoint, not_a_checkpoint)
+{
+    const char* fname = "checkpoint_test_bad.dat";
+    {
+        std::ofstream f(fname);
+        f << "p cnf 1 1\n1 0\n";
+    }
+    SATSolver s;
+    EXPECT_THROW(s.load_checkpoint(fname), std::runtime_error);
+    std::remove(fname);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
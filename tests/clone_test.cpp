@@ -0,0 +1,195 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+static bool file_exists(const string& fname)
+{
+    std::ifstream f(fname);
+    return f.good();
+}
+
+TEST(clone, independent_copies)
+{
+    const uint32_t num_vars = 150;
+    for(uint32_t seed = 40; seed < 43; seed++) {
+        const auto cls = random_3sat(seed, num_vars, 630);
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+        s.set_max_confl(500);
+        s.solve();
+
+        SATSolver* c = s.clone();
+        EXPECT_EQ(c->nVars(), num_vars);
+        EXPECT_EQ(c->get_sum_conflicts(), s.get_sum_conflicts());
+
+        SATSolver plain;
+        plain.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            plain.add_clause(cl);
+        }
+        const lbool expected = plain.solve();
+        EXPECT_EQ(c->solve(), expected);
+        if (expected == l_True) {
+            EXPECT_TRUE(model_ok(cls, c->get_model()));
+        }
+
+        //Clauses of the copy do not go to the original
+        c->add_clause(vector<Lit>{Lit(0, false)});
+        c->add_clause(vector<Lit>{Lit(0, true)});
+        EXPECT_EQ(c->solve(), l_False);
+        delete c;
+        s.set_max_confl(std::numeric_limits<long>::max());
+        EXPECT_EQ(s.solve(), expected);
+    }
+}
+
+TEST(clone, parallel_assumptions)
+{
+    const uint32_t num_vars = 120;
+    const auto cls = random_3sat(50, num_vars, 480);
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s.add_clause(cl);
+    }
+    s.solve();
+
+    MTRand rnd(50);
+    vector<vector<Lit>> assumps(4);
+    vector<SATSolver*> clones;
+    for(auto& a: assumps) {
+        for(uint32_t j = 0; j < 8; j++) {
+            a.push_back(Lit(rnd.randInt(num_vars-1), rnd.randInt(1)));
+        }
+        clones.push_back(s.clone());
+    }
+    vector<lbool> ret(assumps.size());
+    vector<std::thread> threads;
+    for(size_t i = 0; i < assumps.size(); i++) {
+        threads.push_back(std::thread([&, i]() {
+            ret[i] = clones[i]->solve(&assumps[i]);
+        }));
+    }
+    for(auto& t: threads) {
+        t.join();
+    }
+
+    for(size_t i = 0; i < assumps.size(); i++) {
+        EXPECT_EQ(ret[i], s.solve(&assumps[i]));
+        if (ret[i] == l_True) {
+            auto with_assumps = cls;
+            for(const Lit l: assumps[i]) {
+                with_assumps.push_back(vector<Lit>{l});
+            }
+            EXPECT_TRUE(model_ok(with_assumps, clones[i]->get_model()));
+        }
+        delete clones[i];
+    }
+}
+
+//Cloning must not backtrack the original: its kept assumption levels are
+//still reused afterwards
+TEST(clone, original_keeps_assumptions)
+{
+    const uint32_t chain = 2000;
+    SolverConf conf;
+    conf.verbosity = 0;
+    conf.do_reuse_assumps = 1;
+    SATSolver s(&conf);
+    s.new_vars(chain+1);
+    for(uint32_t i = 0; i+1 < chain; i++) {
+        s.add_clause(vector<Lit>{Lit(i, true), Lit(i+1, false)});
+    }
+    vector<Lit> assumps{Lit(0, false), Lit(chain, false)};
+    EXPECT_EQ(s.solve(&assumps), l_True);
+
+    SATSolver* c = s.clone();
+    assumps[1] = Lit(chain, true);
+    EXPECT_EQ(s.solve(&assumps), l_True);
+    EXPECT_LT(s.get_last_propagations(), 10u);
+
+    //The copy starts from level 0
+    assumps.push_back(Lit(chain-1, true));
+    EXPECT_EQ(c->solve(&assumps), l_False);
+    assumps.pop_back();
+    EXPECT_EQ(c->solve(&assumps), l_True);
+    EXPECT_EQ(c->get_model()[chain-1], l_True);
+    delete c;
+}
+
+TEST(clone, no_checkpoint_or_metrics)
+{
+    const string chk = "clone_test.chk";
+    const string json = "clone_test_metrics.json";
+    const string addr = "unix:/tmp/clone_test_" + std::to_string(getpid());
+    const uint32_t num_vars = 200;
+    const auto cls = random_3sat(60, num_vars, 852);
+
+    SATSolver* s = new SATSolver;
+    s->new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s->add_clause(cl);
+    }
+    s->set_checkpoint(chk, 1000);
+    s->set_metrics(addr, json, 0.1);
+    s->set_max_confl(10);
+    EXPECT_EQ(s->solve(), l_Undef);
+    EXPECT_TRUE(file_exists(chk));
+
+    //The original still listens on addr, the copy must not try to
+    SATSolver* c = s->clone();
+    std::remove(chk.c_str());
+    c->set_max_confl(10);
+    EXPECT_EQ(c->solve(), l_Undef);
+
+    delete s;
+    std::remove(json.c_str());
+    c->set_max_confl(10);
+    EXPECT_EQ(c->solve(), l_Undef);
+    EXPECT_FALSE(file_exists(chk));
+    EXPECT_FALSE(file_exists(json));
+    delete c;
+    std::remove(addr.c_str() + 5);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "src/solver.h"
 #include "src/compfinder.h"
+#include "src/comptracker.h"
 #include "src/solverconf.h"
 using namespace CMSat;
 #include "test_helper.h"
@@ -123,6 +124,107 @@ TEST_F(comp_finder, find_5_1)
     EXPECT_EQ(finder->getNumComps(), 5U);
 }
 
+TEST_F(comp_finder, track_add)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("3, -4, 5"));
+
+    vector<uint32_t> comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[1], 0U);
+    EXPECT_EQ(comps[4], 2U);
+    EXPECT_EQ(comps[7], 7U);
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 1U);
+
+    //Merged without rebuilding
+    s->add_clause_outer(str_to_cl("2, 4, 8"));
+    comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[1], 0U);
+    EXPECT_EQ(comps[4], 0U);
+    EXPECT_EQ(comps[7], 0U);
+    EXPECT_EQ(comps[10], 10U);
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 1U);
+}
+
+TEST_F(comp_finder, track_units_split)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("1, 3"));
+    s->add_clause_outer(str_to_cl("5, 6"));
+    vector<uint32_t> comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[1], comps[2]);
+
+    //One unit is not worth a rebuild, the comp stays merged
+    s->add_clause_outer(str_to_cl("1"));
+    comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[0], var_Undef);
+    EXPECT_EQ(comps[1], comps[2]);
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 1U);
+
+    s->add_clause_outer(str_to_cl("-5"));
+    comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[4], var_Undef);
+    EXPECT_EQ(comps[1], 1U);
+    EXPECT_EQ(comps[2], 2U);
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 2U);
+}
+
+TEST_F(comp_finder, track_solve_no_rebuild)
+{
+    for(uint32_t i = 0; i < 8; i++) {
+        s->add_clause_outer(str_to_cl(
+            std::to_string(2*i+1) + ", " + std::to_string(2*i+2)));
+        s->add_clause_outer(str_to_cl(
+            "-" + std::to_string(2*i+1) + ", -" + std::to_string(2*i+2)));
+    }
+    vector<uint32_t> comps = s->get_outside_var_components();
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 1U);
+
+    for(uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(s->solve_with_assumptions(NULL, false), l_True);
+        s->add_clause_outer(str_to_cl("2, 3, 5"));
+        comps = s->get_outside_var_components();
+        EXPECT_EQ(comps[4], 0U);
+        EXPECT_EQ(comps[6], 6U);
+    }
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 1U);
+}
+
+TEST_F(comp_finder, track_from_comp_finder)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("1, 3"));
+    vector<uint32_t> comps = s->get_outside_var_components();
+    s->add_clause_outer(str_to_cl("1"));
+
+    finder->find_components();
+    s->compTracker->set_from(*finder);
+    comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[1], 1U);
+    EXPECT_EQ(comps[2], 2U);
+    EXPECT_EQ(s->compTracker->get_num_rebuilds(), 2U);
+}
+
+TEST_F(comp_finder, track_simplified)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-2, 3"));
+    s->add_clause_outer(str_to_cl("5, -6, 7"));
+    s->add_clause_outer(str_to_cl("-7, 8, 9"));
+    s->add_clause_outer(str_to_cl("-5, 6"));
+    s->add_xor_clause_outer(vector<uint32_t>{10, 11, 12}, true);
+    s->add_xor_clause_outer(vector<uint32_t>{12, 13}, false);
+    s->simplify_with_assumptions();
+
+    //Eliminated and replaced vars stay in their comps
+    const vector<uint32_t> comps = s->get_outside_var_components();
+    EXPECT_EQ(comps[1], 0U);
+    EXPECT_EQ(comps[2], 0U);
+    EXPECT_EQ(comps[6], 4U);
+    EXPECT_EQ(comps[8], 4U);
+    EXPECT_EQ(comps[13], 10U);
+    EXPECT_EQ(comps[3], 3U);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
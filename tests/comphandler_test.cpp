@@ -166,6 +166,76 @@ TEST_F(comp_handle, check_unsat)
     EXPECT_EQ(chandle->get_num_components_solved(), 1u);
 }
 
+TEST_F(comp_handle, threads_and_batching)
+{
+    s->conf.comp_threads = 4;
+    s->conf.comp_batch_vars = 4;
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, -2"));
+
+    s->add_clause_outer(str_to_cl("3, 4"));
+    s->add_clause_outer(str_to_cl("-3, -4"));
+
+    s->add_clause_outer(str_to_cl("5, 6, 7"));
+    s->add_clause_outer(str_to_cl("-5, -6"));
+
+    s->add_clause_outer(str_to_cl("11, 12"));
+    s->add_clause_outer(str_to_cl("-11, -12"));
+
+    s->add_clause_outer(str_to_cl("19, 14, 15"));
+    s->add_clause_outer(str_to_cl("15, 16, 17"));
+    s->add_clause_outer(str_to_cl("17, 16, 18, 14"));
+    s->add_clause_outer(str_to_cl("17, 18, 13"));
+
+    chandle->handle();
+    EXPECT_TRUE(s->okay());
+    EXPECT_EQ(chandle->get_num_components_solved(), 4u);
+    EXPECT_EQ(chandle->get_num_vars_removed(), 9u);
+    vector<lbool> solution(s->nVarsOuter(), l_Undef);
+    chandle->addSavedState(solution);
+    EXPECT_TRUE(clause_satisfied("1, 2", solution));
+    EXPECT_TRUE(clause_satisfied("-1, -2", solution));
+    EXPECT_TRUE(clause_satisfied("3, 4", solution));
+    EXPECT_TRUE(clause_satisfied("-3, -4", solution));
+    EXPECT_TRUE(clause_satisfied("5, 6, 7", solution));
+    EXPECT_TRUE(clause_satisfied("-5, -6", solution));
+    EXPECT_TRUE(clause_satisfied("11, 12", solution));
+    EXPECT_TRUE(clause_satisfied("-11, -12", solution));
+}
+
+TEST_F(comp_handle, cache_unchanged_comps)
+{
+    s->add_clause_outer(str_to_cl("1, 2"));
+    s->add_clause_outer(str_to_cl("-1, -2"));
+
+    s->add_clause_outer(str_to_cl("11, 12"));
+    s->add_clause_outer(str_to_cl("-11, -12"));
+
+    s->add_clause_outer(str_to_cl("19, 14, 15"));
+    s->add_clause_outer(str_to_cl("15, 16, 17"));
+    s->add_clause_outer(str_to_cl("17, 16, 18, 14"));
+    s->add_clause_outer(str_to_cl("17, 18, 13"));
+
+    chandle->handle();
+    EXPECT_EQ(chandle->get_num_components_solved(), 2u);
+    EXPECT_EQ(chandle->get_num_components_cached(), 0u);
+
+    //Puts all components back, and changes one of them
+    chandle->readdRemovedClauses();
+    EXPECT_EQ(chandle->get_num_vars_removed(), 0u);
+    s->add_clause_outer(str_to_cl("1, 3"));
+
+    chandle->handle();
+    EXPECT_TRUE(s->okay());
+    EXPECT_EQ(chandle->get_num_components_solved(), 4u);
+    EXPECT_EQ(chandle->get_num_components_cached(), 1u);
+    vector<lbool> solution(s->nVarsOuter(), l_Undef);
+    chandle->addSavedState(solution);
+    EXPECT_TRUE(clause_satisfied("1, 3", solution));
+    EXPECT_TRUE(clause_satisfied("11, 12", solution));
+    EXPECT_TRUE(clause_satisfied("-11, -12", solution));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,198 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+//Projected models by going through all assignments
+static std::set<vector<bool>> brute_force(
+    const vector<vector<Lit>>& cls, uint32_t num_vars, const vector<uint32_t>& proj)
+{
+    std::set<vector<bool>> ret;
+    for(uint64_t a = 0; a < (1ULL << num_vars); a++) {
+        bool sat = true;
+        for(const auto& cl: cls) {
+            bool cl_sat = false;
+            for(const Lit l: cl) {
+                cl_sat |= (((a >> l.var()) & 1) != l.sign());
+            }
+            if (!cl_sat) {
+                sat = false;
+                break;
+            }
+        }
+        if (sat) {
+            vector<bool> p;
+            for(const uint32_t v: proj) {
+                p.push_back((a >> v) & 1);
+            }
+            ret.insert(p);
+        }
+    }
+    return ret;
+}
+
+static std::set<vector<bool>> enumerate_all(
+    SATSolver& s, const vector<uint32_t>* proj, const uint32_t num_vars
+    , uint64_t& num_calls
+) {
+    std::set<vector<bool>> ret;
+    num_calls = s.enumerate([&](const vector<lbool>& model) {
+        vector<bool> p;
+        for(uint32_t v = 0; v < num_vars; v++) {
+            if (proj && std::find(proj->begin(), proj->end(), v) == proj->end()) {
+                EXPECT_EQ(model[v], l_Undef);
+                continue;
+            }
+            EXPECT_NE(model[v], l_Undef);
+            p.push_back(model[v] == l_True);
+        }
+        EXPECT_TRUE(ret.insert(p).second) << "model found twice";
+        return true;
+    }, proj);
+    return ret;
+}
+
+TEST(enumerate, all_vars)
+{
+    for(uint32_t seed = 0; seed < 30; seed++) {
+        const uint32_t num_vars = 12;
+        const auto cls = random_3sat(seed, num_vars, 30 + seed);
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+
+        vector<uint32_t> all;
+        for(uint32_t v = 0; v < num_vars; v++) {
+            all.push_back(v);
+        }
+        uint64_t num;
+        const auto models = enumerate_all(s, NULL, num_vars, num);
+        EXPECT_EQ(models, brute_force(cls, num_vars, all));
+        EXPECT_EQ(num, models.size());
+    }
+}
+
+TEST(enumerate, projected)
+{
+    for(uint32_t seed = 0; seed < 30; seed++) {
+        const uint32_t num_vars = 14;
+        const auto cls = random_3sat(seed, num_vars, 40 + seed);
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+
+        //Simplification first, so projection vars may have been eliminated
+        s.solve();
+        const vector<uint32_t> proj = {1, 4, 5, 9, 13};
+        uint64_t num;
+        const auto models = enumerate_all(s, &proj, num_vars, num);
+        EXPECT_EQ(models, brute_force(cls, num_vars, proj));
+        EXPECT_EQ(num, models.size());
+    }
+}
+
+TEST(enumerate, leaves_cnf_unchanged)
+{
+    const uint32_t num_vars = 12;
+    const auto cls = random_3sat(3, num_vars, 30);
+    SATSolver s;
+    s.new_vars(num_vars);
+    for(const auto& cl: cls) {
+        s.add_clause(cl);
+    }
+
+    const vector<uint32_t> proj = {0, 2, 4, 6};
+    uint64_t num1, num2;
+    const auto models1 = enumerate_all(s, &proj, num_vars, num1);
+    const auto models2 = enumerate_all(s, &proj, num_vars, num2);
+    EXPECT_EQ(models1, models2);
+    EXPECT_EQ(s.nVars(), num_vars);
+    EXPECT_EQ(s.solve(), l_True);
+
+    //Only the models of the new clause are left
+    s.add_clause(vector<Lit>{Lit(0, false)});
+    const auto models3 = enumerate_all(s, &proj, num_vars, num1);
+    vector<vector<Lit>> cls2 = cls;
+    cls2.push_back(vector<Lit>{Lit(0, false)});
+    EXPECT_EQ(models3, brute_force(cls2, num_vars, proj));
+}
+
+TEST(enumerate, limit_and_stop)
+{
+    SATSolver s;
+    s.new_vars(10);
+    const vector<uint32_t> proj = {0, 1, 2, 3, 4};
+    EXPECT_EQ(s.enumerate([](const vector<lbool>&) {return true;}, &proj, 7), 7U);
+    EXPECT_EQ(s.enumerate([](const vector<lbool>&) {return true;}, &proj), 32U);
+
+    uint64_t called = 0;
+    EXPECT_EQ(s.enumerate([&](const vector<lbool>&) {return ++called < 3;}, &proj), 3U);
+    EXPECT_EQ(called, 3U);
+}
+
+TEST(enumerate, unsat)
+{
+    SATSolver s;
+    s.new_vars(2);
+    s.add_clause(vector<Lit>{Lit(0, false)});
+    s.add_clause(vector<Lit>{Lit(0, true), Lit(1, false)});
+    s.add_clause(vector<Lit>{Lit(1, true)});
+    EXPECT_EQ(s.enumerate([](const vector<lbool>&) {return true;}), 0U);
+    EXPECT_FALSE(s.okay());
+}
+
+TEST(enumerate, xor_constraints)
+{
+    SATSolver s;
+    s.new_vars(8);
+    s.add_xor_clause(vector<unsigned>{0, 1, 2, 3}, true);
+    s.add_xor_clause(vector<unsigned>{2, 3, 4, 5}, false);
+    s.add_xor_clause(vector<unsigned>{4, 5, 6, 7}, true);
+    s.solve();
+
+    uint64_t num = s.enumerate([](const vector<lbool>& m) {
+        bool x1 = (m[0] == l_True) ^ (m[1] == l_True) ^ (m[2] == l_True) ^ (m[3] == l_True);
+        bool x2 = (m[2] == l_True) ^ (m[3] == l_True) ^ (m[4] == l_True) ^ (m[5] == l_True);
+        bool x3 = (m[4] == l_True) ^ (m[5] == l_True) ^ (m[6] == l_True) ^ (m[7] == l_True);
+        EXPECT_TRUE(x1 && !x2 && x3);
+        return true;
+    });
+    EXPECT_EQ(num, 32U);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,397 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+//Keeps the values of the observed vars from the notifications, and checks
+//that they agree with the models found
+class Tracker : public ExternalPropagator
+{
+public:
+    explicit Tracker(uint32_t num_vars) :
+        value(num_vars, l_Undef)
+    {}
+
+    void notify_assignment(const vector<Lit>& lits) override
+    {
+        for(const Lit l: lits) {
+            EXPECT_EQ(value[l.var()], l_Undef);
+            value[l.var()] = boolToLBool(!l.sign());
+            trail.push_back(l);
+        }
+    }
+
+    void notify_new_decision_level() override
+    {
+        trail_lim.push_back(trail.size());
+    }
+
+    void notify_backtrack(uint32_t new_level) override
+    {
+        EXPECT_LT(new_level, trail_lim.size());
+        while(trail.size() > trail_lim[new_level]) {
+            value[trail.back().var()] = l_Undef;
+            trail.pop_back();
+        }
+        trail_lim.resize(new_level);
+        proposed.clear();
+    }
+
+    bool cb_check_found_model(const vector<Lit>& model) override
+    {
+        models++;
+        for(const Lit l: model) {
+            EXPECT_EQ(value[l.var()], boolToLBool(!l.sign()));
+        }
+        return true;
+    }
+
+    vector<lbool> value;
+    vector<Lit> trail;
+    vector<size_t> trail_lim;
+    std::set<Lit> proposed; ///<propagated, but not notified yet
+    uint64_t models = 0;
+};
+
+//At most k of vars are true, propagated lazily
+class AtMostK : public Tracker
+{
+public:
+    AtMostK(uint32_t num_vars, const vector<uint32_t>& _vars, uint32_t _k) :
+        Tracker(num_vars)
+        , vars(_vars)
+        , k(_k)
+        , reasons(num_vars)
+    {}
+
+    vector<Lit> trues() const
+    {
+        vector<Lit> ret;
+        for(const uint32_t v: vars) {
+            if (value[v] == l_True) {
+                ret.push_back(Lit(v, false));
+            }
+        }
+        return ret;
+    }
+
+    Lit cb_propagate() override
+    {
+        const vector<Lit> t = trues();
+        if (t.size() != k) {
+            return lit_Undef;
+        }
+        for(const uint32_t v: vars) {
+            const Lit l = Lit(v, true);
+            if (value[v] == l_Undef && proposed.insert(l).second) {
+                reasons[v] = t;
+                props++;
+                return l;
+            }
+        }
+        return lit_Undef;
+    }
+
+    void cb_add_reason_clause(Lit propagated, vector<Lit>& reason) override
+    {
+        asked++;
+        reason.push_back(propagated);
+        for(const Lit l: reasons[propagated.var()]) {
+            reason.push_back(~l);
+        }
+    }
+
+    bool cb_add_external_clause(vector<Lit>& clause, bool& forgettable) override
+    {
+        const vector<Lit> t = trues();
+        if (t.size() <= k) {
+            return false;
+        }
+        for(uint32_t i = 0; i <= k; i++) {
+            clause.push_back(~t[i]);
+        }
+        forgettable = true;
+        return true;
+    }
+
+    bool cb_check_found_model(const vector<Lit>& model) override
+    {
+        Tracker::cb_check_found_model(model);
+        uint32_t num = 0;
+        for(const Lit l: model) {
+            num += (!l.sign() && std::find(vars.begin(), vars.end(), l.var()) != vars.end());
+        }
+        EXPECT_LE(num, k);
+        return true;
+    }
+
+    vector<uint32_t> vars;
+    uint32_t k;
+    vector<vector<Lit>> reasons;
+    uint64_t props = 0;
+    uint64_t asked = 0;
+};
+
+static void add_at_most_k(vector<vector<Lit>>& cls, const vector<uint32_t>& vars, uint32_t k)
+{
+    //Every k+1 subset has a false var
+    vector<bool> pick(vars.size(), false);
+    std::fill(pick.begin(), pick.begin() + k + 1, true);
+    do {
+        vector<Lit> cl;
+        for(uint32_t i = 0; i < vars.size(); i++) {
+            if (pick[i]) {
+                cl.push_back(Lit(vars[i], true));
+            }
+        }
+        cls.push_back(cl);
+    } while(std::prev_permutation(pick.begin(), pick.end()));
+}
+
+TEST(extprop, at_most_k_same_as_cnf)
+{
+    const uint32_t num_vars = 40;
+    vector<uint32_t> vars;
+    for(uint32_t v = 0; v < 12; v++) {
+        vars.push_back(v*3);
+    }
+
+    uint32_t num_sat = 0;
+    uint64_t props = 0;
+    for(uint32_t seed = 0; seed < 40; seed++) {
+        const auto cls = random_3sat(seed, num_vars, 150);
+        auto cls_eager = cls;
+        add_at_most_k(cls_eager, vars, 3);
+
+        SATSolver eager;
+        eager.new_vars(num_vars);
+        for(const auto& cl: cls_eager) {
+            eager.add_clause(cl);
+        }
+        const lbool eager_ret = eager.solve();
+
+        AtMostK prop(num_vars, vars, 3);
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+        s.connect_external_propagator(&prop);
+        for(const uint32_t v: vars) {
+            s.add_observed_var(v);
+        }
+        const lbool ret = s.solve();
+        EXPECT_EQ(ret, eager_ret) << "seed: " << seed;
+        if (ret == l_True) {
+            num_sat++;
+            EXPECT_TRUE(model_ok(cls_eager, s.get_model())) << "seed: " << seed;
+            EXPECT_GE(prop.models, 1U);
+        }
+        props += prop.props;
+        EXPECT_LE(prop.asked, prop.props);
+    }
+    EXPECT_GT(num_sat, 0U);
+    EXPECT_LT(num_sat, 40U);
+    EXPECT_GT(props, 0U);
+}
+
+//Rejects every model, blocking it on the observed vars
+class Blocker : public Tracker
+{
+public:
+    Blocker(uint32_t num_vars) :
+        Tracker(num_vars)
+    {}
+
+    bool cb_check_found_model(const vector<Lit>& model) override
+    {
+        Tracker::cb_check_found_model(model);
+        vector<Lit> sorted = model;
+        for(const Lit l: model) {
+            block.push_back(~l);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_TRUE(seen.insert(sorted).second) << "model found twice";
+        return false;
+    }
+
+    bool cb_add_external_clause(vector<Lit>& clause, bool& forgettable) override
+    {
+        if (block.empty()) {
+            return false;
+        }
+        clause.swap(block);
+        block.clear();
+        forgettable = false;
+        return true;
+    }
+
+    vector<Lit> block;
+    std::set<vector<Lit>> seen;
+};
+
+TEST(extprop, reject_all_models)
+{
+    for(uint32_t seed = 0; seed < 20; seed++) {
+        const uint32_t num_vars = 12;
+        const auto cls = random_3sat(seed, num_vars, 30);
+        const vector<uint32_t> proj = {0, 3, 4, 7, 11};
+
+        //Projected models by going through all assignments
+        std::set<vector<bool>> models;
+        for(uint32_t a = 0; a < (1U << num_vars); a++) {
+            vector<lbool> m;
+            for(uint32_t v = 0; v < num_vars; v++) {
+                m.push_back(boolToLBool((a >> v) & 1));
+            }
+            if (model_ok(cls, m)) {
+                vector<bool> p;
+                for(const uint32_t v: proj) {
+                    p.push_back((a >> v) & 1);
+                }
+                models.insert(p);
+            }
+        }
+
+        Blocker prop(num_vars);
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+        s.connect_external_propagator(&prop);
+        for(const uint32_t v: proj) {
+            s.add_observed_var(v);
+        }
+        EXPECT_EQ(s.solve(), l_False);
+        EXPECT_EQ(prop.seen.size(), models.size()) << "seed: " << seed;
+    }
+}
+
+TEST(extprop, assumptions_and_incremental)
+{
+    const uint32_t num_vars = 10;
+    const vector<uint32_t> vars = {0, 1, 2, 3, 4, 5};
+    AtMostK prop(num_vars, vars, 2);
+    SATSolver s;
+    s.new_vars(num_vars);
+    s.add_clause(vector<Lit>{Lit(6, false), Lit(7, false)});
+    s.connect_external_propagator(&prop);
+    for(const uint32_t v: vars) {
+        s.add_observed_var(v);
+    }
+    EXPECT_EQ(s.solve(), l_True);
+
+    //The third one is propagated false by the propagator
+    vector<Lit> assumps = {Lit(0, false), Lit(1, false), Lit(2, false)};
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    vector<Lit> confl = s.get_conflict();
+    std::sort(confl.begin(), confl.end());
+    EXPECT_EQ(confl, (vector<Lit>{Lit(0, true), Lit(1, true), Lit(2, true)}));
+    EXPECT_GE(prop.asked, 1U);
+
+    assumps = {Lit(0, false), Lit(1, false)};
+    EXPECT_EQ(s.solve(&assumps), l_True);
+    for(uint32_t v = 2; v < 6; v++) {
+        EXPECT_EQ(s.get_model()[v], l_False);
+    }
+
+    //Clauses forcing three of them make it UNSAT
+    s.add_clause(vector<Lit>{Lit(3, false)});
+    s.add_clause(vector<Lit>{Lit(4, false)});
+    s.add_clause(vector<Lit>{Lit(5, false)});
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(extprop, observed_vars_not_eliminated)
+{
+    //Var 1 only connects two clauses, so it would be eliminated
+    Tracker prop(4);
+    SATSolver s;
+    s.new_vars(4);
+    s.add_clause(vector<Lit>{Lit(0, false), Lit(1, false)});
+    s.add_clause(vector<Lit>{Lit(1, true), Lit(2, false)});
+    s.add_clause(vector<Lit>{Lit(2, true), Lit(3, false)});
+    EXPECT_EQ(s.simplify(), l_Undef);
+    s.connect_external_propagator(&prop);
+    s.add_observed_var(1);
+    s.add_observed_var(2);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(prop.models, 1U);
+    EXPECT_NE(s.get_model()[1], l_Undef);
+    EXPECT_NE(s.get_model()[2], l_Undef);
+}
+
+TEST(extprop, errors)
+{
+    SATSolver s;
+    s.new_vars(2);
+    EXPECT_THROW(s.add_observed_var(0), std::runtime_error);
+
+    Tracker prop(2);
+    s.connect_external_propagator(&prop);
+    EXPECT_THROW(s.set_num_threads(2), std::runtime_error);
+    EXPECT_THROW(s.enumerate([](const vector<lbool>&) {return true;}), std::runtime_error);
+    s.disconnect_external_propagator();
+    EXPECT_EQ(s.solve(), l_True);
+}
+
+TEST(extprop, disconnect_restores_conf)
+{
+    SolverConf conf;
+    conf.doFindXors = 1;
+    conf.doBreakid = true;
+    conf.diff_declev_for_chrono = 7;
+    std::atomic<bool> must_inter(false);
+    Solver s(&conf, &must_inter);
+    s.new_vars(2);
+
+    Tracker prop(2);
+    s.connect_external_propagator(&prop);
+    EXPECT_EQ(s.conf.doFindXors, 0);
+    EXPECT_FALSE(s.conf.doBreakid);
+    EXPECT_EQ(s.conf.diff_declev_for_chrono, -1);
+
+    //Connecting again must not make the off values the ones to restore
+    s.connect_external_propagator(&prop);
+    s.disconnect_external_propagator();
+    EXPECT_EQ(s.conf.doCompHandler, conf.doCompHandler);
+    EXPECT_EQ(s.conf.doFindAndReplaceEqLits, conf.doFindAndReplaceEqLits);
+    EXPECT_EQ(s.conf.doFindXors, 1);
+    EXPECT_EQ(s.conf.gaussconf.doMatrixFind, conf.gaussconf.doMatrixFind);
+    EXPECT_TRUE(s.conf.doBreakid);
+    EXPECT_EQ(s.conf.diff_declev_for_chrono, 7);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
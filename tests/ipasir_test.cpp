@@ -368,6 +368,107 @@ TEST(ipasir_interface, assump_clears)
 }
 
 
+static int terminate_after_3(void* state)
+{
+    int* called = (int*)state;
+    (*called)++;
+    return *called >= 3;
+}
+
+TEST(ipasir_interface, terminate)
+{
+    //Pigeonhole, 11 pigeons in 10 holes: far too hard to finish
+    void* s = ipasir_init();
+    const int holes = 10;
+    for(int p = 0; p <= holes; p++) {
+        for(int h = 0; h < holes; h++) {
+            ipasir_add(s, p*holes+h+1);
+        }
+        ipasir_add(s, 0);
+    }
+    for(int h = 0; h < holes; h++) {
+        for(int p1 = 0; p1 <= holes; p1++) {
+            for(int p2 = p1+1; p2 <= holes; p2++) {
+                ipasir_add(s, -(p1*holes+h+1));
+                ipasir_add(s, -(p2*holes+h+1));
+                ipasir_add(s, 0);
+            }
+        }
+    }
+
+    int called = 0;
+    ipasir_set_terminate(s, &called, terminate_after_3);
+    EXPECT_EQ(ipasir_solve(s), 0);
+    EXPECT_EQ(called, 3);
+
+    //Trivially UNSAT once the first pigeon has no holes
+    ipasir_set_terminate(s, NULL, NULL);
+    for(int h = 0; h < holes; h++) {
+        ipasir_add(s, -(h+1));
+        ipasir_add(s, 0);
+    }
+    EXPECT_EQ(ipasir_solve(s), 20);
+    EXPECT_EQ(called, 3);
+    ipasir_release(s);
+}
+
+//Rejects every model and blocks it with a clause
+struct model_counter {
+    int models;
+    int block[3];
+    int block_at; ///<-1 if no clause to add
+};
+
+static int count_and_reject(void* state, const int* model, int size)
+{
+    model_counter* c = (model_counter*)state;
+    EXPECT_EQ(size, 3);
+    for(int i = 0; i < size; i++) {
+        c->block[i] = -model[i];
+    }
+    c->block_at = 0;
+    c->models++;
+    return 0;
+}
+
+static int has_block(void* state, int* is_forgettable)
+{
+    model_counter* c = (model_counter*)state;
+    *is_forgettable = 0;
+    return c->block_at == 0;
+}
+
+static int block_lit(void* state)
+{
+    model_counter* c = (model_counter*)state;
+    if (c->block_at == 3) {
+        c->block_at = -1;
+        return 0;
+    }
+    return c->block[c->block_at++];
+}
+
+TEST(ipasir_interface, external_propagator)
+{
+    void* s = ipasir_init();
+    ipasir_add(s, 4);
+    ipasir_add(s, 5);
+    ipasir_add(s, 0);
+
+    model_counter c = {0, {0, 0, 0}, -1};
+    ipasir_up_propagator prop = {};
+    prop.cb_check_found_model = count_and_reject;
+    prop.cb_has_external_clause = has_block;
+    prop.cb_add_external_clause_lit = block_lit;
+    ipasir_connect_external_propagator(s, &c, &prop);
+    for(int v = 1; v <= 3; v++) {
+        ipasir_add_observed_var(s, v);
+    }
+    EXPECT_EQ(ipasir_solve(s), 20);
+    EXPECT_EQ(c.models, 8);
+    ipasir_release(s);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
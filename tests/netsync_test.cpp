@@ -0,0 +1,304 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include "src/netsync.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+using namespace CMSat::net;
+
+TEST(netsync_varint, roundtrip)
+{
+    vector<uint8_t> out;
+    const uint64_t vals[] = {0, 1, 127, 128, 300, 1ULL<<32, ~0ULL};
+    for(uint64_t v: vals) {
+        put_varint(out, v);
+    }
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[2], 127);
+
+    const uint8_t* at = out.data();
+    const uint8_t* end = out.data() + out.size();
+    for(uint64_t v: vals) {
+        uint64_t got;
+        EXPECT_TRUE(get_varint(at, end, got));
+        EXPECT_EQ(got, v);
+    }
+    EXPECT_EQ(at, end);
+}
+
+TEST(netsync_varint, truncated)
+{
+    vector<uint8_t> out;
+    put_varint(out, 1ULL<<40);
+    const uint8_t* at = out.data();
+    uint64_t got;
+    EXPECT_FALSE(get_varint(at, out.data() + out.size() - 1, got));
+}
+
+TEST(netsync_clauses, roundtrip_sorted)
+{
+    vector<uint32_t> flat = {1, 7, 2, 9, 4, 3, 100, 2, 50};
+    vector<uint8_t> out;
+    encode_clauses(flat, out);
+
+    vector<uint32_t> got;
+    EXPECT_TRUE(decode_clauses(out.data(), out.size(), got));
+    vector<uint32_t> expected = {1, 7, 2, 4, 9, 3, 2, 50, 100};
+    EXPECT_EQ(got, expected);
+}
+
+TEST(netsync_clauses, short_clauses_are_small)
+{
+    vector<uint32_t> flat;
+    for(uint32_t i = 0; i < 1000; i++) {
+        flat.push_back(3);
+        flat.push_back(2*i);
+        flat.push_back(2*i+5);
+        flat.push_back(2*i+9);
+    }
+    vector<uint8_t> out;
+    encode_clauses(flat, out);
+    EXPECT_LT(out.size(), flat.size()*sizeof(uint32_t)/2);
+
+    vector<uint32_t> got;
+    EXPECT_TRUE(decode_clauses(out.data(), out.size(), got));
+    EXPECT_EQ(got, flat);
+}
+
+TEST(netsync_clauses, malformed)
+{
+    vector<uint32_t> flat = {3, 10, 20, 30};
+    vector<uint8_t> out;
+    encode_clauses(flat, out);
+
+    vector<uint32_t> got;
+    EXPECT_FALSE(decode_clauses(out.data(), out.size()-1, got));
+
+    const uint8_t zero_size[] = {0};
+    got.clear();
+    EXPECT_FALSE(decode_clauses(zero_size, 1, got));
+}
+
+TEST(netsync_clauses, hash_order_independent_after_sort)
+{
+    vector<uint32_t> a = {2, 8, 3};
+    vector<uint32_t> b = {2, 3, 8};
+    vector<uint8_t> out_a;
+    vector<uint8_t> out_b;
+    encode_clauses(a, out_a);
+    encode_clauses(b, out_b);
+    EXPECT_EQ(out_a, out_b);
+    EXPECT_EQ(clause_hash(a.data()+1, 2), clause_hash(b.data()+1, 2));
+
+    vector<uint32_t> c = {3, 8, 4};
+    EXPECT_NE(clause_hash(b.data()+1, 2), clause_hash(c.data()+1, 2));
+}
+
+#ifndef _WIN32
+//Plays the hub over a local socket
+struct FakeHub
+{
+    FakeHub() :
+        addr("unix:/tmp/cmsat_netsync_test_" + std::to_string(getpid()))
+    {
+        listen_fd = listen_on(addr);
+    }
+
+    ~FakeHub()
+    {
+        delete conn;
+        close_fd(listen_fd);
+        unlink(addr.c_str() + 5);
+    }
+
+    void accept_client()
+    {
+        pollfd p;
+        p.fd = listen_fd;
+        p.events = POLLIN;
+        p.revents = 0;
+        ASSERT_EQ(poll(&p, 1, 10000), 1);
+        int fd = accept(listen_fd, NULL, NULL);
+        ASSERT_NE(fd, -1);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        conn = new Conn(fd);
+    }
+
+    //Returns false if nothing arrived in time
+    bool wait_msg(MsgType& type, vector<uint8_t>& payload)
+    {
+        bool malformed;
+        for(int i = 0; i < 1000; i++) {
+            if (!conn->read_some()) {
+                return false;
+            }
+            if (conn->next_msg(type, payload, malformed)) {
+                return true;
+            }
+            if (malformed) {
+                return false;
+            }
+            usleep(1000);
+        }
+        return false;
+    }
+
+    string addr;
+    int listen_fd;
+    Conn* conn = NULL;
+};
+
+static bool wait_receive(Client& c, vector<uint32_t>& flat, bool& got_done)
+{
+    for(int i = 0; i < 1000; i++) {
+        if (!c.receive(flat, got_done)) {
+            return false;
+        }
+        if (!flat.empty() || got_done) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+TEST(netsync_socket, exchange)
+{
+    FakeHub hub;
+    Client c(hub.addr);
+    hub.accept_client();
+
+    c.add_clause({6, 2, 4});
+    c.add_clause({2, 4, 6});
+    EXPECT_EQ(c.get_stats().dedup_cls, 1U);
+    c.send_batch(10);
+
+    MsgType type;
+    vector<uint8_t> payload;
+    ASSERT_TRUE(hub.wait_msg(type, payload));
+    EXPECT_EQ(type, MsgType::hello);
+    const uint8_t* at = payload.data();
+    uint64_t num_vars;
+    EXPECT_TRUE(get_varint(at, payload.data() + payload.size(), num_vars));
+    EXPECT_EQ(num_vars, 10U);
+
+    ASSERT_TRUE(hub.wait_msg(type, payload));
+    EXPECT_EQ(type, MsgType::clauses);
+    vector<uint32_t> flat;
+    EXPECT_TRUE(decode_clauses(payload.data(), payload.size(), flat));
+    EXPECT_EQ(flat, vector<uint32_t>({3, 2, 4, 6}));
+
+    vector<uint32_t> from_other = {2, 8, 11};
+    payload.clear();
+    encode_clauses(from_other, payload);
+    hub.conn->queue(MsgType::clauses, payload);
+    EXPECT_TRUE(hub.conn->flush_all());
+
+    flat.clear();
+    bool got_done;
+    ASSERT_TRUE(wait_receive(c, flat, got_done));
+    EXPECT_FALSE(got_done);
+    EXPECT_EQ(flat, from_other);
+    EXPECT_EQ(c.get_stats().recv_cls, 1U);
+
+    //Whatever came from the hub is not sent back
+    c.add_clause({11, 8});
+    EXPECT_EQ(c.get_stats().dedup_cls, 2U);
+
+    c.send_done();
+    ASSERT_TRUE(hub.wait_msg(type, payload));
+    EXPECT_EQ(type, MsgType::done);
+}
+
+TEST(netsync_socket, done_from_hub)
+{
+    FakeHub hub;
+    Client c(hub.addr);
+    hub.accept_client();
+
+    hub.conn->queue(MsgType::done, vector<uint8_t>());
+    EXPECT_TRUE(hub.conn->flush_all());
+
+    vector<uint32_t> flat;
+    bool got_done;
+    ASSERT_TRUE(wait_receive(c, flat, got_done));
+    EXPECT_TRUE(got_done);
+    EXPECT_TRUE(flat.empty());
+}
+
+TEST(netsync_socket, held_back_while_hub_not_reading)
+{
+    FakeHub hub;
+    Client c(hub.addr);
+    hub.accept_client();
+
+    //The hub doesn't read, so the output buffer fills up, and then the
+    //batches must be held back, not lost
+    uint32_t var = 0;
+    while(c.get_stats().held_batches == 0 && var < 40U*1000U*1000U) {
+        for(uint32_t i = 0; i < 100000; i++, var += 3) {
+            c.add_clause({2*var, 2*var+2, 2*var+4});
+        }
+        c.send_batch(3*var);
+    }
+    ASSERT_GT(c.get_stats().held_batches, 0U);
+    EXPECT_EQ(c.get_stats().dropped_batches, 0U);
+
+    //Now the hub reads, and the held batch must follow
+    uint64_t recv_cls = 0;
+    MsgType type;
+    vector<uint8_t> payload;
+    vector<uint32_t> flat;
+    bool malformed = false;
+    for(int i = 0; i < 100000 && recv_cls < c.get_stats().sent_cls; i++) {
+        c.send_batch(3*var);
+        ASSERT_TRUE(hub.conn->read_some());
+        while(hub.conn->next_msg(type, payload, malformed)) {
+            if (type != MsgType::clauses) {
+                continue;
+            }
+            flat.clear();
+            ASSERT_TRUE(decode_clauses(payload.data(), payload.size(), flat));
+            for(size_t at = 0; at < flat.size(); at += 1 + flat[at]) {
+                recv_cls++;
+            }
+        }
+        ASSERT_FALSE(malformed);
+    }
+    EXPECT_EQ(recv_cls, c.get_stats().sent_cls);
+    EXPECT_EQ(c.get_stats().sent_cls, var/3);
+}
+#endif
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+TEST(snapshot, same_results_under_assumptions)
+{
+    const char* fname = "snapshot_test.dat";
+    for(uint32_t seed = 20; seed < 24; seed++) {
+        const uint32_t num_vars = 120;
+        const auto cls = random_3sat(seed, num_vars, 480);
+        {
+            SATSolver s;
+            s.new_vars(num_vars);
+            for(const auto& cl: cls) {
+                s.add_clause(cl);
+            }
+            s.save_simplified(fname);
+        }
+
+        MTRand rnd(seed);
+        for(unsigned threads = 1; threads <= 2; threads++) {
+            for(uint32_t i = 0; i < 5; i++) {
+                vector<Lit> assumps;
+                for(uint32_t j = 0; j < 6; j++) {
+                    assumps.push_back(Lit(rnd.randInt(num_vars-1), rnd.randInt(1)));
+                }
+
+                SATSolver plain;
+                plain.new_vars(num_vars);
+                for(const auto& cl: cls) {
+                    plain.add_clause(cl);
+                }
+                const lbool expected = plain.solve(&assumps);
+
+                SATSolver s;
+                s.set_num_threads(threads);
+                s.load_simplified(fname);
+                EXPECT_EQ(s.nVars(), num_vars);
+                const lbool ret = s.solve(&assumps);
+                EXPECT_EQ(ret, expected);
+                if (ret == l_True) {
+                    auto with_assumps = cls;
+                    for(const Lit l: assumps) {
+                        with_assumps.push_back(vector<Lit>{l});
+                    }
+                    EXPECT_TRUE(model_ok(with_assumps, s.get_model()));
+                }
+            }
+        }
+    }
+    std::remove(fname);
+}
+
+TEST(snapshot, keeps_sampling_vars)
+{
+    const char* fname = "snapshot_test.dat";
+    const uint32_t num_vars = 60;
+    const auto cls = random_3sat(30, num_vars, 150);
+    vector<uint32_t> sampling;
+    for(uint32_t v = 0; v < num_vars; v += 3) {
+        sampling.push_back(v);
+    }
+    {
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) {
+            s.add_clause(cl);
+        }
+        s.set_sampling_vars(&sampling);
+        s.save_simplified(fname);
+    }
+
+    SATSolver s;
+    s.load_simplified(fname);
+    EXPECT_EQ(s.solve(NULL, true), l_True);
+    for(const uint32_t v: sampling) {
+        EXPECT_NE(s.get_model()[v], l_Undef);
+    }
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_TRUE(model_ok(cls, s.get_model()));
+    std::remove(fname);
+}
+
+TEST(snapshot, unsat)
+{
+    const char* fname = "snapshot_test.dat";
+    {
+        SATSolver s;
+        s.new_vars(2);
+        s.add_clause(vector<Lit>{Lit(0, false), Lit(1, false)});
+        s.add_clause(vector<Lit>{Lit(0, true), Lit(1, false)});
+        s.add_clause(vector<Lit>{Lit(0, false), Lit(1, true)});
+        s.add_clause(vector<Lit>{Lit(0, true), Lit(1, true)});
+        s.save_simplified(fname);
+    }
+
+    SATSolver s;
+    s.load_simplified(fname);
+    EXPECT_EQ(s.solve(), l_False);
+    std::remove(fname);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include "src/solver.h"
 #include "src/xor.h"
+#include "src/MersenneTwister.h"
 #include "cryptominisat5/cryptominisat.h"
 
 using std::cout;
@@ -626,6 +627,42 @@ bool cl_eq(const vector<Lit>& lits1, const vector<Lit>& lits2)
     return true;
 }
 
+//Clauses never contain the same variable twice
+vector<vector<Lit>> random_3sat(uint32_t seed, uint32_t num_vars, uint32_t num_cls)
+{
+    MTRand rnd(seed);
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const uint32_t v = rnd.randInt(num_vars-1);
+            bool dup = false;
+            for(const Lit l: cl) {
+                dup |= (l.var() == v);
+            }
+            if (!dup) {
+                cl.push_back(Lit(v, rnd.randInt(1)));
+            }
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+bool model_ok(const vector<vector<Lit>>& cls, const vector<lbool>& model)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) {
+            sat |= ((model[l.var()] ^ l.sign()) == l_True);
+        }
+        if (!sat) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool cl_exists(const vector<vector<Lit> >& cls, const vector<Lit>& cl) {
     for(const vector<Lit>& cli: cls) {
         if (cl_eq(cli, cl)) {